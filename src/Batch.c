@@ -0,0 +1,633 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Batch.c : Batch runner. Runs a list of independent jobs over a pool of worker threads, each with a machine of its own,
+and writes one summary of the results
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "Batch.h"
+#include "Scheduler.h"
+#include "SysIO/Log.h"
+#include "IO/IOController.h"
+#include "Z80/Z80.h"
+#include "Z80/Z80Step.h"
+#include "Z80/Z80Flags.h"
+
+/* The batch */
+BatchJob_t* batch_jobs = NULL;
+int batch_nJobs = 0;
+BatchWorker_t batch_workers[MAX_NUMBER_OF_BATCH_WORKERS];
+int batch_nWorkers = 0;
+int batch_lanes = 1;
+Z0MachineOptions_t batch_options;
+
+/* Input script of the job running on this thread */
+Z0_MACHINE_LOCAL BatchInput_t batch_inputs[MAX_NUMBER_OF_BATCH_INPUTS];
+Z0_MACHINE_LOCAL int batch_nInputs = 0;
+Z0_MACHINE_LOCAL int batch_nextInput = 0;
+Z0_MACHINE_LOCAL int batch_nextPortInput = 0;
+Z0_MACHINE_LOCAL uint64_t batch_jobStart = 0;
+Z0_MACHINE_LOCAL BatchPort_t batch_ports[MAX_NUMBER_OF_BATCH_PORTS];
+Z0_MACHINE_LOCAL int batch_nPorts = 0;
+
+/********************************************************************
+
+    Batch Functions
+
+********************************************************************/
+
+/*
+Runs every job in 'jobsPath' over 'workers' threads, 0 for one per hardware thread, and writes the results to
+'summaryPath'. Each worker runs up to 'lanes' jobs at a time in lockstep. 'options' gives the engine settings every job
+shares. Returns false if the batch couldn't be run
+*/
+bool batch_run(const char* jobsPath, const char* summaryPath, int workers, int lanes, const Z0MachineOptions_t* options) {
+    if (!batch_loadJobs(jobsPath))
+        return false;
+
+    batch_options = *options;
+    if (workers <= 0)
+        workers = batch_hardwareThreads();
+    if (workers > batch_nJobs)
+        workers = batch_nJobs;
+    if (workers > MAX_NUMBER_OF_BATCH_WORKERS)
+        workers = MAX_NUMBER_OF_BATCH_WORKERS;
+    if (workers < 1)
+        workers = 1;
+    batch_nWorkers = workers;
+    batch_lanes = lanes < 1 ? 1 : lanes > Z80_LOCKSTEP_MAX_LANES ? Z80_LOCKSTEP_MAX_LANES : lanes;
+    formattedLog(stdlog, LOGTYPE_MSG, "Running %i jobs from '%s' on %i workers\n", batch_nJobs, jobsPath, batch_nWorkers);
+    if (batch_lanes > 1) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Running up to %i jobs in lockstep on machines using the step engine\n", batch_lanes);
+    }
+
+    // Deal the jobs out in contiguous ranges. Stealing evens out whatever this gets wrong
+    for (int i = 0; i < batch_nWorkers; i++) {
+        BatchWorker_t* worker = &batch_workers[i];
+        worker->index = i;
+        worker->head = (int)((long long)batch_nJobs * i / batch_nWorkers);
+        worker->tail = (int)((long long)batch_nJobs * (i + 1) / batch_nWorkers);
+        worker->stolen = 0;
+        worker->restarts = 0;
+        worker->lockstepGroups = 0;
+        worker->vectorInstructions = 0;
+        worker->scalarInstructions = 0;
+        worker->lock = sfMutex_create();
+        worker->thread = sfThread_create(&batch_worker, worker);
+    }
+
+    sfClock* batchClock = sfClock_create();
+    for (int i = 0; i < batch_nWorkers; i++)
+        sfThread_launch(batch_workers[i].thread);
+    for (int i = 0; i < batch_nWorkers; i++)
+        sfThread_wait(batch_workers[i].thread);
+    double seconds = sfTime_asSeconds(sfClock_getElapsedTime(batchClock));
+    sfClock_destroy(batchClock);
+
+    bool written = batch_writeSummary(summaryPath, seconds);
+
+    for (int i = 0; i < batch_nWorkers; i++) {
+        sfThread_destroy(batch_workers[i].thread);
+        sfMutex_destroy(batch_workers[i].lock);
+    }
+    free(batch_jobs);
+    batch_jobs = NULL;
+    batch_nJobs = 0;
+    return written;
+}
+
+/*
+Reads the jobs file. Blank lines and lines starting with '#' are skipped
+*/
+bool batch_loadJobs(const char* jobsPath) {
+    FILE* fp = fopen(jobsPath, "r");
+    if (fp == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to open jobs file '%s'\n", jobsPath);
+        return false;
+    }
+
+    int capacity = 0;
+    int lineNumber = 0;
+    char line[BATCH_LINE_LEN];
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        lineNumber++;
+        char* content = line + strspn(line, " \t\r\n");
+        if (content[0] == '\0' || content[0] == '#')
+            continue;
+
+        if (batch_nJobs == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 64;
+            BatchJob_t* jobs = realloc(batch_jobs, capacity * sizeof(BatchJob_t));
+            if (jobs == NULL) {
+                formattedLog(stdlog, LOGTYPE_ERROR, "Unable to allocate memory for %i jobs\n", capacity);
+                fclose(fp);
+                return false;
+            }
+            batch_jobs = jobs;
+        }
+
+        BatchJob_t* job = &batch_jobs[batch_nJobs];
+        memset(job, 0, sizeof(BatchJob_t));
+        unsigned long long tStates;
+        if (sscanf(content, "%255s %255s %255s %llu %255s", job->rom, job->cfg, job->script, &tStates, job->output) != 5) {
+            formattedLog(stdlog, LOGTYPE_WARN, "Jobs file '%s' line %i is not '<rom> <cfg> <input script> <T-states> <memory dump>', skipped\n", jobsPath, lineNumber);
+            continue;
+        }
+        job->tStates = tStates;
+        batch_nJobs++;
+    }
+    fclose(fp);
+
+    if (batch_nJobs == 0) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Jobs file '%s' has no jobs\n", jobsPath);
+        return false;
+    }
+    return true;
+}
+
+/*
+Writes one line per job, in the order of the jobs file, and logs the totals
+*/
+bool batch_writeSummary(const char* summaryPath, double seconds) {
+    FILE* fp = fopen(summaryPath, "w");
+    if (fp == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to open summary file '%s'\n", summaryPath);
+        return false;
+    }
+
+    const char* statusNames[] = { "notrun", "ok", "failed", "error" };
+    int counts[4] = { 0 };
+    uint64_t tStates = 0;
+    uint64_t instructions = 0;
+    fprintf(fp, "# job status worker reused lanes tstates instructions pc sp af memhash seconds rom cfg script\n");
+    for (int i = 0; i < batch_nJobs; i++) {
+        BatchJob_t* job = &batch_jobs[i];
+        counts[job->status]++;
+        tStates += job->tStatesRun;
+        instructions += job->instructions;
+        fprintf(fp, "%i %s %i %i %i %llu %llu %04X %04X %04X %016llx %f %s %s %s\n", i, statusNames[job->status], job->worker, job->reused, job->lanes,
+            (unsigned long long)job->tStatesRun, (unsigned long long)job->instructions, job->pc, job->sp, job->af, (unsigned long long)job->memoryHash, job->seconds, job->rom, job->cfg, job->script);
+    }
+    fclose(fp);
+
+    uint64_t stolen = 0;
+    uint64_t restarts = 0;
+    uint64_t groups = 0;
+    uint64_t vector = 0;
+    uint64_t scalar = 0;
+    for (int i = 0; i < batch_nWorkers; i++) {
+        stolen += batch_workers[i].stolen;
+        restarts += batch_workers[i].restarts;
+        groups += batch_workers[i].lockstepGroups;
+        vector += batch_workers[i].vectorInstructions;
+        scalar += batch_workers[i].scalarInstructions;
+    }
+    formattedLog(stdlog, LOGTYPE_MSG, "Batch: %i jobs (%i ok, %i failed, %i errors) in %f seconds, %f jobs/s, %f emulated MHz, %f million instructions/s\n", batch_nJobs,
+        counts[BatchStatus_OK], counts[BatchStatus_Failed], counts[BatchStatus_Error], seconds, seconds > 0 ? batch_nJobs / seconds : 0.0,
+        seconds > 0 ? tStates / seconds / 1000000.0 : 0.0, seconds > 0 ? instructions / seconds / 1000000.0 : 0.0);
+    formattedLog(stdlog, LOGTYPE_MSG, "Batch: %llu jobs stolen, %llu run on restarted machines, summary in '%s'\n", (unsigned long long)stolen, (unsigned long long)restarts, summaryPath);
+    if (groups > 0) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Batch: %llu lockstep groups, %f%% of their instructions run in lane loops\n", (unsigned long long)groups,
+            vector + scalar > 0 ? 100.0 * vector / (vector + scalar) : 0.0);
+    }
+    return true;
+}
+
+int batch_hardwareThreads() {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    return threads > 0 ? (int)threads : 1;
+#endif
+}
+
+/********************************************************************
+
+    Batch Worker Functions
+
+********************************************************************/
+
+/*
+Body of a worker thread. The worker keeps one machine, restarting it between jobs built from the same ROM and cfg and
+rebuilding it otherwise. Runs of such jobs with the same budget are taken together and run in lockstep
+*/
+void batch_worker(void* data) {
+    BatchWorker_t* worker = data;
+    Z0Machine_t* machine = NULL;
+    const BatchJob_t* builtFor = NULL;
+
+    int group[Z80_LOCKSTEP_MAX_LANES];
+    int n;
+    while ((n = batch_nextJobs(worker, group, batch_lanes)) > 0) {
+        BatchJob_t* job = &batch_jobs[group[0]];
+        bool reused = false;
+
+        if (machine != NULL && batch_sameMachine(builtFor, job)) {
+            z0machine_restart(machine);
+            reused = true;
+            worker->restarts++;
+        }
+        else {
+            if (machine != NULL)
+                z0machine_destroy(machine);
+
+            Z0MachineOptions_t options = batch_options;
+            options.cfgPath = job->cfg;
+            options.biosRom = job->rom;
+            options.turbo = true;
+            machine = z0machine_create(&options);
+            builtFor = job;
+            if (machine != NULL) {
+                // Every job sets its own budget
+                machine->runTStates = 0;
+                ioController_attachTimedDevice(0, 0, &batch_readPort, NULL, &batch_catchUpPorts, &batch_nextPortChange);
+            }
+        }
+
+        for (int i = 0; i < n; i++) {
+            batch_jobs[group[i]].worker = worker->index;
+            batch_jobs[group[i]].reused = reused;
+            batch_jobs[group[i]].lanes = 1;
+            if (machine == NULL)
+                batch_jobs[group[i]].status = BatchStatus_Error;
+        }
+        if (machine == NULL)
+            continue;
+
+        if (n > 1)
+            batch_runLockstep(machine, worker, group, n);
+        else
+            batch_runJob(machine, job);
+    }
+
+    if (machine != NULL)
+        z0machine_destroy(machine);
+}
+
+/*
+Index of the next job for 'worker' to run, stealing one if its own queue is empty. -1 once every queue is empty
+*/
+int batch_nextJob(BatchWorker_t* worker) {
+    int job = -1;
+    sfMutex_lock(worker->lock);
+    if (worker->head < worker->tail)
+        job = worker->head++;
+    sfMutex_unlock(worker->lock);
+
+    if (job < 0)
+        job = batch_steal(worker);
+    return job;
+}
+
+/*
+Takes the next job for 'worker' and up to 'max' - 1 more following it in the worker's queue that can share its machine
+and budget, so they can run in lockstep. Returns the number of jobs taken into 'jobs', 0 once every queue is empty
+*/
+int batch_nextJobs(BatchWorker_t* worker, int* jobs, int max) {
+    int first = batch_nextJob(worker);
+    if (first < 0)
+        return 0;
+
+    int n = 1;
+    jobs[0] = first;
+    sfMutex_lock(worker->lock);
+    while (n < max && worker->head < worker->tail && batch_sameMachine(&batch_jobs[first], &batch_jobs[worker->head]) &&
+        batch_jobs[worker->head].tStates == batch_jobs[first].tStates)
+        jobs[n++] = worker->head++;
+    sfMutex_unlock(worker->lock);
+    return n;
+}
+
+/*
+Takes the upper half of the longest queue for 'worker', which has run out. Returns the first job taken, -1 if there
+was nothing to take
+*/
+int batch_steal(BatchWorker_t* worker) {
+    while (true) {
+        BatchWorker_t* victim = NULL;
+        int longest = 0;
+        for (int i = 0; i < batch_nWorkers; i++) {
+            BatchWorker_t* other = &batch_workers[i];
+            if (other == worker)
+                continue;
+            sfMutex_lock(other->lock);
+            int remaining = other->tail - other->head;
+            sfMutex_unlock(other->lock);
+            if (remaining > longest) {
+                longest = remaining;
+                victim = other;
+            }
+        }
+        if (victim == NULL)
+            return -1;
+
+        sfMutex_lock(victim->lock);
+        int remaining = victim->tail - victim->head;
+        int start = victim->tail - (remaining + 1) / 2;
+        int end = victim->tail;
+        if (remaining > 0)
+            victim->tail = start;
+        sfMutex_unlock(victim->lock);
+        // The victim ran its queue down since it was measured, look again
+        if (remaining <= 0)
+            continue;
+
+        sfMutex_lock(worker->lock);
+        worker->head = start + 1;
+        worker->tail = end;
+        sfMutex_unlock(worker->lock);
+        worker->stolen += end - start;
+        return start;
+    }
+}
+
+/*
+True if a machine built for job 'a' can be restarted to run job 'b'
+*/
+bool batch_sameMachine(const BatchJob_t* a, const BatchJob_t* b) {
+    return strcmp(a->rom, b->rom) == 0 && strcmp(a->cfg, b->cfg) == 0;
+}
+
+/*
+Runs one job on a machine in its power-on state and records its results
+*/
+void batch_runJob(Z0Machine_t* machine, BatchJob_t* job) {
+    batch_nPorts = 0;
+    batch_nInputs = 0;
+    batch_nextInput = 0;
+    batch_nextPortInput = 0;
+    if (strcmp(job->script, "-") != 0 && !batch_loadScript(job->script)) {
+        job->status = BatchStatus_Error;
+        return;
+    }
+
+    sfClock* jobClock = sfClock_create();
+    batch_jobStart = scheduler_now();
+    uint64_t instructionsStart = Z80_instructionsExecuted;
+    // Only the pokes need events. The port reads catch up on the script as they are made
+    batch_postNextPoke();
+
+    job->tStatesRun = z0machine_run(machine, job->tStates);
+    job->seconds = sfTime_asSeconds(sfClock_getElapsedTime(jobClock));
+    sfClock_destroy(jobClock);
+    scheduler_cancel(&batch_inputEvent);
+
+    job->status = z0machine_failed(machine) ? BatchStatus_Failed : BatchStatus_OK;
+    job->instructions = Z80_instructionsExecuted - instructionsStart;
+    Z80FLAGS_SYNC();
+    job->pc = PC;
+    job->sp = SP;
+    job->af = AF;
+    batch_recordMemory(machine, job, -1);
+}
+
+/*
+Runs jobs sharing a machine and budget side by side in the lanes of the lockstep engine, each lane starting from the
+machine's power-on state. Jobs that can't, because their scripts do more than poke memory before they start or the
+machine has device events, run alone afterwards. The machine is left in its power-on state
+*/
+void batch_runLockstep(Z0Machine_t* machine, BatchWorker_t* worker, const int* jobs, int nJobs) {
+    int lanes[Z80_LOCKSTEP_MAX_LANES];
+    int nLanes = 0;
+    int alone[Z80_LOCKSTEP_MAX_LANES];
+    int nAlone = 0;
+    for (int i = 0; i < nJobs; i++) {
+        if (Z80_engine == Z80Engine_Step && scheduler_nEvents == 0 && batch_canLockstep(&batch_jobs[jobs[i]]))
+            lanes[nLanes++] = jobs[i];
+        else
+            alone[nAlone++] = jobs[i];
+    }
+
+    if (nLanes > 1 && Z80Lockstep_init(nLanes)) {
+        // Each lane gets its own job's pokes
+        for (int l = 0; l < nLanes; l++) {
+            batch_canLockstep(&batch_jobs[lanes[l]]);
+            for (int i = 0; i < batch_nInputs; i++)
+                Z80Lockstep_writeByte(l, batch_inputs[i].address, batch_inputs[i].value);
+        }
+        batch_nInputs = 0;
+        batch_nPorts = 0;
+        batch_nextPortInput = 0;
+
+        sfClock* groupClock = sfClock_create();
+        Z80Lockstep_run(batch_jobs[lanes[0]].tStates);
+        double seconds = sfTime_asSeconds(sfClock_getElapsedTime(groupClock));
+        sfClock_destroy(groupClock);
+
+        Z80Lanes_t* state = &Z80Lockstep_lanes;
+        for (int l = 0; l < nLanes; l++) {
+            BatchJob_t* job = &batch_jobs[lanes[l]];
+            job->lanes = nLanes;
+            job->status = state->failed[l] ? BatchStatus_Failed : BatchStatus_OK;
+            job->tStatesRun = state->tStates[l] - Z80Lockstep_home.tStates;
+            job->instructions = state->instructions[l] - Z80Lockstep_home.instructions;
+            job->pc = state->pc[l];
+            job->sp = state->sp[l];
+            job->af = state->af[l];
+            job->seconds = seconds;
+            batch_recordMemory(machine, job, l);
+        }
+        worker->lockstepGroups++;
+        worker->vectorInstructions += Z80Lockstep_vectorInstructions;
+        worker->scalarInstructions += Z80Lockstep_scalarInstructions;
+        Z80Lockstep_destroy();
+    }
+    else {
+        for (int l = 0; l < nLanes; l++)
+            alone[nAlone++] = lanes[l];
+    }
+
+    // The lanes never touched the machine, so the first job run alone needs no restart
+    for (int i = 0; i < nAlone; i++) {
+        if (i > 0)
+            z0machine_restart(machine);
+        batch_runJob(machine, &batch_jobs[alone[i]]);
+    }
+}
+
+/*
+Loads a job's input script and returns true if it only pokes memory before the job starts, which a lockstep lane
+can take
+*/
+bool batch_canLockstep(const BatchJob_t* job) {
+    batch_nInputs = 0;
+    if (strcmp(job->script, "-") == 0)
+        return true;
+    if (!batch_loadScript(job->script))
+        return false;
+    for (int i = 0; i < batch_nInputs; i++) {
+        if (batch_inputs[i].port || batch_inputs[i].tState != 0)
+            return false;
+    }
+    return true;
+}
+
+/*
+Hashes the job's final memory, FNV-1a over everything the CPU can read, and writes its dump. 'lane' is the lockstep lane
+that ran it, -1 if it ran on the machine
+*/
+void batch_recordMemory(Z0Machine_t* machine, BatchJob_t* job, int lane) {
+    uint8_t* dump = strcmp(job->output, "-") != 0 ? malloc(0x10000) : NULL;
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (uint32_t address = 0; address < 0x10000; address++) {
+        uint8_t value = lane < 0 ? z0machine_readByte(machine, (uint16_t)address) : Z80Lockstep_readByte(lane, (uint16_t)address);
+        hash = (hash ^ value) * 0x100000001B3ull;
+        if (dump != NULL)
+            dump[address] = value;
+    }
+    job->memoryHash = hash;
+
+    if (dump != NULL) {
+        FILE* fp = fopen(job->output, "wb");
+        if (fp == NULL || fwrite(dump, 1, 0x10000, fp) != 0x10000) {
+            formattedLog(stdlog, LOGTYPE_ERROR, "Unable to write memory dump '%s'\n", job->output);
+            job->status = BatchStatus_Error;
+        }
+        if (fp != NULL)
+            fclose(fp);
+        free(dump);
+    }
+}
+
+/********************************************************************
+
+    Batch Input Functions
+
+********************************************************************/
+
+/*
+Reads an input script for the job about to run on this thread
+*/
+bool batch_loadScript(const char* path) {
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to open input script '%s'\n", path);
+        return false;
+    }
+
+    bool valid = true;
+    int lineNumber = 0;
+    char line[BATCH_LINE_LEN];
+    while (valid && fgets(line, sizeof(line), fp) != NULL) {
+        lineNumber++;
+        char* content = line + strspn(line, " \t\r\n");
+        if (content[0] == '\0' || content[0] == '#')
+            continue;
+
+        char kind[8];
+        unsigned long long tState;
+        int address;
+        int value;
+        if (sscanf(content, "%llu %7s %i %i", &tState, kind, &address, &value) != 4 || (strcmp(kind, "poke") != 0 && strcmp(kind, "in") != 0)) {
+            formattedLog(stdlog, LOGTYPE_ERROR, "Input script '%s' line %i is not '<T-state> poke|in <address> <value>'\n", path, lineNumber);
+            valid = false;
+        }
+        else if (batch_nInputs == MAX_NUMBER_OF_BATCH_INPUTS) {
+            formattedLog(stdlog, LOGTYPE_ERROR, "Input script '%s' has more than %i inputs\n", path, MAX_NUMBER_OF_BATCH_INPUTS);
+            valid = false;
+        }
+        else if (batch_nInputs > 0 && tState < batch_inputs[batch_nInputs - 1].tState) {
+            formattedLog(stdlog, LOGTYPE_ERROR, "Input script '%s' line %i goes back in time\n", path, lineNumber);
+            valid = false;
+        }
+        else {
+            BatchInput_t* input = &batch_inputs[batch_nInputs++];
+            input->tState = tState;
+            input->port = strcmp(kind, "in") == 0;
+            input->address = (uint16_t)address;
+            input->value = (uint8_t)value;
+        }
+    }
+    fclose(fp);
+    return valid;
+}
+
+/*
+Pokes the memory for the script's pokes due by 'tState' and posts the event for the next
+*/
+void batch_inputEvent(uint64_t tState) {
+    while (batch_nextInput < batch_nInputs && batch_jobStart + batch_inputs[batch_nextInput].tState <= tState) {
+        BatchInput_t* input = &batch_inputs[batch_nextInput++];
+        if (!input->port)
+            z0machine_writeByte(z0machine_current, input->address, input->value);
+    }
+    batch_postNextPoke();
+}
+
+/*
+Posts the event for the next poke of the script, skipping the port inputs before it
+*/
+void batch_postNextPoke() {
+    while (batch_nextInput < batch_nInputs && batch_inputs[batch_nextInput].port)
+        batch_nextInput++;
+    if (batch_nextInput < batch_nInputs)
+        scheduler_post(batch_jobStart + batch_inputs[batch_nextInput].tState, &batch_inputEvent);
+}
+
+/*
+Catch up function of the port device. Sets the ports from the script's port inputs due by 'tState', the T-state of the
+access about to be made
+*/
+void batch_catchUpPorts(uint64_t tState) {
+    while (batch_nextPortInput < batch_nInputs && batch_jobStart + batch_inputs[batch_nextPortInput].tState <= tState) {
+        BatchInput_t* input = &batch_inputs[batch_nextPortInput++];
+        if (!input->port)
+            continue;
+
+        int i = 0;
+        while (i < batch_nPorts && batch_ports[i].port != input->address)
+            i++;
+        if (i == MAX_NUMBER_OF_BATCH_PORTS) {
+            formattedLog(stdlog, LOGTYPE_WARN, "Input script drives more than %i ports, port %04X ignored\n", MAX_NUMBER_OF_BATCH_PORTS, input->address);
+            continue;
+        }
+        if (i == batch_nPorts)
+            batch_nPorts++;
+        batch_ports[i].port = input->address;
+        batch_ports[i].value = input->value;
+    }
+}
+
+/*
+T-state of the script's next port input, UINT64_MAX once there are none
+*/
+uint64_t batch_nextPortChange() {
+    while (batch_nextPortInput < batch_nInputs && !batch_inputs[batch_nextPortInput].port)
+        batch_nextPortInput++;
+    return batch_nextPortInput < batch_nInputs ? batch_jobStart + batch_inputs[batch_nextPortInput].tState : UINT64_MAX;
+}
+
+/*
+IO device giving the value the input script last set for 'port'. Ports it never set float high
+*/
+uint8_t batch_readPort(uint16_t port) {
+    for (int i = 0; i < batch_nPorts; i++) {
+        if (batch_ports[i].port == port)
+            return batch_ports[i].value;
+    }
+    return 0xFF;
+}
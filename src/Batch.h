@@ -0,0 +1,149 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Batch.h : Batch runner. Runs a list of independent jobs over a pool of worker threads, each with a machine of its own,
+and writes one summary of the results
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Z0Machine.h"
+#include "Z80/Z80Lockstep.h"
+#include "SFML/System.h"
+
+#define MAX_NUMBER_OF_BATCH_WORKERS 64
+#define MAX_NUMBER_OF_BATCH_INPUTS 1024 // Lines of one input script
+#define MAX_NUMBER_OF_BATCH_PORTS 16 // Ports an input script can drive at once
+#define BATCH_PATH_LEN 256
+#define BATCH_LINE_LEN 1024
+#define BATCH_DEFAULT_SUMMARY "batch_summary.txt"
+
+enum BatchStatusEnum { BatchStatus_NotRun, BatchStatus_OK, BatchStatus_Failed, BatchStatus_Error };
+
+/*
+One line of the jobs file, '<rom> <cfg> <input script> <T-states> <memory dump>'. The script and dump may be '-' for none.
+The results are only written by the worker that runs the job
+*/
+typedef struct BatchJob {
+    char rom[BATCH_PATH_LEN];
+    char cfg[BATCH_PATH_LEN];
+    char script[BATCH_PATH_LEN];
+    uint64_t tStates; // Budget. The job stops on the first instruction boundary after it
+    char output[BATCH_PATH_LEN];
+
+    int status; // Takes a value of BatchStatusEnum
+    int worker;
+    bool reused; // Ran on a machine restarted from the previous job rather than built for it
+    int lanes; // Jobs it ran alongside in lockstep, itself included. 1 if it ran alone
+    uint64_t tStatesRun;
+    uint64_t instructions;
+    uint16_t pc;
+    uint16_t sp;
+    uint16_t af;
+    uint64_t memoryHash; // FNV-1a of the whole address space at the end of the job
+    double seconds;
+} BatchJob_t;
+
+/*
+One line of an input script, '<T-state> poke <address> <value>' or '<T-state> in <port> <value>'. T-states count from the
+start of the job and must not decrease. 'in' sets what reads of that exact port return from then on
+*/
+typedef struct BatchInput {
+    uint64_t tState;
+    bool port;
+    uint16_t address;
+    uint8_t value;
+} BatchInput_t;
+
+typedef struct BatchPort {
+    uint16_t port;
+    uint8_t value;
+} BatchPort_t;
+
+/*
+The jobs a worker has still to run are jobs [head, tail). The worker takes jobs from its head, and a worker that runs
+out steals the upper half of the longest queue, so every queue stays one contiguous range
+*/
+typedef struct BatchWorker {
+    int index;
+    sfThread* thread;
+    sfMutex* lock; // Guards head and tail, the only worker state other workers touch
+    int head;
+    int tail;
+    uint64_t stolen; // Jobs taken from other workers
+    uint64_t restarts; // Jobs run on a restarted machine
+    uint64_t lockstepGroups;
+    uint64_t vectorInstructions; // Lockstep instructions run in lane loops
+    uint64_t scalarInstructions; // Lockstep instructions run one instance at a time
+} BatchWorker_t;
+
+/* The batch. Set up before the workers start and read only while they run, apart from the queues and each job's results */
+extern BatchJob_t* batch_jobs;
+extern int batch_nJobs;
+extern BatchWorker_t batch_workers[MAX_NUMBER_OF_BATCH_WORKERS];
+extern int batch_nWorkers;
+extern int batch_lanes;
+extern Z0MachineOptions_t batch_options;
+
+/* Input script of the job running on this thread */
+extern Z0_MACHINE_LOCAL BatchInput_t batch_inputs[MAX_NUMBER_OF_BATCH_INPUTS];
+extern Z0_MACHINE_LOCAL int batch_nInputs;
+extern Z0_MACHINE_LOCAL int batch_nextInput; // Next poke, which is applied by an event when it is due
+extern Z0_MACHINE_LOCAL int batch_nextPortInput; // Next port input, which the port device catches up on when the CPU reads it
+extern Z0_MACHINE_LOCAL uint64_t batch_jobStart;
+extern Z0_MACHINE_LOCAL BatchPort_t batch_ports[MAX_NUMBER_OF_BATCH_PORTS];
+extern Z0_MACHINE_LOCAL int batch_nPorts;
+
+/********************************************************************
+
+    Batch Functions
+
+********************************************************************/
+
+bool batch_run(const char* jobsPath, const char* summaryPath, int workers, int lanes, const Z0MachineOptions_t* options);
+bool batch_loadJobs(const char* jobsPath);
+bool batch_writeSummary(const char* summaryPath, double seconds);
+int batch_hardwareThreads();
+
+/********************************************************************
+
+    Batch Worker Functions
+
+********************************************************************/
+
+void batch_worker(void* data);
+int batch_nextJob(BatchWorker_t* worker);
+int batch_nextJobs(BatchWorker_t* worker, int* jobs, int max);
+int batch_steal(BatchWorker_t* worker);
+bool batch_sameMachine(const BatchJob_t* a, const BatchJob_t* b);
+void batch_runJob(Z0Machine_t* machine, BatchJob_t* job);
+void batch_runLockstep(Z0Machine_t* machine, BatchWorker_t* worker, const int* jobs, int nJobs);
+bool batch_canLockstep(const BatchJob_t* job);
+void batch_recordMemory(Z0Machine_t* machine, BatchJob_t* job, int lane);
+
+/********************************************************************
+
+    Batch Input Functions
+
+********************************************************************/
+
+bool batch_loadScript(const char* path);
+void batch_inputEvent(uint64_t tState);
+void batch_postNextPoke();
+void batch_catchUpPorts(uint64_t tState);
+uint64_t batch_nextPortChange();
+uint8_t batch_readPort(uint16_t port);
@@ -23,11 +23,11 @@ CfgReader.c : Reads the CFG file and exposes the settings
 #include <stdlib.h>
 #include <stdio.h>
 
-SysFile_t* cfgFile;
+Z0_MACHINE_LOCAL SysFile_t* cfgFile;
 
 #define MAX_NUM_SETTINGS 256
-Setting_t* settings[MAX_NUM_SETTINGS];
-int currentSetting = 0;
+Z0_MACHINE_LOCAL Setting_t* settings[MAX_NUM_SETTINGS];
+Z0_MACHINE_LOCAL int currentSetting = 0;
 
 /********************************************************************
 
@@ -98,8 +98,10 @@ void cfgReader_cleanSettings() {
     for (int i = 0; i < MAX_NUM_SETTINGS; i++) {
         if (settings[i] != NULL) {
             cfgReader_destroySetting(settings[i]);
+            settings[i] = NULL;
         }
     }
+    currentSetting = 0;
 }
 
 /********************************************************************
@@ -191,17 +193,26 @@ bool cfgReader_querySettingExist(const char* n) {
 
 ********************************************************************/
 
-void cfgReader_readConfiguration(const char* path) {
+/*
+Reads the settings from a CFG file. Returns false if it can't be read
+*/
+bool cfgReader_readConfiguration(const char* path) {
     // Open the CFG file
     cfgFile = sysIO_openFile(path);
+    if (cfgFile == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to open configuration file '%s'\n", path);
+        return false;
+    }
 
     // Cache the content
     sysIO_cacheFile(cfgFile);
 
     // Check it is cached
     if (!cfgFile->cached) {
-        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to read configuration file! Terminating\n");
-        exit(-1);
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to read configuration file '%s'\n", path);
+        sysIO_closeFile(cfgFile);
+        cfgFile = NULL;
+        return false;
     }
 
     // Process the CFG file
@@ -210,6 +221,7 @@ void cfgReader_readConfiguration(const char* path) {
     // Close the CFG file
     sysIO_closeFile(cfgFile);
     cfgFile = NULL;
+    return true;
 }
 
 void cfgReader_processConfiguration(const char* data, const long int size) {
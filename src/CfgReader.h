@@ -19,6 +19,8 @@ CfgReader.h : Reads the CFG file and exposes the settings
 
 #include <stdbool.h>
 
+#include "Z0Machine.h"
+
 typedef struct Setting {
     char* name;
     struct SettingValue {
@@ -44,7 +46,7 @@ void cfgReader_cleanSettings();
 
 ********************************************************************/
 
-void cfgReader_readConfiguration(const char* path);
+bool cfgReader_readConfiguration(const char* path);
 void cfgReader_processConfiguration(const char* data, const long int size);
 void cfgReader_processLine(const char* ln);
 
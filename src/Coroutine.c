@@ -0,0 +1,178 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Coroutine.c : Devices written as stackless coroutines for the edge engine, resumed only on the clock edges they wait for
+
+*/
+
+#include "Coroutine.h"
+#include "SysIO/Log.h"
+
+/* Running coroutines */
+Z0_MACHINE_LOCAL Coroutine_t* coroutine_all[MAX_NUMBER_OF_COROUTINES];
+Z0_MACHINE_LOCAL uint8_t coroutine_nAll = 0;
+Z0_MACHINE_LOCAL uint64_t coroutine_edges = 0;
+Z0_MACHINE_LOCAL uint64_t coroutine_nextEdge = UINT64_MAX;
+
+/* Statistics */
+Z0_MACHINE_LOCAL uint64_t coroutine_resumes = 0;
+Z0_MACHINE_LOCAL uint64_t coroutine_dueEdges = 0;
+
+/********************************************************************
+
+    Coroutine Functions
+
+********************************************************************/
+
+/*
+Forgets every coroutine. The devices own them, so nothing is freed. signals_destroy() clears the waits on the signals
+*/
+void coroutine_destroy() {
+    for (int i = 0; i < coroutine_nAll; i++) {
+        coroutine_all[i]->wait = CoroutineWait_None;
+        coroutine_all[i]->resume = 0;
+        coroutine_all[i] = NULL;
+    }
+    coroutine_nAll = 0;
+    coroutine_edges = 0;
+    coroutine_nextEdge = UINT64_MAX;
+    coroutine_resumes = 0;
+    coroutine_dueEdges = 0;
+}
+
+/*
+Adds a coroutine and runs its body up to its first wait
+*/
+bool coroutine_start(Coroutine_t* co, void (*body)(Coroutine_t*)) {
+    if (coroutine_nAll >= MAX_NUMBER_OF_COROUTINES) {
+        formattedLog(debuglog, LOGTYPE_ERROR, "Unable to start coroutine: no free space\n");
+        return false;
+    }
+
+    co->body = body;
+    co->resume = 0;
+    co->wait = CoroutineWait_None;
+    co->signal = NULL;
+    co->ready = false;
+    coroutine_all[coroutine_nAll++] = co;
+
+    co->body(co);
+    return true;
+}
+
+/*
+Takes a running coroutine back to the top of its body and runs it up to its first wait. Does nothing to one that was
+never started, or has been forgotten by coroutine_destroy()
+*/
+void coroutine_restart(Coroutine_t* co) {
+    bool running = false;
+    for (int i = 0; i < coroutine_nAll; i++)
+        running = running || coroutine_all[i] == co;
+    if (!running)
+        return;
+
+    // A signal it was parked on no longer has it waiting
+    if (co->wait == CoroutineWait_Signal && !co->ready)
+        co->signal->nWaiters--;
+
+    co->resume = 0;
+    co->wait = CoroutineWait_None;
+    co->signal = NULL;
+    co->ready = false;
+    co->body(co);
+}
+
+/*
+Parks 'co' until 'edges' edges from now. Only called through COROUTINE_WAIT_EDGES
+*/
+void coroutine_waitEdges(Coroutine_t* co, uint64_t edges) {
+    co->wait = CoroutineWait_Edge;
+    co->wakeEdge = coroutine_edges + (edges > 0 ? edges : 1);
+    co->signal = NULL;
+    co->ready = false;
+    if (co->wakeEdge < coroutine_nextEdge)
+        coroutine_nextEdge = co->wakeEdge;
+}
+
+/*
+Parks 'co' until the first edge at which 'signal' is at 'level'. Only called through COROUTINE_WAIT_SIGNAL
+*/
+void coroutine_waitSignal(Coroutine_t* co, Signal_t* signal, bool level) {
+    co->wait = CoroutineWait_Signal;
+    co->signal = signal;
+    co->level = level;
+    co->ready = signal->state == level;
+    if (!co->ready) {
+        // Nothing is due until the signal changes
+        signal->nWaiters++;
+        return;
+    }
+
+    co->wakeEdge = coroutine_edges + 1;
+    if (co->wakeEdge < coroutine_nextEdge)
+        coroutine_nextEdge = co->wakeEdge;
+}
+
+/*
+Called by the signals when one with coroutines parked on it changes. Those it has now reached the level of are due on
+the next edge
+*/
+void coroutine_onSignal(Signal_t* signal) {
+    for (int i = 0; i < coroutine_nAll; i++) {
+        Coroutine_t* co = coroutine_all[i];
+        if (co->wait != CoroutineWait_Signal || co->signal != signal || co->ready || signal->state != co->level)
+            continue;
+
+        co->ready = true;
+        co->wakeEdge = coroutine_edges + 1;
+        signal->nWaiters--;
+        if (co->wakeEdge < coroutine_nextEdge)
+            coroutine_nextEdge = co->wakeEdge;
+    }
+}
+
+/*
+Resumes the coroutines due on this edge, in the order they were started. A signal that has moved off its level again
+since it woke its coroutine parks it once more
+*/
+void coroutine_runDue() {
+    coroutine_dueEdges++;
+    for (int i = 0; i < coroutine_nAll; i++) {
+        Coroutine_t* co = coroutine_all[i];
+        if (co->wakeEdge > coroutine_edges || co->wait == CoroutineWait_None || (co->wait == CoroutineWait_Signal && !co->ready))
+            continue;
+
+        if (co->wait == CoroutineWait_Signal && co->signal->state != co->level) {
+            co->ready = false;
+            co->signal->nWaiters++;
+            continue;
+        }
+
+        coroutine_resumes++;
+        co->body(co);
+    }
+    coroutine_planNextEdge();
+}
+
+/*
+Finds the earliest edge anything is due on
+*/
+void coroutine_planNextEdge() {
+    coroutine_nextEdge = UINT64_MAX;
+    for (int i = 0; i < coroutine_nAll; i++) {
+        Coroutine_t* co = coroutine_all[i];
+        bool due = co->wait == CoroutineWait_Edge || (co->wait == CoroutineWait_Signal && co->ready);
+        if (due && co->wakeEdge < coroutine_nextEdge)
+            coroutine_nextEdge = co->wakeEdge;
+    }
+}
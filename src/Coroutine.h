@@ -0,0 +1,89 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Coroutine.h : Devices written as stackless coroutines for the edge engine. A device body runs straight through its bus
+protocol and waits for a number of clock edges or for a signal to reach a level, and is only resumed once that comes round,
+rather than being called on every edge to work out where it was. The CPU runs its machine cycles the same way
+
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Signals.h"
+#include "Z0Machine.h"
+
+#define MAX_NUMBER_OF_COROUTINES 16
+
+/* What a coroutine is waiting for */
+typedef enum CoroutineWait {
+    CoroutineWait_None, // Not started, or finished
+    CoroutineWait_Edge, // The clock edge numbered 'wakeEdge'
+    CoroutineWait_Signal // The first clock edge at which 'signal' is at 'level'
+} CoroutineWait_t;
+
+typedef struct Coroutine {
+    void (*body)(struct Coroutine* co); // Runs from the wait it last stopped at. Locals don't survive a wait, state lives in the device
+    uint32_t resume; // Line of the wait to carry on from, 0 to start from the top
+    CoroutineWait_t wait;
+    uint64_t wakeEdge; // Edge to resume on. Set for a signal wait too, once the signal has reached its level
+    Signal_t* signal;
+    bool level;
+    bool ready; // Waiting on a signal that has reached its level, so due on 'wakeEdge' if it is still there then
+} Coroutine_t;
+
+/*
+Protothread style continuations, which keep the position in the body as the line of the wait it stopped at. A body
+starts with COROUTINE_BEGIN and ends with COROUTINE_END, and can't wait from inside a switch of its own
+*/
+#define COROUTINE_BEGIN(co) switch ((co)->resume) { case 0:
+#define COROUTINE_END(co) } (co)->resume = 0; (co)->wait = CoroutineWait_None; return
+
+/* Stops until 'edges' clock edges from now, at least one */
+#define COROUTINE_WAIT_EDGES(co, edges) do { coroutine_waitEdges((co), (edges)); (co)->resume = __LINE__; return; case __LINE__:; } while (0)
+
+/* Stops until the first clock edge at which 'sig' is at 'lvl', which is the next one if it already is */
+#define COROUTINE_WAIT_SIGNAL(co, sig, lvl) do { coroutine_waitSignal((co), (sig), (lvl)); (co)->resume = __LINE__; return; case __LINE__:; } while (0)
+
+/* Running coroutines */
+extern Z0_MACHINE_LOCAL Coroutine_t* coroutine_all[MAX_NUMBER_OF_COROUTINES];
+extern Z0_MACHINE_LOCAL uint8_t coroutine_nAll;
+extern Z0_MACHINE_LOCAL uint64_t coroutine_edges; // Clock edges made, rising and falling
+extern Z0_MACHINE_LOCAL uint64_t coroutine_nextEdge; // Earliest edge any coroutine is due on, UINT64_MAX when none are
+
+/* Statistics */
+extern Z0_MACHINE_LOCAL uint64_t coroutine_resumes; // Times a body was resumed
+extern Z0_MACHINE_LOCAL uint64_t coroutine_dueEdges; // Edges on which anything was due
+
+/*
+Makes one clock edge. Due coroutines run before the CLCK listeners, in the order they were started, so a device started
+ahead of the CPU sees the bus as the last edge left it
+*/
+#define COROUTINE_CLOCK_EDGE() do { coroutine_edges++; if (coroutine_nextEdge <= coroutine_edges) coroutine_runDue(); } while (0)
+
+/********************************************************************
+
+    Coroutine Functions
+
+********************************************************************/
+
+void coroutine_destroy();
+bool coroutine_start(Coroutine_t* co, void (*body)(Coroutine_t*));
+void coroutine_restart(Coroutine_t* co);
+void coroutine_waitEdges(Coroutine_t* co, uint64_t edges);
+void coroutine_waitSignal(Coroutine_t* co, Signal_t* signal, bool level);
+void coroutine_onSignal(Signal_t* signal);
+void coroutine_runDue();
+void coroutine_planNextEdge();
@@ -0,0 +1,124 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+IOController.c : Routes Z80 port reads and writes to attached I/O devices
+
+*/
+
+#include "IOController.h"
+#include "../Scheduler.h"
+#include "../SysIO/Log.h"
+
+/* I/O devices */
+Z0_MACHINE_LOCAL IODevice_t ioDevices[MAX_NUMBER_OF_IO_DEVICES];
+Z0_MACHINE_LOCAL int numIODevices = 0;
+Z0_MACHINE_LOCAL int ioController_nTimedDevices = 0;
+
+/********************************************************************
+
+    IOController device functions
+
+********************************************************************/
+
+/*
+Attach a device that answers the ports selected by portMask/portMatch
+*/
+bool ioController_attachDevice(uint16_t portMask, uint16_t portMatch, uint8_t (*read)(uint16_t port), void (*write)(uint16_t port, uint8_t value)) {
+    return ioController_attachTimedDevice(portMask, portMatch, read, write, NULL, NULL);
+}
+
+/*
+Attach a device that keeps its own time. It isn't run as the CPU goes, but caught up to the T-state of each access before
+it is made, so it reads just as if it had been. 'nextChange' tells the engines' shortcuts how far they can run without
+looking at its ports
+*/
+bool ioController_attachTimedDevice(uint16_t portMask, uint16_t portMatch, uint8_t (*read)(uint16_t port), void (*write)(uint16_t port, uint8_t value),
+    void (*catchUp)(uint64_t tState), uint64_t (*nextChange)()) {
+    if (numIODevices >= MAX_NUMBER_OF_IO_DEVICES) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to attach I/O device: no free space\n");
+        return false;
+    }
+
+    ioDevices[numIODevices].portMask = portMask;
+    ioDevices[numIODevices].portMatch = portMatch;
+    ioDevices[numIODevices].read = read;
+    ioDevices[numIODevices].write = write;
+    ioDevices[numIODevices].catchUp = catchUp;
+    ioDevices[numIODevices].nextChange = nextChange;
+    numIODevices++;
+    if (catchUp != NULL)
+        ioController_nTimedDevices++;
+    return true;
+}
+
+/*
+Detaches every device
+*/
+void ioController_destroy() {
+    numIODevices = 0;
+    ioController_nTimedDevices = 0;
+}
+
+/********************************************************************
+
+    IOController access functions
+
+********************************************************************/
+
+/*
+Reads a port. Every selected device drives the bus, so their values are ANDed together. Nothing selected reads as 0xFF.
+The stepped engines time the access at the start of the instruction making it
+*/
+uint8_t ioController_directRead(uint16_t port) {
+    uint8_t value = 0xFF;
+    for (int i = 0; i < numIODevices; i++) {
+        if ((port & ioDevices[i].portMask) == ioDevices[i].portMatch && ioDevices[i].read != NULL) {
+            if (ioDevices[i].catchUp != NULL)
+                ioDevices[i].catchUp(scheduler_now());
+            value &= ioDevices[i].read(port);
+        }
+    }
+    return value;
+}
+
+/*
+Writes a port. Every selected device sees the write
+*/
+void ioController_directWrite(uint16_t port, uint8_t value) {
+    for (int i = 0; i < numIODevices; i++) {
+        if ((port & ioDevices[i].portMask) == ioDevices[i].portMatch && ioDevices[i].write != NULL) {
+            if (ioDevices[i].catchUp != NULL)
+                ioDevices[i].catchUp(scheduler_now());
+            ioDevices[i].write(port, value);
+        }
+    }
+}
+
+/*
+Earliest T-state at which a device that lags behind the CPU may read differently. Until then its ports hold still, so
+a loop polling them repeats exactly
+*/
+uint64_t ioController_nextChange() {
+    uint64_t next = UINT64_MAX;
+    if (ioController_nTimedDevices == 0)
+        return next;
+
+    for (int i = 0; i < numIODevices; i++) {
+        if (ioDevices[i].nextChange != NULL) {
+            uint64_t change = ioDevices[i].nextChange();
+            if (change < next)
+                next = change;
+        }
+    }
+    return next;
+}
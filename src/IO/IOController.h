@@ -0,0 +1,60 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+IOController.h : Routes Z80 port reads and writes to attached I/O devices
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../Z0Machine.h"
+
+#define MAX_NUMBER_OF_IO_DEVICES 16
+
+typedef struct IODevice {
+    uint16_t portMask; // Bits of the port address the device decodes
+    uint16_t portMatch; // The device is selected when (port & portMask) == portMatch
+
+    uint8_t (*read)(uint16_t port); // May be NULL if the device is write only
+    void (*write)(uint16_t port, uint8_t value); // May be NULL if the device is read only
+
+    // A device that lags behind the CPU rather than running alongside it. Both are NULL for a device with no time of its own
+    void (*catchUp)(uint64_t tState); // Brings the device up to 'tState', the T-state of the access about to be made
+    uint64_t (*nextChange)(); // Earliest T-state at which what the device reads may change, UINT64_MAX for never
+} IODevice_t;
+
+extern Z0_MACHINE_LOCAL int ioController_nTimedDevices; // Devices attached with a catch up function
+
+/********************************************************************
+
+    IOController device functions
+
+********************************************************************/
+
+bool ioController_attachDevice(uint16_t portMask, uint16_t portMatch, uint8_t (*read)(uint16_t port), void (*write)(uint16_t port, uint8_t value));
+bool ioController_attachTimedDevice(uint16_t portMask, uint16_t portMatch, uint8_t (*read)(uint16_t port), void (*write)(uint16_t port, uint8_t value),
+    void (*catchUp)(uint64_t tState), uint64_t (*nextChange)());
+void ioController_destroy();
+
+/********************************************************************
+
+    IOController access functions
+
+********************************************************************/
+
+uint8_t ioController_directRead(uint16_t port);
+void ioController_directWrite(uint16_t port, uint8_t value);
+uint64_t ioController_nextChange();
@@ -15,13 +15,34 @@ MemoryController.c : Memory controller system
 
 */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "../Signals.h"
+#include "../Coroutine.h"
 #include "../SysIO/Log.h"
 
 #include "MemoryController.h"
 
 /* Memories */
-MemoryDevice_t* memories[MAX_NUMBER_OF_MEMORIES];
+Z0_MACHINE_LOCAL MemoryDevice_t* memories[MAX_NUMBER_OF_MEMORIES];
+
+/* Direct access page tables. An entry points at the first byte of a page inside a device data buffer when exactly one device serves the whole page */
+Z0_MACHINE_LOCAL uint8_t* memoryController_readPages[MEMORY_NUM_PAGES];
+Z0_MACHINE_LOCAL uint8_t* memoryController_writePages[MEMORY_NUM_PAGES];
+
+/* Bus side of the edge engine */
+Z0_MACHINE_LOCAL Coroutine_t memoryController_coroutine;
+
+/* Write listeners */
+Z0_MACHINE_LOCAL void (*memoryController_writeListeners[MAX_NUMBER_OF_WRITE_LISTENERS])(uint16_t address);
+Z0_MACHINE_LOCAL uint8_t memoryController_nWriteListeners = 0;
+
+/* Snapshots */
+Z0_MACHINE_LOCAL MemorySnapshot_t* memoryController_snapshots[MAX_NUMBER_OF_MEMORY_SNAPSHOTS];
+Z0_MACHINE_LOCAL uint8_t memoryController_nSnapshots = 0;
+Z0_MACHINE_LOCAL bool memoryController_cowPages[MEMORY_NUM_PAGES];
+Z0_MACHINE_LOCAL uint64_t memoryController_pagesCopied = 0;
 
 /********************************************************************
 
@@ -33,8 +54,19 @@ MemoryDevice_t* memories[MAX_NUMBER_OF_MEMORIES];
 Initialise the memory controller and the memories
 */
 void memoryController_init() {
-    // Connect the clock signal
-    signals_addListener(&signal_CLCK, &memoryController_onCLCK);
+    // Answer the bus on the edges MREQ is active for, rather than listening to every edge
+    coroutine_start(&memoryController_coroutine, &memoryController_run);
+}
+
+/*
+Attach a function to be told about every write that lands in a device
+*/
+void memoryController_addWriteListener(void (*fun)(uint16_t)) {
+    if (memoryController_nWriteListeners >= MAX_NUMBER_OF_WRITE_LISTENERS) {
+        formattedLog(debuglog, LOGTYPE_ERROR, "Unable to add memory write listener: no free space\n");
+        return;
+    }
+    memoryController_writeListeners[memoryController_nWriteListeners++] = fun;
 }
 
 /********************************************************************
@@ -71,29 +103,358 @@ void memoryController_createDevice(uint16_t startAdd, uint16_t size, bool writea
 
     // Create the device
     memories[i] = memoryDevice_create(startAdd, size, writeable, readable);
+
+    // The device layout changed, so the direct access pages need recalculating
+    memoryController_rebuildPageTables();
+}
+
+/*
+Frees every device and detaches the write listeners, leaving an empty address space. Snapshots still taken are forgotten
+rather than freed, as their owners hold them, so they have to be destroyed before the machine
+*/
+void memoryController_destroy() {
+    if (memoryController_nSnapshots > 0) {
+        formattedLog(debuglog, LOGTYPE_WARN, "Memory destroyed with %i snapshots still taken\n", memoryController_nSnapshots);
+    }
+    memoryController_nSnapshots = 0;
+    memset(memoryController_cowPages, 0, sizeof(memoryController_cowPages));
+    memoryController_pagesCopied = 0;
+
+    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
+        if (memories[i] != NULL) {
+            memoryDevice_deconstruct(memories[i]);
+            memories[i] = NULL;
+        }
+    }
+    memoryController_rebuildPageTables();
+    memoryController_nWriteListeners = 0;
+}
+
+/*
+Recalculates the direct access page tables from the devices
+*/
+void memoryController_rebuildPageTables() {
+    for (int page = 0; page < MEMORY_NUM_PAGES; page++)
+        memoryController_rebuildPage(page);
+}
+
+/*
+Recalculates one page's entries. Pages touched by more than one device, or only partly covered, are left NULL so accesses
+fall back to scanning the devices. So is the write entry of a page a snapshot still shares
+*/
+void memoryController_rebuildPage(int page) {
+    int pageStart = page << MEMORY_PAGE_SHIFT;
+    int pageEnd = pageStart + MEMORY_PAGE_SIZE;
+    MemoryDevice_t* owner = NULL;
+    int numOverlapping = 0;
+
+    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
+        if (memories[i] == NULL)
+            continue;
+
+        int devStart = memories[i]->startOffset;
+        int devEnd = devStart + memories[i]->len;
+        if (devStart < pageEnd && devEnd > pageStart) {
+            numOverlapping++;
+            // Only a device covering the whole page can own it
+            if (devStart <= pageStart && devEnd >= pageEnd)
+                owner = memories[i];
+        }
+    }
+
+    memoryController_readPages[page] = NULL;
+    memoryController_writePages[page] = NULL;
+    if (numOverlapping == 1 && owner != NULL) {
+        uint8_t* base = owner->data + (pageStart - owner->startOffset);
+        if (owner->readEnable)
+            memoryController_readPages[page] = base;
+        if (owner->writeEnable && !memoryController_cowPages[page])
+            memoryController_writePages[page] = base;
+    }
 }
 
 /********************************************************************
 
-    MemoryController clock response functions
+    MemoryController image functions
 
 ********************************************************************/
 
 /*
-On CLCK
+Copies the writeable memory into a new image. Returns NULL if it can't be allocated
 */
-void memoryController_onCLCK(bool rising) {
+MemoryImage_t* memoryController_createImage() {
+    MemoryImage_t* image = calloc(1, sizeof(MemoryImage_t));
+    if (image == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to create memory image: can't allocate memory for struct\n");
+        return NULL;
+    }
+
+    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
+        if (memories[i] == NULL || !memories[i]->writeEnable)
+            continue;
+        image->data[i] = malloc(memories[i]->len);
+        if (image->data[i] == NULL) {
+            formattedLog(stdlog, LOGTYPE_ERROR, "Unable to create memory image: can't allocate %i bytes\n", memories[i]->len);
+            memoryController_destroyImage(image);
+            return NULL;
+        }
+        memcpy(image->data[i], memories[i]->data, memories[i]->len);
+    }
+
+    // The image's pages are the machine's, moved over to the copies wherever they point into a writeable device
+    for (int page = 0; page < MEMORY_NUM_PAGES; page++) {
+        image->readPages[page] = memoryController_readPages[page];
+        image->writePages[page] = memoryController_writePages[page];
+        for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
+            if (image->data[i] == NULL)
+                continue;
+            uint8_t* start = memories[i]->data;
+            uint8_t* end = start + memories[i]->len;
+            bool moved = false;
+            if (image->readPages[page] >= start && image->readPages[page] < end) {
+                image->readPages[page] = image->data[i] + (image->readPages[page] - start);
+                moved = true;
+            }
+            if (image->writePages[page] >= start && image->writePages[page] < end) {
+                image->writePages[page] = image->data[i] + (image->writePages[page] - start);
+                moved = true;
+            }
+            if (moved)
+                image->swapPages[image->nSwapPages++] = (uint8_t)page;
+        }
+    }
+    return image;
+}
+
+/*
+Frees an image. It must not be swapped in
+*/
+void memoryController_destroyImage(MemoryImage_t* image) {
+    if (image == NULL)
+        return;
+    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++)
+        free(image->data[i]);
+    free(image);
+}
+
+/*
+Exchanges the machine's writeable memory with the image's. Swapping the same image again puts everything back
+*/
+void memoryController_swapImage(MemoryImage_t* image) {
+    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
+        if (image->data[i] != NULL) {
+            uint8_t* data = memories[i]->data;
+            memories[i]->data = image->data[i];
+            image->data[i] = data;
+        }
+    }
+    for (int i = 0; i < image->nSwapPages; i++) {
+        int page = image->swapPages[i];
+        uint8_t* readPage = memoryController_readPages[page];
+        uint8_t* writePage = memoryController_writePages[page];
+        memoryController_readPages[page] = image->readPages[page];
+        memoryController_writePages[page] = image->writePages[page];
+        image->readPages[page] = readPage;
+        image->writePages[page] = writePage;
+    }
+}
+
+/********************************************************************
+
+    MemoryController snapshot functions
+
+********************************************************************/
+
+/*
+Takes a snapshot of the writeable memory. Nothing is copied yet: every writeable page is marked as shared, and is copied
+by the first write to it. Read-only memory can't change, so it is never copied. Returns NULL if it can't be allocated
+*/
+MemorySnapshot_t* memoryController_createSnapshot() {
+    if (memoryController_nSnapshots >= MAX_NUMBER_OF_MEMORY_SNAPSHOTS) {
+        formattedLog(debuglog, LOGTYPE_ERROR, "Unable to create memory snapshot: no free space\n");
+        return NULL;
+    }
+
+    MemorySnapshot_t* snapshot = calloc(1, sizeof(MemorySnapshot_t));
+    if (snapshot == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to create memory snapshot: can't allocate memory for struct\n");
+        return NULL;
+    }
+    memoryController_snapshots[memoryController_nSnapshots++] = snapshot;
+
+    for (int page = 0; page < MEMORY_NUM_PAGES; page++) {
+        if (memoryController_isWriteablePage(page)) {
+            memoryController_cowPages[page] = true;
+            memoryController_writePages[page] = NULL;
+        }
+    }
+    return snapshot;
+}
+
+/*
+Frees a snapshot and the page copies no other snapshot holds. Pages only it shared with the machine go back to direct writes
+*/
+void memoryController_destroySnapshot(MemorySnapshot_t* snapshot) {
+    if (snapshot == NULL)
+        return;
+
+    int n = 0;
+    for (int i = 0; i < memoryController_nSnapshots; i++) {
+        if (memoryController_snapshots[i] != snapshot)
+            memoryController_snapshots[n++] = memoryController_snapshots[i];
+    }
+    memoryController_nSnapshots = (uint8_t)n;
+
+    for (int page = 0; page < MEMORY_NUM_PAGES; page++) {
+        MemoryPageCopy_t* copy = snapshot->pages[page];
+        if (copy != NULL && --copy->refs == 0)
+            free(copy);
+    }
+    free(snapshot);
+    memoryController_updateCowPages();
+}
+
+/*
+Puts the writeable memory back as it was when the snapshot was taken. Only pages written since have anything to put back,
+and only the bytes that differ are written, so the caches built from the rest are kept. Other snapshots sharing a page
+about to be put back are given their copy of it first
+*/
+void memoryController_restoreSnapshot(MemorySnapshot_t* snapshot) {
+    for (int page = 0; page < MEMORY_NUM_PAGES; page++) {
+        if (snapshot->pages[page] == NULL)
+            continue;
+        if (memoryController_cowPages[page])
+            memoryController_copyPage(page);
+        memoryController_loadPageCopy(snapshot->pages[page], page);
+    }
+}
+
+/*
+True if a writeable device covers any of the page
+*/
+bool memoryController_isWriteablePage(int page) {
+    int pageStart = page << MEMORY_PAGE_SHIFT;
+    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
+        if (memories[i] != NULL && memories[i]->writeEnable && memories[i]->startOffset < pageStart + MEMORY_PAGE_SIZE && memories[i]->startOffset + memories[i]->len > pageStart)
+            return true;
+    }
+    return false;
+}
+
+/*
+Called before the first write to a page some snapshot shares with the machine. The page is copied once for every snapshot
+that still shares it, and from then on writes to it go direct again
+*/
+void memoryController_copyPage(int page) {
+    int pageStart = page << MEMORY_PAGE_SHIFT;
+    uint8_t devices[MAX_NUMBER_OF_MEMORIES];
+    int nDevices = 0;
+    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
+        if (memories[i] != NULL && memories[i]->writeEnable && memories[i]->startOffset < pageStart + MEMORY_PAGE_SIZE && memories[i]->startOffset + memories[i]->len > pageStart)
+            devices[nDevices++] = (uint8_t)i;
+    }
+
+    MemoryPageCopy_t* copy = malloc(sizeof(MemoryPageCopy_t) + (size_t)nDevices * MEMORY_PAGE_SIZE);
+    if (copy == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to copy memory page %02X for the snapshots: can't allocate memory\n", page);
+        return;
+    }
+    copy->refs = 0;
+    copy->nDevices = (uint8_t)nDevices;
+    for (int d = 0; d < nDevices; d++) {
+        MemoryDevice_t* device = memories[devices[d]];
+        copy->devices[d] = devices[d];
+        for (int offset = 0; offset < MEMORY_PAGE_SIZE; offset++) {
+            int effectiveAddress = pageStart + offset - device->startOffset;
+            if (effectiveAddress >= 0 && effectiveAddress < device->len)
+                copy->data[d * MEMORY_PAGE_SIZE + offset] = device->data[effectiveAddress];
+        }
+    }
+
+    for (int i = 0; i < memoryController_nSnapshots; i++) {
+        if (memoryController_snapshots[i]->pages[page] == NULL) {
+            memoryController_snapshots[i]->pages[page] = copy;
+            copy->refs++;
+        }
+    }
+    if (copy->refs == 0)
+        free(copy);
+
+    memoryController_pagesCopied++;
+    memoryController_cowPages[page] = false;
+    memoryController_rebuildPage(page);
+}
+
+/*
+Writes a page copy back into its devices. The write listeners are told about each byte that changes
+*/
+void memoryController_loadPageCopy(const MemoryPageCopy_t* copy, int page) {
+    int pageStart = page << MEMORY_PAGE_SHIFT;
+    for (int d = 0; d < copy->nDevices; d++) {
+        MemoryDevice_t* device = memories[copy->devices[d]];
+        for (int offset = 0; offset < MEMORY_PAGE_SIZE; offset++) {
+            int effectiveAddress = pageStart + offset - device->startOffset;
+            if (effectiveAddress < 0 || effectiveAddress >= device->len)
+                continue;
+            uint8_t value = copy->data[d * MEMORY_PAGE_SIZE + offset];
+            if (device->data[effectiveAddress] != value) {
+                device->data[effectiveAddress] = value;
+                memoryController_notifyWrite((uint16_t)(pageStart + offset));
+            }
+        }
+    }
+}
+
+/*
+Works out again which pages a snapshot still shares with the machine, after one has gone
+*/
+void memoryController_updateCowPages() {
+    for (int page = 0; page < MEMORY_NUM_PAGES; page++) {
+        bool shared = false;
+        if (memoryController_isWriteablePage(page)) {
+            for (int i = 0; i < memoryController_nSnapshots && !shared; i++)
+                shared = memoryController_snapshots[i]->pages[page] == NULL;
+        }
+        if (shared != memoryController_cowPages[page]) {
+            memoryController_cowPages[page] = shared;
+            memoryController_rebuildPage(page);
+        }
+    }
+}
+
+/********************************************************************
+
+    MemoryController bus response functions
+
+********************************************************************/
+
+/*
+Coroutine body. Each clock edge with MREQ active is passed to every memory, in the state the last edge left the bus
+*/
+void memoryController_run(Coroutine_t* co) {
+    COROUTINE_BEGIN(co);
+    while (true) {
+        COROUTINE_WAIT_SIGNAL(co, &signal_MREQ, true);
+        memoryController_processBus();
+    }
+    COROUTINE_END(co);
+}
+
+/*
+Answers the bus as it stands
+*/
+void memoryController_processBus() {
     // We need to process this for each memory, so we shall pass it off to a handler for each
     for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
         if (memories[i] != NULL)
-            memoryController_processOnCLCK(memories[i], rising);
+            memoryController_processAccess(memories[i]);
     }
 }
 
 /*
-On CLCK
+On a clock edge with MREQ active
 */
-void memoryController_processOnCLCK(MemoryDevice_t* device, bool rising) {
+void memoryController_processAccess(MemoryDevice_t* device) {
     // Check for the MREQ signal, as this will enable read/write decisions
     if (signals_readSignal(&signal_MREQ)) {
         // We will check for reads first as priority
@@ -128,6 +489,58 @@ uint8_t memoryController_rawRead(uint16_t address) {
     return 0;
 }
 
+/*
+Reads a byte without involving the bus signals. Used by the instruction-stepped engine.
+Follows the same rules as a bus read: the last readable device in range wins, and unmapped space reads as 0xFF
+*/
+uint8_t memoryController_directRead(uint16_t address) {
+    uint8_t* page = memoryController_readPages[address >> MEMORY_PAGE_SHIFT];
+    if (page != NULL)
+        return page[address & MEMORY_PAGE_MASK];
+
+    uint8_t value = 0xFF;
+    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
+        if (memories[i] != NULL && memories[i]->readEnable) {
+            int effectiveAddress = address - memories[i]->startOffset;
+            if (effectiveAddress >= 0 && effectiveAddress < memories[i]->len)
+                value = memories[i]->data[effectiveAddress];
+        }
+    }
+    return value;
+}
+
+/*
+True if no device covers any of the 'len' bytes from 'address', so they read 0xFF and writes to them are lost
+*/
+bool memoryController_isUnmapped(uint16_t address, int len) {
+    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
+        if (memories[i] == NULL)
+            continue;
+        if (address < memories[i]->startOffset + memories[i]->len && memories[i]->startOffset < address + len)
+            return false;
+    }
+    return true;
+}
+
+/*
+True if the address is served by a readable device and no device in range can be written, so its contents can't change once loaded
+*/
+bool memoryController_isReadOnly(uint16_t address) {
+    bool readable = false;
+    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
+        if (memories[i] == NULL)
+            continue;
+        int effectiveAddress = address - memories[i]->startOffset;
+        if (effectiveAddress >= 0 && effectiveAddress < memories[i]->len) {
+            if (memories[i]->writeEnable)
+                return false;
+            if (memories[i]->readEnable)
+                readable = true;
+        }
+    }
+    return readable;
+}
+
 /*
 If the address bus is set to a value in the range of the provided device, place the data at that address on the data bus
 */
@@ -151,6 +564,56 @@ void memoryController_attemptRead(MemoryDevice_t* device) {
 
 ********************************************************************/
 
+/*
+Writes a byte without involving the bus signals. Used by the instruction-stepped engine.
+Every writeable device in range stores the value, as with a bus write
+*/
+void memoryController_directWrite(uint16_t address, uint8_t value) {
+    uint8_t* page = memoryController_writePages[address >> MEMORY_PAGE_SHIFT];
+    if (page != NULL) {
+        page[address & MEMORY_PAGE_MASK] = value;
+        memoryController_notifyWrite(address);
+        return;
+    }
+
+    if (memoryController_cowPages[address >> MEMORY_PAGE_SHIFT])
+        memoryController_copyPage(address >> MEMORY_PAGE_SHIFT);
+
+    bool written = false;
+    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
+        if (memories[i] != NULL && memories[i]->writeEnable) {
+            int effectiveAddress = address - memories[i]->startOffset;
+            if (effectiveAddress >= 0 && effectiveAddress < memories[i]->len) {
+                memories[i]->data[effectiveAddress] = value;
+                written = true;
+            }
+        }
+    }
+    if (written)
+        memoryController_notifyWrite(address);
+}
+
+/*
+Tells the write listeners that the byte at 'address' has changed
+*/
+void memoryController_notifyWrite(uint16_t address) {
+    for (int i = 0; i < memoryController_nWriteListeners; i++)
+        memoryController_writeListeners[i](address);
+}
+
+/*
+Stores a byte in the read-only devices in range. Bus writes skip these, so this is how ROM images get loaded
+*/
+void memoryController_programReadOnly(uint16_t address, uint8_t value) {
+    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
+        if (memories[i] != NULL && !memories[i]->writeEnable) {
+            int effectiveAddress = address - memories[i]->startOffset;
+            if (effectiveAddress >= 0 && effectiveAddress < memories[i]->len)
+                memories[i]->data[effectiveAddress] = value;
+        }
+    }
+}
+
 /*
 If the address bus is set to a value in the range of the provided device, read the value off the data bus and save in memory
 */
@@ -162,8 +625,11 @@ void memoryController_attemptWrite(MemoryDevice_t* device) {
     // Get the effectiveAddress, and then test if it is in range
     int effectiveAddress = signal_addressBus - device->startOffset;
     if (effectiveAddress >= 0 && effectiveAddress < device->len) {
-        // We are in range, store the value from the bus
+        // We are in range, store the value from the bus once any snapshot sharing the page has its copy
+        if (memoryController_cowPages[signal_addressBus >> MEMORY_PAGE_SHIFT])
+            memoryController_copyPage(signal_addressBus >> MEMORY_PAGE_SHIFT);
         // formattedLog(debuglog, LOGTYPE_DEBUG, "[MEMORY] Device write @ %04X(dev_add=%04X) of value %04X\n", signal_addressBus, effectiveAddress, device->data[effectiveAddress]);
         device->data[effectiveAddress] = signal_dataBus;
+        memoryController_notifyWrite(signal_addressBus);
     }
 }
\ No newline at end of file
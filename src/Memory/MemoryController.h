@@ -18,8 +18,58 @@ MemoryController.h : Memory controller system
 */
 
 #include "MemoryDevice.h"
+#include "../Coroutine.h"
+#include "../Z0Machine.h"
 
 #define MAX_NUMBER_OF_MEMORIES 32
+#define MAX_NUMBER_OF_WRITE_LISTENERS 8
+#define MAX_NUMBER_OF_MEMORY_SNAPSHOTS 16
+
+/* Direct access pages */
+#define MEMORY_PAGE_SHIFT 8
+#define MEMORY_PAGE_SIZE 0x100
+#define MEMORY_PAGE_MASK 0xFF
+#define MEMORY_NUM_PAGES 0x100
+
+extern Z0_MACHINE_LOCAL uint8_t* memoryController_readPages[MEMORY_NUM_PAGES];
+extern Z0_MACHINE_LOCAL uint8_t* memoryController_writePages[MEMORY_NUM_PAGES];
+
+/* Write listeners. Called with the address of every byte stored in a device, so anything caching memory contents can drop stale copies */
+extern Z0_MACHINE_LOCAL void (*memoryController_writeListeners[MAX_NUMBER_OF_WRITE_LISTENERS])(uint16_t address);
+extern Z0_MACHINE_LOCAL uint8_t memoryController_nWriteListeners;
+
+/* A copy of the writeable memory that can be swapped in for the machine's own, so one machine can stand in for several
+instances sharing its read-only memory. Its page tables are only valid while it isn't swapped in */
+typedef struct MemoryImage {
+    uint8_t* data[MAX_NUMBER_OF_MEMORIES]; // ALLOCATED: copy of each writeable device's data, NULL for the others
+    uint8_t* readPages[MEMORY_NUM_PAGES];
+    uint8_t* writePages[MEMORY_NUM_PAGES];
+    uint8_t swapPages[MEMORY_NUM_PAGES]; // Pages served by a writeable device, the only ones a swap has to exchange
+    int nSwapPages;
+} MemoryImage_t;
+
+/* A page of the writeable memory as it was before the first write to it after a snapshot. One copy is shared by every
+snapshot that still had the page in common with the machine when it was written */
+typedef struct MemoryPageCopy {
+    int refs; // Snapshots holding the copy
+    uint8_t nDevices;
+    uint8_t devices[MAX_NUMBER_OF_MEMORIES]; // Writeable devices overlapping the page
+    uint8_t data[]; // MEMORY_PAGE_SIZE bytes for each of 'devices', at the page offsets the device covers
+} MemoryPageCopy_t;
+
+/* The writeable memory at the time a snapshot was taken. Pages still as they were are shared with the machine, and only
+copied the first time they are written */
+typedef struct MemorySnapshot {
+    MemoryPageCopy_t* pages[MEMORY_NUM_PAGES]; // ALLOCATED: copies of the pages written since, NULL for the others
+} MemorySnapshot_t;
+
+/* Snapshots taken */
+extern Z0_MACHINE_LOCAL MemorySnapshot_t* memoryController_snapshots[MAX_NUMBER_OF_MEMORY_SNAPSHOTS];
+extern Z0_MACHINE_LOCAL uint8_t memoryController_nSnapshots;
+// Pages some snapshot still has in common with the machine. Their write pages are left NULL so the first write goes the
+// slow way round, which copies the page before storing
+extern Z0_MACHINE_LOCAL bool memoryController_cowPages[MEMORY_NUM_PAGES];
+extern Z0_MACHINE_LOCAL uint64_t memoryController_pagesCopied; // Statistics: pages copied on a first write
 
 /********************************************************************
 
@@ -28,6 +78,7 @@ MemoryController.h : Memory controller system
 ********************************************************************/
 
 void memoryController_init();
+void memoryController_addWriteListener(void (*fun)(uint16_t));
 
 /********************************************************************
 
@@ -36,16 +87,44 @@ void memoryController_init();
 ********************************************************************/
 
 void memoryController_createDevice(uint16_t startAdd, uint16_t size, bool writeable, bool readable);
+void memoryController_destroy();
 // void memoryController_destroyDevice();
+void memoryController_rebuildPageTables();
+void memoryController_rebuildPage(int page);
 
 /********************************************************************
 
-    MemoryController clock response functions
+    MemoryController image functions
 
 ********************************************************************/
 
-void memoryController_onCLCK(bool rising);
-void memoryController_processOnCLCK(MemoryDevice_t* device, bool rising);
+MemoryImage_t* memoryController_createImage();
+void memoryController_destroyImage(MemoryImage_t* image);
+void memoryController_swapImage(MemoryImage_t* image);
+
+/********************************************************************
+
+    MemoryController snapshot functions
+
+********************************************************************/
+
+MemorySnapshot_t* memoryController_createSnapshot();
+void memoryController_destroySnapshot(MemorySnapshot_t* snapshot);
+void memoryController_restoreSnapshot(MemorySnapshot_t* snapshot);
+bool memoryController_isWriteablePage(int page);
+void memoryController_copyPage(int page);
+void memoryController_loadPageCopy(const MemoryPageCopy_t* copy, int page);
+void memoryController_updateCowPages();
+
+/********************************************************************
+
+    MemoryController bus response functions
+
+********************************************************************/
+
+void memoryController_run(Coroutine_t* co);
+void memoryController_processBus();
+void memoryController_processAccess(MemoryDevice_t* device);
 
 /********************************************************************
 
@@ -54,6 +133,9 @@ void memoryController_processOnCLCK(MemoryDevice_t* device, bool rising);
 ********************************************************************/
 
 uint8_t memoryController_rawRead(uint16_t address);
+uint8_t memoryController_directRead(uint16_t address);
+bool memoryController_isUnmapped(uint16_t address, int len);
+bool memoryController_isReadOnly(uint16_t address);
 void memoryController_attemptRead(MemoryDevice_t* device);
 
 /********************************************************************
@@ -62,4 +144,7 @@ void memoryController_attemptRead(MemoryDevice_t* device);
 
 ********************************************************************/
 
+void memoryController_directWrite(uint16_t address, uint8_t value);
+void memoryController_notifyWrite(uint16_t address);
+void memoryController_programReadOnly(uint16_t address, uint8_t value);
 void memoryController_attemptWrite(MemoryDevice_t* device);
\ No newline at end of file
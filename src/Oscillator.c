@@ -17,6 +17,8 @@ Oscillator.c : Provides the clock signal
 
 #include "Oscillator.h"
 #include "Signals.h"
+#include "Scheduler.h"
+#include "Coroutine.h"
 #include "SysIO/Log.h"
 #include <stdlib.h>
 #include <stdint.h>
@@ -24,13 +26,14 @@ Oscillator.c : Provides the clock signal
 #include "SFML/System.h"
 #include "CfgReader.h"
 
-double freqMHz = 0.1;
-double microsPerClock = 0.0;
-double overflow = 0;
+Z0_MACHINE_LOCAL double freqMHz = 0.1;
+Z0_MACHINE_LOCAL double microsPerClock = 0.0;
+Z0_MACHINE_LOCAL double overflow = 0;
 
-bool clockState = false;
+Z0_MACHINE_LOCAL bool clockState = false;
+Z0_MACHINE_LOCAL uint64_t oscillator_tStates = 0;
 
-sfClock* clock;
+Z0_MACHINE_LOCAL sfClock* oscillator_clock;
 
 void oscillator_init() {
     double fMHz = 0.00001;
@@ -44,22 +47,38 @@ void oscillator_init() {
     freqMHz = fMHz;
     microsPerClock = 1.0 / freqMHz;
 
-    clock = sfClock_create();
-    if (clock == NULL) {
+    oscillator_clock = sfClock_create();
+    if (oscillator_clock == NULL) {
         // Failed to initialise oscillator!
         formattedLog(stdlog, LOGTYPE_ERROR, "FAILED TO INITIALISE OSCIALLATOR!\n");
         exit(EXIT_FAILURE);
     }
 
-    sfClock_restart(clock);
+    sfClock_restart(oscillator_clock);
 
     formattedLog(stdlog, LOGTYPE_MSG, "Osciallator settings: freqMHz = %f (%f Hz), microsPerClock = %f\n", freqMHz, freqMHz * 1000000, microsPerClock);
 }
 
+/*
+Stops the clock and puts the oscillator back as it was before oscillator_init()
+*/
+void oscillator_destroy() {
+    if (oscillator_clock != NULL)
+        sfClock_destroy(oscillator_clock);
+    oscillator_clock = NULL;
+    freqMHz = 0.1;
+    microsPerClock = 0.0;
+    overflow = 0;
+    clockState = false;
+    oscillator_tStates = 0;
+}
+
 bool oscillator_tick() {
-    sfInt64 elapsedMicros = sfTime_asMicroseconds(sfClock_getElapsedTime(clock));
-    sfClock_restart(clock);
+    sfInt64 elapsedMicros = sfTime_asMicroseconds(sfClock_getElapsedTime(oscillator_clock));
+    sfClock_restart(oscillator_clock);
     overflow += elapsedMicros;
+    if (overflow > OSCILLATOR_MAX_CATCHUP_MICROS)
+        overflow = OSCILLATOR_MAX_CATCHUP_MICROS;
 
     if (overflow < microsPerClock) {
         return false;
@@ -70,15 +89,45 @@ bool oscillator_tick() {
     while (overflow > microsPerClock) {
         overflow -= microsPerClock;
         ticksDone++;
-        clockState = !clockState;
-        if (clockState) {
-            signals_raiseSignal(&signal_CLCK);
-        }   
-        else {
-            signals_dropSignal(&signal_CLCK);
-        }
+        oscillator_toggle();
     }
     // directLog(debuglog, "Completed %i ticks\n", ticksDone);
 
     return true;
+}
+
+/*
+Makes one clock edge. Used by oscillator_tick(), and by anything running the edge engine without following the wall clock
+*/
+void oscillator_toggle() {
+    clockState = !clockState;
+    COROUTINE_CLOCK_EDGE();
+    if (clockState) {
+        signals_raiseSignal(&signal_CLCK);
+        // Device events fire on the edge that reaches them
+        oscillator_tStates++;
+        if (SCHEDULER_NEXT_DEADLINE() <= oscillator_tStates)
+            scheduler_runDue(oscillator_tStates);
+    }
+    else {
+        signals_dropSignal(&signal_CLCK);
+    }
+}
+
+/*
+Used by engines that aren't driven by signal_CLCK.
+Consumes the elapsed time and returns the number of whole clock periods (T-states) that are now due. A period is two CLCK toggles
+*/
+uint64_t oscillator_pendingTStates() {
+    sfInt64 elapsedMicros = sfTime_asMicroseconds(sfClock_getElapsedTime(oscillator_clock));
+    sfClock_restart(oscillator_clock);
+    overflow += elapsedMicros;
+    if (overflow > OSCILLATOR_MAX_CATCHUP_MICROS)
+        overflow = OSCILLATOR_MAX_CATCHUP_MICROS;
+
+    double microsPerTState = 2.0 * microsPerClock;
+    uint64_t due = (uint64_t)(overflow / microsPerTState);
+    overflow -= due * microsPerTState;
+
+    return due;
 }
\ No newline at end of file
@@ -18,9 +18,19 @@ Oscillator.h : Provides the clock signal
 */
 
 #include <stdbool.h>
+#include <stdint.h>
 
-extern double freqMHz;
+#include "Z0Machine.h"
+
+#define OSCILLATOR_MAX_CATCHUP_MICROS 100000.0 // Most wall time made up in one call. A clock faster than the host can run drops the rest rather than falling ever further behind
+
+extern Z0_MACHINE_LOCAL double freqMHz;
 extern double millisPerClock;
+extern Z0_MACHINE_LOCAL uint64_t oscillator_tStates; // Clock periods (rising CLCK edges) made since oscillator_init()
+extern Z0_MACHINE_LOCAL bool clockState; // Level CLCK was last driven to
 
 void oscillator_init();
-bool oscillator_tick();
\ No newline at end of file
+void oscillator_destroy();
+bool oscillator_tick();
+void oscillator_toggle();
+uint64_t oscillator_pendingTStates();
\ No newline at end of file
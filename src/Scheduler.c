@@ -0,0 +1,166 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Scheduler.c : Device events keyed by T-state. The engines run freely up to the next event and fire it there
+
+*/
+
+#include "Scheduler.h"
+#include "SysIO/Log.h"
+
+/* Pending events */
+Z0_MACHINE_LOCAL SchedulerEvent_t scheduler_events[MAX_NUMBER_OF_SCHEDULED_EVENTS];
+Z0_MACHINE_LOCAL uint8_t scheduler_nEvents = 0;
+Z0_MACHINE_LOCAL uint64_t scheduler_posted = 0;
+Z0_MACHINE_LOCAL uint64_t scheduler_fired = 0;
+
+/* Time */
+Z0_MACHINE_LOCAL const uint64_t* scheduler_clock = NULL;
+
+/********************************************************************
+
+    Scheduler Functions
+
+********************************************************************/
+
+/*
+Drops every pending event and the clock, and starts the counts again
+*/
+void scheduler_destroy() {
+    scheduler_nEvents = 0;
+    scheduler_posted = 0;
+    scheduler_fired = 0;
+    scheduler_clock = NULL;
+}
+
+/*
+Sets the counter events are timed against. The stepped engines count Z80_tStates, the edge engine counts oscillator_tStates
+*/
+void scheduler_setClock(const uint64_t* clock) {
+    scheduler_clock = clock;
+}
+
+uint64_t scheduler_now() {
+    return scheduler_clock != NULL ? *scheduler_clock : 0;
+}
+
+/*
+Posts an event to fire once the engine reaches 'tState'. One already due fires at the next chance the engine gives
+*/
+bool scheduler_post(uint64_t tState, void (*fire)(uint64_t)) {
+    if (scheduler_nEvents >= MAX_NUMBER_OF_SCHEDULED_EVENTS) {
+        formattedLog(debuglog, LOGTYPE_ERROR, "Unable to post scheduler event: no free space\n");
+        return false;
+    }
+
+    SchedulerEvent_t* event = &scheduler_events[scheduler_nEvents];
+    event->tState = tState;
+    event->sequence = scheduler_posted++;
+    event->fire = fire;
+    scheduler_siftUp(scheduler_nEvents++);
+    return true;
+}
+
+/*
+Posts an event to fire 'tStates' from now
+*/
+bool scheduler_postIn(uint64_t tStates, void (*fire)(uint64_t)) {
+    return scheduler_post(scheduler_now() + tStates, fire);
+}
+
+/*
+Removes every pending event that would call 'fire', then rebuilds the heap from what is left. Returns the number removed
+*/
+int scheduler_cancel(void (*fire)(uint64_t)) {
+    int kept = 0;
+    for (int i = 0; i < scheduler_nEvents; i++) {
+        if (scheduler_events[i].fire != fire)
+            scheduler_events[kept++] = scheduler_events[i];
+    }
+    int removed = scheduler_nEvents - kept;
+    scheduler_nEvents = (uint8_t)kept;
+    for (int i = kept / 2 - 1; i >= 0; i--)
+        scheduler_siftDown(i);
+    return removed;
+}
+
+uint64_t scheduler_nextDeadline() {
+    return SCHEDULER_NEXT_DEADLINE();
+}
+
+/*
+Fires the events due by 'now' in time order, including any they post that are also due. Returns the number fired
+*/
+int scheduler_runDue(uint64_t now) {
+    int fired = 0;
+    while (scheduler_nEvents > 0 && scheduler_events[0].tState <= now) {
+        SchedulerEvent_t event = scheduler_events[0];
+        scheduler_removeAt(0);
+        event.fire(event.tState);
+        fired++;
+    }
+    scheduler_fired += fired;
+    return fired;
+}
+
+/********************************************************************
+
+    Scheduler Heap Functions
+
+********************************************************************/
+
+bool scheduler_before(const SchedulerEvent_t* a, const SchedulerEvent_t* b) {
+    return a->tState < b->tState || (a->tState == b->tState && a->sequence < b->sequence);
+}
+
+void scheduler_siftUp(int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!scheduler_before(&scheduler_events[i], &scheduler_events[parent]))
+            break;
+        SchedulerEvent_t t = scheduler_events[i];
+        scheduler_events[i] = scheduler_events[parent];
+        scheduler_events[parent] = t;
+        i = parent;
+    }
+}
+
+void scheduler_siftDown(int i) {
+    while (true) {
+        int first = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < scheduler_nEvents && scheduler_before(&scheduler_events[left], &scheduler_events[first]))
+            first = left;
+        if (right < scheduler_nEvents && scheduler_before(&scheduler_events[right], &scheduler_events[first]))
+            first = right;
+        if (first == i)
+            return;
+        SchedulerEvent_t t = scheduler_events[i];
+        scheduler_events[i] = scheduler_events[first];
+        scheduler_events[first] = t;
+        i = first;
+    }
+}
+
+/*
+Fills the gap with the last event and moves it whichever way restores the heap
+*/
+void scheduler_removeAt(int i) {
+    scheduler_nEvents--;
+    if (i == scheduler_nEvents)
+        return;
+    scheduler_events[i] = scheduler_events[scheduler_nEvents];
+    scheduler_siftUp(i);
+    scheduler_siftDown(i);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Scheduler.h : Device events keyed by T-state. The engines run freely up to the next event and fire it there
+
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Z0Machine.h"
+
+#define MAX_NUMBER_OF_SCHEDULED_EVENTS 64
+
+/* A future event. 'fire' is passed the T-state the event was posted for, so a repeating event can post its next one without drift */
+typedef struct SchedulerEvent {
+    uint64_t tState;
+    uint64_t sequence; // Order of posting, so events due on the same T-state fire in the order they were posted
+    void (*fire)(uint64_t tState);
+} SchedulerEvent_t;
+
+/* Pending events, a min-heap on (tState, sequence) */
+extern Z0_MACHINE_LOCAL SchedulerEvent_t scheduler_events[MAX_NUMBER_OF_SCHEDULED_EVENTS];
+extern Z0_MACHINE_LOCAL uint8_t scheduler_nEvents;
+extern Z0_MACHINE_LOCAL uint64_t scheduler_posted; // Events posted, which also numbers them
+extern Z0_MACHINE_LOCAL uint64_t scheduler_fired; // Events fired
+extern Z0_MACHINE_LOCAL const uint64_t* scheduler_clock; // T-state counter of the running engine, set with scheduler_setClock()
+
+/* Due time of the earliest event, UINT64_MAX when there are none. Cheap enough to check on every instruction or edge */
+#define SCHEDULER_NEXT_DEADLINE() (scheduler_nEvents > 0 ? scheduler_events[0].tState : UINT64_MAX)
+
+/********************************************************************
+
+    Scheduler Functions
+
+********************************************************************/
+
+void scheduler_destroy();
+void scheduler_setClock(const uint64_t* clock);
+uint64_t scheduler_now();
+bool scheduler_post(uint64_t tState, void (*fire)(uint64_t));
+bool scheduler_postIn(uint64_t tStates, void (*fire)(uint64_t));
+int scheduler_cancel(void (*fire)(uint64_t));
+uint64_t scheduler_nextDeadline();
+int scheduler_runDue(uint64_t now);
+
+/********************************************************************
+
+    Scheduler Heap Functions
+
+********************************************************************/
+
+bool scheduler_before(const SchedulerEvent_t* a, const SchedulerEvent_t* b);
+void scheduler_siftUp(int i);
+void scheduler_siftDown(int i);
+void scheduler_removeAt(int i);
@@ -15,32 +15,70 @@ Signals.c : Handles all the "signals" that the CPU and other components can acce
 
 */
 
+#include <stddef.h>
+
 #include "Signals.h"
+#include "Coroutine.h"
 
 /* Signal defs */
 // Busses
-uint8_t signal_dataBus = 0;
-uint16_t signal_addressBus = 0;
+Z0_MACHINE_LOCAL uint8_t signal_dataBus = 0;
+Z0_MACHINE_LOCAL uint16_t signal_addressBus = 0;
 
 // System control
-Signal_t signal_M1 = { false, NULL, 0 };
-Signal_t signal_MREQ = { false, NULL, 0 };
-Signal_t signal_IORQ = { false, NULL, 0 };
-Signal_t signal_RD = { false, NULL, 0 };
-Signal_t signal_WR = { false, NULL, 0 };
-Signal_t signal_RFSH = { false, NULL, 0 };
+Z0_MACHINE_LOCAL Signal_t signal_M1 = { .state = false, .pin = true };
+Z0_MACHINE_LOCAL Signal_t signal_MREQ = { .state = false, .pin = true };
+Z0_MACHINE_LOCAL Signal_t signal_IORQ = { .state = false, .pin = true };
+Z0_MACHINE_LOCAL Signal_t signal_RD = { .state = false, .pin = true };
+Z0_MACHINE_LOCAL Signal_t signal_WR = { .state = false, .pin = true };
+Z0_MACHINE_LOCAL Signal_t signal_RFSH = { .state = false, .pin = true };
 
 // CLOCK
-Signal_t signal_CLCK = { false, NULL, 0 };
+Z0_MACHINE_LOCAL Signal_t signal_CLCK = { .state = false };
 
 // CPU control
-Signal_t signal_HALT = { false, NULL, 0 };
-Signal_t signal_WAIT = { false, NULL, 0 };
-Signal_t signal_INT = { false, NULL, 0 };
-Signal_t signal_NMI = { false, NULL, 0 };
-Signal_t signal_RESET = { false, NULL, 0 };
-Signal_t signal_BUSRQ = { false, NULL, 0 };
-Signal_t signal_BUSACK = { false, NULL, 0 };
+Z0_MACHINE_LOCAL Signal_t signal_HALT = { .state = false };
+Z0_MACHINE_LOCAL Signal_t signal_WAIT = { .state = false };
+Z0_MACHINE_LOCAL Signal_t signal_INT = { .state = false };
+Z0_MACHINE_LOCAL Signal_t signal_NMI = { .state = false };
+Z0_MACHINE_LOCAL Signal_t signal_RESET = { .state = false };
+Z0_MACHINE_LOCAL Signal_t signal_BUSRQ = { .state = false };
+Z0_MACHINE_LOCAL Signal_t signal_BUSACK = { .state = false };
+
+// Pin synthesis
+Z0_MACHINE_LOCAL bool signals_lazyPins = false;
+Z0_MACHINE_LOCAL uint8_t signals_nPinObservers = 0;
+Z0_MACHINE_LOCAL void (*signals_pinSync)() = NULL;
+
+/*
+Detaches every listener and drops every signal, as they were before any device connected
+*/
+void signals_destroy() {
+    Signal_t* all[NUMBER_OF_SIGNALS];
+    int n = signals_all(all);
+    for (int i = 0; i < n; i++) {
+        all[i]->state = false;
+        all[i]->nListeners = 0;
+        all[i]->nWaiters = 0;
+    }
+
+    signal_dataBus = 0;
+    signal_addressBus = 0;
+    signals_lazyPins = false;
+    signals_nPinObservers = 0;
+    signals_pinSync = NULL;
+}
+
+/*
+Fills 'all' with every signal, in a fixed order. Returns how many there are
+*/
+int signals_all(Signal_t* all[NUMBER_OF_SIGNALS]) {
+    Signal_t* signals[NUMBER_OF_SIGNALS] = { &signal_M1, &signal_MREQ, &signal_IORQ, &signal_RD, &signal_WR, &signal_RFSH, &signal_CLCK,
+        &signal_HALT, &signal_WAIT, &signal_INT, &signal_NMI, &signal_RESET, &signal_BUSRQ, &signal_BUSACK };
+    for (int i = 0; i < NUMBER_OF_SIGNALS; i++)
+        all[i] = signals[i];
+    return NUMBER_OF_SIGNALS;
+}
 
 void signals_triggerListeners(Signal_t* signal, bool rising) {
     for (int i = 0; i < signal->nListeners; i++) {
@@ -49,11 +87,17 @@ void signals_triggerListeners(Signal_t* signal, bool rising) {
 }
 
 void signals_raiseSignal(Signal_t* signal) {
-    signals_triggerListeners(signal, signal->state = true);
+    signal->state = true;
+    if (signal->nWaiters > 0)
+        coroutine_onSignal(signal);
+    signals_triggerListeners(signal, true);
 }
 
 void signals_dropSignal(Signal_t* signal) {
-    signals_triggerListeners(signal, signal->state = false);
+    signal->state = false;
+    if (signal->nWaiters > 0)
+        coroutine_onSignal(signal);
+    signals_triggerListeners(signal, false);
 }
 
 bool signals_readSignal(Signal_t* signal) {
@@ -70,5 +114,32 @@ void signals_addListener(Signal_t* signal, void (*fun)(bool)) {
         signal->listeners[signal->nListeners] = fun;
         // Increment the number of listeners attached to this function
         signal->nListeners++;
+        // Anything listening to a pin needs to see its edges, so lazy engines start synthesising them
+        if (signal->pin)
+            signals_nPinObservers++;
     }
+}
+
+/*
+Puts the pins in lazy mode. The engine making the transactions synthesises pin edges only while signals_pinsObserved(),
+and 'sync' is called to bring the pins up to date when they are read
+*/
+void signals_setLazyPins(void (*sync)()) {
+    signals_lazyPins = true;
+    signals_pinSync = sync;
+}
+
+/*
+True when the pin edges have to be generated as they happen
+*/
+bool signals_pinsObserved() {
+    return !signals_lazyPins || signals_nPinObservers > 0;
+}
+
+/*
+Brings the pins and busses up to date before they are read. Only lazy pins that nothing observes can be out of date
+*/
+void signals_syncPins() {
+    if (signals_lazyPins && signals_nPinObservers == 0 && signals_pinSync != NULL)
+        signals_pinSync();
 }
\ No newline at end of file
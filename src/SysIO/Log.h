@@ -35,5 +35,7 @@ void log_initLogFiles();
 void log_closeLogFiles();
 void log_dumpHexToDebug(int elementsPerLine, SysFile_t* file);
 
-#define directLog(fp, fmt, ...) if(fp) { fprintf(fp, fmt, __VA_ARGS__); } printf(fmt, __VA_ARGS__);
-#define formattedLog(fp, type, fmt, ...) if(fp) { fprintf(fp, type); fprintf(fp, fmt, __VA_ARGS__); } printf(type); printf(fmt, __VA_ARGS__);
\ No newline at end of file
+// The format string is the first of the variable arguments, so a message with nothing to format needs no trailing comma
+// under compilers other than MSVC
+#define directLog(fp, ...) if(fp) { fprintf(fp, __VA_ARGS__); } printf(__VA_ARGS__);
+#define formattedLog(fp, type, ...) if(fp) { fprintf(fp, type); fprintf(fp, __VA_ARGS__); } printf(type); printf(__VA_ARGS__);
\ No newline at end of file
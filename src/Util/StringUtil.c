@@ -10,6 +10,10 @@ Created by Matthew Clarke
 #include "StringUtil.h"
 #include <string.h>
 
+#if defined(_MSC_VER)
+#define strtok_r strtok_s
+#endif
+
 /********************************************************************
 
     String Functions
@@ -64,16 +68,17 @@ char* sutil_trim(char* str, const char* seps) {
 int sutil_split(char* b, size_t bLen, char** splits, size_t splitsLen, const char* token) {
     // Prepare the variables to capture the lines
     char* line;
+    char* context = NULL; // Kept here rather than inside strtok(), so every thread can split at once
     int linesDetected = 0;
 
     // Get the first line
-    line = strtok(b, token);
+    line = strtok_r(b, token, &context);
     while (line != NULL && linesDetected < splitsLen) {
         // Save the current pointer
         splits[linesDetected] = sutil_trim(line, NULL);
 
         // Get the next line
-        line = strtok(NULL, token);
+        line = strtok_r(NULL, token, &context);
         linesDetected++;
     }
 
@@ -89,4 +94,32 @@ void sutil_byteToBinary(uint8_t byte, char* buffer, int bufferLen) {
             buffer[j] = '0';
     }
     buffer[bufferLen - 1] = '\0';
-}
\ No newline at end of file
+}
+/*
+Writes 'num' in base 'radix' (2 to 36) into buffer, as _itoa() does under MSVC
+*/
+void sutil_intToString(int num, int radix, char* buffer, size_t bufferLen) {
+    const char* digits = "0123456789abcdefghijklmnopqrstuvwxyz";
+    char reversed[34];
+    int len = 0;
+    // Only base 10 is signed, as with _itoa()
+    unsigned int value = (radix == 10 && num < 0) ? (unsigned int)-(long long)num : (unsigned int)num;
+
+    if (bufferLen == 0)
+        return;
+    if (radix < 2 || radix > 36) {
+        buffer[0] = '\0';
+        return;
+    }
+    do {
+        reversed[len++] = digits[value % radix];
+        value /= radix;
+    } while (value != 0);
+    if (radix == 10 && num < 0)
+        reversed[len++] = '-';
+
+    size_t i = 0;
+    for (; i < bufferLen - 1 && len > 0; i++)
+        buffer[i] = reversed[--len];
+    buffer[i] = '\0';
+}
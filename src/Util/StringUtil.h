@@ -19,4 +19,5 @@ Created by Matthew Clarke
 
 char* sutil_trim(char* str, const char* seps);
 int sutil_split(char* b, size_t bLen, char** splits, size_t splitsLen, const char* token);
-void sutil_byteToBinary(uint8_t byte, char* buffer, int bufferLen);
\ No newline at end of file
+void sutil_byteToBinary(uint8_t byte, char* buffer, int bufferLen);
+void sutil_intToString(int num, int radix, char* buffer, size_t bufferLen);
\ No newline at end of file
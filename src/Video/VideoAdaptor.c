@@ -44,12 +44,12 @@ double eventClockResponseTime = 1000.0 / 100.0; // In ms: (1 second / frequency)
 sfClock* renderClock;
 double renderClockResponseTime = 1000.0 / 60.0;
 
-DisplayInf_t displayInfo;
+Z0_MACHINE_LOCAL DisplayInf_t displayInfo;
 
 void (*currentScreen)() = NULL;
 bool currentScreenInit = true;
 
-const uint16_t defaultZero16 = 0;
+const Z80Registers_t defaultRegisters = { 0 };
 
 #ifdef _VIDEO_DEBUG
 sfClock* debugTimerClock;
@@ -70,14 +70,8 @@ bool videoAdaptor_initialise() {
 #endif
 
     // Init pointers of registers
-    displayInfo.AFReg = &defaultZero16;
-    displayInfo.BCReg = &defaultZero16;
-    displayInfo.DEReg = &defaultZero16;
-    displayInfo.HLReg = &defaultZero16;
-    displayInfo.IX = &defaultZero16;
-    displayInfo.IY = &defaultZero16;
-    displayInfo.PC = &defaultZero16;
-    displayInfo.SP = &defaultZero16;
+    displayInfo.registers = &defaultRegisters;
+    displayInfo.syncRegisters = NULL;
 
     videoMode.bitsPerPixel = 8;
     videoMode.width = 800;
@@ -115,9 +109,6 @@ bool videoAdaptor_initialise() {
     sfRenderWindow_display(mainWindow);
     sfRenderWindow_setFramerateLimit(mainWindow, 100);
 
-    // Connect our clock detection
-    signals_addListener(&signal_CLCK, &videoAdaptor_onCLCK);
-
     eventClock = sfClock_create();
     renderClock = sfClock_create();
 
@@ -151,9 +142,9 @@ void videoAdaptor_pushSplash() {
 }
 
 /*
-Activates on each clock cycle
+Handles window events and redraws. Paced by wall time, so the main loop calls it once per pass rather than on every clock edge
 */
-void videoAdaptor_onCLCK(bool rising) {
+void videoAdaptor_update() {
     // Check our clock to see if we should respond to events. We only respond at a max frequency of 100Hz to make sure we don't overload the program
     uint32_t elapsedEventTime = sfTime_asMilliseconds(sfClock_getElapsedTime(eventClock));
     if (elapsedEventTime >= eventClockResponseTime) {
@@ -224,13 +215,13 @@ void videoAdaptor_displayText(const char* string, sfRenderWindow* window, unsign
 
 #ifdef _VIDEO_DEBUG
     uint64_t time = sfTime_asMicroseconds(sfClock_getElapsedTime(debugTimerClock));
-    printf(__FUNCTION__" %s %llu micro seconds\n", string, time);
+    printf("%s %s %llu micro seconds\n", __FUNCTION__, string, (unsigned long long)time);
 #endif
 }
 
 void videoAdaptor_displayTextFromInt(int num, int radix, sfRenderWindow* window, unsigned int x, unsigned int y, unsigned int size, sfFont* font, sfColor c) {
     char temp[50];
-    _itoa(num, temp, radix);
+    sutil_intToString(num, radix, temp, sizeof(temp));
     videoAdaptor_displayText(temp, window, x, y, size, font, c);
 }
 
@@ -253,8 +244,9 @@ void videoAdaptor_displayTextFromDouble(double num, unsigned int numDigits, sfRe
         numDigits = 49;
     }
     
-    char temp[50];
-    _gcvt(num, numDigits, temp);
+    // Room for the digits, sign, point and exponent
+    char temp[64];
+    snprintf(temp, sizeof(temp), "%.*g", (int)numDigits, num);
     // snprintf(temp, 50, "%f", num);
     videoAdaptor_displayText(temp, window, x, y, size, font, c);
 }
@@ -271,22 +263,29 @@ void videoAdaptor_setUIScreen(void (*newScreen)()) {
 }
 
 void videoAdaptor_dispRegisters() {
+    // Bring the registers up to date
+    if (displayInfo.syncRegisters != NULL)
+        displayInfo.syncRegisters();
+
     // Display the information
     int y = 20; int size = 15;
     videoAdaptor_displayText("Registers", mainWindow, 2, y, size, defaultFont, sfCyan); y += 20;
-    videoAdaptor_displayText("A:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(*displayInfo.AFReg >> 8, "%02X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
-    videoAdaptor_displayText("BC:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(*displayInfo.BCReg, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
-    videoAdaptor_displayText("DE:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(*displayInfo.DEReg, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
-    videoAdaptor_displayText("HL:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(*displayInfo.HLReg, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
-    videoAdaptor_displayText("IX:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(*displayInfo.IX, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
-    videoAdaptor_displayText("IY:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(*displayInfo.IY, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
-    videoAdaptor_displayText("PC:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(*displayInfo.PC, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
-    videoAdaptor_displayText("SP:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(*displayInfo.SP, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
-    char buff[9]; sutil_byteToBinary(*displayInfo.AFReg & 0xF, buff, 9);
+    videoAdaptor_displayText("A:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(displayInfo.registers->main.r.af.b.h, "%02X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
+    videoAdaptor_displayText("BC:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(displayInfo.registers->main.r.bc.w, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
+    videoAdaptor_displayText("DE:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(displayInfo.registers->main.r.de.w, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
+    videoAdaptor_displayText("HL:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(displayInfo.registers->main.r.hl.w, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
+    videoAdaptor_displayText("IX:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(displayInfo.registers->ix.w, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
+    videoAdaptor_displayText("IY:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(displayInfo.registers->iy.w, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
+    videoAdaptor_displayText("PC:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(displayInfo.registers->pc.w, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
+    videoAdaptor_displayText("SP:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayTextFromIntWithFmt(displayInfo.registers->sp.w, "%04X", mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
+    char buff[9]; sutil_byteToBinary(displayInfo.registers->main.r.af.b.l, buff, 9);
     videoAdaptor_displayText("F:", mainWindow, 2, y, size, defaultFont, sfWhite); videoAdaptor_displayText(buff, mainWindow, 40, y, size, defaultFont, sfWhite); y += 15;
 }
 
 void videoAdaptor_dispSignals() {
+    // Bring the pins up to date
+    signals_syncPins();
+
     // Display signals
     int y = 200; int size = 10; sfVector2f rpos = { 70,240 }; sfVector2f rsize = { 80, 5 };
     videoAdaptor_displayText("Signals", mainWindow, 2, y, size, defaultFont, sfCyan); y += 16; rpos.y = (float)y + ((float)size / 2.5f);
@@ -338,13 +337,13 @@ void videoAdaptor_dispInstructionInfo() {
     videoAdaptor_displayText("Instr Text:", mainWindow, 2, y, size, defaultFont, sfWhite);
     videoAdaptor_displayText(displayInfo.cInstr->string, mainWindow, 130, y, size, defaultFont, sfWhite); y += 15;
     videoAdaptor_displayText("Exec Func:", mainWindow, 2, y, size, defaultFont, sfWhite);
-    videoAdaptor_displayTextFromUIntWithFmt((unsigned int)displayInfo.cInstr->execFunction, "%016X", mainWindow, 130, y, size, defaultFont, sfWhite); y += 15;
+    videoAdaptor_displayTextFromUIntWithFmt((unsigned int)(uintptr_t)displayInfo.cInstr->execFunction, "%016X", mainWindow, 130, y, size, defaultFont, sfWhite); y += 15;
 }
 
 void videoAdaptor_dispMemPC() {
     // Display memory content around PC
     int y = 410; int size = 10; int x = 2;
-    unsigned int pc = *displayInfo.PC;
+    unsigned int pc = displayInfo.registers->pc.w;
     videoAdaptor_displayText("Memory Around PC", mainWindow, 2, y, size, defaultFont, sfCyan); y += 12;
     for (int i = -8; i < 24; i++) {
         if (displayInfo.cInstr->detectedPrefix && (i == 0 || i == -1)) {
@@ -369,7 +368,7 @@ void videoAdaptor_dispMemPC() {
 void videoAdaptor_dispMemSP() {
     // Display memory content around SP
     int y = 440; int size = 10; int x = 2;
-    unsigned int sp = *displayInfo.SP;
+    unsigned int sp = displayInfo.registers->sp.w;
     videoAdaptor_displayText("Memory Around SP", mainWindow, 2, y, size, defaultFont, sfCyan); y += 12;
     for (int i = -8; i < 24; i++) {
         if (i == 0) {
@@ -383,6 +382,9 @@ void videoAdaptor_dispMemSP() {
 }
 
 void videoAdaptor_dispMemAddrBus() {
+    // Bring the address bus up to date
+    signals_syncPins();
+
     // Display memory content around addressBus
     int y = 470; int size = 10; int x = 2;
     videoAdaptor_displayText("Memory Around Address Bus", mainWindow, 2, y, size, defaultFont, sfCyan); y += 12;
@@ -21,25 +21,20 @@ VideoAdaptor.h : Handles the interface between the system and the graphics for t
 #include <stdint.h>
 
 #include "SFML/Graphics.h"
+#include "../Z80/Z80.h"
 #include "../Z80/Z80Instructions.h"
 
 extern sfRenderWindow* mainWindow;
 extern sfFont* defaultFont;
 
 typedef struct DisplayInf {
-    const uint16_t* AFReg;
-    const uint16_t* BCReg;
-    const uint16_t* DEReg;
-    const uint16_t* HLReg;
-    const uint16_t* IX;
-    const uint16_t* IY;
-    const uint16_t* PC;
-    const uint16_t* SP;
+    const Z80Registers_t* registers;
     Z80_Instr_t* cInstr;
+    void (*syncRegisters)(); // If non-NULL, called before the registers are read so any lazily held state is written back
 } DisplayInf_t;
 
 extern bool closeRequested;
-extern DisplayInf_t displayInfo;
+extern Z0_MACHINE_LOCAL DisplayInf_t displayInfo; // Set up by the machine on this thread
 extern void (*currentScreen)();
 extern sfColor clearColor;
 
@@ -52,7 +47,7 @@ extern sfColor clearColor;
 bool videoAdaptor_initialise();
 void videoAdaptor_destroy();
 void videoAdaptor_pushSplash();
-void videoAdaptor_onCLCK(bool rising);
+void videoAdaptor_update();
 
 /********************************************************************
 
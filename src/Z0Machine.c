@@ -0,0 +1,487 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z0Machine.c : Machine context. Builds a machine from a cfg, runs it and gives access to its memory. The command line
+front end is one client, anything embedding the emulator can be another
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Z0Machine.h"
+#include "Signals.h"
+#include "Oscillator.h"
+#include "Scheduler.h"
+#include "Coroutine.h"
+#include "CfgReader.h"
+#include "SysIO/Log.h"
+#include "SysIO/SysIO.h"
+#include "Util/StringUtil.h"
+#include "IO/IOController.h"
+#include "Memory/MemoryController.h"
+#include "Z80/Z80.h"
+#include "Z80/Z80Step.h"
+#include "Z80/Z80Execute.h"
+#include "Z80/Z80DecodeCache.h"
+#include "Z80/Z80Block.h"
+#include "Z80/Z80Jit.h"
+#include "Z80/Z80Threaded.h"
+#include "Z80/Z80Bus.h"
+#include "Z80/Z80Idle.h"
+#include "Z80/Z80Fusion.h"
+#include "Z80/Z80Refresh.h"
+
+#include "SFML/System.h"
+
+/* The machine living on this thread */
+Z0_MACHINE_LOCAL Z0Machine_t* z0machine_current = NULL;
+
+/********************************************************************
+
+    Z0Machine Lifetime Functions
+
+********************************************************************/
+
+/*
+Builds a machine from its cfg. The machine belongs to the calling thread, which can hold one machine at a time, and is
+only run from that thread. Returns NULL if the machine couldn't be built
+*/
+Z0Machine_t* z0machine_create(const Z0MachineOptions_t* options) {
+    if (z0machine_current != NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to create machine: this thread already holds one\n");
+        return NULL;
+    }
+
+    Z0Machine_t* machine = calloc(1, sizeof(Z0Machine_t));
+    if (machine == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to create machine: can't allocate memory for struct\n");
+        return NULL;
+    }
+    z0machine_current = machine;
+
+    formattedLog(stdlog, LOGTYPE_MSG, "Parsing CFG\n");
+    if (!cfgReader_readConfiguration(options->cfgPath)) {
+        z0machine_destroy(machine);
+        return NULL;
+    }
+
+    // Pick the engine before the Z80 connects to any signals
+    z0machine_configure(machine, options);
+
+    // Init the memory
+    memoryController_init();
+    // Init the Z80
+    Z80_init();
+    // Init the oscillator
+    oscillator_init();
+
+    if (!options->bare) {
+        // Load memory devices here
+        z0machine_loadMemoryDevices();
+
+        // Load the bios ROM
+        const char* biosRomFilePath = options->biosRom;
+        if (biosRomFilePath == NULL && cfgReader_querySettingExist("bios_rom"))
+            biosRomFilePath = cfgReader_querySettingValueStr("bios_rom");
+        if (!z0machine_loadBiosROM(biosRomFilePath)) {
+            z0machine_destroy(machine);
+            return NULL;
+        }
+    }
+
+    // Remember what the address space holds now, for z0machine_restart()
+    machine->powerOnImage = malloc(0x10000);
+    if (machine->powerOnImage == NULL) {
+        formattedLog(stdlog, LOGTYPE_WARN, "Unable to allocate the power-on image, the machine can't be restarted\n");
+    }
+    else {
+        for (uint32_t address = 0; address < 0x10000; address++)
+            machine->powerOnImage[address] = memoryController_directRead((uint16_t)address);
+    }
+
+    // Device sources driven by the CPU's own state start once it is built
+    Z80Refresh_start();
+
+    return machine;
+}
+
+/*
+Frees the machine and puts every module back as it was before z0machine_create(), so the thread can build another
+*/
+void z0machine_destroy(Z0Machine_t* machine) {
+    if (!z0machine_isCurrent(machine))
+        return;
+
+    Z80_destroy();
+    oscillator_destroy();
+    scheduler_destroy();
+    memoryController_destroy();
+    ioController_destroy();
+    coroutine_destroy();
+    signals_destroy();
+    cfgReader_cleanSettings();
+
+    free(machine->powerOnImage);
+    free(machine);
+    z0machine_current = NULL;
+}
+
+/*
+Resets the CPU. Memory and the caches built from it are kept, as RESET leaves memory alone
+*/
+void z0machine_reset(Z0Machine_t* machine) {
+    if (!z0machine_isCurrent(machine))
+        return;
+
+    Z80_reset();
+    machine->owedTStates = 0;
+    // R is back to 0, which moves the next change of A6
+    Z80Refresh_start();
+}
+
+/*
+Puts the machine back as z0machine_create() left it without building it again. The CPU is reset, pending device events
+are dropped and every writeable byte that changed is restored. Read-only memory is untouched, so the caches built from it
+are kept, which makes running many jobs on one machine much cheaper than creating a machine for each
+*/
+void z0machine_restart(Z0Machine_t* machine) {
+    if (!z0machine_isCurrent(machine))
+        return;
+
+    z0machine_reset(machine);
+    scheduler_destroy();
+    scheduler_setClock(Z80_engine == Z80Engine_Edge ? &oscillator_tStates : &Z80_tStates);
+    Z80Refresh_start();
+
+    if (machine->powerOnImage == NULL)
+        return;
+    for (uint32_t address = 0; address < 0x10000; address++) {
+        // Only changed bytes are written, so only the cache entries they cover are dropped
+        if (!memoryController_isReadOnly((uint16_t)address) && memoryController_directRead((uint16_t)address) != machine->powerOnImage[address])
+            memoryController_directWrite((uint16_t)address, machine->powerOnImage[address]);
+    }
+}
+
+/*
+True if 'machine' is the one living on the calling thread. Logs an error if not
+*/
+bool z0machine_isCurrent(Z0Machine_t* machine) {
+    if (machine == NULL || machine != z0machine_current) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Machine %p doesn't belong to this thread\n", (void*)machine);
+        return false;
+    }
+    return true;
+}
+
+/********************************************************************
+
+    Z0Machine Setup Functions
+
+********************************************************************/
+
+/*
+Value of an on/off setting, or 'otherwise' if the cfg doesn't have it
+*/
+bool z0machine_querySwitch(const char* name, bool otherwise) {
+    if (!cfgReader_querySettingExist(name))
+        return otherwise;
+    return cfgReader_querySettingValueInt(name) != 0;
+}
+
+/*
+Chooses the Z80 engine, run limits and engine features. The options take priority over the cfg settings
+*/
+void z0machine_configure(Z0Machine_t* machine, const Z0MachineOptions_t* options) {
+    const char* engine = options->engine;
+    if (engine == NULL && cfgReader_querySettingExist("z80_engine"))
+        engine = cfgReader_querySettingValueStr("z80_engine");
+
+    if (engine == NULL || strcmp(engine, "edge") == 0) {
+        Z80_engine = Z80Engine_Edge;
+    }
+    else if (strcmp(engine, "step") == 0) {
+        Z80_engine = Z80Engine_Step;
+    }
+    else if (strcmp(engine, "mcycle") == 0) {
+        Z80_engine = Z80Engine_MCycle;
+    }
+    else {
+        formattedLog(stdlog, LOGTYPE_WARN, "Unknown Z80 engine '%s', using 'edge'\n", engine);
+        Z80_engine = Z80Engine_Edge;
+    }
+
+    machine->turbo = options->turbo || z0machine_querySwitch("oscillator_turbo", false);
+    machine->runTStates = options->runTStates;
+    if (machine->runTStates == 0 && cfgReader_querySettingExist("run_tstates"))
+        machine->runTStates = strtoull(cfgReader_querySettingValueStr("run_tstates"), NULL, 10);
+    machine->jitOff = options->jitOff || !z0machine_querySwitch("z80_jit", true);
+
+    Z80DecodeCache_enabled = z0machine_querySwitch("z80_decode_cache", true);
+    Z80Block_enabled = z0machine_querySwitch("z80_block_cache", true);
+    Z80Jit_enabled = Z80Block_enabled && !machine->jitOff;
+    Z80Threaded_enabled = z0machine_querySwitch("z80_rom_threading", true);
+    // Bulk block instructions need the T-state deadline only the step engine keeps, and skip the bus transactions
+    Z80_bulkEnabled = Z80_engine == Z80Engine_Step && z0machine_querySwitch("z80_bulk_block", true);
+    // The edge engine keeps no T-state deadline to skip to
+    Z80_haltSkipEnabled = Z80_engine != Z80Engine_Edge && z0machine_querySwitch("z80_halt_skip", true);
+    Z80Idle_enabled = Z80_engine != Z80Engine_Edge && z0machine_querySwitch("z80_idle_skip", true);
+    Z80Fusion_enabled = z0machine_querySwitch("z80_fusion", true);
+    // The ZX80 wires A6 to INT, so the refresh address times the display lines
+    Z80Refresh_enabled = z0machine_querySwitch("z80_refresh_interrupt", false);
+    // The profile is taken in Z80_step(), so every instruction has to come through it rather than a block or the ROM
+    Z80Fusion_profiling = options->fusionProfile && Z80_engine == Z80Engine_Step;
+    if (Z80Fusion_profiling) {
+        Z80Block_enabled = false;
+        Z80Jit_enabled = false;
+        Z80Threaded_enabled = false;
+        Z80Fusion_enabled = false;
+    }
+
+    // Every fetch has to reach the bus in the machine cycle engine, so none of the caches can be used
+    Z80Bus_enabled = Z80_engine == Z80Engine_MCycle;
+    if (Z80_engine == Z80Engine_MCycle) {
+        Z80DecodeCache_enabled = false;
+        Z80Block_enabled = false;
+        Z80Jit_enabled = false;
+        Z80Threaded_enabled = false;
+        Z80Fusion_enabled = false;
+        // It makes plain transactions, so the pins only follow them when something observes or reads them
+        signals_setLazyPins(&Z80Bus_syncPins);
+    }
+
+    // Device events are timed against the engine's own T-state count
+    scheduler_setClock(Z80_engine == Z80Engine_Edge ? &oscillator_tStates : &Z80_tStates);
+
+    formattedLog(stdlog, LOGTYPE_MSG, "Z80 engine: %s, turbo=%i, run_tstates=%llu\n", Z80_engine == Z80Engine_MCycle ? "mcycle" : Z80_engine == Z80Engine_Step ? "step" : "edge",
+        machine->turbo, (unsigned long long)machine->runTStates);
+}
+
+bool z0machine_loadBiosROM(const char* biosRomFilePath) {
+    // Load the ROM file specified by the settings
+        // This is a required step: we fail if it can't be done
+    if (biosRomFilePath == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Cfg file missing 'bios_rom' setting, unable to load\n");
+        return false;
+    }
+    SysFile_t* biosRomFile = sysIO_openFile(biosRomFilePath);
+    if (biosRomFile == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "BIOS ROM file error: unable to find file '%s'\n", biosRomFilePath);
+        return false;
+    }
+
+    // Cache the file
+    sysIO_cacheFile(biosRomFile);
+    if (!biosRomFile->cached) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "BIOS ROM file '%s' could not be cached\n", biosRomFilePath);
+        sysIO_closeFile(biosRomFile);
+        return false;
+    }
+
+    // Load the file into memory now, at position 0 by default
+    uint16_t romAddress = 0;
+    formattedLog(stdlog, LOGTYPE_MSG, "Loading BIOS ROM file '%s' into address ", biosRomFilePath);
+    if (cfgReader_querySettingExist("bios_address")) {
+        romAddress = cfgReader_querySettingValueInt("bios_address");
+    }
+    directLog(stdlog, "%04X\n", romAddress);
+
+    // We need to drive the signal_addressBus and signal_dataBus with the appropriate values as we scan through the data
+    // To allow writing, we need to put signal_MREQ and signal_WR high to make the controller write on the memoryController_processBus() trigger
+    signals_raiseSignal(&signal_MREQ);
+    signals_raiseSignal(&signal_WR);
+
+    // Do the writing
+    formattedLog(debuglog, LOGTYPE_DEBUG, "Writing BIOS ROM file to memory. Bytes to write: %04X\n", (unsigned int)biosRomFile->size);
+    formattedLog(stdlog, LOGTYPE_MSG, "Writing BIOS ROM file to memory. Bytes to write: %04X\n", (unsigned int)biosRomFile->size);
+
+    signal_addressBus = romAddress;
+    for (uint16_t i = 0; i < biosRomFile->size; i++) {
+        // Put the data on the bus
+        signal_addressBus = i + romAddress;
+        signal_dataBus = biosRomFile->data[i];
+
+        // Trigger the write
+        memoryController_processBus();
+        // Read-only devices ignore bus writes, so they are programmed directly
+        memoryController_programReadOnly(signal_addressBus, signal_dataBus);
+    }
+    directLog(debuglog, "\n");
+    formattedLog(debuglog, LOGTYPE_DEBUG, "BIOS ROM file write complete\n");
+    formattedLog(stdlog, LOGTYPE_MSG, "BIOS ROM file write complete\n");
+
+    // Clean up the signals
+    signals_dropSignal(&signal_MREQ);
+    signals_dropSignal(&signal_WR);
+
+    // Read-only ROM never changes, so the stepped engine can run it from threaded code
+    if (Z80_engine == Z80Engine_Step && Z80Threaded_enabled) {
+        sfClock* predecodeClock = sfClock_create();
+        if (Z80Threaded_predecode(romAddress, biosRomFile->size)) {
+            formattedLog(stdlog, LOGTYPE_MSG, "Pre-decoded %u ROM addresses into threaded code in %f ms\n", Z80Threaded_len,
+                sfTime_asMicroseconds(sfClock_getElapsedTime(predecodeClock)) / 1000.0);
+        }
+        sfClock_destroy(predecodeClock);
+    }
+
+    sysIO_closeFile(biosRomFile);
+    return true;
+}
+
+void z0machine_loadMemoryDevices() {
+    formattedLog(debuglog, LOGTYPE_DEBUG, "Memory device configuation\n");
+
+    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
+        // Generate the matcher string we look for as a setting
+        char prefix[50];
+        char* matcher = prefix;
+        snprintf(matcher, sizeof(prefix), "memdev%i", i);
+        directLog(debuglog, "Looking for memory device '%s' definition...\n", matcher);
+
+        if (cfgReader_querySettingExist(matcher)) {
+            // We have the definition, but we must check it to be sure
+            char* rawVal = cfgReader_querySettingValueStr(matcher);
+            int buffLen = (int)strlen(rawVal) + 1;
+            char* buff = calloc(buffLen, sizeof(char));
+            if (buff == NULL) {
+                // We fail!
+                formattedLog(stdlog, LOGTYPE_WARN, "Detected setting for '%s' but failed to allocate memory for buffer\n", matcher);
+            }
+
+            memcpy(buff, rawVal, buffLen); // Copy the null char too
+            char* splits[8];
+            int splitsMade = sutil_split(buff, buffLen, splits, 8, ",");
+            if (splitsMade == 4) {
+                // We are valid!
+                formattedLog(stdlog, LOGTYPE_MSG, "Detected setting for '%s'\n", matcher);
+                // Time to configure the memory device
+                memoryController_createDevice(atoi(splits[0]), atoi(splits[1]), atoi(splits[2]), atoi(splits[3]));
+            }
+            else {
+                formattedLog(stdlog, LOGTYPE_WARN, "Detected setting for '%s', but it was of the incorrect format. Had %i elements.\n", matcher, splitsMade);
+            }
+
+            free(buff);
+        }
+    }
+}
+
+/********************************************************************
+
+    Z0Machine Run Functions
+
+********************************************************************/
+
+/*
+True once the CPU has issued a termination request
+*/
+bool z0machine_failed(Z0Machine_t* machine) {
+    (void)machine;
+    return Z80_state() == Z80State_Failure;
+}
+
+/*
+True once the machine has run its 'run_tstates'
+*/
+bool z0machine_finished(Z0Machine_t* machine) {
+    return machine->runTStates > 0 && Z80_tStates >= machine->runTStates;
+}
+
+/*
+Runs one slice of the instruction-stepped engines. The oscillator sets the size of the slice unless the machine is in
+turbo mode. Returns the T-states run
+*/
+uint64_t z0machine_runSlice(Z0Machine_t* machine) {
+    // Device events fire between slices, on the first instruction boundary at or after their T-state
+    scheduler_runDue(Z80_tStates);
+
+    uint64_t budget = machine->turbo ? Z0_MACHINE_SLICE_TSTATES : machine->owedTStates + oscillator_pendingTStates();
+    // A halted CPU that nothing can wake until the run ends costs nothing to run to the end in one slice
+    if (machine->turbo && machine->runTStates > 0 && halted && Z80_haltCanSkip())
+        budget = machine->runTStates - Z80_tStates;
+    if (machine->runTStates > 0 && budget > machine->runTStates - Z80_tStates)
+        budget = machine->runTStates - Z80_tStates;
+    // Run freely up to the next device event. When throttled, what that leaves is run in the next slice so pacing is kept
+    uint64_t eventDeadline = SCHEDULER_NEXT_DEADLINE();
+    machine->owedTStates = 0;
+    if (budget > eventDeadline - Z80_tStates) {
+        if (!machine->turbo)
+            machine->owedTStates = budget - (eventDeadline - Z80_tStates);
+        budget = eventDeadline - Z80_tStates;
+    }
+    return Z80_runFor(budget);
+}
+
+/*
+Runs the machine unthrottled for 'tStates', stopping early if the CPU fails or the machine finishes its run.
+The edge engine is clocked directly rather than by the oscillator. Returns the T-states run
+*/
+uint64_t z0machine_run(Z0Machine_t* machine, uint64_t tStates) {
+    if (!z0machine_isCurrent(machine))
+        return 0;
+
+    if (Z80_engine == Z80Engine_Edge) {
+        uint64_t start = oscillator_tStates;
+        while (oscillator_tStates - start < tStates && !z0machine_failed(machine))
+            z0machine_clockPeriod();
+        return oscillator_tStates - start;
+    }
+
+    // Run in slices no longer than the caller asked for, so the stop lands on the first instruction boundary after it
+    uint64_t start = Z80_tStates;
+    uint64_t runTStates = machine->runTStates;
+    bool turbo = machine->turbo;
+    uint64_t target = start + tStates;
+    if (runTStates == 0 || runTStates > target)
+        machine->runTStates = target;
+    machine->turbo = true;
+
+    while (!z0machine_failed(machine) && !z0machine_finished(machine))
+        z0machine_runSlice(machine);
+
+    machine->runTStates = runTStates;
+    machine->turbo = turbo;
+    return Z80_tStates - start;
+}
+
+/*
+One whole clock period of the edge engine
+*/
+void z0machine_clockPeriod() {
+    oscillator_toggle();
+    oscillator_toggle();
+}
+
+/********************************************************************
+
+    Z0Machine Memory Functions
+
+********************************************************************/
+
+/*
+Reads a byte as the CPU would see it, without any bus activity
+*/
+uint8_t z0machine_readByte(Z0Machine_t* machine, uint16_t address) {
+    if (!z0machine_isCurrent(machine))
+        return 0xFF;
+    return memoryController_directRead(address);
+}
+
+/*
+Stores a byte as the CPU would, so read-only memory is left alone and anything cached from the old value is dropped
+*/
+void z0machine_writeByte(Z0Machine_t* machine, uint16_t address, uint8_t value) {
+    if (!z0machine_isCurrent(machine))
+        return;
+    memoryController_directWrite(address, value);
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z0Machine.h : Machine context. Builds a machine from a cfg, runs it and gives access to its memory. The command line
+front end is one client, anything embedding the emulator can be another
+
+One machine per thread: the CPU, bus and devices keep their state in thread-local globals rather than behind the
+Z0Machine_t handle, so z0machine_create() fails while the calling thread already holds a machine. This is deliberate,
+as it keeps the hot paths free of a context pointer. To run several machines at once, give each its own thread (as
+the batch runner does), or destroy one before creating the next
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* State owned by a machine. Every thread has its own copy, so each thread can run a machine of its own */
+#if defined(_MSC_VER)
+#define Z0_MACHINE_LOCAL __declspec(thread)
+#else
+#define Z0_MACHINE_LOCAL _Thread_local
+#endif
+
+#define Z0_MACHINE_SLICE_TSTATES 100000 // T-states run per slice when the machine is unthrottled
+
+/* How to build a machine. The fields that override a cfg setting leave it alone when zero */
+typedef struct Z0MachineOptions {
+    const char* cfgPath; // Cfg file describing the machine
+    const char* engine; // If non-NULL, overrides the 'z80_engine' setting
+    const char* biosRom; // If non-NULL, overrides the 'bios_rom' setting
+    bool turbo; // Run unthrottled rather than following the oscillator. Also set by 'oscillator_turbo'
+    bool jitOff; // Never run compiled blocks. Also set by 'z80_jit = 0'
+    uint64_t runTStates; // If non-zero, the machine terminates after this many T-states. Also set by 'run_tstates'
+    bool bare; // Leave out the memory devices and BIOS ROM, for tools that only need the CPU
+    bool fusionProfile; // Count the instruction pairs and triples run, to choose the patterns in Z80Fusion.def
+} Z0MachineOptions_t;
+
+typedef struct Z0Machine {
+    bool turbo;
+    bool jitOff;
+    uint64_t runTStates;
+    uint64_t owedTStates; // T-states the oscillator has made due that a slice cut short by a device event didn't run
+    uint8_t* powerOnImage; // ALLOCATED: the address space as it was once built, which z0machine_restart() returns to
+} Z0Machine_t;
+
+/* The machine living on this thread, NULL if there is none */
+extern Z0_MACHINE_LOCAL Z0Machine_t* z0machine_current;
+
+/********************************************************************
+
+    Z0Machine Lifetime Functions
+
+********************************************************************/
+
+Z0Machine_t* z0machine_create(const Z0MachineOptions_t* options);
+void z0machine_destroy(Z0Machine_t* machine);
+void z0machine_reset(Z0Machine_t* machine);
+void z0machine_restart(Z0Machine_t* machine);
+bool z0machine_isCurrent(Z0Machine_t* machine);
+
+/********************************************************************
+
+    Z0Machine Setup Functions
+
+********************************************************************/
+
+bool z0machine_querySwitch(const char* name, bool otherwise);
+void z0machine_configure(Z0Machine_t* machine, const Z0MachineOptions_t* options);
+bool z0machine_loadBiosROM(const char* biosRomFilePath);
+void z0machine_loadMemoryDevices();
+
+/********************************************************************
+
+    Z0Machine Run Functions
+
+********************************************************************/
+
+bool z0machine_failed(Z0Machine_t* machine);
+bool z0machine_finished(Z0Machine_t* machine);
+uint64_t z0machine_runSlice(Z0Machine_t* machine);
+uint64_t z0machine_run(Z0Machine_t* machine, uint64_t tStates);
+void z0machine_clockPeriod();
+
+/********************************************************************
+
+    Z0Machine Memory Functions
+
+********************************************************************/
+
+uint8_t z0machine_readByte(Z0Machine_t* machine, uint16_t address);
+void z0machine_writeByte(Z0Machine_t* machine, uint16_t address, uint8_t value);
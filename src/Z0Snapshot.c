@@ -0,0 +1,267 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z0Snapshot.c : Copy-on-write snapshots of a whole machine, and forks of a running machine
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Z0Snapshot.h"
+#include "Oscillator.h"
+#include "SysIO/Log.h"
+#include "Z80/Z80Step.h"
+#include "Z80/Z80Lockstep.h"
+
+/********************************************************************
+
+    Z0Snapshot Functions
+
+********************************************************************/
+
+/*
+Takes a snapshot of the machine between two runs. Nothing in memory is copied until it is next written.
+Returns NULL if the snapshot can't be taken
+*/
+Z0Snapshot_t* z0snapshot_take(Z0Machine_t* machine) {
+    if (!z0machine_isCurrent(machine))
+        return NULL;
+    // Lockstep lanes swap memory images in and out under the page tables, which the shared pages rely on
+    if (Z80Lockstep_nLanes > 0) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to take snapshot: lockstep lanes are running\n");
+        return NULL;
+    }
+
+    Z0Snapshot_t* snapshot = calloc(1, sizeof(Z0Snapshot_t));
+    if (snapshot == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to take snapshot: can't allocate memory for struct\n");
+        return NULL;
+    }
+    snapshot->memory = memoryController_createSnapshot();
+    if (snapshot->memory == NULL) {
+        free(snapshot);
+        return NULL;
+    }
+    snapshot->machine = machine;
+    Z80_saveState(&snapshot->cpu);
+
+    Signal_t* all[NUMBER_OF_SIGNALS];
+    int nSignals = signals_all(all);
+    for (int i = 0; i < nSignals; i++) {
+        snapshot->signalStates[i] = all[i]->state;
+        snapshot->signalPins[i] = all[i]->pin;
+        snapshot->signalWaiters[i] = all[i]->nWaiters;
+    }
+    snapshot->dataBus = signal_dataBus;
+    snapshot->addressBus = signal_addressBus;
+
+    memcpy(snapshot->events, scheduler_events, sizeof(scheduler_events));
+    snapshot->nEvents = scheduler_nEvents;
+    snapshot->posted = scheduler_posted;
+
+    snapshot->oscillatorTStates = oscillator_tStates;
+    snapshot->clockState = clockState;
+    for (int i = 0; i < coroutine_nAll; i++)
+        snapshot->coroutines[i] = *coroutine_all[i];
+    snapshot->nCoroutines = coroutine_nAll;
+    snapshot->edges = coroutine_edges;
+    snapshot->nextEdge = coroutine_nextEdge;
+
+    snapshot->owedTStates = machine->owedTStates;
+    return snapshot;
+}
+
+/*
+Puts the machine back as it was when the snapshot was taken. The snapshot is kept, so it can be put back again.
+Only the memory written since is touched, so the caches built from the rest are kept
+*/
+bool z0snapshot_restore(Z0Machine_t* machine, const Z0Snapshot_t* snapshot) {
+    if (!z0machine_isCurrent(machine))
+        return false;
+    if (snapshot == NULL || snapshot->machine != machine || snapshot->nCoroutines != coroutine_nAll) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to restore snapshot: it wasn't taken of this machine as it is built now\n");
+        return false;
+    }
+
+    memoryController_restoreSnapshot(snapshot->memory);
+    Z80_loadState(&snapshot->cpu);
+
+    Signal_t* all[NUMBER_OF_SIGNALS];
+    int nSignals = signals_all(all);
+    for (int i = 0; i < nSignals; i++) {
+        all[i]->state = snapshot->signalStates[i];
+        all[i]->pin = snapshot->signalPins[i];
+        all[i]->nWaiters = snapshot->signalWaiters[i];
+    }
+    signal_dataBus = snapshot->dataBus;
+    signal_addressBus = snapshot->addressBus;
+
+    memcpy(scheduler_events, snapshot->events, sizeof(scheduler_events));
+    scheduler_nEvents = snapshot->nEvents;
+    scheduler_posted = snapshot->posted;
+
+    oscillator_tStates = snapshot->oscillatorTStates;
+    clockState = snapshot->clockState;
+    for (int i = 0; i < coroutine_nAll; i++)
+        *coroutine_all[i] = snapshot->coroutines[i];
+    coroutine_edges = snapshot->edges;
+    coroutine_nextEdge = snapshot->nextEdge;
+
+    machine->owedTStates = snapshot->owedTStates;
+    return true;
+}
+
+/*
+Frees a snapshot. Must be called before its machine is destroyed
+*/
+void z0snapshot_destroy(Z0Snapshot_t* snapshot) {
+    if (snapshot == NULL)
+        return;
+    memoryController_destroySnapshot(snapshot->memory);
+    free(snapshot);
+}
+
+/*
+Forks the machine into 'nChildren' children. Each is passed to 'child' in turn, starting from the machine as it is now,
+and can run it however it likes. Between children only the pages the last one wrote are put back, so a child costs what it
+runs and little more. The machine is left as it was before the fork. Returns false if it couldn't be forked
+*/
+bool z0snapshot_fork(Z0Machine_t* machine, int nChildren, void (*child)(Z0Machine_t* machine, int index, void* context), void* context) {
+    Z0Snapshot_t* snapshot = z0snapshot_take(machine);
+    if (snapshot == NULL)
+        return false;
+
+    for (int i = 0; i < nChildren; i++) {
+        child(machine, i, context);
+        z0snapshot_restore(machine, snapshot);
+    }
+    z0snapshot_destroy(snapshot);
+    return true;
+}
+
+/********************************************************************
+
+    Z0Snapshot Check Functions
+
+********************************************************************/
+
+/*
+Hash of the address space, the registers but F, and the clocks. F is left out as it may still be pending
+*/
+uint64_t z0snapshot_fingerprint(Z0Machine_t* machine) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (uint32_t address = 0; address < 0x10000; address++)
+        hash = (hash ^ z0machine_readByte(machine, (uint16_t)address)) * 0x100000001B3ULL;
+
+    uint64_t state[] = { AF >> 8, BC, DE, HL, IX, IY, SP, PC, Z80_tStates, Z80_instructionsExecuted, oscillator_tStates };
+    for (int i = 0; i < (int)(sizeof(state) / sizeof(state[0])); i++)
+        hash = (hash ^ state[i]) * 0x100000001B3ULL;
+    return hash;
+}
+
+/*
+A fork child for the self-check: seeds the data the loop adds up with its index, runs on and records where it got to
+*/
+void z0snapshot_checkChild(Z0Machine_t* machine, int index, void* context) {
+    uint64_t* results = context;
+    z0machine_writeByte(machine, (uint16_t)(0x2000 + index * MEMORY_PAGE_SIZE), (uint8_t)(index + 1));
+    z0machine_run(machine, Z0_SNAPSHOT_CHECK_TSTATES);
+    results[index] = z0snapshot_fingerprint(machine);
+}
+
+/*
+Checks that a snapshot puts the machine back exactly, so running on from it again ends up in the same place, and that
+forking twice gives the same children and leaves the machine alone. Runs a loop that writes over 48 pages and adds up
+what it finds there, in whichever engine the machine was built with
+*/
+void z0snapshot_selfCheck(Z0Machine_t* machine) {
+    // LD HL,$1000 / loop: LD (HL),A / INC HL / INC A / ADD A,(HL) / BIT 6,H / JR Z,loop / LD HL,$1000 / JR loop
+    const uint8_t program[] = { 0x21, 0x00, 0x10, 0x77, 0x23, 0x3C, 0x86, 0xCB, 0x74, 0x28, 0xF8, 0x21, 0x00, 0x10, 0x18, 0xF3 };
+    uint64_t cases = 0;
+    uint64_t failures = 0;
+
+    if (memoryController_isUnmapped(0, 0x4000))
+        memoryController_createDevice(0, 0x4000, true, true);
+    z0machine_reset(machine);
+    for (int i = 0; i < (int)sizeof(program); i++)
+        z0machine_writeByte(machine, (uint16_t)i, program[i]);
+    z0machine_run(machine, Z0_SNAPSHOT_CHECK_TSTATES);
+
+    Z0Snapshot_t* snapshot = z0snapshot_take(machine);
+    if (snapshot == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Snapshot self-check failed: no snapshot\n");
+        return;
+    }
+    uint64_t taken = z0snapshot_fingerprint(machine);
+    z0machine_run(machine, Z0_SNAPSHOT_CHECK_TSTATES);
+    uint64_t ranOn = z0snapshot_fingerprint(machine);
+
+    // Back to the snapshot, and the same run from there
+    z0snapshot_restore(machine, snapshot);
+    cases++;
+    if (z0snapshot_fingerprint(machine) != taken) {
+        failures++;
+        formattedLog(debuglog, LOGTYPE_ERROR, "Snapshot self-check: the restored machine differs from the one snapshotted\n");
+    }
+    z0machine_run(machine, Z0_SNAPSHOT_CHECK_TSTATES);
+    cases++;
+    if (z0snapshot_fingerprint(machine) != ranOn) {
+        failures++;
+        formattedLog(debuglog, LOGTYPE_ERROR, "Snapshot self-check: running on from the snapshot went elsewhere\n");
+    }
+
+    // Two forks of the same machine make the same children, with the snapshot taken still held alongside
+    uint64_t first[Z0_SNAPSHOT_CHECK_CHILDREN];
+    uint64_t second[Z0_SNAPSHOT_CHECK_CHILDREN];
+    z0snapshot_fork(machine, Z0_SNAPSHOT_CHECK_CHILDREN, &z0snapshot_checkChild, first);
+    cases++;
+    if (z0snapshot_fingerprint(machine) != ranOn) {
+        failures++;
+        formattedLog(debuglog, LOGTYPE_ERROR, "Snapshot self-check: the fork didn't leave the machine as it was\n");
+    }
+    z0snapshot_fork(machine, Z0_SNAPSHOT_CHECK_CHILDREN, &z0snapshot_checkChild, second);
+    for (int i = 0; i < Z0_SNAPSHOT_CHECK_CHILDREN; i++) {
+        cases++;
+        if (first[i] != second[i]) {
+            failures++;
+            formattedLog(debuglog, LOGTYPE_ERROR, "Snapshot self-check: fork child %i ran differently the second time\n", i);
+        }
+    }
+
+    // And the first snapshot still puts the machine back after all that
+    z0snapshot_restore(machine, snapshot);
+    cases++;
+    if (z0snapshot_fingerprint(machine) != taken) {
+        failures++;
+        formattedLog(debuglog, LOGTYPE_ERROR, "Snapshot self-check: the snapshot changed while the machine was forked\n");
+    }
+    z0snapshot_destroy(snapshot);
+
+    // With no snapshots left every page writes direct again
+    cases++;
+    for (int page = 0; page < MEMORY_NUM_PAGES; page++) {
+        if (memoryController_cowPages[page]) {
+            failures++;
+            formattedLog(debuglog, LOGTYPE_ERROR, "Snapshot self-check: page %02X still shared with no snapshots\n", page);
+            break;
+        }
+    }
+
+    if (failures == 0) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Snapshot self-check passed: %llu cases, %llu pages copied\n", (unsigned long long)cases, (unsigned long long)memoryController_pagesCopied);
+    }
+    else {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Snapshot self-check failed: %llu of %llu cases\n", (unsigned long long)failures, (unsigned long long)cases);
+    }
+}
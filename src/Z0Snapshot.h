@@ -0,0 +1,83 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z0Snapshot.h : Snapshots of a whole machine, which it can be put back to any number of times, and forks of a running
+machine into children that each carry on from the same point. Memory is shared with the machine copy-on-write a page at a
+time, so taking a snapshot copies nothing and putting it back only writes the pages that have changed
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Z0Machine.h"
+#include "Signals.h"
+#include "Scheduler.h"
+#include "Coroutine.h"
+#include "Memory/MemoryController.h"
+#include "Z80/Z80.h"
+
+#define Z0_SNAPSHOT_CHECK_TSTATES 20000 // T-states run between the steps of z0snapshot_selfCheck()
+#define Z0_SNAPSHOT_CHECK_CHILDREN 4
+
+/* A machine as it was between two runs. I/O devices attached from outside keep their own state, and aren't included */
+typedef struct Z0Snapshot {
+    Z0Machine_t* machine;
+    MemorySnapshot_t* memory; // ALLOCATED: kept up to date by the memory controller until z0snapshot_destroy()
+    Z80State_t cpu;
+
+    // Signals. The listeners are the machine's, so only the levels are kept
+    bool signalStates[NUMBER_OF_SIGNALS];
+    bool signalPins[NUMBER_OF_SIGNALS];
+    uint8_t signalWaiters[NUMBER_OF_SIGNALS];
+    uint8_t dataBus;
+    uint16_t addressBus;
+
+    // Pending device events
+    SchedulerEvent_t events[MAX_NUMBER_OF_SCHEDULED_EVENTS];
+    uint8_t nEvents;
+    uint64_t posted;
+
+    // Edge engine clock and the device coroutines parked on it
+    uint64_t oscillatorTStates;
+    bool clockState;
+    Coroutine_t coroutines[MAX_NUMBER_OF_COROUTINES];
+    uint8_t nCoroutines;
+    uint64_t edges;
+    uint64_t nextEdge;
+
+    uint64_t owedTStates;
+} Z0Snapshot_t;
+
+/********************************************************************
+
+    Z0Snapshot Functions
+
+********************************************************************/
+
+Z0Snapshot_t* z0snapshot_take(Z0Machine_t* machine);
+bool z0snapshot_restore(Z0Machine_t* machine, const Z0Snapshot_t* snapshot);
+void z0snapshot_destroy(Z0Snapshot_t* snapshot);
+bool z0snapshot_fork(Z0Machine_t* machine, int nChildren, void (*child)(Z0Machine_t* machine, int index, void* context), void* context);
+
+/********************************************************************
+
+    Z0Snapshot Check Functions
+
+********************************************************************/
+
+uint64_t z0snapshot_fingerprint(Z0Machine_t* machine);
+void z0snapshot_checkChild(Z0Machine_t* machine, int index, void* context);
+void z0snapshot_selfCheck(Z0Machine_t* machine);
@@ -27,8 +27,29 @@ Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
 #include "SysIO/SysIO.h"
 #include "Z80/Z80Decomp.h"
 #include "Oscillator.h"
+#include "Scheduler.h"
+#include "Coroutine.h"
 #include "Util/StringUtil.h"
 #include "Video/VideoAdaptor.h"
+#include "Z80/Z80Step.h"
+#include "Z80/Z80DecodeCache.h"
+#include "Z80/Z80Block.h"
+#include "Z80/Z80Jit.h"
+#include "Z80/Z80Threaded.h"
+#include "Z80/Z80AluReference.h"
+#include "Z80/Z80Flags.h"
+#include "Z80/Z80Opcodes.h"
+#include "Z80/Z80Bus.h"
+#include "Z80/Z80Execute.h"
+#include "Z80/Z80Idle.h"
+#include "Z80/Z80Lockstep.h"
+#include "Z80/Z80Fusion.h"
+#include "Z80/Z80Refresh.h"
+#include "Z0Machine.h"
+#include "Z0Snapshot.h"
+#include "Batch.h"
+
+#include "SFML/System.h"
 
 #define MATCHARG(a, b) strcmp(argV[a], b) == 0
 
@@ -43,6 +64,12 @@ int state = Z0State_NONE; // The state we are currently executing in. Takes a va
 char* defaultCfg = "configuration.cfg"; // Default configuration file
 char* overrideCfg = NULL; // If this is non-NULL, we override the default CFG file
 
+/* Z0x50 batch runs */
+char* batchFile = NULL; // Jobs file, see Batch.h
+char* summaryFile = BATCH_DEFAULT_SUMMARY;
+int batchWorkers = 0; // 0 for one per hardware thread
+int batchLanes = 1; // Jobs run side by side in lockstep, 1 for none
+
 /* Z0x50 decompilation */
 char* decompFile = NULL;
 SysFile_t* decompilationFp = NULL;
@@ -52,12 +79,21 @@ char** argV;
 int argC;
 
 /* Test variables */
-bool clkV = false;
 int i = 0;
 
 /* Tracking variables */
 unsigned long long numOscillations = 0;
 
+/* The machine we run, and how it was asked for */
+Z0MachineOptions_t options = { 0 };
+Z0Machine_t* machine = NULL;
+
+/* Stepped run reporting */
+sfClock* runClock = NULL; // Measures the wall time of a stepped run
+double lastProgressSeconds = 0; // Wall time of the last turbo progress report
+uint64_t lastProgressTStates = 0; // Z80_tStates at the last turbo progress report
+uint64_t lastProgressMaterialisations = 0; // Z80Flags_materialisations at the last turbo progress report
+
 /********************************************************************
 
     Main Function
@@ -74,14 +110,9 @@ void Z0_main() {
         break;
 
     case Z0State_TEST:
-        // Rotate the clock signal 50 times
+        // Rotate the clock signal 50 times, through the oscillator so the CPU coroutine follows it
         if(i < 50) {
-            clkV = !clkV;
-            // printf("Clock now %i, iteration %i\n", clkV, i);
-            if (clkV)
-                signals_raiseSignal(&signal_CLCK);
-            else
-                signals_dropSignal(&signal_CLCK);
+            oscillator_toggle();
             i++;
         }
         else {
@@ -91,8 +122,15 @@ void Z0_main() {
         break;
 
     case Z0State_NORMAL:
+        // The machine cycle engine is the stepped engine with transactions switched on
+        if (Z80_engine != Z80Engine_Edge) {
+            Z0_runStepped();
+            break;
+        }
+
         if (numOscillations > 5000) {
             formattedLog(stdlog, LOGTYPE_MSG, "Z80 has reached termination\n");
+            Z0_reportEdge();
             state = Z0State_NONE;
             break;
         }
@@ -101,9 +139,11 @@ void Z0_main() {
             // Ask the oscillator to function
             if(oscillator_tick())
                 numOscillations++;
+            videoAdaptor_update();
         }
         else {
             formattedLog(stdlog, LOGTYPE_MSG, "Z80 has issued a termination request\n");
+            Z0_reportEdge();
             state = Z0State_NONE;
         }
         break;
@@ -115,6 +155,124 @@ void Z0_main() {
     }
 }
 
+/*
+Runs one slice of the instruction-stepped engine and reports on it
+*/
+void Z0_runStepped() {
+    if (z0machine_failed(machine)) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Z80 has issued a termination request\n");
+        Z0_reportStepped();
+        state = Z0State_NONE;
+        return;
+    }
+    if (z0machine_finished(machine)) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Z80 has reached termination\n");
+        Z0_reportStepped();
+        state = Z0State_NONE;
+        return;
+    }
+
+    z0machine_runSlice(machine);
+
+    // In turbo mode report the emulated speed about once a second
+    if (machine->turbo) {
+        double seconds = sfTime_asSeconds(sfClock_getElapsedTime(runClock));
+        if (seconds - lastProgressSeconds >= 1.0) {
+            double interval = seconds - lastProgressSeconds;
+            double mhz = (Z80_tStates - lastProgressTStates) / interval / 1000000.0;
+            double materialisations = (Z80Flags_materialisations - lastProgressMaterialisations) / interval;
+            formattedLog(stdlog, LOGTYPE_MSG, "Emulated speed: %f MHz, %.0f flag materialisations/s\n", mhz, materialisations);
+            lastProgressSeconds = seconds;
+            lastProgressTStates = Z80_tStates;
+            lastProgressMaterialisations = Z80Flags_materialisations;
+        }
+    }
+
+    videoAdaptor_update();
+}
+
+/*
+Keeps the window serviced while the edge engine catches up on a long run of edges. It repeats for the whole run
+*/
+void Z0_uiEvent(uint64_t tState) {
+    videoAdaptor_update();
+    scheduler_post(tState + Z0_UI_EVENT_TSTATES, &Z0_uiEvent);
+}
+
+/*
+Logs the totals of an edge engine run
+*/
+void Z0_reportEdge() {
+    formattedLog(stdlog, LOGTYPE_MSG, "Edge run: %llu T-states, %llu clock edges, %llu with a device coroutine due (%llu resumes)\n", (unsigned long long)oscillator_tStates, (unsigned long long)coroutine_edges,
+        (unsigned long long)coroutine_dueEdges, (unsigned long long)coroutine_resumes);
+}
+
+/*
+Logs the totals of a stepped run
+*/
+void Z0_reportStepped() {
+    double seconds = sfTime_asSeconds(sfClock_getElapsedTime(runClock));
+    formattedLog(stdlog, LOGTYPE_MSG, "Stepped run: %llu T-states, %llu instructions in %f seconds\n", (unsigned long long)Z80_tStates, (unsigned long long)Z80_instructionsExecuted, seconds);
+    if (seconds > 0) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Emulated speed: %f MHz, %f MIPS\n", Z80_tStates / seconds / 1000000.0, Z80_instructionsExecuted / seconds / 1000000.0);
+        formattedLog(stdlog, LOGTYPE_MSG, "Flags materialised %llu times (%.0f/s, %f per instruction)\n", (unsigned long long)Z80Flags_materialisations, Z80Flags_materialisations / seconds,
+            Z80_instructionsExecuted > 0 ? (double)Z80Flags_materialisations / Z80_instructionsExecuted : 0.0);
+    }
+    if (Z80Bus_enabled) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Bus: %llu machine cycle transactions (%f per instruction, %.0f/s)\n", (unsigned long long)Z80Bus_transactions,
+            Z80_instructionsExecuted > 0 ? (double)Z80Bus_transactions / Z80_instructionsExecuted : 0.0, seconds > 0 ? Z80Bus_transactions / seconds : 0.0);
+    }
+    if (Z80Block_enabled) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Block cache: %llu blocks built (%f ops each), %llu entries, %llu chained, %llu invalidations, %llu flushes\n", (unsigned long long)Z80Block_built,
+            Z80Block_built > 0 ? (double)Z80Block_opsBuilt / Z80Block_built : 0.0, (unsigned long long)Z80Block_entries, (unsigned long long)Z80Block_chainedEntries, (unsigned long long)Z80Block_invalidations, (unsigned long long)Z80Block_flushes);
+    }
+    if (Z80_bulkEnabled) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Bulk block instructions: %llu runs, %llu iterations (%.2f%% of instructions)\n", (unsigned long long)Z80_bulkRuns, (unsigned long long)Z80_bulkIterations,
+            Z80_instructionsExecuted > 0 ? 100.0 * Z80_bulkIterations / Z80_instructionsExecuted : 0.0);
+    }
+    formattedLog(stdlog, LOGTYPE_MSG, "Scheduler: %llu events posted, %llu fired, %u pending\n", (unsigned long long)scheduler_posted, (unsigned long long)scheduler_fired, scheduler_nEvents);
+    if (Z80_haltSkipEnabled) {
+        formattedLog(stdlog, LOGTYPE_MSG, "HALT skip: %llu re-executions, %llu T-states (%.2f%% of T-states)\n", (unsigned long long)Z80_haltSkipped, (unsigned long long)Z80_haltSkippedTStates,
+            Z80_tStates > 0 ? 100.0 * Z80_haltSkippedTStates / Z80_tStates : 0.0);
+    }
+    if (Z80Idle_enabled) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Idle loops: %llu skips, %llu iterations, %llu T-states (%.2f%% of T-states)\n", (unsigned long long)Z80Idle_skips, (unsigned long long)Z80Idle_iterations, (unsigned long long)Z80Idle_tStates,
+            Z80_tStates > 0 ? 100.0 * Z80Idle_tStates / Z80_tStates : 0.0);
+        for (int i = 0; i < Z80Idle_nLoops; i++) {
+            formattedLog(stdlog, LOGTYPE_MSG, "    Loop at %04X: %llu skips, %llu iterations, %llu T-states\n", Z80Idle_loops[i].pc, (unsigned long long)Z80Idle_loops[i].skips,
+                (unsigned long long)Z80Idle_loops[i].iterations, (unsigned long long)Z80Idle_loops[i].tStates);
+        }
+    }
+    if (Z80Threaded_ops != NULL) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Threaded ROM: %llu instructions (%.2f%% of instructions)\n", (unsigned long long)Z80Threaded_instructions,
+            Z80_instructionsExecuted > 0 ? 100.0 * Z80Threaded_instructions / Z80_instructionsExecuted : 0.0);
+    }
+    if (Z80Jit_enabled) {
+        formattedLog(stdlog, LOGTYPE_MSG, "JIT: %llu blocks compiled (%llu ops inlined, %zu bytes in use, %llu arena resets), %llu native entries running %llu ops (%.2f%% of instructions)\n",
+            (unsigned long long)Z80Jit_compiled, (unsigned long long)Z80Jit_inlinedOps, Z80Jit_arenaUsed, (unsigned long long)Z80Jit_arenaResets, (unsigned long long)Z80Jit_nativeEntries, (unsigned long long)Z80Jit_nativeOps,
+            Z80_instructionsExecuted > 0 ? 100.0 * Z80Jit_nativeOps / Z80_instructionsExecuted : 0.0);
+    }
+    if (Z80Fusion_enabled && (Z80Block_enabled || Z80Threaded_ops != NULL)) {
+        uint64_t fusedRuns, fusedInstructions;
+        Z80Fusion_totals(&fusedRuns, &fusedInstructions);
+        formattedLog(stdlog, LOGTYPE_MSG, "Fusion: %llu runs, %llu instructions (%.2f%% of instructions)\n", (unsigned long long)fusedRuns, (unsigned long long)fusedInstructions,
+            Z80_instructionsExecuted > 0 ? 100.0 * fusedInstructions / Z80_instructionsExecuted : 0.0);
+        for (int i = 0; i < Z80Fusion_nPatterns; i++) {
+            formattedLog(stdlog, LOGTYPE_MSG, "    %s: %llu runs\n", Z80Fusion_patterns[i].mnemonic, (unsigned long long)Z80Fusion_patternRuns[i]);
+        }
+    }
+    if (Z80Fusion_profiling)
+        Z80Fusion_logProfile();
+    if (Z80Refresh_enabled) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Refresh INT: %llu edges, %llu checks (%llu before the edge), %llu writes to R (%llu watched to the end of the slice)\n",
+            (unsigned long long)Z80Refresh_edges, (unsigned long long)Z80Refresh_checks, (unsigned long long)Z80Refresh_early, (unsigned long long)Z80Refresh_writes, (unsigned long long)Z80Refresh_watches);
+    }
+    if (!Z80Block_enabled && Z80DecodeCache_enabled) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Decode cache: %llu hits, %llu misses (%.2f%% hit rate), %llu invalidations\n", (unsigned long long)Z80DecodeCache_hits, (unsigned long long)Z80DecodeCache_misses,
+            Z80DecodeCache_hitRate() * 100.0, (unsigned long long)Z80DecodeCache_invalidations);
+    }
+}
+
 /********************************************************************
 
     Initialisation Functions
@@ -123,13 +281,15 @@ void Z0_main() {
 
 // Initialisation of the system from the arguments and CFG
 void Z0_initSystem() {
-    // Init the memory
-    memoryController_init();
-    // Init the Z80
-    Z80_init();
-
-    // Init the oscillator
-    oscillator_init();
+    // Decompilation and the self-checks only need the CPU
+    options.bare = state == Z0State_DECOMPILE || state == Z0State_TEST;
+    machine = z0machine_create(&options);
+    if (machine == NULL) {
+        state = Z0State_NONE;
+        return;
+    }
+    if (Z80_engine == Z80Engine_Edge)
+        scheduler_postIn(Z0_UI_EVENT_TSTATES, &Z0_uiEvent);
 
     // Do a switch for init here
     switch (state) {
@@ -163,13 +323,16 @@ void Z0_initSystem() {
         // Display the AllStats UI
         videoAdaptor_setUIScreen(&videoAdaptor_screenAllStats);
 
-        // Load memory devices here
-        Z0_loadMemoryDevices();
+        runClock = sfClock_create();
+        break;
 
-        // Load the bios ROM
-        if (!Z0_loadBiosROM())
-            break;
-        // state = Z0State_NONE;
+    case Z0State_TEST: // Self-checks, before clocking the CPU
+        Z80Alu_selfCheck(); // Table driven ALU against its reference
+        Z80Opcodes_selfCheck(); // Opcode tables against themselves
+        Z80Fusion_selfCheck(); // Fused handlers against their ops one at a time
+        Z80Lockstep_selfCheck(); // Lockstep lanes against the ALU
+        Z80Refresh_selfCheck(); // Refresh INT prediction against stepping R
+        z0snapshot_selfCheck(machine); // Snapshots against running straight on
         break;
 
     default:
@@ -178,108 +341,6 @@ void Z0_initSystem() {
     }
 }
 
-bool Z0_loadBiosROM() {
-    // Load the ROM file specified by the settings
-        // This is a required step: we fail if it can't be done
-    if (!cfgReader_querySettingExist("bios_rom")) {
-        formattedLog(stdlog, LOGTYPE_ERROR, "Cfg file missing 'bios_rom' setting, unable to load\n");
-        state = Z0State_NONE;
-        return false;
-    }
-    char* biosRomFilePath = cfgReader_querySettingValueStr("bios_rom");
-    SysFile_t* biosRomFile = sysIO_openFile(biosRomFilePath);
-    if (biosRomFile == NULL) {
-        formattedLog(stdlog, LOGTYPE_ERROR, "BIOS ROM file error: unable to find file '%s'\n", biosRomFilePath);
-        state = Z0State_NONE;
-        return false;
-    }
-
-    // Cache the file
-    sysIO_cacheFile(biosRomFile);
-    if (!biosRomFile->cached) {
-        formattedLog(stdlog, LOGTYPE_ERROR, "BIOS ROM file '%s' could not be cached\n", biosRomFilePath);
-        state = Z0State_NONE;
-        return false;
-    }
-
-    // Load the file into memory now, at position 0 by default
-    uint16_t romAddress = 0;
-    formattedLog(stdlog, LOGTYPE_MSG, "Loading BIOS ROM file '%s' into address ", biosRomFilePath);
-    if (cfgReader_querySettingExist("bios_address")) {
-        romAddress = cfgReader_querySettingValueInt("bios_address");
-    }
-    directLog(stdlog, "%04X\n", romAddress);
-
-    // We need to drive the signal_addressBus and signal_dataBus with the appropriate values as we scan through the data
-    // To allow writing, we need to put signal_MREQ and signal_WR high to make the controller write on the memoryController_onCLCK(true) trigger
-    signals_raiseSignal(&signal_MREQ);
-    signals_raiseSignal(&signal_WR);
-
-    // Do the writing
-    formattedLog(debuglog, LOGTYPE_DEBUG, "Writing BIOS ROM file to memory. Bytes to write: %04X\n", biosRomFile->size);
-    formattedLog(stdlog, LOGTYPE_MSG, "Writing BIOS ROM file to memory. Bytes to write: %04X\n", biosRomFile->size);
-
-    signal_addressBus = romAddress;
-    for (uint16_t i = 0; i < biosRomFile->size; i++) {
-        // Put the data on the bus
-        signal_addressBus = i + romAddress;
-        signal_dataBus = biosRomFile->data[i];
-
-        // Trigger the write
-        memoryController_onCLCK(true);
-    }
-    directLog(debuglog, "\n");
-    formattedLog(debuglog, LOGTYPE_DEBUG, "BIOS ROM file write complete\n");
-    formattedLog(stdlog, LOGTYPE_MSG, "BIOS ROM file write complete\n");
-
-    // Clean up the signals
-    signals_dropSignal(&signal_MREQ);
-    signals_dropSignal(&signal_WR);
-
-    sysIO_closeFile(biosRomFile);
-    return true;
-}
-
-void Z0_loadMemoryDevices() {
-    formattedLog(debuglog, LOGTYPE_DEBUG, "Memory device configuation\n");
-
-    for (int i = 0; i < MAX_NUMBER_OF_MEMORIES; i++) {
-        // Generate the matcher string we look for as a setting
-        char prefix[50] = "memdev";
-        char* matcher = prefix;
-        char number[3];
-        _itoa(i, number, 10);
-        strcat(matcher, number);
-        directLog(debuglog, "Looking for memory device '%s' definition...\n", matcher);
-
-        if (cfgReader_querySettingExist(matcher)) {
-            // We have the definition, but we must check it to be sure
-            char* rawVal = cfgReader_querySettingValueStr(matcher);
-            int buffLen = (int)strlen(rawVal) + 1;
-            char* buff = calloc(buffLen, sizeof(char));
-            if (buff == NULL) {
-                // We fail!
-                formattedLog(stdlog, LOGTYPE_WARN, "Detected setting for '%s' but failed to allocate memory for buffer\n", matcher);
-            }
-
-            memcpy(buff, rawVal, buffLen); // Copy the null char too
-            char* splits[8];
-            int splitsMade = sutil_split(buff, buffLen, splits, 8, ",");
-            if (splitsMade == 4) {
-                // We are valid!
-                formattedLog(stdlog, LOGTYPE_MSG, "Detected setting for '%s'\n", matcher);
-                // Time to configure the memory device
-                memoryController_createDevice(atoi(splits[0]), atoi(splits[1]), atoi(splits[2]), atoi(splits[3]));
-            }
-            else {
-                formattedLog(stdlog, LOGTYPE_WARN, "Detected setting for '%s', but it was of the incorrect format. Had %i elements.\n", matcher, splitsMade);
-            }
-
-            free(buff);
-        }
-    }
-}
-
 // Argument parsing function. Modifies var Z0_State
 void Z0_parseArguments() {
     // If argc == 1, we don't have any arguments. Return
@@ -299,11 +360,48 @@ void Z0_parseArguments() {
             // Set the state
             state = Z0State_TEST;
         }
+        if (MATCHARG(i, "-B") && i < (argC - 1)) { // Batch mode switch, runs the jobs listed in the next arg without a window
+            formattedLog(stdlog, LOGTYPE_MSG, "Set state: BATCH\n");
+            state = Z0State_BATCH;
+            batchFile = argV[++i];
+        }
+        if (MATCHARG(i, "-j") && i < (argC - 1)) { // Worker threads for batch mode
+            batchWorkers = atoi(argV[++i]);
+            formattedLog(stdlog, LOGTYPE_MSG, "Set batch workers: %i\n", batchWorkers);
+        }
+        if (MATCHARG(i, "-L") && i < (argC - 1)) { // Jobs each batch worker runs in lockstep
+            batchLanes = atoi(argV[++i]);
+            formattedLog(stdlog, LOGTYPE_MSG, "Set batch lanes: %i\n", batchLanes);
+        }
+        if (MATCHARG(i, "-S") && i < (argC - 1)) { // Summary file for batch mode
+            summaryFile = argV[++i];
+            formattedLog(stdlog, LOGTYPE_MSG, "Set batch summary: %s\n", summaryFile);
+        }
         if (MATCHARG(i, "-c") && i < (argC - 1)){ // CFG select switch, only triggers if there is at least one more argument
             // Set the CFG
             overrideCfg = argV[++i];
             formattedLog(stdlog, LOGTYPE_MSG, "Set CFG: %s\n", overrideCfg);
         }
+        if (MATCHARG(i, "-e") && i < (argC - 1)) { // Z80 engine select switch
+            options.engine = argV[++i];
+            formattedLog(stdlog, LOGTYPE_MSG, "Set engine: %s\n", options.engine);
+        }
+        if (MATCHARG(i, "-t")) { // Turbo switch, runs the stepped engine unthrottled
+            options.turbo = true;
+            formattedLog(stdlog, LOGTYPE_MSG, "Set turbo\n");
+        }
+        if (MATCHARG(i, "-J")) { // Switches the JIT off, so results can be checked against the interpreter
+            options.jitOff = true;
+            formattedLog(stdlog, LOGTYPE_MSG, "Set JIT off\n");
+        }
+        if (MATCHARG(i, "-F")) { // Profiles the instruction pairs and triples run, for choosing the fused patterns
+            options.fusionProfile = true;
+            formattedLog(stdlog, LOGTYPE_MSG, "Set fusion profile\n");
+        }
+        if (MATCHARG(i, "-n") && i < (argC - 1)) { // T-state limit for the stepped engine
+            options.runTStates = strtoull(argV[++i], NULL, 10);
+            formattedLog(stdlog, LOGTYPE_MSG, "Set run limit: %llu T-states\n", (unsigned long long)options.runTStates);
+        }
     }
 
 }
@@ -336,11 +434,19 @@ int main(int argc, char* argv[]) {
     state = Z0State_NORMAL;
     Z0_parseArguments();
 
-    // Parse cfg
-    formattedLog(stdlog, LOGTYPE_MSG, "Parsing CFG\n");
+    // The machine reads the cfg when it is created
     if (overrideCfg == NULL)
         overrideCfg = defaultCfg;
-    cfgReader_readConfiguration(overrideCfg);
+    options.cfgPath = overrideCfg;
+
+    if (state == Z0State_BATCH) {
+        // Batch runs are headless, every job's machine is built by a worker thread
+        batch_run(batchFile, summaryFile, batchWorkers, batchLanes, &options);
+
+        formattedLog(stdlog, LOGTYPE_MSG, "Exiting\n");
+        log_closeLogFiles();
+        return 0;
+    }
 
     if (!videoAdaptor_initialise()) {
         formattedLog(stdlog, LOGTYPE_ERROR, "Unable to continue: failed to initialise video adaptor\n");
@@ -359,7 +465,7 @@ int main(int argc, char* argv[]) {
     }
 
     while (closeRequested == false) {
-        videoAdaptor_onCLCK(true);
+        videoAdaptor_update();
     }
 
     videoAdaptor_destroy();
@@ -371,8 +477,14 @@ int main(int argc, char* argv[]) {
         decompilationFp = NULL;
     }
 
-    // Clean up the settings
-    cfgReader_cleanSettings();
+    // Tear the machine down, which also cleans up the settings
+    if (machine) {
+        z0machine_destroy(machine);
+        machine = NULL;
+    }
+
+    if (runClock)
+        sfClock_destroy(runClock);
 
     // Close
     log_closeLogFiles();
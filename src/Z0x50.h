@@ -15,7 +15,12 @@ Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
 
 */
 
-enum Z0StateEnum { Z0State_NONE, Z0State_NORMAL, Z0State_DECOMPILE, Z0State_TEST }; // Our possible states we can execute in
+#include <stdint.h>
+#include <stdbool.h>
+
+enum Z0StateEnum { Z0State_NONE, Z0State_NORMAL, Z0State_DECOMPILE, Z0State_TEST, Z0State_BATCH }; // Our possible states we can execute in
+
+#define Z0_UI_EVENT_TSTATES 10000 // T-states between UI updates inside one oscillator_tick() of the edge engine
 
 /* CONSTS */
 extern const char* ASCII_headerArt;
@@ -30,5 +35,8 @@ extern int argC;
 
 /* Z0x50 function predeclarations */
 void Z0_parseArguments();
-bool Z0_loadBiosROM();
-void Z0_loadMemoryDevices();
+void Z0_runStepped();
+void Z0_reportStepped();
+void Z0_reportEdge();
+void Z0_uiEvent(uint64_t tState);
+void Z0_initSystem();
@@ -18,8 +18,21 @@ Z80.c : Z80 CPU component
 #include "Z80.h"
 #include "Z80Flags.h"
 #include "Z80Instructions.h"
+#include "Z80Execute.h"
+#include "Z80Opcodes.h"
+#include "Z80Alu.h"
+#include "Z80DecodeCache.h"
+#include "Z80Block.h"
+#include "Z80Jit.h"
+#include "Z80Threaded.h"
+#include "Z80Bus.h"
+#include "Z80Idle.h"
+#include "Z80Fusion.h"
+#include "Z80Refresh.h"
+#include "Z80Step.h"
 
 #include "../Signals.h"
+#include "../Oscillator.h"
 #include "../SysIO/Log.h"
 #include "../Video/VideoAdaptor.h"
 
@@ -31,44 +44,38 @@ Z80.c : Z80 CPU component
 
 ********************************************************************/
 
-/* General Registers */
-uint16_t AF = 0;
-uint16_t BC = 0;
-uint16_t DE = 0;
-uint16_t HL = 0;
-
-/* Alternate General Registers */
-uint16_t AFPrime = 0;
-uint16_t BCPrime = 0;
-uint16_t DEPrime = 0;
-uint16_t HLPrime = 0;
-
-/* Special Registers */
-uint16_t IVMR = 0;
-uint16_t IX = 0;
-uint16_t IY = 0;
-uint16_t SP = 0;
-uint16_t PC = 0;
+/* Registers */
+Z0_MACHINE_LOCAL Z80_CACHE_ALIGNED Z80Registers_t Z80_registers = { 0 };
+
+/* Interrupt State */
+Z0_MACHINE_LOCAL bool IFF1 = false; // Interrupts are accepted while set
+Z0_MACHINE_LOCAL bool IFF2 = false; // Holds IFF1 across an NMI
+Z0_MACHINE_LOCAL int interruptMode = 0; // IM 0, 1 or 2
+Z0_MACHINE_LOCAL bool halted = false; // Set by HALT until an interrupt is accepted
+Z0_MACHINE_LOCAL bool eiPending = false; // Set by EI so no interrupt is accepted before the next instruction
+Z0_MACHINE_LOCAL bool nmiPending = false; // Latched on the edge of signal_NMI
 
 /* Z80 Instruction */
-Z80_Instr_t cInstr; // The current instruction we are processing
+Z0_MACHINE_LOCAL Z80_Instr_t cInstr; // The current instruction we are processing
 
 /* Z80 Internal State Variables */
-int internalState = Z80State_Fetch; // The broad state we are in
-bool wait = false; // If true, the CPU stops at its current step and doesn't advance
-int microcodeState = 0; // Used by instruction functions to control their internal affairs
+Z0_MACHINE_LOCAL int internalState = Z80State_Fetch; // The broad state we are in
+Z0_MACHINE_LOCAL bool Z80_wait = false; // If true, the CPU stops at its current step and doesn't advance
+Z0_MACHINE_LOCAL int microcodeState = 0; // Used by instruction functions to control their internal affairs
 int Z80_state() { return internalState; }
 
+/* Z80 Engine */
+Z0_MACHINE_LOCAL int Z80_engine = Z80Engine_Edge; // Takes a value of Z80EngineEnum. Must be chosen before Z80_init()
+
 /* Data Movement Variables */
-uint16_t addressBusLatch = 0; // This value is pushed to the address bus during the start of memory read and write cycles. Needs to be preloaded
-uint8_t* internalDataBus = NULL; // This is a pointer to where the data we read/write goes to/comes from when doing memory read and write cycles
+Z0_MACHINE_LOCAL uint16_t addressBusLatch = 0; // This value is pushed to the address bus during the start of memory read and write cycles. Needs to be preloaded
+Z0_MACHINE_LOCAL uint8_t* internalDataBus = NULL; // This is a pointer to where the data we read/write goes to/comes from when doing memory read and write cycles
 
-/* Clock timing pointers */
-void (*onNextRisingCLCK)() = NULL; // If non-NULL, called on next rising clock edge. Set to NULL before call
-void (*onNextFallingCLCK)() = NULL; // If non-NULL, called on next falling clock edge. Set to NULL before call
+/* Machine cycles under the edge engine, resumed only on the clock edges the CPU has something to do on */
+Z0_MACHINE_LOCAL Coroutine_t Z80_coroutine;
 
-/* Next M cycle return pointer */
-void (*onFinishMCycle)() = NULL;
+/* Waits 'edges' clock edges, then on by whole clock periods while WAIT holds the CPU, so the next step keeps to its edge */
+#define Z80_WAIT_EDGES(co, edges) do { uint64_t n = (edges); do { COROUTINE_WAIT_EDGES((co), n); n = 2; } while (Z80_wait); } while (0)
 
 /********************************************************************
 
@@ -77,15 +84,15 @@ void (*onFinishMCycle)() = NULL;
 ********************************************************************/
 
 void Z80Flags_setFlag(int f) {
-    uint8_t lower = REG_LOWER(AF) | (0b00000001 << f);
-    AF = (AF & 0xF0) | lower;
+    Z80FLAGS_SYNC();
+    AF |= (0b00000001 << f);
 }
 void Z80Flags_clearFlag(int f) {
-    uint8_t lower = REG_LOWER(AF) | (~(0b00000001 << f));
-    AF = (AF & 0xF0) | lower;
+    Z80FLAGS_SYNC();
+    AF &= ~(0b00000001 << f);
 }
 bool Z80Flags_readFlag(int f) {
-    return (REG_LOWER(AF) & (0b00000001 << f)) == 1;
+    return (Z80FLAGS_READ() & (0b00000001 << f)) != 0;
 }
 
 /********************************************************************
@@ -98,29 +105,147 @@ bool Z80Flags_readFlag(int f) {
 void Z80_init() {
     internalState = Z80State_Fetch;
 
+    // Build the ALU flag tables
+    Z80Alu_init();
+
+    // Only the stepped engine decodes from the caches
+    if (Z80_engine == Z80Engine_Step) {
+        Z80DecodeCache_init();
+        Z80Block_init();
+        Z80Jit_init();
+        Z80Fusion_init();
+    }
+
     // Firstly connect the signals
     Z80_initSignals();
 
-    // Lastly, connect the first function on the rising clock edge (the fetch T1Rising function)
-    onNextRisingCLCK = &Z80_fetchCycleStart;
+    // Lastly, start the machine cycles. The stepped engine is driven directly, so it doesn't follow the clock
+    if (Z80_engine == Z80Engine_Edge)
+        coroutine_start(&Z80_coroutine, &Z80_run);
+}
+
+/*
+Resets the CPU as the RESET pin does: every register to 0, interrupts off in mode 0, and the next clock starts a fetch.
+The T-state and instruction counts carry on, so device events timed against them stay in order
+*/
+void Z80_reset() {
+    Z80_registers = (Z80Registers_t){ 0 };
+    Z80Flags_lazy = (Z80LazyFlags_t){ Z80LazyFlags_None, 0, 0, 0, 0 };
+    IFF1 = false;
+    IFF2 = false;
+    interruptMode = 0;
+    halted = false;
+    eiPending = false;
+    nmiPending = false;
+
+    cInstr = instructions_NULLInstr;
+    internalState = Z80State_Fetch;
+    Z80_wait = false;
+    microcodeState = 0;
+    addressBusLatch = 0;
+    internalDataBus = NULL;
+    // Fetch again from the next rising clock edge
+    coroutine_restart(&Z80_coroutine);
+}
+
+/*
+Frees the caches and puts the CPU and its counters back as they were before Z80_init(), ready for another machine
+*/
+void Z80_destroy() {
+    Z80Jit_destroy();
+    Z80Block_destroy();
+    Z80DecodeCache_destroy();
+    Z80Threaded_destroy();
+    Z80Bus_destroy();
+    Z80Idle_destroy();
+    Z80Fusion_destroy();
+    Z80Refresh_destroy();
+    Z80_reset();
+
+    Z80_engine = Z80Engine_Edge;
+    Z80_tStates = 0;
+    Z80_instructionsExecuted = 0;
+    Z80_tStateDeadline = 0;
+    Z80Flags_materialisations = 0;
+    Z80_writes = 0;
+    Z80_refreshReads = 0;
+    Z80_bulkEnabled = true;
+    Z80_bulkRuns = 0;
+    Z80_bulkIterations = 0;
+    Z80_haltSkipEnabled = true;
+    Z80_haltSkipped = 0;
+    Z80_haltSkippedTStates = 0;
+}
+
+/*
+Copies out the CPU state, as between two instructions under the stepped engines or two clock edges under the edge engine
+*/
+void Z80_saveState(Z80State_t* state) {
+    state->registers = Z80_registers;
+    state->lazy = Z80Flags_lazy;
+    state->iff1 = IFF1;
+    state->iff2 = IFF2;
+    state->halted = halted;
+    state->eiPending = eiPending;
+    state->nmiPending = nmiPending;
+    state->interruptMode = interruptMode;
+
+    state->cInstr = cInstr;
+    state->internalState = internalState;
+    state->wait = Z80_wait;
+    state->microcodeState = microcodeState;
+    state->addressBusLatch = addressBusLatch;
+    state->internalDataBus = internalDataBus;
+
+    state->tStates = Z80_tStates;
+    state->instructionsExecuted = Z80_instructionsExecuted;
+    state->tStateDeadline = Z80_tStateDeadline;
+    state->writes = Z80_writes;
+    state->refreshReads = Z80_refreshReads;
+    state->idleHead = Z80Idle_head;
+    state->refreshWatching = Z80Refresh_watching;
+}
+
+/*
+Puts back a state copied out by Z80_saveState() on this machine. The data bus pointer is into the CPU's own state, so it
+stays good
+*/
+void Z80_loadState(const Z80State_t* state) {
+    Z80_registers = state->registers;
+    Z80Flags_lazy = state->lazy;
+    IFF1 = state->iff1;
+    IFF2 = state->iff2;
+    halted = state->halted;
+    eiPending = state->eiPending;
+    nmiPending = state->nmiPending;
+    interruptMode = state->interruptMode;
+
+    cInstr = state->cInstr;
+    internalState = state->internalState;
+    Z80_wait = state->wait;
+    microcodeState = state->microcodeState;
+    addressBusLatch = state->addressBusLatch;
+    internalDataBus = state->internalDataBus;
+
+    Z80_tStates = state->tStates;
+    Z80_instructionsExecuted = state->instructionsExecuted;
+    Z80_tStateDeadline = state->tStateDeadline;
+    Z80_writes = state->writes;
+    Z80_refreshReads = state->refreshReads;
+    Z80Idle_head = state->idleHead;
+    Z80Refresh_watching = state->refreshWatching;
 }
 
 void Z80_initSignals() {
-    // Add the clock listener
-    signals_addListener(&signal_CLCK, &Z80_signalCLCKListener);
     // Add the wait listener
     signals_addListener(&signal_WAIT, &Z80_signalWAITListener);
+    // Add the NMI listener, the NMI is edge triggered so it is latched here
+    signals_addListener(&signal_NMI, &Z80_signalNMIListener);
 
     // Connect the video adaptor hooks
-    displayInfo.AFReg = &AF;
-    displayInfo.BCReg = &BC;
-    displayInfo.DEReg = &DE;
-    displayInfo.HLReg = &HL;
-    displayInfo.IX = &IX;
-    displayInfo.IY = &IY;
-    displayInfo.SP = &SP;
-    displayInfo.PC = &PC;
+    displayInfo.registers = &Z80_registers;
     displayInfo.cInstr = &cInstr;
+    displayInfo.syncRegisters = &Z80Flags_materialise;
 }
 
 /********************************************************************
@@ -129,47 +254,97 @@ void Z80_initSignals() {
 
 ********************************************************************/
 
-void Z80_signalCLCKListener(bool rising) {
-    // If waiting, just ignore the CLCK for now
-    if (wait || internalState == Z80State_Failure)
-        return;
+void Z80_signalWAITListener(bool rising) {
+    Z80_wait = rising; // Just directly set the wait variable
+}
 
-    // Complete a clock tick
-    void (*func)() = NULL;
-    if (rising) {
-        // Check if we have a rising clck function to do
-        if (onNextRisingCLCK != NULL) {
-            func = onNextRisingCLCK; // Transfer the pointer
-            onNextRisingCLCK = NULL; // NULL out the pointer
-        }
-    }
-    else {
-        if (onNextFallingCLCK != NULL) {
-            func = onNextFallingCLCK; // Transfer the pointer
-            onNextFallingCLCK = NULL; // NULL out the pointer
+void Z80_signalNMIListener(bool rising) {
+    if (rising)
+        nmiPending = true;
+}
+
+/********************************************************************
+
+    Z80 Machine Cycle Functions
+
+********************************************************************/
+
+/*
+Coroutine body for the edge engine. Runs the machine cycles of each instruction in turn, resumed only on the clock edges
+a step falls on, and stops for good if the processor fails. Z80_reset() starts it over
+*/
+void Z80_run(Coroutine_t* co) {
+    COROUTINE_BEGIN(co);
+    // The first fetch starts on the next rising edge
+    Z80_WAIT_EDGES(co, clockState ? 2 : 1);
+    while (true) {
+        // M1, the opcode fetch and decode
+        Z80_M1T1Rise();
+        if (internalState == Z80State_Failure)
+            break;
+        Z80_WAIT_EDGES(co, 1);
+        Z80_M1T1Fall();
+        Z80_WAIT_EDGES(co, 2);
+        Z80_M1T2Fall();
+        Z80_WAIT_EDGES(co, 1);
+        Z80_M1T3Rise();
+        Z80_WAIT_EDGES(co, 2);
+
+        // Execute or set up a read on the rising edge of M1T4, then raise MREQ on its falling edge
+        Z80_decodeBranchDecision();
+        if (internalState == Z80State_Failure)
+            break;
+        Z80_WAIT_EDGES(co, 1);
+        Z80_M1T4Fall();
+        Z80_WAIT_EDGES(co, 1);
+
+        // Memory read cycles for prefixed opcodes, DDCB / FDCB displacements and operands, each ending on a rising edge
+        while (internalState == Z80State_Decode) {
+            Z80_memReadT1Rise();
+            Z80_WAIT_EDGES(co, 1);
+            Z80_memReadT1Fall();
+            Z80_WAIT_EDGES(co, 1);
+            Z80_memReadT2Rise();
+            Z80_WAIT_EDGES(co, 1);
+            Z80_memReadT2Fall();
+            Z80_WAIT_EDGES(co, 1);
+
+            if (!cInstr.detectedPrefix) {
+                // An operand. Read the next, or execute
+                if (cInstr.numOperandsToRead > 0)
+                    Z80_prepReadOperands();
+                else
+                    Z80_executeInstruction();
+                if (internalState == Z80State_Failure)
+                    break;
+                Z80_WAIT_EDGES(co, 2);
+            }
+            else if (internalDataBus == &cInstr.operand1) {
+                // A displacement, whose opcode is read straight after
+                Z80_prepIndexedBitOpcodeRead();
+            }
+            else {
+                // A prefixed opcode, decoded now and acted on at the next rising edge
+                Z80_finalisePrefixedInstructionRead();
+                Z80_WAIT_EDGES(co, 2);
+                Z80_decodeBranchDecision();
+                if (internalState == Z80State_Failure)
+                    break;
+                Z80_WAIT_EDGES(co, 2);
+            }
         }
-    }
 
-    if (func != NULL) {
-        // We have a non-NULL function, call it
-        func();
-    }
-    else if (rising && onFinishMCycle != NULL) {
-        // We have no function to complete, do we have a return function?
-        func = onFinishMCycle; // Transfer the pointer
-        onFinishMCycle = NULL; // NULL out the pointer
-        func();
-    }
-    else if (rising && onFinishMCycle == NULL && onNextFallingCLCK == NULL) {
-        // We have no function to complete but we need to! Fail the processor here
-        formattedLog(stdlog, LOGTYPE_ERROR, "Processor microstate execution has failed: no function to execute!\n");
-        signals_raiseSignal(&signal_WAIT);
-        internalState = Z80State_Failure;
+        // An instruction that hasn't finished executes again on each rising edge
+        while (internalState == Z80State_Execute) {
+            Z80_executeInstruction();
+            if (internalState == Z80State_Failure)
+                break;
+            Z80_WAIT_EDGES(co, 2);
+        }
+        if (internalState == Z80State_Failure)
+            break;
     }
-}
-
-void Z80_signalWAITListener(bool rising) {
-    wait = rising; // Just directly set the wait variable
+    COROUTINE_END(co);
 }
 
 
@@ -206,9 +381,6 @@ void Z80_M1T1Rise() {
 
     // Update our internal addressLatch
     addressBusLatch = PC;
-
-    // Setup the next function to be called, which is a falling edge. RD and MREQ disable
-    onNextFallingCLCK = &Z80_M1T1Fall;
 }
 
 /*
@@ -226,9 +398,6 @@ void Z80_M1T1Fall() {
     // Set the necessary signals low
     signals_dropSignal(&signal_MREQ);
     signals_dropSignal(&signal_RD);
-
-    // Setup the next function to be called, which is on the falling edge of the next clock cycle. Data IN
-    onNextFallingCLCK = &Z80_M1T2Fall;
 }
 
 /*
@@ -246,9 +415,6 @@ void Z80_M1T2Fall() {
     // Take in a value from the data bus and store in cInstr
     cInstr = instructions_NULLInstr; // Clear the instruction to null
     cInstr.opcode = signal_dataBus; // HERE we take in the value
-
-    // The next thing to do is perform a rudimentary decode on the next rising edge (M1T3). At the same time various signals toggle
-    onNextRisingCLCK = &Z80_M1T3Rise;
 }
 
 /*
@@ -270,32 +436,11 @@ void Z80_M1T3Rise() {
 
     // Drop apppropriate signals
     signals_dropSignal(&signal_RFSH); // The refresh signal does technically need a refresh address, but we will just use the PC for now as it's still on the bus
+    Z80_INCREMENT_R();
 
     // Do a decode
     internalState = Z80State_Decode;
     Z80_decode();
-
-    // Setup the next function. The falling edge of M1T3 requires a MREQ fall and is where we decide the course of action: execution or memory read/write
-    onNextFallingCLCK = &Z80_M1T3Fall;
-}
-
-/*
-Activates on the falling edge of M1T3.
-Drops MREQ.
-Decides if we can execute on the next rising clock, or if we need to get a memory read
-*/
-void Z80_M1T3Fall() {
-    if (internalState != Z80State_Decode) {
-        // We require to match the decode state!
-        // Generate an error here?
-        return; // For now just return. This will halt the processor
-    }
-
-    // Decide
-    Z80_decodeBranchDecision();
-
-    // On the next falling edge we need to raise MREQ regardless of what we do here
-    onNextFallingCLCK = &Z80_M1T4Fall;
 }
 
 /*
@@ -305,7 +450,7 @@ Raises MREQ.
 void Z80_M1T4Fall() {
     signals_raiseSignal(&signal_MREQ);
 
-    // This is the end of the M1 Mcycle path, we decided our direction in Z80_M1T3Fall() so no function pointers set here
+    // This is the end of the M1 Mcycle path, the step on the rising edge of M1T4 has already set our direction
 }
 
 /********************************************************************
@@ -324,9 +469,6 @@ void Z80_memReadT1Rise() {
 
     // Put the address on the bus
     signal_addressBus = addressBusLatch;
-
-    // Set up the next step
-    onNextFallingCLCK = &Z80_memReadT1Fall;
 }
 
 /*
@@ -338,9 +480,6 @@ void Z80_memReadT1Fall() {
     // Do signal dropping
     signals_dropSignal(&signal_MREQ);
     signals_dropSignal(&signal_RD);
-
-    // On the next rising edge try and sample the data in (likely to be WAIT)
-    onNextRisingCLCK = &Z80_memReadT2Rise;
 }
 
 /*
@@ -354,9 +493,6 @@ void Z80_memReadT2Rise() {
         // We have a valid place to write to perhaps?
         *internalDataBus = signal_dataBus;
     }
-
-    // Set the final part of the memRead cycle
-    onNextFallingCLCK = &Z80_memReadT2Fall;
 }
 
 /*
@@ -369,7 +505,7 @@ void Z80_memReadT2Fall() {
     signals_raiseSignal(&signal_MREQ);
     signals_raiseSignal(&signal_RD);
 
-    // This is the end of the memRead cycle, let the return address take hold now
+    // This is the end of the memRead cycle, what the byte was read for says what comes next
 }
 
 /********************************************************************
@@ -390,9 +526,6 @@ void Z80_memWriteT1Rise() {
 
     // Put the address on the bus
     signal_addressBus = addressBusLatch;
-
-    // Set up the next step
-    onNextFallingCLCK = &Z80_memWriteT1Fall;
 }
 
 /*
@@ -406,9 +539,6 @@ void Z80_memWriteT1Fall() {
 
     // Put data on bus
     signal_dataBus = *internalDataBus;
-
-    // On the next falling edge set WR low
-    onNextFallingCLCK = &Z80_memWriteT2Fall;
 }
 
 /*
@@ -420,9 +550,6 @@ void Z80_memWriteT2Fall() {
 
     // Put WR low
     signals_dropSignal(&signal_WR);
-
-    // On the next falling edge we put everything back
-    onNextFallingCLCK = &Z80_memWriteT3Fall;
 }
 
 /*
@@ -435,8 +562,6 @@ void Z80_memWriteT3Fall() {
     // Put signals high
     signals_raiseSignal(&signal_MREQ);
     signals_raiseSignal(&signal_WR);
-
-    // This is the end of the memory write so we let the return ability work
 }
 
 /********************************************************************
@@ -446,34 +571,18 @@ void Z80_memWriteT3Fall() {
 ********************************************************************/
 
 /*
-Activates on the rising edge of M1T4
-Sets up the operand read
+Activates on the rising edge of M1T4, or the rising edge after an operand read
+Sets up the operand read, which starts on the next rising edge
 */
 void Z80_prepReadOperands() {
     // printf("[OPERANDS: %i]\n", cInstr.numOperandsToRead);
 
-    // The next rising edge needs to be a memory read cycle
-    onNextRisingCLCK = &Z80_memReadCycleStart;
-
-    // The return location is either the execute instruction function or a second operand read
-    if (cInstr.numOperandsToRead == 1) {
-        onFinishMCycle = &Z80_executeInstruction;
-        // Point to operand0
-        internalDataBus = &cInstr.operand0;
-        addressBusLatch++;
-    }
-    else if (cInstr.numOperandsToRead == 2) {
-        onFinishMCycle = &Z80_prepReadOperands;
-        // Point to operand1
+    // Two operands are read into operand1 then operand0. Opcodes have at most two, see Z80OPND_BYTES()
+    if (cInstr.numOperandsToRead == 2)
         internalDataBus = &cInstr.operand1;
-        addressBusLatch++;
-    }
-    else {
-        // We have no more operands to read, move to execution. Somehow we ended up here? Maybe detected 3 operands?????
-        formattedLog(stdlog, LOGTYPE_WARN, __FUNCTION__" attempted operand read, INVALID: cInstr.numOperandsToRead = %i. Performing execution of instruction anyway\n", cInstr.numOperandsToRead);
-        onFinishMCycle = &Z80_executeInstruction;
-        onNextRisingCLCK = NULL; // we don't need to read anything, so cancel the proceedure here
-    }
+    else
+        internalDataBus = &cInstr.operand0;
+    addressBusLatch++;
 
     // Decrement operands to read
     cInstr.numOperandsToRead--;
@@ -485,35 +594,57 @@ void Z80_prepReadOperands() {
 
 ********************************************************************/
 
+/*
+Moves the opcode just read into the prefix. A DD or FD followed by another DD, ED or FD has no effect, so the earlier prefix is dropped
+*/
+void Z80_accumulatePrefix() {
+    uint8_t lastPrefix = cInstr.prefix & 0xFF;
+    if ((lastPrefix == PREFIX_IX || lastPrefix == PREFIX_IY) && cInstr.opcode != PREFIX_BITS) {
+        cInstr.prefix = cInstr.opcode;
+        cInstr.ignoredPrefixes++;
+    }
+    else {
+        cInstr.prefix = (cInstr.prefix << 8) | cInstr.opcode;
+    }
+}
+
 /*
 Similar to if we had encountered an operand to read, we have encountered a prefix and thus need to get the instruction in the next position in memory
 */
 void Z80_prepPrefixedInstructionRead() {
     // We must transfer the "opcode" into our prefix buffer
-    cInstr.prefix = (cInstr.prefix << 8) | cInstr.opcode;
+    Z80_accumulatePrefix();
 
     // Now we must set up the memory read cycle to read into the opcode location by pointing the internalDataBus at it
+    addressBusLatch++;
+    if (cInstr.prefix == PREFIX_IX_BITS || cInstr.prefix == PREFIX_IY_BITS) {
+        // DDCB and FDCB put the displacement before the opcode, so read it first
+        internalDataBus = &cInstr.operand1;
+    }
+    else {
+        internalDataBus = &cInstr.opcode;
+        Z80_INCREMENT_R();
+    }
+}
+
+/*
+Reads the opcode of a DDCB or FDCB instruction, which follows the displacement. Its memory read cycle starts on the same
+rising edge as the displacement read ends
+*/
+void Z80_prepIndexedBitOpcodeRead() {
     addressBusLatch++;
     internalDataBus = &cInstr.opcode;
-    // Now set up the return function
-    onFinishMCycle = &Z80_finalisePrefixedInstructionRead;
-    
-    // The next rising edge needs to be a memory read cycle
-    onNextRisingCLCK = &Z80_memReadCycleStart;
 }
 
 /*
-This function is analagous to Z80_M1T3Rise and Z80_M1T3Fall, where we decide what to do. 
-This takes place on a rising edge though, so we must in actuality EXECUTE the next function, not point to it like in others. <----- we don't do this for now, do we need to?
+This function is analagous to Z80_M1T3Rise, where we decode. It takes place on the rising edge after the prefixed opcode
+is read, and the branch decision follows on the next one
 */
 void Z80_finalisePrefixedInstructionRead() {
     internalState = Z80State_Decode;
     // formattedLog(debuglog, LOGTYPE_DEBUG, "[PREFIXED DECODE]\n");
     // Perform the decode
     Z80_decode();
-
-    // Perform the branch decision
-    Z80_decodeBranchDecision();
 }
 
 /********************************************************************
@@ -544,20 +675,18 @@ void Z80_executeInstruction() {
     int execFuncResponse = cInstr.execFunction();
 
     if (execFuncResponse == INSTR_EXEC_FAILED) {
-        // FAIL!
+        // FAIL! Nothing can follow, so the processor stops here
         formattedLog(stdlog, LOGTYPE_WARN, "Processor microstate execution has give a failure: execFunction returned a failure\n");
         signals_raiseSignal(&signal_WAIT);
+        internalState = Z80State_Failure;
     }
     else if (execFuncResponse == INSTR_EXEC_SUCCESS) {
         // We are ready to move on
-        // Excution finished for now, set to the next M1 cycle
-        onFinishMCycle = &Z80_fetchCycleStart;
-        // Set back to fetch state
+        // Excution finished for now, set back to fetch state for the next M1 cycle
         internalState = Z80State_Fetch;
     }
     else if(execFuncResponse == INSTR_EXEC_CONT){
-        // We stil need to continue
-        onNextRisingCLCK = &Z80_executeInstruction;
+        // We stil need to continue, staying in the execute state executes again on the next rising edge
     }
     else if (execFuncResponse == INSTR_EXEC_NOTIMPL) {
         formattedLog(stdlog, LOGTYPE_ERROR, "Processor microstate execution has give a failure: this opcode is not implemented\n");
@@ -568,6 +697,7 @@ void Z80_executeInstruction() {
     else {
         formattedLog(stdlog, LOGTYPE_WARN, "Processor microstate execution has give a failure: execFunction returned an unknown response of %i\n", execFuncResponse);
         signals_raiseSignal(&signal_WAIT);
+        internalState = Z80State_Failure;
     }
 }
 
@@ -584,96 +714,55 @@ Decodes the opcode
 void Z80_decode() {
     // We have a cInstr struct with a .opcode value
     // We take this and split the bit fields for easier decoding
-    cInstr.z = (cInstr.opcode & 0b11000000) >> 6;
+    cInstr.x = (cInstr.opcode & 0b11000000) >> 6;
     cInstr.y = (cInstr.opcode & 0b00111000) >> 3;
     cInstr.z = (cInstr.opcode & 0b00000111);
     cInstr.p = cInstr.y >> 1;
     cInstr.q = cInstr.y % 2;
 
-    // Now we retrieve the human-readable pointer
-    switch (cInstr.prefix) {
-    case PREFIX_BITS:
-        cInstr.string = instructions_bitInstructionText[cInstr.opcode];
-        cInstr.instrByteLen = instructions_bitInstructionParams[cInstr.opcode];
-        cInstr.numOperands = cInstr.instrByteLen > 2 ? cInstr.instrByteLen - 2 : 0;
-        cInstr.execFunction = instructions_bitInstructionFuncs[cInstr.opcode];
-        break;
-    case PREFIX_EXX:
-        cInstr.string = instructions_extendedInstructionText[cInstr.opcode];
-        cInstr.instrByteLen = instructions_extendedInstructionParams[cInstr.opcode];
-        cInstr.numOperands = cInstr.instrByteLen > 2 ? cInstr.instrByteLen - 2 : 0;
-        cInstr.execFunction = instructions_extendedInstructionFuncs[cInstr.opcode];
-        break;
-    case PREFIX_IX:
-        cInstr.string = instructions_IXInstructionText[cInstr.opcode];
-        cInstr.instrByteLen = instructions_IXInstructionParams[cInstr.opcode];
-        cInstr.numOperands = cInstr.instrByteLen > 2 ? cInstr.instrByteLen - 2 : 0;
-        cInstr.execFunction = instructions_IXInstructionFuncs[cInstr.opcode];
-        break;
-    case PREFIX_IY:
-        cInstr.string = instructions_IYInstructionText[cInstr.opcode];
-        cInstr.instrByteLen = instructions_IYInstructionParams[cInstr.opcode];
-        cInstr.numOperands = cInstr.instrByteLen > 2 ? cInstr.instrByteLen - 2 : 0;
-        cInstr.execFunction = instructions_IYInstructionFuncs[cInstr.opcode];
-        break;
-    case PREFIX_IX_BITS:
-        cInstr.string = instructions_IXBitInstructionText[cInstr.opcode];
-        cInstr.instrByteLen = instructions_IXBitInstructionParams[cInstr.opcode];
-        cInstr.numOperands = cInstr.instrByteLen > 3 ? cInstr.instrByteLen - 3 : 0;
-        // cInstr.execFunction = instructions_IXBitInstructionFuncs[cInstr.opcode];
-        break;
-    case PREFIX_IY_BITS:
-        cInstr.string = instructions_IYBitInstructionText[cInstr.opcode];
-        cInstr.instrByteLen = instructions_IYBitInstructionParams[cInstr.opcode];
-        cInstr.numOperands = cInstr.instrByteLen > 3 ? cInstr.instrByteLen - 3 : 0;
-        cInstr.execFunction = instructions_IYBitInstructionFuncs[cInstr.opcode];
-        break;
-    default:
-        cInstr.string = instructions_mainInstructionText[cInstr.opcode];
-        cInstr.instrByteLen = instructions_mainInstructionParams[cInstr.opcode];
-        cInstr.numOperands = cInstr.instrByteLen > 1 ? cInstr.instrByteLen - 1 : 0;
-        cInstr.execFunction = instructions_mainInstructionFuncs[cInstr.opcode];
-        break;
-    }
-
-    // Determine if the opcode is a prefix
-    switch (cInstr.opcode) {
-    case PREFIX_BITS:
-    case PREFIX_EXX:
-    case PREFIX_IX:
-    case PREFIX_IY:
+    // Now we retrieve the opcode information from the packed table for the prefix
+    const Z80OpcodeInfo_t* info = &Z80Opcodes_table(cInstr.prefix)[cInstr.opcode];
+    cInstr.string = info->mnemonic;
+    cInstr.instrByteLen = info->length;
+    cInstr.tStates = info->tStates;
+    cInstr.execFunction = info->execFunction;
+    if (cInstr.prefix == PREFIX_IX_BITS || cInstr.prefix == PREFIX_IY_BITS)
+        cInstr.numOperands = 0; // The displacement has already been read into operand1, before the opcode
+    else
+        cInstr.numOperands = Z80OPND_BYTES(info->operands);
+
+    // Determine if the opcode is a prefix. The tables mark these with a length of -1, so CB inside a DD table and the like are handled correctly
+    if (cInstr.instrByteLen == (uint8_t)-1) {
         cInstr.detectedPrefix = true;
         // formattedLog(debuglog, LOGTYPE_DEBUG, "prefix %s (pc: %04X, %04X %02X)\n", cInstr.string, PC.v, cInstr.prefix, cInstr.opcode);
-        break;
-
-    default:
+    }
+    else {
         cInstr.detectedPrefix = false;
+        // Overridden prefixes still took up a byte and an opcode fetch each
+        cInstr.instrByteLen += cInstr.ignoredPrefixes;
+        cInstr.tStates += 4 * cInstr.ignoredPrefixes;
         // formattedLog(debuglog, LOGTYPE_DEBUG, "opcode %s (pc: %04X, %04X %02X)\n", cInstr.string, PC.v, cInstr.prefix, cInstr.opcode);
-        break;
     }
 
-    // Catch massive operand counts
-    if (cInstr.numOperands >= 3) {
-        cInstr.numOperands = 0;
-    }
     cInstr.numOperandsToRead = cInstr.numOperands;
 }
 
 /*
+Activates on the rising edge after a decode, M1T4 for an unprefixed opcode
 We decide here if we need to execute the instruction, handle a prefix or read memory
 */
 void Z80_decodeBranchDecision() {
     // We have a prefix code, so we need to handle it
     if (cInstr.detectedPrefix) {
         // We need to move to a prefix read branch
-        onNextRisingCLCK = &Z80_prepPrefixedInstructionRead;
+        Z80_prepPrefixedInstructionRead();
     }
     // If we have no operands, we can just do an execution
     else if (cInstr.numOperandsToRead == 0) {
-        onNextRisingCLCK = &Z80_executeInstruction;
+        Z80_executeInstruction();
     }
     else {
         // We need to read operands from memory to continue the execution, so we shall set up the pathway
-        onNextRisingCLCK = &Z80_prepReadOperands; // this is just a dummy function that leads into the real pathway after M1 has elapsed
+        Z80_prepReadOperands();
     }
 }
\ No newline at end of file
@@ -20,17 +20,120 @@ Z80.h : Z80 CPU component
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "Z80Instructions.h"
+#include "Z80Flags.h"
+#include "Z80Idle.h"
+#include "../Z0Machine.h"
+#include "../Coroutine.h"
+
 /* 16bit register definition */
-#define REG_UPPER(x) (x >> 8)
-#define REG_LOWER(x) (x & 0xF)
+#define REG_UPPER(x) ((x) >> 8)
+#define REG_LOWER(x) ((x) & 0xFF)
+
+/* Register pair. Hosts are little-endian, so the low byte comes first */
+typedef union Z80RegisterPair {
+    uint16_t w;
+    struct { uint8_t l, h; } b;
+} Z80RegisterPair_t;
+
+/* The exchangeable registers, as one 64 bit word so EXX and EX AF,AF' swap a bank in a single masked exchange */
+typedef union Z80RegisterBank {
+    struct { Z80RegisterPair_t bc, de, hl, af; } r;
+    uint64_t packed;
+} Z80RegisterBank_t;
+
+#define Z80_BANK_MASK_EXX 0x0000FFFFFFFFFFFFull // BC, DE and HL
+#define Z80_BANK_MASK_AF 0xFFFF000000000000ull
+
+/* Register file. Kept together in one cache line, with the main bank at its start */
+typedef struct Z80Registers {
+    Z80RegisterBank_t main;
+    Z80RegisterBank_t alternate;
+    Z80RegisterPair_t ix, iy, sp, pc;
+    Z80RegisterPair_t ivmr; // I in the high byte, R in the low
+} Z80Registers_t;
+
+#if defined(_MSC_VER)
+#define Z80_CACHE_ALIGNED __declspec(align(64))
+#else
+#define Z80_CACHE_ALIGNED __attribute__((aligned(64)))
+#endif
+
+extern Z0_MACHINE_LOCAL Z80Registers_t Z80_registers;
+
+/* General Registers */
+#define AF (Z80_registers.main.r.af.w)
+#define BC (Z80_registers.main.r.bc.w)
+#define DE (Z80_registers.main.r.de.w)
+#define HL (Z80_registers.main.r.hl.w)
+
+/* Alternate General Registers */
+#define AFPrime (Z80_registers.alternate.r.af.w)
+#define BCPrime (Z80_registers.alternate.r.bc.w)
+#define DEPrime (Z80_registers.alternate.r.de.w)
+#define HLPrime (Z80_registers.alternate.r.hl.w)
+
+/* Special Registers */
+#define IVMR (Z80_registers.ivmr.w)
+#define IX (Z80_registers.ix.w)
+#define IY (Z80_registers.iy.w)
+#define SP (Z80_registers.sp.w)
+#define PC (Z80_registers.pc.w)
+
+/* Interrupt State */
+extern Z0_MACHINE_LOCAL bool IFF1;
+extern Z0_MACHINE_LOCAL bool IFF2;
+extern Z0_MACHINE_LOCAL int interruptMode;
+extern Z0_MACHINE_LOCAL bool halted;
+extern Z0_MACHINE_LOCAL bool eiPending;
+extern Z0_MACHINE_LOCAL bool nmiPending;
+
+/* R is incremented on every M1 cycle. Only the low 7 bits count, bit 7 is kept */
+#define Z80_INCREMENT_R() IVMR = (uint16_t)((IVMR & 0xFF80) | ((IVMR + 1) & 0x7F))
+#define Z80_ADVANCE_R(n) IVMR = (uint16_t)((IVMR & 0xFF80) | ((IVMR + (n)) & 0x7F))
+
+/* True when Z80_pollInterrupts() might have something to do */
+#define Z80_INTERRUPT_POSSIBLE() (nmiPending || eiPending || IFF1)
 
 /* Z80 Internal State Variables */
-extern int microcodeState;
+extern Z0_MACHINE_LOCAL int microcodeState;
+extern Z0_MACHINE_LOCAL int internalState;
+extern Z0_MACHINE_LOCAL bool Z80_wait;
 
 /* State */
 enum Z80InternalStateEnum { Z80State_Fetch, Z80State_Decode, Z80State_Execute, Z80State_Failure };
 int Z80_state();
 
+/* Engine. Edge clocks the CPU from signal_CLCK, Step runs whole instructions through Z80_step() / Z80_runFor(),
+MCycle runs the Step engine without its caches and reports each machine cycle through Z80Bus */
+enum Z80EngineEnum { Z80Engine_Edge, Z80Engine_Step, Z80Engine_MCycle };
+extern Z0_MACHINE_LOCAL int Z80_engine;
+
+/* Everything the CPU carries from one clock edge or instruction to the next, so a machine can be put back where it was.
+The counters are included, as device events are timed against them. Under the edge engine, the point reached in the
+machine cycles is kept by the CPU coroutine, which Z0Snapshot saves along with the devices' ones */
+typedef struct Z80State {
+    Z80Registers_t registers;
+    Z80LazyFlags_t lazy;
+    bool iff1, iff2, halted, eiPending, nmiPending;
+    int interruptMode;
+
+    Z80_Instr_t cInstr;
+    int internalState;
+    bool wait;
+    int microcodeState;
+    uint16_t addressBusLatch;
+    uint8_t* internalDataBus;
+
+    uint64_t tStates;
+    uint64_t instructionsExecuted;
+    uint64_t tStateDeadline;
+    uint64_t writes;
+    uint64_t refreshReads;
+    Z80IdleState_t idleHead;
+    bool refreshWatching;
+} Z80State_t;
+
 /********************************************************************
 
     Z80 Init Functions
@@ -38,7 +141,11 @@ int Z80_state();
 ********************************************************************/
 
 void Z80_init();
+void Z80_reset();
+void Z80_destroy();
 void Z80_initSignals();
+void Z80_saveState(Z80State_t* state);
+void Z80_loadState(const Z80State_t* state);
 
 /********************************************************************
 
@@ -46,8 +153,16 @@ void Z80_initSignals();
 
 ********************************************************************/
 
-void Z80_signalCLCKListener(bool rising);
 void Z80_signalWAITListener(bool rising);
+void Z80_signalNMIListener(bool rising);
+
+/********************************************************************
+
+    Z80 Machine Cycle Functions
+
+********************************************************************/
+
+void Z80_run(Coroutine_t* co);
 
 /********************************************************************
 
@@ -60,7 +175,6 @@ void Z80_M1T1Rise();
 void Z80_M1T1Fall();
 void Z80_M1T2Fall();
 void Z80_M1T3Rise();
-void Z80_M1T3Fall();
 void Z80_M1T4Fall();
 
 /********************************************************************
@@ -103,7 +217,9 @@ void Z80_prepReadOperands();
 
 ********************************************************************/
 
+void Z80_accumulatePrefix();
 void Z80_prepPrefixedInstructionRead();
+void Z80_prepIndexedBitOpcodeRead();
 void Z80_finalisePrefixedInstructionRead();
 
 /********************************************************************
@@ -17,10 +17,344 @@ Z80Alu.c : Z80 CPU ALU component
 
 #include "Z80Alu.h"
 #include "Z80Flags.h"
+#include "Z80.h"
 
-/* Internal ALU values to simplify C variable handling */
-union resultStore {
-    uint32_t _32;
-    uint16_t _16;
-    uint8_t _8;
-} resultStore; // Stores the result of a calculation. Uses a 32 bit "input" so we can do tests if necessary
+/* F register access. Reads build any pending flags first, writes replace them */
+#define FLAGS Z80FLAGS_READ()
+// 'f' is worked out before the pending operation is dropped, as it may read F
+#define SET_FLAGS(f) { uint8_t newFlags = (uint8_t)(f); Z80FLAGS_DISCARD(); AF = (uint16_t)((AF & 0xFF00) | newFlags); }
+
+/* Lazy flag state */
+Z0_MACHINE_LOCAL Z80LazyFlags_t Z80Flags_lazy = { Z80LazyFlags_None, 0, 0, 0, 0 };
+Z0_MACHINE_LOCAL uint64_t Z80Flags_materialisations = 0;
+
+/* Records an 8 bit operation whose flags are built later */
+#define SET_LAZY(kind, opA, opB, res) { Z80Flags_lazy.op = (kind); Z80Flags_lazy.a = (opA); Z80Flags_lazy.b = (opB); Z80Flags_lazy.result = (res); }
+
+/* Flag tables, filled by Z80Alu_init() */
+Z0_MACHINE_LOCAL uint8_t Z80Alu_szTable[0x100]; // S, Z and the undocumented bits of a result
+Z0_MACHINE_LOCAL uint8_t Z80Alu_szpTable[0x100]; // As Z80Alu_szTable, plus P/V set for even parity
+Z0_MACHINE_LOCAL uint8_t Z80Alu_incTable[0x100]; // F after INC, apart from C, indexed by the result
+Z0_MACHINE_LOCAL uint8_t Z80Alu_decTable[0x100]; // F after DEC, apart from C, indexed by the result
+
+/*
+Half carry and overflow of an 8 bit add or subtract, indexed by Z80ALU_HV_INDEX.
+Bit 0 of the index is from the first operand, bit 1 from the second and bit 2 from the result
+*/
+const uint8_t Z80Alu_halfCarryAddTable[8] = { 0, Z80FLAG_H, Z80FLAG_H, Z80FLAG_H, 0, 0, 0, Z80FLAG_H };
+const uint8_t Z80Alu_halfCarrySubTable[8] = { 0, 0, Z80FLAG_H, 0, Z80FLAG_H, 0, Z80FLAG_H, Z80FLAG_H };
+const uint8_t Z80Alu_overflowAddTable[8] = { 0, 0, 0, Z80FLAG_PV, Z80FLAG_PV, 0, 0, 0 };
+const uint8_t Z80Alu_overflowSubTable[8] = { 0, Z80FLAG_PV, 0, 0, 0, 0, Z80FLAG_PV, 0 };
+
+/* Bits 3 and 7 of the operands and result packed so bits 0-2 give the half carry index and bits 4-6 the overflow index */
+#define Z80ALU_HV_INDEX(a, b, r) ((((a) & 0x88) >> 3) | (((b) & 0x88) >> 2) | (((r) & 0x88) >> 1))
+
+/********************************************************************
+
+    Z80 ALU helpers
+
+********************************************************************/
+
+/*
+True if the value has an even number of set bits
+*/
+bool Z80Alu_parity(uint8_t v) {
+    v ^= v >> 4;
+    v ^= v >> 2;
+    v ^= v >> 1;
+    return (v & 1) == 0;
+}
+
+/*
+Builds the flag tables. Must be called before any ALU function
+*/
+void Z80Alu_init() {
+    for (int i = 0; i < 0x100; i++) {
+        uint8_t v = (uint8_t)i;
+        Z80Alu_szTable[i] = (v & (Z80FLAG_S | Z80FLAG_XY)) | (v == 0 ? Z80FLAG_Z : 0);
+        Z80Alu_szpTable[i] = Z80Alu_szTable[i] | (Z80Alu_parity(v) ? Z80FLAG_PV : 0);
+
+        // INC gives a half carry when the low nibble wraps to 0, and overflows into 0x80
+        Z80Alu_incTable[i] = Z80Alu_szTable[i] | ((v & 0x0F) == 0x00 ? Z80FLAG_H : 0) | (v == 0x80 ? Z80FLAG_PV : 0);
+        // DEC gives a half borrow when the low nibble wraps to F, and overflows into 0x7F
+        Z80Alu_decTable[i] = Z80Alu_szTable[i] | Z80FLAG_N | ((v & 0x0F) == 0x0F ? Z80FLAG_H : 0) | (v == 0x7F ? Z80FLAG_PV : 0);
+    }
+}
+
+/********************************************************************
+
+    Z80 lazy flags
+
+********************************************************************/
+
+/*
+Builds F from the pending 8 bit operation and writes it into AF
+*/
+void Z80Flags_materialise() {
+    uint8_t a = Z80Flags_lazy.a;
+    uint8_t b = Z80Flags_lazy.b;
+    uint8_t r = (uint8_t)Z80Flags_lazy.result;
+    uint8_t carry = (Z80Flags_lazy.result >> 8) & Z80FLAG_C;
+    uint8_t index = Z80ALU_HV_INDEX(a, b, r);
+    uint8_t f;
+
+    switch (Z80Flags_lazy.op) {
+    case Z80LazyFlags_Add:
+        f = carry | Z80Alu_halfCarryAddTable[index & 0x07] | Z80Alu_overflowAddTable[index >> 4] | Z80Alu_szTable[r];
+        break;
+    case Z80LazyFlags_Sub:
+        f = carry | Z80FLAG_N | Z80Alu_halfCarrySubTable[index & 0x07] | Z80Alu_overflowSubTable[index >> 4] | Z80Alu_szTable[r];
+        break;
+    case Z80LazyFlags_Cp:
+        f = carry | Z80FLAG_N | Z80Alu_halfCarrySubTable[index & 0x07] | Z80Alu_overflowSubTable[index >> 4] | (Z80Alu_szTable[r] & ~Z80FLAG_XY) | (b & Z80FLAG_XY);
+        break;
+    case Z80LazyFlags_And:
+        f = Z80Alu_szpTable[r] | Z80FLAG_H;
+        break;
+    case Z80LazyFlags_Logic:
+        f = Z80Alu_szpTable[r];
+        break;
+    case Z80LazyFlags_Inc:
+        f = Z80Flags_lazy.carry | Z80Alu_incTable[r];
+        break;
+    case Z80LazyFlags_Dec:
+        f = Z80Flags_lazy.carry | Z80Alu_decTable[r];
+        break;
+    default:
+        return; // Nothing pending
+    }
+
+    AF = (uint16_t)((AF & 0xFF00) | f);
+    Z80Flags_lazy.op = Z80LazyFlags_None;
+    Z80Flags_materialisations++;
+}
+
+/*
+Reads C without building the rest of F. ADC, SBC, INC and DEC only need the carry
+*/
+uint8_t Z80Flags_readCarry() {
+    switch (Z80Flags_lazy.op) {
+    case Z80LazyFlags_Add:
+    case Z80LazyFlags_Sub:
+    case Z80LazyFlags_Cp:
+        return (Z80Flags_lazy.result >> 8) & Z80FLAG_C;
+    case Z80LazyFlags_And:
+    case Z80LazyFlags_Logic:
+        return 0;
+    case Z80LazyFlags_Inc:
+    case Z80LazyFlags_Dec:
+        return Z80Flags_lazy.carry;
+    default:
+        return AF & Z80FLAG_C;
+    }
+}
+
+/********************************************************************
+
+    Z80 ALU 8 bit arithmetic and logic
+
+********************************************************************/
+
+uint8_t Z80Alu_add8(uint8_t a, uint8_t b, uint8_t carry) {
+    uint32_t result = a + b + carry; // Wide enough to keep the carry or borrow out
+    SET_LAZY(Z80LazyFlags_Add, a, b, (uint16_t)result);
+    return (uint8_t)result;
+}
+
+uint8_t Z80Alu_sub8(uint8_t a, uint8_t b, uint8_t carry) {
+    uint32_t result = a - b - carry; // Wide enough to keep the carry or borrow out
+    SET_LAZY(Z80LazyFlags_Sub, a, b, (uint16_t)result);
+    return (uint8_t)result;
+}
+
+/*
+A compare is a subtraction that throws the result away. The undocumented bits come from the operand, not the result
+*/
+void Z80Alu_cp8(uint8_t a, uint8_t b) {
+    uint32_t result = a - b;
+    SET_LAZY(Z80LazyFlags_Cp, a, b, (uint16_t)result);
+}
+
+uint8_t Z80Alu_and8(uint8_t a, uint8_t b) {
+    uint8_t r = a & b;
+    SET_LAZY(Z80LazyFlags_And, a, b, r);
+    return r;
+}
+
+uint8_t Z80Alu_xor8(uint8_t a, uint8_t b) {
+    uint8_t r = a ^ b;
+    SET_LAZY(Z80LazyFlags_Logic, a, b, r);
+    return r;
+}
+
+uint8_t Z80Alu_or8(uint8_t a, uint8_t b) {
+    uint8_t r = a | b;
+    SET_LAZY(Z80LazyFlags_Logic, a, b, r);
+    return r;
+}
+
+uint8_t Z80Alu_inc8(uint8_t a) {
+    uint8_t r = a + 1;
+    Z80Flags_lazy.carry = Z80Flags_readCarry();
+    SET_LAZY(Z80LazyFlags_Inc, a, 1, r);
+    return r;
+}
+
+uint8_t Z80Alu_dec8(uint8_t a) {
+    uint8_t r = a - 1;
+    Z80Flags_lazy.carry = Z80Flags_readCarry();
+    SET_LAZY(Z80LazyFlags_Dec, a, 1, r);
+    return r;
+}
+
+/*
+Decimal adjust after an addition or subtraction of two BCD values
+*/
+uint8_t Z80Alu_daa(uint8_t a) {
+    uint8_t f = FLAGS;
+    uint8_t diff = 0;
+    uint8_t carry = f & Z80FLAG_C;
+
+    if ((f & Z80FLAG_H) || (a & 0x0F) > 9)
+        diff |= 0x06;
+    if (carry || a > 0x99) {
+        diff |= 0x60;
+        carry = Z80FLAG_C;
+    }
+
+    uint8_t r = (f & Z80FLAG_N) ? a - diff : a + diff;
+    SET_FLAGS(Z80Alu_szpTable[r] | ((a ^ r) & Z80FLAG_H) | (f & Z80FLAG_N) | carry);
+    return r;
+}
+
+uint8_t Z80Alu_cpl(uint8_t a) {
+    uint8_t r = ~a;
+    SET_FLAGS((FLAGS & (Z80FLAG_S | Z80FLAG_Z | Z80FLAG_PV | Z80FLAG_C)) | Z80FLAG_H | Z80FLAG_N | (r & Z80FLAG_XY));
+    return r;
+}
+
+void Z80Alu_scf(uint8_t a) {
+    SET_FLAGS((FLAGS & (Z80FLAG_S | Z80FLAG_Z | Z80FLAG_PV)) | Z80FLAG_C | (a & Z80FLAG_XY));
+}
+
+void Z80Alu_ccf(uint8_t a) {
+    uint8_t f = FLAGS;
+    uint8_t h = (f & Z80FLAG_C) ? Z80FLAG_H : 0;
+    SET_FLAGS((f & (Z80FLAG_S | Z80FLAG_Z | Z80FLAG_PV)) | h | ((f & Z80FLAG_C) ^ Z80FLAG_C) | (a & Z80FLAG_XY));
+}
+
+/********************************************************************
+
+    Z80 ALU 16 bit arithmetic
+
+********************************************************************/
+
+/*
+ADD HL,rr. Only H, N, C and the undocumented bits change
+*/
+uint16_t Z80Alu_add16(uint16_t a, uint16_t b) {
+    uint32_t result = a + b;
+    uint16_t r = (uint16_t)result;
+
+    uint8_t f = FLAGS & (Z80FLAG_S | Z80FLAG_Z | Z80FLAG_PV);
+    f |= ((a ^ b ^ r) >> 8) & Z80FLAG_H;
+    f |= (r >> 8) & Z80FLAG_XY;
+    if (result > 0xFFFF)
+        f |= Z80FLAG_C;
+    SET_FLAGS(f);
+    return r;
+}
+
+uint16_t Z80Alu_adc16(uint16_t a, uint16_t b) {
+    uint32_t result = a + b + Z80Flags_readCarry();
+    uint16_t r = (uint16_t)result;
+
+    uint8_t f = ((r >> 8) & (Z80FLAG_S | Z80FLAG_XY)) | (r == 0 ? Z80FLAG_Z : 0);
+    f |= ((a ^ b ^ r) >> 8) & Z80FLAG_H;
+    if (((a ^ ~b) & (a ^ r)) & 0x8000)
+        f |= Z80FLAG_PV;
+    if (result > 0xFFFF)
+        f |= Z80FLAG_C;
+    SET_FLAGS(f);
+    return r;
+}
+
+uint16_t Z80Alu_sbc16(uint16_t a, uint16_t b) {
+    uint32_t result = a - b - Z80Flags_readCarry();
+    uint16_t r = (uint16_t)result;
+
+    uint8_t f = ((r >> 8) & (Z80FLAG_S | Z80FLAG_XY)) | (r == 0 ? Z80FLAG_Z : 0) | Z80FLAG_N;
+    f |= ((a ^ b ^ r) >> 8) & Z80FLAG_H;
+    if (((a ^ b) & (a ^ r)) & 0x8000)
+        f |= Z80FLAG_PV;
+    if (result > 0xFFFF) // Wrapped below zero
+        f |= Z80FLAG_C;
+    SET_FLAGS(f);
+    return r;
+}
+
+/********************************************************************
+
+    Z80 ALU rotate, shift and bit functions
+
+********************************************************************/
+
+/* Flags kept by the accumulator rotates */
+#define ACC_ROTATE_KEEP (Z80FLAG_S | Z80FLAG_Z | Z80FLAG_PV)
+
+uint8_t Z80Alu_rlca(uint8_t a) {
+    uint8_t r = (a << 1) | (a >> 7);
+    SET_FLAGS((FLAGS & ACC_ROTATE_KEEP) | (r & Z80FLAG_XY) | (a >> 7));
+    return r;
+}
+
+uint8_t Z80Alu_rrca(uint8_t a) {
+    uint8_t r = (a >> 1) | (a << 7);
+    SET_FLAGS((FLAGS & ACC_ROTATE_KEEP) | (r & Z80FLAG_XY) | (a & Z80FLAG_C));
+    return r;
+}
+
+uint8_t Z80Alu_rla(uint8_t a) {
+    uint8_t r = (a << 1) | (FLAGS & Z80FLAG_C);
+    SET_FLAGS((FLAGS & ACC_ROTATE_KEEP) | (r & Z80FLAG_XY) | (a >> 7));
+    return r;
+}
+
+uint8_t Z80Alu_rra(uint8_t a) {
+    uint8_t r = (a >> 1) | ((FLAGS & Z80FLAG_C) << 7);
+    SET_FLAGS((FLAGS & ACC_ROTATE_KEEP) | (r & Z80FLAG_XY) | (a & Z80FLAG_C));
+    return r;
+}
+
+uint8_t Z80Alu_rotateShift(int op, uint8_t v) {
+    uint8_t r;
+    uint8_t carry;
+    switch (op & 7) {
+    case 0: r = (v << 1) | (v >> 7); carry = v >> 7; break; // RLC
+    case 1: r = (v >> 1) | (v << 7); carry = v & 1; break; // RRC
+    case 2: r = (v << 1) | (FLAGS & Z80FLAG_C); carry = v >> 7; break; // RL
+    case 3: r = (v >> 1) | ((FLAGS & Z80FLAG_C) << 7); carry = v & 1; break; // RR
+    case 4: r = v << 1; carry = v >> 7; break; // SLA
+    case 5: r = (v >> 1) | (v & 0x80); carry = v & 1; break; // SRA
+    case 6: r = (v << 1) | 1; carry = v >> 7; break; // SLL (undocumented)
+    default: r = v >> 1; carry = v & 1; break; // SRL
+    }
+    SET_FLAGS(Z80Alu_szpTable[r] | carry);
+    return r;
+}
+
+/*
+BIT n. The undocumented bits come from 'xySource', which is the tested value for registers
+*/
+void Z80Alu_bit(int bit, uint8_t v, uint8_t xySource) {
+    uint8_t tested = v & (1 << bit);
+    uint8_t f = (FLAGS & Z80FLAG_C) | Z80FLAG_H | (xySource & Z80FLAG_XY);
+    if (tested == 0)
+        f |= Z80FLAG_Z | Z80FLAG_PV;
+    f |= tested & Z80FLAG_S; // Only set when testing bit 7
+    SET_FLAGS(f);
+}
+
+void Z80Alu_flagsSZP(uint8_t v) {
+    SET_FLAGS(Z80Alu_szpTable[v] | (FLAGS & Z80FLAG_C));
+}
@@ -18,4 +18,84 @@ Z80Alu.h : Z80 CPU ALU component
 */
 
 #include <stdint.h>
-#include <stdbool.h>
\ No newline at end of file
+#include <stdbool.h>
+
+#include "../Z0Machine.h"
+
+/* Flag tables, indexed by an 8 bit result */
+extern Z0_MACHINE_LOCAL uint8_t Z80Alu_szTable[0x100];
+extern Z0_MACHINE_LOCAL uint8_t Z80Alu_szpTable[0x100];
+extern Z0_MACHINE_LOCAL uint8_t Z80Alu_incTable[0x100];
+extern Z0_MACHINE_LOCAL uint8_t Z80Alu_decTable[0x100];
+
+/* Half carry and overflow tables for 8 bit add and subtract */
+extern const uint8_t Z80Alu_halfCarryAddTable[8];
+extern const uint8_t Z80Alu_halfCarrySubTable[8];
+extern const uint8_t Z80Alu_overflowAddTable[8];
+extern const uint8_t Z80Alu_overflowSubTable[8];
+
+/********************************************************************
+
+    Z80 ALU init
+
+********************************************************************/
+
+void Z80Alu_init();
+
+/********************************************************************
+
+    Z80 ALU 8 bit arithmetic and logic
+    Each function returns the result and writes the F register
+
+********************************************************************/
+
+uint8_t Z80Alu_add8(uint8_t a, uint8_t b, uint8_t carry);
+uint8_t Z80Alu_sub8(uint8_t a, uint8_t b, uint8_t carry);
+void Z80Alu_cp8(uint8_t a, uint8_t b);
+uint8_t Z80Alu_and8(uint8_t a, uint8_t b);
+uint8_t Z80Alu_xor8(uint8_t a, uint8_t b);
+uint8_t Z80Alu_or8(uint8_t a, uint8_t b);
+uint8_t Z80Alu_inc8(uint8_t a);
+uint8_t Z80Alu_dec8(uint8_t a);
+
+uint8_t Z80Alu_daa(uint8_t a);
+uint8_t Z80Alu_cpl(uint8_t a);
+void Z80Alu_scf(uint8_t a);
+void Z80Alu_ccf(uint8_t a);
+
+/********************************************************************
+
+    Z80 ALU 16 bit arithmetic
+
+********************************************************************/
+
+uint16_t Z80Alu_add16(uint16_t a, uint16_t b);
+uint16_t Z80Alu_adc16(uint16_t a, uint16_t b);
+uint16_t Z80Alu_sbc16(uint16_t a, uint16_t b);
+
+/********************************************************************
+
+    Z80 ALU rotate, shift and bit functions
+
+********************************************************************/
+
+/* Accumulator rotates (RLCA, RRCA, RLA, RRA) leave S, Z and P/V alone */
+uint8_t Z80Alu_rlca(uint8_t a);
+uint8_t Z80Alu_rrca(uint8_t a);
+uint8_t Z80Alu_rla(uint8_t a);
+uint8_t Z80Alu_rra(uint8_t a);
+
+/* CB prefixed rotates and shifts. 'op' is bits 3-5 of the opcode: RLC RRC RL RR SLA SRA SLL SRL */
+uint8_t Z80Alu_rotateShift(int op, uint8_t v);
+void Z80Alu_bit(int bit, uint8_t v, uint8_t xySource);
+
+/* Sets S, Z, P and the undocumented bits from a value, clears H and N and keeps C. Used by IN r,(C), RLD, RRD */
+void Z80Alu_flagsSZP(uint8_t v);
+
+/********************************************************************
+
+    Z80 ALU helpers
+
+********************************************************************/
+
+bool Z80Alu_parity(uint8_t v);
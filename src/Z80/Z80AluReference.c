@@ -0,0 +1,477 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80AluReference.c : Slow, bit by bit reference for the table driven ALU and a self-check that compares the two
+
+*/
+
+#include "Z80AluReference.h"
+#include "Z80Alu.h"
+#include "Z80Flags.h"
+#include "Z80.h"
+
+#include "../SysIO/Log.h"
+
+/* F register access */
+#define FLAGS Z80FLAGS_READ()
+// 'f' is worked out before the pending operation is dropped, as it may read F
+#define SET_FLAGS(f) { uint8_t newFlags = (uint8_t)(f); Z80FLAGS_DISCARD(); AF = (uint16_t)((AF & 0xFF00) | newFlags); }
+
+/* Sign, zero and the undocumented bits of an 8 bit result */
+#define SZXY(v) (((v) & (Z80FLAG_S | Z80FLAG_XY)) | ((v) == 0 ? Z80FLAG_Z : 0))
+
+/********************************************************************
+
+    Z80 ALU reference functions
+    Each flag is worked out on its own from the operands and the result
+
+********************************************************************/
+
+uint8_t Z80AluRef_add8(uint8_t a, uint8_t b, uint8_t carry) {
+    uint32_t result = a + b + carry;
+    uint8_t r = (uint8_t)result;
+
+    uint8_t f = SZXY(r);
+    f |= (a ^ b ^ r) & Z80FLAG_H;
+    if (((a ^ ~b) & (a ^ r)) & 0x80)
+        f |= Z80FLAG_PV;
+    if (result > 0xFF)
+        f |= Z80FLAG_C;
+    SET_FLAGS(f);
+    return r;
+}
+
+uint8_t Z80AluRef_sub8(uint8_t a, uint8_t b, uint8_t carry) {
+    uint32_t result = a - b - carry;
+    uint8_t r = (uint8_t)result;
+
+    uint8_t f = SZXY(r) | Z80FLAG_N;
+    f |= (a ^ b ^ r) & Z80FLAG_H;
+    if (((a ^ b) & (a ^ r)) & 0x80)
+        f |= Z80FLAG_PV;
+    if (result > 0xFF) // Wrapped below zero
+        f |= Z80FLAG_C;
+    SET_FLAGS(f);
+    return r;
+}
+
+/*
+A compare is a subtraction that throws the result away. The undocumented bits come from the operand, not the result
+*/
+void Z80AluRef_cp8(uint8_t a, uint8_t b) {
+    Z80AluRef_sub8(a, b, 0);
+    SET_FLAGS((FLAGS & ~Z80FLAG_XY) | (b & Z80FLAG_XY));
+}
+
+uint8_t Z80AluRef_and8(uint8_t a, uint8_t b) {
+    uint8_t r = a & b;
+    SET_FLAGS(SZXY(r) | Z80FLAG_H | (Z80Alu_parity(r) ? Z80FLAG_PV : 0));
+    return r;
+}
+
+uint8_t Z80AluRef_xor8(uint8_t a, uint8_t b) {
+    uint8_t r = a ^ b;
+    SET_FLAGS(SZXY(r) | (Z80Alu_parity(r) ? Z80FLAG_PV : 0));
+    return r;
+}
+
+uint8_t Z80AluRef_or8(uint8_t a, uint8_t b) {
+    uint8_t r = a | b;
+    SET_FLAGS(SZXY(r) | (Z80Alu_parity(r) ? Z80FLAG_PV : 0));
+    return r;
+}
+
+uint8_t Z80AluRef_inc8(uint8_t a) {
+    uint8_t r = a + 1;
+    uint8_t f = SZXY(r) | (FLAGS & Z80FLAG_C);
+    if ((a & 0x0F) == 0x0F)
+        f |= Z80FLAG_H;
+    if (a == 0x7F)
+        f |= Z80FLAG_PV;
+    SET_FLAGS(f);
+    return r;
+}
+
+uint8_t Z80AluRef_dec8(uint8_t a) {
+    uint8_t r = a - 1;
+    uint8_t f = SZXY(r) | Z80FLAG_N | (FLAGS & Z80FLAG_C);
+    if ((a & 0x0F) == 0x00)
+        f |= Z80FLAG_H;
+    if (a == 0x80)
+        f |= Z80FLAG_PV;
+    SET_FLAGS(f);
+    return r;
+}
+
+/*
+Decimal adjust after an addition or subtraction of two BCD values
+*/
+uint8_t Z80AluRef_daa(uint8_t a) {
+    uint8_t f = FLAGS;
+    uint8_t diff = 0;
+    uint8_t carry = f & Z80FLAG_C;
+
+    if ((f & Z80FLAG_H) || (a & 0x0F) > 9)
+        diff |= 0x06;
+    if (carry || a > 0x99) {
+        diff |= 0x60;
+        carry = Z80FLAG_C;
+    }
+
+    uint8_t r;
+    uint8_t h;
+    if (f & Z80FLAG_N) {
+        r = a - diff;
+        h = ((f & Z80FLAG_H) && (a & 0x0F) < 6) ? Z80FLAG_H : 0;
+    }
+    else {
+        r = a + diff;
+        h = ((a & 0x0F) > 9) ? Z80FLAG_H : 0;
+    }
+
+    SET_FLAGS(SZXY(r) | h | (f & Z80FLAG_N) | carry | (Z80Alu_parity(r) ? Z80FLAG_PV : 0));
+    return r;
+}
+
+uint8_t Z80AluRef_cpl(uint8_t a) {
+    uint8_t r = ~a;
+    uint8_t f = FLAGS;
+    SET_FLAGS((f & Z80FLAG_S) | (f & Z80FLAG_Z) | (f & Z80FLAG_PV) | (f & Z80FLAG_C) | Z80FLAG_H | Z80FLAG_N | (r & Z80FLAG_XY));
+    return r;
+}
+
+void Z80AluRef_scf(uint8_t a) {
+    uint8_t f = FLAGS;
+    SET_FLAGS((f & Z80FLAG_S) | (f & Z80FLAG_Z) | (f & Z80FLAG_PV) | Z80FLAG_C | (a & Z80FLAG_XY));
+}
+
+/*
+CCF. H takes the carry from before it is inverted
+*/
+void Z80AluRef_ccf(uint8_t a) {
+    uint8_t f = FLAGS;
+    bool carry = (f & Z80FLAG_C) != 0;
+    SET_FLAGS((f & Z80FLAG_S) | (f & Z80FLAG_Z) | (f & Z80FLAG_PV) | (carry ? Z80FLAG_H : Z80FLAG_C) | (a & Z80FLAG_XY));
+}
+
+/*
+ADD HL,rr. H is the carry out of bit 11, and the undocumented bits come from the high byte of the result
+*/
+uint16_t Z80AluRef_add16(uint16_t a, uint16_t b) {
+    uint32_t result = a + b;
+    uint16_t r = (uint16_t)result;
+
+    uint8_t f = FLAGS & (Z80FLAG_S | Z80FLAG_Z | Z80FLAG_PV);
+    if ((a & 0x0FFF) + (b & 0x0FFF) > 0x0FFF)
+        f |= Z80FLAG_H;
+    f |= (r >> 8) & Z80FLAG_XY;
+    if (result > 0xFFFF)
+        f |= Z80FLAG_C;
+    SET_FLAGS(f);
+    return r;
+}
+
+uint16_t Z80AluRef_adc16(uint16_t a, uint16_t b) {
+    unsigned int carry = (FLAGS & Z80FLAG_C) ? 1 : 0;
+    uint32_t result = a + b + carry;
+    int32_t signedResult = (int16_t)a + (int16_t)b + (int32_t)carry;
+    uint16_t r = (uint16_t)result;
+
+    uint8_t f = (r >> 8) & (Z80FLAG_S | Z80FLAG_XY);
+    if (r == 0)
+        f |= Z80FLAG_Z;
+    if ((a & 0x0FFF) + (b & 0x0FFF) + carry > 0x0FFF)
+        f |= Z80FLAG_H;
+    if (signedResult < -0x8000 || signedResult > 0x7FFF)
+        f |= Z80FLAG_PV;
+    if (result > 0xFFFF)
+        f |= Z80FLAG_C;
+    SET_FLAGS(f);
+    return r;
+}
+
+uint16_t Z80AluRef_sbc16(uint16_t a, uint16_t b) {
+    unsigned int carry = (FLAGS & Z80FLAG_C) ? 1 : 0;
+    int32_t signedResult = (int16_t)a - (int16_t)b - (int32_t)carry;
+    uint16_t r = (uint16_t)(a - b - carry);
+
+    uint8_t f = ((r >> 8) & (Z80FLAG_S | Z80FLAG_XY)) | Z80FLAG_N;
+    if (r == 0)
+        f |= Z80FLAG_Z;
+    if ((a & 0x0FFF) < (b & 0x0FFF) + carry)
+        f |= Z80FLAG_H;
+    if (signedResult < -0x8000 || signedResult > 0x7FFF)
+        f |= Z80FLAG_PV;
+    if (a < b + carry)
+        f |= Z80FLAG_C;
+    SET_FLAGS(f);
+    return r;
+}
+
+/*
+Accumulator rotates. Only H, N, C and the undocumented bits change
+*/
+uint8_t Z80AluRef_rlca(uint8_t a) {
+    uint8_t r = (uint8_t)((a << 1) | (a >> 7));
+    SET_FLAGS((FLAGS & (Z80FLAG_S | Z80FLAG_Z | Z80FLAG_PV)) | (r & Z80FLAG_XY) | ((a & 0x80) ? Z80FLAG_C : 0));
+    return r;
+}
+
+uint8_t Z80AluRef_rrca(uint8_t a) {
+    uint8_t r = (uint8_t)((a >> 1) | (a << 7));
+    SET_FLAGS((FLAGS & (Z80FLAG_S | Z80FLAG_Z | Z80FLAG_PV)) | (r & Z80FLAG_XY) | ((a & 0x01) ? Z80FLAG_C : 0));
+    return r;
+}
+
+uint8_t Z80AluRef_rla(uint8_t a) {
+    uint8_t f = FLAGS;
+    uint8_t r = (uint8_t)((a << 1) | ((f & Z80FLAG_C) ? 1 : 0));
+    SET_FLAGS((f & (Z80FLAG_S | Z80FLAG_Z | Z80FLAG_PV)) | (r & Z80FLAG_XY) | ((a & 0x80) ? Z80FLAG_C : 0));
+    return r;
+}
+
+uint8_t Z80AluRef_rra(uint8_t a) {
+    uint8_t f = FLAGS;
+    uint8_t r = (uint8_t)((a >> 1) | ((f & Z80FLAG_C) ? 0x80 : 0));
+    SET_FLAGS((f & (Z80FLAG_S | Z80FLAG_Z | Z80FLAG_PV)) | (r & Z80FLAG_XY) | ((a & 0x01) ? Z80FLAG_C : 0));
+    return r;
+}
+
+uint8_t Z80AluRef_rotateShift(int op, uint8_t v) {
+    uint8_t r;
+    uint8_t carry;
+    switch (op & 7) {
+    case 0: r = (v << 1) | (v >> 7); carry = v >> 7; break; // RLC
+    case 1: r = (v >> 1) | (v << 7); carry = v & 1; break; // RRC
+    case 2: r = (v << 1) | (FLAGS & Z80FLAG_C); carry = v >> 7; break; // RL
+    case 3: r = (v >> 1) | ((FLAGS & Z80FLAG_C) << 7); carry = v & 1; break; // RR
+    case 4: r = v << 1; carry = v >> 7; break; // SLA
+    case 5: r = (v >> 1) | (v & 0x80); carry = v & 1; break; // SRA
+    case 6: r = (v << 1) | 1; carry = v >> 7; break; // SLL (undocumented)
+    default: r = v >> 1; carry = v & 1; break; // SRL
+    }
+    SET_FLAGS(SZXY(r) | (Z80Alu_parity(r) ? Z80FLAG_PV : 0) | carry);
+    return r;
+}
+
+/*
+BIT n. The undocumented bits come from 'xySource', which is the tested value for registers
+*/
+void Z80AluRef_bit(int bit, uint8_t v, uint8_t xySource) {
+    uint8_t tested = v & (1 << bit);
+    uint8_t f = (FLAGS & Z80FLAG_C) | Z80FLAG_H | (xySource & Z80FLAG_XY);
+    if (tested == 0)
+        f |= Z80FLAG_Z | Z80FLAG_PV;
+    f |= tested & Z80FLAG_S; // Only set when testing bit 7
+    SET_FLAGS(f);
+}
+
+void Z80AluRef_flagsSZP(uint8_t v) {
+    SET_FLAGS(SZXY(v) | (Z80Alu_parity(v) ? Z80FLAG_PV : 0) | (FLAGS & Z80FLAG_C));
+}
+
+/********************************************************************
+
+    Z80 ALU self-check
+
+********************************************************************/
+
+/* Number of mismatches logged before the rest are only counted */
+#define SELFCHECK_MAX_REPORTS 4
+#define SELFCHECK_PENDING_KINDS 8 // Operations Z80Alu_selfCheckPending() can leave pending
+#define SELFCHECK_16BIT_CASES 0x10000 // Random operand pairs for each 16 bit operation
+
+// Per machine, as batch workers each run their own
+static Z0_MACHINE_LOCAL unsigned long selfCheckFailures = 0;
+static Z0_MACHINE_LOCAL unsigned long selfCheckCases = 0;
+static Z0_MACHINE_LOCAL int selfCheckReports = 0;
+
+/*
+Records the outcome of one case. 'refAF' and 'fastAF' hold the result above F in the low byte
+*/
+void Z80Alu_selfCheckCompare(const char* op, uint16_t inAF, unsigned int operand, uint32_t refAF, uint32_t fastAF) {
+    selfCheckCases++;
+    if (refAF == fastAF)
+        return;
+
+    selfCheckFailures++;
+    if (selfCheckReports++ < SELFCHECK_MAX_REPORTS) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "ALU self-check %s: AF=%04X operand=%04X expected %04X got %04X\n", op, inAF, operand, refAF, fastAF);
+    }
+}
+
+/* Runs 'call' through the reference and fast functions with the same incoming AF and compares result and F */
+#define SELFCHECK_CASE(name, inAF, operand, refCall, fastCall) { \
+    AF = (inAF); Z80FLAGS_DISCARD(); \
+    uint16_t refR = (uint16_t)(refCall); \
+    uint32_t refAF = ((uint32_t)refR << 8) | FLAGS; \
+    AF = (inAF); Z80FLAGS_DISCARD(); \
+    uint16_t fastR = (uint16_t)(fastCall); \
+    uint32_t fastAF = ((uint32_t)fastR << 8) | FLAGS; \
+    Z80Alu_selfCheckCompare(name, inAF, operand, refAF, fastAF); \
+}
+
+/* As SELFCHECK_CASE, after an 8 bit operation. The reference builds its F at once, the fast ALU leaves it pending */
+#define SELFCHECK_CASE_AFTER(name, inAF, kind, a, b, refCall, fastCall) { \
+    AF = (inAF); Z80FLAGS_DISCARD(); Z80Alu_selfCheckPending(kind, a, b, true); \
+    uint16_t refR = (uint16_t)(refCall); \
+    uint32_t refAF = ((uint32_t)refR << 8) | FLAGS; \
+    AF = (inAF); Z80FLAGS_DISCARD(); Z80Alu_selfCheckPending(kind, a, b, false); \
+    uint16_t fastR = (uint16_t)(fastCall); \
+    uint32_t fastAF = ((uint32_t)fastR << 8) | FLAGS; \
+    Z80Alu_selfCheckCompare(name, inAF, ((kind) << 8) | (b), refAF, fastAF); \
+}
+
+/* Runs 'call' with the flags of an 8 bit operation still pending, then again with F built from them first, and compares result and F */
+#define SELFCHECK_PENDING_CASE(name, inAF, kind, a, b, call) { \
+    AF = (inAF); Z80FLAGS_DISCARD(); Z80Alu_selfCheckPending(kind, a, b, false); \
+    uint16_t lazyR = (uint16_t)(call); \
+    uint32_t lazyAF = ((uint32_t)lazyR << 8) | FLAGS; \
+    AF = (inAF); Z80FLAGS_DISCARD(); Z80Alu_selfCheckPending(kind, a, b, false); Z80Flags_materialise(); \
+    uint16_t builtR = (uint16_t)(call); \
+    uint32_t builtAF = ((uint32_t)builtR << 8) | FLAGS; \
+    Z80Alu_selfCheckCompare(name, inAF, ((kind) << 8) | (b), builtAF, lazyAF); \
+}
+
+/*
+Runs an 8 bit operation, ADD, SUB, CP, AND, XOR, OR, INC or DEC by 'kind'. The fast ALU leaves its flags pending, the
+'reference' one writes F
+*/
+void Z80Alu_selfCheckPending(int kind, uint8_t a, uint8_t b, bool reference) {
+    switch (kind) {
+    case 0: reference ? Z80AluRef_add8(a, b, 0) : Z80Alu_add8(a, b, 0); break;
+    case 1: reference ? Z80AluRef_sub8(a, b, 1) : Z80Alu_sub8(a, b, 1); break;
+    case 2: reference ? Z80AluRef_cp8(a, b) : Z80Alu_cp8(a, b); break;
+    case 3: reference ? Z80AluRef_and8(a, b) : Z80Alu_and8(a, b); break;
+    case 4: reference ? Z80AluRef_xor8(a, b) : Z80Alu_xor8(a, b); break;
+    case 5: reference ? Z80AluRef_or8(a, b) : Z80Alu_or8(a, b); break;
+    case 6: reference ? Z80AluRef_inc8(a) : Z80Alu_inc8(a); break;
+    default: reference ? Z80AluRef_dec8(a) : Z80Alu_dec8(a); break;
+    }
+}
+
+/*
+Exhaustively compares every table driven ALU operation with its reference over all operands and every incoming flag state the operation reads.
+Returns true if they all match. The registers are restored afterwards
+*/
+bool Z80Alu_selfCheck() {
+    Z80FLAGS_SYNC();
+    uint16_t savedAF = AF;
+    selfCheckFailures = 0;
+    selfCheckCases = 0;
+    selfCheckReports = 0;
+
+    for (unsigned int a = 0; a < 0x100; a++) {
+        for (unsigned int b = 0; b < 0x100; b++) {
+            for (uint8_t carry = 0; carry < 2; carry++) {
+                SELFCHECK_CASE("ADD/ADC", a << 8, b | (carry << 8), Z80AluRef_add8(a, b, carry), Z80Alu_add8(a, b, carry));
+                SELFCHECK_CASE("SUB/SBC", a << 8, b | (carry << 8), Z80AluRef_sub8(a, b, carry), Z80Alu_sub8(a, b, carry));
+            }
+            SELFCHECK_CASE("CP", a << 8, b, (Z80AluRef_cp8(a, b), 0), (Z80Alu_cp8(a, b), 0));
+            SELFCHECK_CASE("AND", a << 8, b, Z80AluRef_and8(a, b), Z80Alu_and8(a, b));
+            SELFCHECK_CASE("XOR", a << 8, b, Z80AluRef_xor8(a, b), Z80Alu_xor8(a, b));
+            SELFCHECK_CASE("OR", a << 8, b, Z80AluRef_or8(a, b), Z80Alu_or8(a, b));
+        }
+    }
+
+    // Operations that read F are run against every incoming F
+    for (unsigned int f = 0; f < 0x100; f++) {
+        for (unsigned int v = 0; v < 0x100; v++) {
+            uint16_t inAF = (uint16_t)((v << 8) | f);
+            SELFCHECK_CASE("INC", inAF, v, Z80AluRef_inc8(v), Z80Alu_inc8(v));
+            SELFCHECK_CASE("DEC", inAF, v, Z80AluRef_dec8(v), Z80Alu_dec8(v));
+            SELFCHECK_CASE("DAA", inAF, v, Z80AluRef_daa(v), Z80Alu_daa(v));
+            SELFCHECK_CASE("SZP", inAF, v, (Z80AluRef_flagsSZP(v), 0), (Z80Alu_flagsSZP(v), 0));
+            SELFCHECK_CASE("CPL", inAF, v, Z80AluRef_cpl(v), Z80Alu_cpl(v));
+            SELFCHECK_CASE("SCF", inAF, v, (Z80AluRef_scf(v), 0), (Z80Alu_scf(v), 0));
+            SELFCHECK_CASE("CCF", inAF, v, (Z80AluRef_ccf(v), 0), (Z80Alu_ccf(v), 0));
+            SELFCHECK_CASE("RLCA", inAF, v, Z80AluRef_rlca(v), Z80Alu_rlca(v));
+            SELFCHECK_CASE("RRCA", inAF, v, Z80AluRef_rrca(v), Z80Alu_rrca(v));
+            SELFCHECK_CASE("RLA", inAF, v, Z80AluRef_rla(v), Z80Alu_rla(v));
+            SELFCHECK_CASE("RRA", inAF, v, Z80AluRef_rra(v), Z80Alu_rra(v));
+            for (int op = 0; op < 8; op++)
+                SELFCHECK_CASE("ROT/SHIFT", inAF, (op << 8) | v, Z80AluRef_rotateShift(op, v), Z80Alu_rotateShift(op, v));
+            for (int bit = 0; bit < 8; bit++) {
+                // BIT only keeps C from the incoming F, and takes the undocumented bits from xySource
+                SELFCHECK_CASE("BIT", inAF, (bit << 8) | v, (Z80AluRef_bit(bit, v, (uint8_t)f), 0), (Z80Alu_bit(bit, v, (uint8_t)f), 0));
+            }
+        }
+    }
+
+    // 16 bit operations over random operands, from every F that differs in a flag they keep or read
+    uint32_t seed = 0x2545F491;
+    for (int i = 0; i < SELFCHECK_16BIT_CASES; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        uint16_t a = (uint16_t)seed;
+        uint16_t b = (uint16_t)(seed >> 16);
+        for (int keep = 0; keep < 2; keep++) {
+            uint16_t inAF = (uint16_t)(keep ? (a & 0xFF00) | 0xC5 : a & 0xFF00);
+            SELFCHECK_CASE("ADD16", inAF, b, Z80AluRef_add16(a, b), Z80Alu_add16(a, b));
+            SELFCHECK_CASE("ADC16", inAF, b, Z80AluRef_adc16(a, b), Z80Alu_adc16(a, b));
+            SELFCHECK_CASE("SBC16", inAF, b, Z80AluRef_sbc16(a, b), Z80Alu_sbc16(a, b));
+        }
+    }
+
+    // Operations that keep part of F must see the flags of a pending operation, as if F had been built before them.
+    // The stale F underneath is made to differ from the pending flags
+    for (int kind = 0; kind < SELFCHECK_PENDING_KINDS; kind++) {
+        for (unsigned int a = 0; a < 0x100; a++) {
+            for (unsigned int b = 0; b < 0x100; b++) {
+                uint16_t inAF = (uint16_t)((a << 8) | (b ^ 0x5A));
+                uint16_t pair = (uint16_t)((a << 8) | b);
+                SELFCHECK_PENDING_CASE("pending/CPL", inAF, kind, a, b, Z80Alu_cpl(b));
+                SELFCHECK_PENDING_CASE("pending/SCF", inAF, kind, a, b, (Z80Alu_scf(b), 0));
+                SELFCHECK_PENDING_CASE("pending/CCF", inAF, kind, a, b, (Z80Alu_ccf(b), 0));
+                SELFCHECK_PENDING_CASE("pending/DAA", inAF, kind, a, b, Z80Alu_daa(b));
+                SELFCHECK_PENDING_CASE("pending/RLCA", inAF, kind, a, b, Z80Alu_rlca(b));
+                SELFCHECK_PENDING_CASE("pending/RRCA", inAF, kind, a, b, Z80Alu_rrca(b));
+                SELFCHECK_PENDING_CASE("pending/RLA", inAF, kind, a, b, Z80Alu_rla(b));
+                SELFCHECK_PENDING_CASE("pending/RRA", inAF, kind, a, b, Z80Alu_rra(b));
+                SELFCHECK_PENDING_CASE("pending/INC", inAF, kind, a, b, Z80Alu_inc8(b));
+                SELFCHECK_PENDING_CASE("pending/DEC", inAF, kind, a, b, Z80Alu_dec8(b));
+                SELFCHECK_PENDING_CASE("pending/SZP", inAF, kind, a, b, (Z80Alu_flagsSZP(b), 0));
+                SELFCHECK_PENDING_CASE("pending/RL", inAF, kind, a, b, Z80Alu_rotateShift(2, b));
+                SELFCHECK_PENDING_CASE("pending/RR", inAF, kind, a, b, Z80Alu_rotateShift(3, b));
+                SELFCHECK_PENDING_CASE("pending/BIT", inAF, kind, a, b, (Z80Alu_bit(b & 7, b, (uint8_t)a), 0));
+                SELFCHECK_PENDING_CASE("pending/ADD16", inAF, kind, a, b, Z80Alu_add16(pair, (uint16_t)~pair));
+                SELFCHECK_PENDING_CASE("pending/ADC16", inAF, kind, a, b, Z80Alu_adc16(pair, (uint16_t)~pair));
+                SELFCHECK_PENDING_CASE("pending/SBC16", inAF, kind, a, b, Z80Alu_sbc16(pair, pair));
+
+                // And the same as the reference, which has F built by then
+                SELFCHECK_CASE_AFTER("after/CPL", inAF, kind, a, b, Z80AluRef_cpl(b), Z80Alu_cpl(b));
+                SELFCHECK_CASE_AFTER("after/SCF", inAF, kind, a, b, (Z80AluRef_scf(b), 0), (Z80Alu_scf(b), 0));
+                SELFCHECK_CASE_AFTER("after/CCF", inAF, kind, a, b, (Z80AluRef_ccf(b), 0), (Z80Alu_ccf(b), 0));
+                SELFCHECK_CASE_AFTER("after/RLCA", inAF, kind, a, b, Z80AluRef_rlca(b), Z80Alu_rlca(b));
+                SELFCHECK_CASE_AFTER("after/RRCA", inAF, kind, a, b, Z80AluRef_rrca(b), Z80Alu_rrca(b));
+                SELFCHECK_CASE_AFTER("after/RLA", inAF, kind, a, b, Z80AluRef_rla(b), Z80Alu_rla(b));
+                SELFCHECK_CASE_AFTER("after/RRA", inAF, kind, a, b, Z80AluRef_rra(b), Z80Alu_rra(b));
+                SELFCHECK_CASE_AFTER("after/SZP", inAF, kind, a, b, (Z80AluRef_flagsSZP(b), 0), (Z80Alu_flagsSZP(b), 0));
+                SELFCHECK_CASE_AFTER("after/ADD16", inAF, kind, a, b, Z80AluRef_add16(pair, (uint16_t)~pair), Z80Alu_add16(pair, (uint16_t)~pair));
+                SELFCHECK_CASE_AFTER("after/ADC16", inAF, kind, a, b, Z80AluRef_adc16(pair, (uint16_t)~pair), Z80Alu_adc16(pair, (uint16_t)~pair));
+                SELFCHECK_CASE_AFTER("after/SBC16", inAF, kind, a, b, Z80AluRef_sbc16(pair, pair), Z80Alu_sbc16(pair, pair));
+            }
+        }
+    }
+
+    AF = savedAF;
+    Z80FLAGS_DISCARD();
+    if (selfCheckFailures == 0) {
+        formattedLog(stdlog, LOGTYPE_MSG, "ALU self-check passed: %lu cases\n", selfCheckCases);
+    }
+    else {
+        formattedLog(stdlog, LOGTYPE_ERROR, "ALU self-check FAILED: %lu of %lu cases differ from the reference\n", selfCheckFailures, selfCheckCases);
+    }
+    return selfCheckFailures == 0;
+}
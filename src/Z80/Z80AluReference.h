@@ -0,0 +1,61 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80AluReference.h : Slow reference for the Z80 ALU, used to check the table driven ALU
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************
+
+    Z80 ALU reference functions
+    Same behaviour as the matching Z80Alu_ functions, computed flag by flag
+
+********************************************************************/
+
+uint8_t Z80AluRef_add8(uint8_t a, uint8_t b, uint8_t carry);
+uint8_t Z80AluRef_sub8(uint8_t a, uint8_t b, uint8_t carry);
+void Z80AluRef_cp8(uint8_t a, uint8_t b);
+uint8_t Z80AluRef_and8(uint8_t a, uint8_t b);
+uint8_t Z80AluRef_xor8(uint8_t a, uint8_t b);
+uint8_t Z80AluRef_or8(uint8_t a, uint8_t b);
+uint8_t Z80AluRef_inc8(uint8_t a);
+uint8_t Z80AluRef_dec8(uint8_t a);
+uint8_t Z80AluRef_daa(uint8_t a);
+uint8_t Z80AluRef_cpl(uint8_t a);
+void Z80AluRef_scf(uint8_t a);
+void Z80AluRef_ccf(uint8_t a);
+uint16_t Z80AluRef_add16(uint16_t a, uint16_t b);
+uint16_t Z80AluRef_adc16(uint16_t a, uint16_t b);
+uint16_t Z80AluRef_sbc16(uint16_t a, uint16_t b);
+uint8_t Z80AluRef_rlca(uint8_t a);
+uint8_t Z80AluRef_rrca(uint8_t a);
+uint8_t Z80AluRef_rla(uint8_t a);
+uint8_t Z80AluRef_rra(uint8_t a);
+uint8_t Z80AluRef_rotateShift(int op, uint8_t v);
+void Z80AluRef_bit(int bit, uint8_t v, uint8_t xySource);
+void Z80AluRef_flagsSZP(uint8_t v);
+
+/********************************************************************
+
+    Z80 ALU self-check
+
+********************************************************************/
+
+void Z80Alu_selfCheckCompare(const char* op, uint16_t inAF, unsigned int operand, uint32_t refAF, uint32_t fastAF);
+void Z80Alu_selfCheckPending(int kind, uint8_t a, uint8_t b, bool reference);
+bool Z80Alu_selfCheck();
@@ -0,0 +1,404 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Block.c : Basic block translation cache. Straight-line code is decoded once into an array of micro-ops and run from there
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Z80Block.h"
+#include "Z80.h"
+#include "Z80Instructions.h"
+#include "Z80Execute.h"
+#include "Z80Step.h"
+#include "Z80Jit.h"
+#include "Z80Threaded.h"
+#include "Z80Idle.h"
+#include "Z80Fusion.h"
+
+#include "../Signals.h"
+#include "../SysIO/Log.h"
+#include "../Memory/MemoryController.h"
+
+/* Z80 Instruction */
+extern Z0_MACHINE_LOCAL Z80_Instr_t cInstr;
+
+/* Cache state */
+Z0_MACHINE_LOCAL bool Z80Block_enabled = true;
+Z0_MACHINE_LOCAL Z80Block_t** Z80Block_map = NULL; // Block for each entry PC, NULL if none has been built. Allocated by Z80Block_init()
+Z0_MACHINE_LOCAL uint32_t Z80Block_pageVersions[Z80_BLOCK_NUM_PAGES]; // Bumped on every write to the page
+Z0_MACHINE_LOCAL bool Z80Block_pageHasCode[Z80_BLOCK_NUM_PAGES]; // Set once a block has been built over the page
+Z0_MACHINE_LOCAL uint32_t Z80Block_codeWrites = 0; // Bumped on writes to pages with code, so a running block knows to recheck itself
+
+/* Block storage. When it runs out, every block is dropped and the cache starts again */
+Z0_MACHINE_LOCAL Z80Block_t* Z80Block_pool = NULL; // Z80_BLOCK_POOL_SIZE blocks, allocated by Z80Block_init()
+Z0_MACHINE_LOCAL int Z80Block_poolUsed = 0;
+
+/* Statistics */
+Z0_MACHINE_LOCAL uint64_t Z80Block_built = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Block_entries = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Block_chainedEntries = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Block_invalidations = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Block_flushes = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Block_opsBuilt = 0;
+
+/********************************************************************
+
+    Z80 Block Cache Functions
+
+********************************************************************/
+
+/*
+Empties the cache and starts watching memory writes so self-modifying code is seen
+*/
+void Z80Block_init() {
+    if (Z80Block_map == NULL)
+        Z80Block_map = malloc(Z80_BLOCK_MAP_SIZE * sizeof(Z80Block_t*));
+    if (Z80Block_pool == NULL)
+        Z80Block_pool = malloc(Z80_BLOCK_POOL_SIZE * sizeof(Z80Block_t));
+    if (Z80Block_map == NULL || Z80Block_pool == NULL) {
+        formattedLog(stdlog, LOGTYPE_WARN, "Unable to allocate the block cache, it is disabled\n");
+        Z80Block_enabled = false;
+        return;
+    }
+
+    Z80Block_flush();
+    Z80Block_flushes = 0;
+    memoryController_addWriteListener(&Z80Block_onMemoryWrite);
+    formattedLog(debuglog, LOGTYPE_DEBUG, "Block cache: %i blocks of up to %i ops, enabled=%i\n", Z80_BLOCK_POOL_SIZE, Z80_BLOCK_MAX_OPS, Z80Block_enabled);
+}
+
+/*
+Frees the cache and puts it back as it was before Z80Block_init()
+*/
+void Z80Block_destroy() {
+    free(Z80Block_map);
+    free(Z80Block_pool);
+    Z80Block_map = NULL;
+    Z80Block_pool = NULL;
+    Z80Block_poolUsed = 0;
+    Z80Block_enabled = true;
+    memset(Z80Block_pageVersions, 0, sizeof(Z80Block_pageVersions));
+    memset(Z80Block_pageHasCode, 0, sizeof(Z80Block_pageHasCode));
+    Z80Block_codeWrites = 0;
+
+    Z80Block_built = 0;
+    Z80Block_entries = 0;
+    Z80Block_chainedEntries = 0;
+    Z80Block_invalidations = 0;
+    Z80Block_flushes = 0;
+    Z80Block_opsBuilt = 0;
+}
+
+/*
+Drops every block
+*/
+void Z80Block_flush() {
+    memset(Z80Block_map, 0, Z80_BLOCK_MAP_SIZE * sizeof(Z80Block_t*));
+    memset(Z80Block_pageHasCode, 0, sizeof(Z80Block_pageHasCode));
+    Z80Block_poolUsed = 0;
+    Z80Block_flushes++;
+}
+
+/*
+Memory write listener. Every block over the page goes stale, they are rebuilt the next time they are entered
+*/
+void Z80Block_onMemoryWrite(uint16_t address) {
+    uint8_t page = address >> Z80_BLOCK_PAGE_SHIFT;
+    Z80Block_pageVersions[page]++;
+    if (Z80Block_pageHasCode[page])
+        Z80Block_codeWrites++;
+}
+
+/*
+True if nothing has been written to the pages the block was built from
+*/
+bool Z80Block_isCurrent(Z80Block_t* block) {
+    return block->valid && Z80Block_pageVersions[block->firstPage] == block->firstPageVersion
+        && Z80Block_pageVersions[block->lastPage] == block->lastPageVersion;
+}
+
+/*
+Returns the block starting at 'pc', building or rebuilding it if needed
+*/
+Z80Block_t* Z80Block_lookup(uint16_t pc) {
+    Z80Block_t* block = Z80Block_map[pc];
+    if (block != NULL) {
+        if (Z80Block_isCurrent(block))
+            return block;
+        // Stale, so it gets rebuilt in place. Chains pointing at it stay correct as the entry PC is the same
+        Z80Block_invalidations++;
+    }
+    else {
+        if (Z80Block_poolUsed >= Z80_BLOCK_POOL_SIZE)
+            Z80Block_flush();
+        block = &Z80Block_pool[Z80Block_poolUsed++];
+        Z80Block_map[pc] = block;
+    }
+
+    Z80Block_build(block, pc);
+    return block;
+}
+
+/*
+Decodes instructions from 'pc' into the block until one that can change the flow of control, or the block is full
+*/
+void Z80Block_build(Z80Block_t* block, uint16_t pc) {
+    uint16_t address = pc;
+
+    block->pc = pc;
+    block->numOps = 0;
+    block->hasTarget = false;
+    block->targetChain = NULL;
+    block->endChain = NULL;
+    block->entryCount = 0;
+    block->native = NULL;
+    block->nativeOps = 0;
+
+    while (block->numOps < Z80_BLOCK_MAX_OPS) {
+        uint16_t opPC = address;
+        uint8_t m1Cycles = Z80_decodeAt(address);
+
+        Z80MicroOp_t* op = &block->ops[block->numOps++];
+        Z80Block_captureOp(op, m1Cycles);
+        address += cInstr.instrByteLen;
+
+        if (Z80Block_endsBlock(op->prefix, op->opcode)) {
+            block->hasTarget = Z80Block_staticTarget(op, opPC, &block->targetPC);
+            break;
+        }
+        // Keep the block inside two pages
+        if ((uint16_t)(address - pc) >= 0x80)
+            break;
+    }
+
+    block->endPC = address;
+    Z80Fusion_markBlock(block);
+
+    block->firstPage = pc >> Z80_BLOCK_PAGE_SHIFT;
+    block->lastPage = (uint16_t)(address - 1) >> Z80_BLOCK_PAGE_SHIFT;
+    block->firstPageVersion = Z80Block_pageVersions[block->firstPage];
+    block->lastPageVersion = Z80Block_pageVersions[block->lastPage];
+    Z80Block_pageHasCode[block->firstPage] = true;
+    Z80Block_pageHasCode[block->lastPage] = true;
+    block->valid = true;
+
+    internalState = Z80State_Fetch;
+    Z80Block_built++;
+    Z80Block_opsBuilt += block->numOps;
+}
+
+/*
+Fills in a micro-op from the instruction just decoded into cInstr
+*/
+void Z80Block_captureOp(Z80MicroOp_t* op, uint8_t m1Cycles) {
+    op->exec = cInstr.execFunction;
+    op->prefix = cInstr.prefix;
+    op->opcode = cInstr.opcode;
+    op->operand0 = cInstr.operand0;
+    op->operand1 = cInstr.operand1;
+    op->len = cInstr.instrByteLen;
+    op->tStates = cInstr.tStates;
+    op->m1Cycles = m1Cycles;
+}
+
+/*
+True for instructions that can move PC anywhere other than the next instruction: jumps, calls, returns, RST, HALT and the repeating block instructions
+*/
+bool Z80Block_endsBlock(uint16_t prefix, uint8_t opcode) {
+    uint8_t x = opcode >> 6;
+    uint8_t z = opcode & 0x07;
+
+    switch (prefix) {
+    case PREFIX_BITS:
+    case PREFIX_IX_BITS:
+    case PREFIX_IY_BITS:
+        return false;
+    case PREFIX_EXX:
+        // RETN / RETI, and LDIR, CPIR, INIR, OTIR and their decrementing forms
+        return (x == 1 && z == 5) || (opcode >= 0xB0 && z <= 3);
+    default:
+        // DD and FD opcodes without an index form behave as the unprefixed ones
+        if (x == 0)
+            return opcode == 0x10 || opcode == 0x18 || opcode == 0x20 || opcode == 0x28 || opcode == 0x30 || opcode == 0x38;
+        if (x == 1)
+            return opcode == 0x76;
+        if (x == 3)
+            return z == 0 || z == 2 || z == 4 || z == 7 || opcode == 0xC3 || opcode == 0xC9 || opcode == 0xCD || opcode == 0xE9;
+        return false;
+    }
+}
+
+/*
+Puts the destination of a direct jump, call or RST in 'target'. Returns false if the destination isn't fixed, as with RET and JP (HL)
+*/
+bool Z80Block_staticTarget(Z80MicroOp_t* op, uint16_t opPC, uint16_t* target) {
+    if (op->prefix == PREFIX_EXX || op->prefix == PREFIX_BITS || op->prefix == PREFIX_IX_BITS || op->prefix == PREFIX_IY_BITS)
+        return false;
+
+    // DJNZ e, JR e and JR cc,e
+    if (op->opcode == 0x10 || op->opcode == 0x18 || (op->opcode & 0xE7) == 0x20) {
+        *target = (uint16_t)(opPC + op->len + (int8_t)op->operand0);
+        return true;
+    }
+    // JP nn, CALL nn, JP cc,nn and CALL cc,nn
+    if (op->opcode == 0xC3 || op->opcode == 0xCD || (op->opcode & 0xC7) == 0xC2 || (op->opcode & 0xC7) == 0xC4) {
+        *target = (uint16_t)((op->operand0 << 8) | op->operand1);
+        return true;
+    }
+
+    // RST p
+    if ((op->opcode & 0xC7) == 0xC7) {
+        *target = op->opcode & 0x38;
+        return true;
+    }
+    return false;
+}
+
+/********************************************************************
+
+    Z80 Block Execution Functions
+
+********************************************************************/
+
+/*
+Finds the block at PC. When the previous block left for its end or its jump target, the block remembered there is used if it is still current
+*/
+Z80Block_t* Z80Block_next(Z80Block_t* previous) {
+    Z80Block_t** chain = NULL;
+    if (previous != NULL) {
+        if (PC == previous->endPC)
+            chain = &previous->endChain;
+        else if (previous->hasTarget && PC == previous->targetPC)
+            chain = &previous->targetChain;
+    }
+
+    if (chain != NULL && *chain != NULL && (*chain)->pc == PC && Z80Block_isCurrent(*chain)) {
+        Z80Block_chainedEntries++;
+        return *chain;
+    }
+
+    Z80Block_t* block = Z80Block_lookup(PC);
+    if (chain != NULL)
+        *chain = block;
+    return block;
+}
+
+/*
+Runs blocks until at least 'tStates' T-states have elapsed, or the CPU stops.
+Interrupts are polled before every op, so the instructions and T-states run are the same as stepping one instruction at a time
+*/
+uint64_t Z80Block_run(uint64_t tStates) {
+    uint64_t executed = 0;
+    Z80Block_t* block = NULL;
+
+    while (executed < tStates && !Z80_wait && internalState != Z80State_Failure) {
+        // Read-only code already has its ops, so it runs without blocks
+        if (Z80THREADED_COVERS(PC)) {
+            executed += Z80Threaded_run(tStates - executed);
+            block = NULL;
+            continue;
+        }
+
+        // A backward branch out of the last block may have closed a tight loop
+        if (block != NULL && Z80Idle_enabled && Z80IDLE_IS_LOOP_BRANCH(block->endPC - 1, PC)) {
+            uint64_t skipped = Z80Idle_loopHead();
+            if (skipped > 0) {
+                executed += skipped;
+                continue;
+            }
+        }
+
+        block = Z80Block_next(block);
+        Z80Block_entries++;
+
+        // Hot blocks run compiled code for as many of their ops as it covers
+        uint32_t codeWrites = Z80Block_codeWrites;
+        int i = 0;
+        if (Z80Jit_enabled) {
+            i = Z80Jit_enter(block, &executed, tStates);
+            if (i < 0)
+                continue;
+            codeWrites = Z80Block_codeWrites;
+        }
+
+        for (; i < block->numOps && executed < tStates; i++) {
+            // Interrupts are accepted between instructions
+            if (Z80_INTERRUPT_POSSIBLE()) {
+                int interruptTStates = Z80_pollInterrupts();
+                if (interruptTStates > 0) {
+                    Z80_tStates += interruptTStates;
+                    executed += interruptTStates;
+                    break;
+                }
+            }
+
+            // A run of ops with a fused handler goes through it in one call
+            if (block->fused[i] != 0) {
+                const Z80MicroOp_t* group[Z80_FUSION_MAX_OPS];
+                int numOps = Z80Fusion_patterns[block->fused[i] - 1].numOps;
+                uint16_t nextPC = PC;
+                for (int j = 0; j < numOps; j++) {
+                    group[j] = &block->ops[i + j];
+                    nextPC += group[j]->len;
+                }
+                uint64_t fusedTStates;
+                Z80FUSION_RUN(block->fused[i], group, tStates - executed, fusedTStates);
+                if (fusedTStates > 0) {
+                    executed += fusedTStates;
+                    i += numOps - 1;
+                    if (PC != nextPC)
+                        break;
+                    if (Z80Block_codeWrites != codeWrites) {
+                        if (!Z80Block_isCurrent(block))
+                            break;
+                        codeWrites = Z80Block_codeWrites;
+                    }
+                    continue;
+                }
+            }
+
+            Z80MicroOp_t* op = &block->ops[i];
+            Z80_ISSUE_MICRO_OP(op);
+
+            uint16_t nextPC = PC + op->len;
+            PC = nextPC;
+            internalState = Z80State_Execute;
+            int execFuncResponse = op->exec();
+
+            Z80_tStates += cInstr.tStates;
+            executed += cInstr.tStates;
+            Z80_instructionsExecuted++;
+
+            if (execFuncResponse != INSTR_EXEC_SUCCESS) {
+                formattedLog(stdlog, LOGTYPE_ERROR, "Block execution has failed: opcode %04X %02X returned %i\n", cInstr.prefix, cInstr.opcode, execFuncResponse);
+                signals_raiseSignal(&signal_WAIT);
+                internalState = Z80State_Failure;
+                return executed;
+            }
+            internalState = Z80State_Fetch;
+
+            // Leave when the op branched, or something wrote over code and this block might be stale
+            if (PC != nextPC)
+                break;
+            if (Z80Block_codeWrites != codeWrites) {
+                if (!Z80Block_isCurrent(block))
+                    break;
+                codeWrites = Z80Block_codeWrites;
+            }
+        }
+    }
+    return executed;
+}
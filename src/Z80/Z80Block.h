@@ -0,0 +1,119 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Block.h : Basic block translation cache. Straight-line code is decoded once into an array of micro-ops and run from there
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../Z0Machine.h"
+
+/* Block limits */
+#define Z80_BLOCK_MAX_OPS 32
+#define Z80_BLOCK_POOL_SIZE 4096
+#define Z80_BLOCK_MAP_SIZE 0x10000 // One entry per PC
+
+/* Pages used for invalidation. These match the memory controller's direct access pages */
+#define Z80_BLOCK_PAGE_SHIFT 8
+#define Z80_BLOCK_NUM_PAGES 0x100
+
+/* One decoded instruction, holding only what the execute functions need */
+typedef struct Z80MicroOp {
+    const int (*exec)(); // Handler from the packed opcode tables
+    uint16_t prefix;
+    uint8_t opcode;
+    uint8_t operand0;
+    uint8_t operand1;
+    uint8_t len; // Bytes, PC moves on by this before the op runs
+    uint8_t tStates; // Base T-states, branches add to this as they execute
+    uint8_t m1Cycles; // Opcode fetches, each one increments R
+} Z80MicroOp_t;
+
+/* Puts an op into cInstr for its execute function and does its opcode fetches' R increments */
+#define Z80_ISSUE_MICRO_OP(op) do { \
+    cInstr.prefix = (op)->prefix; \
+    cInstr.opcode = (op)->opcode; \
+    cInstr.operand0 = (op)->operand0; \
+    cInstr.operand1 = (op)->operand1; \
+    cInstr.instrByteLen = (op)->len; \
+    cInstr.tStates = (op)->tStates; \
+    cInstr.execFunction = (op)->exec; \
+    Z80_ADVANCE_R((op)->m1Cycles); \
+} while (0)
+
+typedef struct Z80Block {
+    uint16_t pc; // Entry PC
+    uint16_t endPC; // Address after the last op. When PC lands here the block ran straight through
+    uint16_t targetPC; // Where the final jump, call or RST goes, if it can be known when the block is built
+    bool hasTarget;
+    bool valid;
+    uint8_t numOps;
+    uint8_t firstPage;
+    uint8_t lastPage;
+    uint32_t firstPageVersion; // Page versions when the block was built. A write since then makes it stale
+    uint32_t lastPageVersion;
+    struct Z80Block* targetChain; // Block last seen at targetPC, checked before it is followed
+    struct Z80Block* endChain; // Block last seen at endPC
+    uint32_t entryCount; // Times the block has been entered since it was built, used to find hot blocks
+    void* native; // Compiled code for the first nativeOps ops, NULL if the block hasn't been compiled
+    uint8_t nativeOps;
+    Z80MicroOp_t ops[Z80_BLOCK_MAX_OPS];
+    uint8_t fused[Z80_BLOCK_MAX_OPS]; // Z80Fusion pattern starting at each op, as its index + 1, or 0
+} Z80Block_t;
+
+/* Cache state */
+extern Z0_MACHINE_LOCAL bool Z80Block_enabled;
+extern Z0_MACHINE_LOCAL Z80Block_t** Z80Block_map;
+extern Z0_MACHINE_LOCAL uint32_t Z80Block_pageVersions[Z80_BLOCK_NUM_PAGES];
+extern Z0_MACHINE_LOCAL bool Z80Block_pageHasCode[Z80_BLOCK_NUM_PAGES];
+extern Z0_MACHINE_LOCAL uint32_t Z80Block_codeWrites;
+extern Z0_MACHINE_LOCAL Z80Block_t* Z80Block_pool;
+extern Z0_MACHINE_LOCAL int Z80Block_poolUsed;
+
+/* Statistics */
+extern Z0_MACHINE_LOCAL uint64_t Z80Block_built;
+extern Z0_MACHINE_LOCAL uint64_t Z80Block_entries;
+extern Z0_MACHINE_LOCAL uint64_t Z80Block_chainedEntries;
+extern Z0_MACHINE_LOCAL uint64_t Z80Block_invalidations;
+extern Z0_MACHINE_LOCAL uint64_t Z80Block_flushes;
+extern Z0_MACHINE_LOCAL uint64_t Z80Block_opsBuilt;
+
+/********************************************************************
+
+    Z80 Block Cache Functions
+
+********************************************************************/
+
+void Z80Block_init();
+void Z80Block_destroy();
+void Z80Block_flush();
+void Z80Block_onMemoryWrite(uint16_t address);
+bool Z80Block_isCurrent(Z80Block_t* block);
+Z80Block_t* Z80Block_lookup(uint16_t pc);
+void Z80Block_build(Z80Block_t* block, uint16_t pc);
+void Z80Block_captureOp(Z80MicroOp_t* op, uint8_t m1Cycles);
+bool Z80Block_endsBlock(uint16_t prefix, uint8_t opcode);
+bool Z80Block_staticTarget(Z80MicroOp_t* op, uint16_t opPC, uint16_t* target);
+
+/********************************************************************
+
+    Z80 Block Execution Functions
+
+********************************************************************/
+
+Z80Block_t* Z80Block_next(Z80Block_t* previous);
+uint64_t Z80Block_run(uint64_t tStates);
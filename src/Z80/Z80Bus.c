@@ -0,0 +1,266 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Bus.c : Machine cycle engine. Runs the stepped engine and reports every bus machine cycle to the transaction listeners
+
+*/
+
+#include "Z80Bus.h"
+#include "Z80Step.h"
+
+#include "../Signals.h"
+#include "../SysIO/Log.h"
+#include "../Memory/MemoryController.h"
+
+/* Machine cycle engine state */
+Z0_MACHINE_LOCAL bool Z80Bus_enabled = false;
+Z0_MACHINE_LOCAL uint64_t Z80Bus_transactions = 0;
+
+/* Transaction listeners */
+Z0_MACHINE_LOCAL void (*Z80Bus_listeners[MAX_NUMBER_OF_BUS_LISTENERS])(const Z80BusTransaction_t* transaction);
+Z0_MACHINE_LOCAL uint8_t Z80Bus_nListeners = 0;
+
+/* Timing of the instruction in progress */
+Z0_MACHINE_LOCAL const uint8_t* Z80Bus_cycle = NULL; // Next entry of the instruction's Z80Opcodes.def cycle list, or NULL past its end
+Z0_MACHINE_LOCAL uint64_t Z80Bus_cycleStart = 0; // T-state the next cycle starts on
+
+/* Last transaction issued, for Z80Bus_syncPins() */
+Z0_MACHINE_LOCAL Z80BusTransaction_t Z80Bus_last = { 0 };
+
+/* Fetches made while decoding, before the instruction and its cycle list are known */
+Z0_MACHINE_LOCAL Z80BusTransaction_t Z80Bus_pending[Z80_BUS_MAX_PENDING];
+Z0_MACHINE_LOCAL uint8_t Z80Bus_nPending = 0;
+
+/********************************************************************
+
+    Z80 Bus Listener Functions
+
+********************************************************************/
+
+void Z80Bus_addListener(void (*fun)(const Z80BusTransaction_t*)) {
+    if (Z80Bus_nListeners >= MAX_NUMBER_OF_BUS_LISTENERS) {
+        formattedLog(debuglog, LOGTYPE_ERROR, "Unable to add bus transaction listener: no free space\n");
+        return;
+    }
+    Z80Bus_listeners[Z80Bus_nListeners++] = fun;
+}
+
+/*
+Detaches the listeners and drops any transactions in flight, switching transactions off
+*/
+void Z80Bus_destroy() {
+    Z80Bus_enabled = false;
+    Z80Bus_transactions = 0;
+    Z80Bus_nListeners = 0;
+    Z80Bus_cycle = NULL;
+    Z80Bus_cycleStart = 0;
+    Z80Bus_last = (Z80BusTransaction_t){ 0 };
+    Z80Bus_nPending = 0;
+}
+
+/********************************************************************
+
+    Z80 Bus Transaction Functions
+
+********************************************************************/
+
+/*
+Reads an opcode or prefix byte (M1). Outside the machine cycle engine this is a plain memory read
+*/
+uint8_t Z80Bus_fetchOpcode(uint16_t address) {
+    uint8_t value = memoryController_directRead(address);
+    if (Z80Bus_enabled && Z80Bus_nPending < Z80_BUS_MAX_PENDING) {
+        Z80BusTransaction_t* pending = &Z80Bus_pending[Z80Bus_nPending++];
+        pending->kind = Z80MCYCLE_OPCODE_FETCH;
+        pending->address = address;
+        pending->data = value;
+    }
+    return value;
+}
+
+/*
+Reads an operand byte, or the displacement and opcode of a DDCB / FDCB instruction, which are not M1 cycles
+*/
+uint8_t Z80Bus_fetchOperand(uint16_t address) {
+    uint8_t value = memoryController_directRead(address);
+    if (Z80Bus_enabled && Z80Bus_nPending < Z80_BUS_MAX_PENDING) {
+        Z80BusTransaction_t* pending = &Z80Bus_pending[Z80Bus_nPending++];
+        pending->kind = Z80MCYCLE_MEMORY_READ;
+        pending->address = address;
+        pending->data = value;
+    }
+    return value;
+}
+
+/*
+Starts timing a decoded instruction from its Z80Opcodes.def cycle list and issues the fetches made while decoding it
+*/
+void Z80Bus_beginInstruction(const uint8_t* mCycles) {
+    Z80Bus_cycle = mCycles;
+    Z80Bus_cycleStart = Z80_tStates;
+
+    uint8_t nPending = Z80Bus_nPending;
+    Z80Bus_nPending = 0;
+    for (int i = 0; i < nPending; i++)
+        Z80Bus_transaction(Z80Bus_pending[i].kind, Z80Bus_pending[i].address, Z80Bus_pending[i].data);
+}
+
+/*
+Starts an interrupt response with its acknowledge cycle. The pushes and vector read that follow use the default cycle lengths
+*/
+void Z80Bus_beginInterrupt(uint16_t address, uint8_t tStates) {
+    Z80Bus_cycle = NULL;
+    Z80Bus_cycleStart = Z80_tStates;
+    Z80Bus_nPending = 0;
+
+    Z80BusTransaction_t transaction = { Z80MCYCLE_INTERRUPT_ACK, tStates, 0xFF, address, Z80Bus_cycleStart };
+    Z80Bus_cycleStart += tStates;
+    Z80Bus_issue(&transaction);
+}
+
+/*
+Issues one machine cycle to the listeners. Its length comes from the next matching entry of the cycle list, passing over
+internal cycles on the way. Cycles beyond the list, such as the pushes of a taken CALL cc, get the default length and
+start straight after the previous cycle; the extra internal T-states of a taken branch are not placed
+*/
+void Z80Bus_transaction(uint8_t kind, uint16_t address, uint8_t data) {
+    uint8_t tStates = 0;
+    while (Z80Bus_cycle != NULL && *Z80Bus_cycle != 0) {
+        uint8_t cycleKind = Z80_MCYCLE_KIND(*Z80Bus_cycle);
+        if (cycleKind == Z80MCYCLE_INTERNAL) {
+            Z80Bus_cycleStart += Z80_MCYCLE_TSTATES(*Z80Bus_cycle++);
+            continue;
+        }
+        if (cycleKind == kind)
+            tStates = Z80_MCYCLE_TSTATES(*Z80Bus_cycle++);
+        break;
+    }
+    if (tStates == 0)
+        tStates = Z80Bus_defaultTStates(kind);
+
+    Z80BusTransaction_t transaction = { kind, tStates, data, address, Z80Bus_cycleStart };
+    Z80Bus_cycleStart += tStates;
+    Z80Bus_issue(&transaction);
+}
+
+/*
+Hands a finished transaction to the listeners. The pins are lazy under this engine, so their edges are only made when observed
+*/
+void Z80Bus_issue(const Z80BusTransaction_t* transaction) {
+    Z80Bus_last = *transaction;
+    Z80Bus_transactions++;
+    if (signals_nPinObservers > 0)
+        Z80Bus_synthesisePins(transaction);
+    for (int i = 0; i < Z80Bus_nListeners; i++)
+        Z80Bus_listeners[i](transaction);
+}
+
+/*
+True when something sees the transactions, so every cycle has to be made rather than skipped over
+*/
+bool Z80Bus_observed() {
+    return Z80Bus_enabled && (Z80Bus_nListeners > 0 || signals_nPinObservers > 0);
+}
+
+/*
+Length of a cycle with no wait states
+*/
+uint8_t Z80Bus_defaultTStates(uint8_t kind) {
+    switch (kind) {
+    case Z80MCYCLE_OPCODE_FETCH:
+    case Z80MCYCLE_PORT_READ:
+    case Z80MCYCLE_PORT_WRITE:
+        return 4;
+    default:
+        return 3;
+    }
+}
+
+/********************************************************************
+
+    Z80 Bus Pin Functions
+
+********************************************************************/
+
+/*
+Drives the pins and busses through a transaction with the same edges the edge engine makes for that cycle. signal_CLCK is
+not toggled, so the memory controller doesn't repeat the access
+*/
+void Z80Bus_synthesisePins(const Z80BusTransaction_t* transaction) {
+    signal_addressBus = transaction->address;
+
+    switch (transaction->kind) {
+    case Z80MCYCLE_OPCODE_FETCH:
+        signals_raiseSignal(&signal_MREQ);
+        signals_raiseSignal(&signal_RD);
+        signals_raiseSignal(&signal_RFSH);
+        signals_dropSignal(&signal_M1);
+        signals_dropSignal(&signal_MREQ);
+        signals_dropSignal(&signal_RD);
+        signal_dataBus = transaction->data;
+        signals_raiseSignal(&signal_MREQ);
+        signals_raiseSignal(&signal_RD);
+        signals_raiseSignal(&signal_M1);
+        signals_dropSignal(&signal_RFSH);
+        signals_raiseSignal(&signal_MREQ);
+        break;
+
+    case Z80MCYCLE_MEMORY_READ:
+        signals_dropSignal(&signal_MREQ);
+        signals_dropSignal(&signal_RD);
+        signal_dataBus = transaction->data;
+        signals_raiseSignal(&signal_MREQ);
+        signals_raiseSignal(&signal_RD);
+        break;
+
+    case Z80MCYCLE_MEMORY_WRITE:
+        signals_dropSignal(&signal_MREQ);
+        signal_dataBus = transaction->data;
+        signals_dropSignal(&signal_WR);
+        signals_raiseSignal(&signal_MREQ);
+        signals_raiseSignal(&signal_WR);
+        break;
+
+    case Z80MCYCLE_PORT_READ:
+        signals_dropSignal(&signal_IORQ);
+        signals_dropSignal(&signal_RD);
+        signal_dataBus = transaction->data;
+        signals_raiseSignal(&signal_IORQ);
+        signals_raiseSignal(&signal_RD);
+        break;
+
+    case Z80MCYCLE_PORT_WRITE:
+        signal_dataBus = transaction->data;
+        signals_dropSignal(&signal_IORQ);
+        signals_dropSignal(&signal_WR);
+        signals_raiseSignal(&signal_IORQ);
+        signals_raiseSignal(&signal_WR);
+        break;
+
+    case Z80MCYCLE_INTERRUPT_ACK:
+        signals_dropSignal(&signal_M1);
+        signals_dropSignal(&signal_IORQ);
+        signal_dataBus = transaction->data;
+        signals_raiseSignal(&signal_M1);
+        signals_raiseSignal(&signal_IORQ);
+        break;
+    }
+}
+
+/*
+Brings unobserved pins up to date for a reader. They are left as they are at the end of the last transaction
+*/
+void Z80Bus_syncPins() {
+    if (Z80Bus_transactions > 0)
+        Z80Bus_synthesisePins(&Z80Bus_last);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Bus.h : Machine cycle engine. Runs the stepped engine and reports every bus machine cycle to the transaction listeners
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Z80Opcodes.h"
+#include "../Z0Machine.h"
+
+#define MAX_NUMBER_OF_BUS_LISTENERS 16
+#define Z80_BUS_MAX_PENDING 8 // Opcode and operand fetches held back until the instruction is decoded
+
+/* Interrupt acknowledge cycles never appear in Z80Opcodes.def, so their kind follows the Z80MCYCLE_ kinds */
+#define Z80MCYCLE_INTERRUPT_ACK 7
+
+/* One machine cycle on the bus */
+typedef struct Z80BusTransaction {
+    uint8_t kind; // Z80MCYCLE_ kind
+    uint8_t tStates; // Length of the cycle
+    uint8_t data; // Byte read or written. Interrupt acknowledges carry 0xFF, the floating bus
+    uint16_t address; // Memory address or port. Opcode fetches carry PC, interrupt acknowledges the PC being pushed
+    uint64_t tState; // Z80_tStates at the start of the cycle
+} Z80BusTransaction_t;
+
+/* Machine cycle engine state */
+extern Z0_MACHINE_LOCAL bool Z80Bus_enabled;
+extern Z0_MACHINE_LOCAL uint64_t Z80Bus_transactions; // Transactions issued since Z80_init()
+extern Z0_MACHINE_LOCAL Z80BusTransaction_t Z80Bus_last; // Last transaction issued
+
+/* Transaction listeners. Called once per bus machine cycle, after the access has been made */
+extern Z0_MACHINE_LOCAL void (*Z80Bus_listeners[MAX_NUMBER_OF_BUS_LISTENERS])(const Z80BusTransaction_t* transaction);
+extern Z0_MACHINE_LOCAL uint8_t Z80Bus_nListeners;
+
+/********************************************************************
+
+    Z80 Bus Listener Functions
+
+********************************************************************/
+
+void Z80Bus_addListener(void (*fun)(const Z80BusTransaction_t*));
+void Z80Bus_destroy();
+
+/********************************************************************
+
+    Z80 Bus Transaction Functions
+
+********************************************************************/
+
+uint8_t Z80Bus_fetchOpcode(uint16_t address);
+uint8_t Z80Bus_fetchOperand(uint16_t address);
+void Z80Bus_beginInstruction(const uint8_t* mCycles);
+void Z80Bus_beginInterrupt(uint16_t address, uint8_t tStates);
+void Z80Bus_transaction(uint8_t kind, uint16_t address, uint8_t data);
+void Z80Bus_issue(const Z80BusTransaction_t* transaction);
+bool Z80Bus_observed();
+uint8_t Z80Bus_defaultTStates(uint8_t kind);
+
+/********************************************************************
+
+    Z80 Bus Pin Functions
+
+********************************************************************/
+
+void Z80Bus_synthesisePins(const Z80BusTransaction_t* transaction);
+void Z80Bus_syncPins();
@@ -0,0 +1,125 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80DecodeCache.c : Direct-mapped cache of decoded instructions keyed by PC, used by the stepped engine
+
+*/
+
+#include <stdlib.h>
+
+#include "Z80DecodeCache.h"
+
+#include "../SysIO/Log.h"
+#include "../Memory/MemoryController.h"
+
+/* Cache state */
+Z0_MACHINE_LOCAL bool Z80DecodeCache_enabled = true;
+Z0_MACHINE_LOCAL Z80DecodeCacheEntry_t* Z80DecodeCache_entries = NULL; // Z80_DECODE_CACHE_SIZE entries, allocated by Z80DecodeCache_init()
+
+/* Statistics */
+Z0_MACHINE_LOCAL uint64_t Z80DecodeCache_hits = 0;
+Z0_MACHINE_LOCAL uint64_t Z80DecodeCache_misses = 0;
+Z0_MACHINE_LOCAL uint64_t Z80DecodeCache_invalidations = 0;
+
+/********************************************************************
+
+    Z80 Decode Cache Functions
+
+********************************************************************/
+
+/*
+Empties the cache and starts watching memory writes so self-modifying code is seen
+*/
+void Z80DecodeCache_init() {
+    if (Z80DecodeCache_entries == NULL)
+        Z80DecodeCache_entries = malloc(Z80_DECODE_CACHE_SIZE * sizeof(Z80DecodeCacheEntry_t));
+    if (Z80DecodeCache_entries == NULL) {
+        formattedLog(stdlog, LOGTYPE_WARN, "Unable to allocate the decode cache, it is disabled\n");
+        Z80DecodeCache_enabled = false;
+        return;
+    }
+
+    Z80DecodeCache_flush();
+    memoryController_addWriteListener(&Z80DecodeCache_onMemoryWrite);
+    formattedLog(debuglog, LOGTYPE_DEBUG, "Decode cache: %i entries, enabled=%i\n", Z80_DECODE_CACHE_SIZE, Z80DecodeCache_enabled);
+}
+
+/*
+Frees the cache and puts it back as it was before Z80DecodeCache_init()
+*/
+void Z80DecodeCache_destroy() {
+    free(Z80DecodeCache_entries);
+    Z80DecodeCache_entries = NULL;
+    Z80DecodeCache_enabled = true;
+    Z80DecodeCache_hits = 0;
+    Z80DecodeCache_misses = 0;
+    Z80DecodeCache_invalidations = 0;
+}
+
+/*
+Drops every entry
+*/
+void Z80DecodeCache_flush() {
+    for (int i = 0; i < Z80_DECODE_CACHE_SIZE; i++)
+        Z80DecodeCache_entries[i].valid = false;
+}
+
+/*
+Returns the entry for the instruction at 'pc', or NULL on a miss. Counts the hit or miss
+*/
+Z80DecodeCacheEntry_t* Z80DecodeCache_lookup(uint16_t pc) {
+    Z80DecodeCacheEntry_t* entry = &Z80DecodeCache_entries[pc & Z80_DECODE_CACHE_MASK];
+    if (entry->valid && entry->pc == pc) {
+        Z80DecodeCache_hits++;
+        return entry;
+    }
+    Z80DecodeCache_misses++;
+    return NULL;
+}
+
+/*
+Saves a fully decoded instruction, replacing whatever shared its slot
+*/
+void Z80DecodeCache_store(uint16_t pc, Z80_Instr_t* instr, uint8_t m1Cycles) {
+    if (!Z80DecodeCache_enabled || instr->instrByteLen > Z80_DECODE_CACHE_MAX_LEN)
+        return;
+
+    Z80DecodeCacheEntry_t* entry = &Z80DecodeCache_entries[pc & Z80_DECODE_CACHE_MASK];
+    entry->instr = *instr;
+    entry->pc = pc;
+    entry->m1Cycles = m1Cycles;
+    entry->valid = true;
+}
+
+/*
+Memory write listener. Drops any cached instruction with a byte at 'address'.
+Only the slots of the few addresses an instruction covering it could start at need checking
+*/
+void Z80DecodeCache_onMemoryWrite(uint16_t address) {
+    for (int back = 0; back < Z80_DECODE_CACHE_MAX_LEN; back++) {
+        uint16_t start = address - back;
+        Z80DecodeCacheEntry_t* entry = &Z80DecodeCache_entries[start & Z80_DECODE_CACHE_MASK];
+        if (entry->valid && entry->pc == start && entry->instr.instrByteLen > back) {
+            entry->valid = false;
+            Z80DecodeCache_invalidations++;
+        }
+    }
+}
+
+/*
+Fraction of lookups that hit, 0 if nothing has been looked up yet
+*/
+double Z80DecodeCache_hitRate() {
+    uint64_t lookups = Z80DecodeCache_hits + Z80DecodeCache_misses;
+    return lookups > 0 ? (double)Z80DecodeCache_hits / lookups : 0.0;
+}
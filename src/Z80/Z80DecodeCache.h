@@ -0,0 +1,61 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80DecodeCache.h : Direct-mapped cache of decoded instructions keyed by PC, used by the stepped engine
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Z80Instructions.h"
+#include "../Z0Machine.h"
+
+/* Cache geometry. Entries are indexed by the low bits of PC */
+#define Z80_DECODE_CACHE_SIZE 0x1000
+#define Z80_DECODE_CACHE_MASK (Z80_DECODE_CACHE_SIZE - 1)
+
+/* Longest instruction that is cached. Anything longer only happens with runs of ignored DD / FD prefixes */
+#define Z80_DECODE_CACHE_MAX_LEN 4
+
+typedef struct Z80DecodeCacheEntry {
+    Z80_Instr_t instr; // The instruction as it is after decode and operand reads, ready to execute
+    uint16_t pc; // Address of the first byte of the instruction
+    uint8_t m1Cycles; // Opcode fetches in the instruction, each one increments R
+    bool valid;
+} Z80DecodeCacheEntry_t;
+
+/* Cache state */
+extern Z0_MACHINE_LOCAL bool Z80DecodeCache_enabled;
+extern Z0_MACHINE_LOCAL Z80DecodeCacheEntry_t* Z80DecodeCache_entries;
+
+/* Statistics */
+extern Z0_MACHINE_LOCAL uint64_t Z80DecodeCache_hits;
+extern Z0_MACHINE_LOCAL uint64_t Z80DecodeCache_misses;
+extern Z0_MACHINE_LOCAL uint64_t Z80DecodeCache_invalidations;
+
+/********************************************************************
+
+    Z80 Decode Cache Functions
+
+********************************************************************/
+
+void Z80DecodeCache_init();
+void Z80DecodeCache_destroy();
+void Z80DecodeCache_flush();
+Z80DecodeCacheEntry_t* Z80DecodeCache_lookup(uint16_t pc);
+void Z80DecodeCache_store(uint16_t pc, Z80_Instr_t* instr, uint8_t m1Cycles);
+void Z80DecodeCache_onMemoryWrite(uint16_t address);
+double Z80DecodeCache_hitRate();
@@ -17,14 +17,15 @@ Z0xDecomp.c : Handles decompilation
 
 #include "Z80Decomp.h"
 #include "Z80Instructions.h"
+#include "Z80Opcodes.h"
 #include "../SysIO/Log.h"
 #include "../Util/LinkedList.h"
 
 FILE* decompLog = NULL;
 SysFile_t* dF = NULL;
 
-#define decompLog(fmt, ...) if(decompLog) { fprintf(decompLog, fmt, __VA_ARGS__); } printf("[DECOMP] "); printf(fmt, __VA_ARGS__);
-#define decompL(fmt, ...) if(decompLog) { fprintf(decompLog, fmt, __VA_ARGS__); } printf(fmt, __VA_ARGS__);
+#define decompLog(...) if(decompLog) { fprintf(decompLog, __VA_ARGS__); } printf("[DECOMP] "); printf(__VA_ARGS__);
+#define decompL(...) if(decompLog) { fprintf(decompLog, __VA_ARGS__); } printf(__VA_ARGS__);
 
 void decomp_addError(int index, const char* errorComment);
 void decomp_printErrors();
@@ -154,60 +155,18 @@ void decomp_printErrors() {
 }
 
 void decomp_deriveInstructionInformation() {
-    if (prefix == 0) {
-        instrByteLen = instructions_mainInstructionParams[instruction];
-        instrNumOperands = instrByteLen > 1 ? instrByteLen - 1 : 0;
-        instrHumanString = instructions_mainInstructionText[instruction];
-        funcPointer = instructions_mainInstructionFuncs[instruction];
-
+    const Z80OpcodeInfo_t* table = Z80Opcodes_table(prefix);
+    if (table == NULL) {
+        decompLog("Unknown prefix code: %04X\n", prefix);
+        instrByteLen = -2;
         return;
     }
 
-    // Check to see if we have a prefix
-    if (prefix > 0) {
-        switch (prefix) {
-        case PREFIX_BITS:
-            instrByteLen = instructions_bitInstructionParams[instruction];
-            instrNumOperands = instrByteLen > 2 ? instrByteLen - 2 : 0;
-            instrHumanString = instructions_bitInstructionText[instruction];
-            funcPointer = instructions_bitInstructionFuncs[instruction];
-            break;
-        case PREFIX_IY:
-            instrByteLen = instructions_IYInstructionParams[instruction];
-            instrNumOperands = instrByteLen > 2 ? instrByteLen - 2 : 0;
-            instrHumanString = instructions_IYInstructionText[instruction];
-            funcPointer = instructions_IYInstructionFuncs[instruction];
-            break;
-        case PREFIX_EXX:
-            // decompLog("Unhandled prefix code: %04X, %s\n", prefix, instructions_mainInstructionText[prefix]);
-            // instrByteLen = -2;
-            instrByteLen = instructions_extendedInstructionParams[instruction];
-            instrNumOperands = instrByteLen > 2 ? instrByteLen - 2 : 0;
-            instrHumanString = instructions_extendedInstructionText[instruction];
-            funcPointer = instructions_extendedInstructionFuncs[instruction];
-            break;
-        case PREFIX_IX:
-            instrByteLen = instructions_IXInstructionParams[instruction];
-            instrNumOperands = instrByteLen > 2 ? instrByteLen - 2 : 0;
-            instrHumanString = instructions_IXInstructionText[instruction];
-            funcPointer = instructions_IXInstructionFuncs[instruction];
-            break;
-        case PREFIX_IX_BITS:
-            decompLog("Unhandled prefix code: %04X\n", prefix);
-            instrByteLen = -2;
-            break;
-        case PREFIX_IY_BITS:
-            instrByteLen = instructions_IYBitInstructionParams[instruction];
-            instrNumOperands = instrByteLen > 3 ? instrByteLen - 3 : 0;
-            instrHumanString = instructions_IYBitInstructionText[instruction];
-            funcPointer = instructions_IYBitInstructionFuncs[instruction];
-            break;
-        default:
-            decompLog("Unknown prefix code: %04X, %s\n", prefix, instructions_mainInstructionText[prefix]);
-            instrByteLen = -2;
-            break;
-        }
-    }
+    const Z80OpcodeInfo_t* info = &table[instruction];
+    instrByteLen = info->length;
+    instrNumOperands = Z80OPND_BYTES(info->operands);
+    instrHumanString = info->mnemonic;
+    funcPointer = info->execFunction;
 }
 
 bool decomp_next() {
@@ -238,7 +197,11 @@ bool decomp_next() {
             else
                 prefix = (prefix << 8) | instruction;
 
-            instruction = dF->data[currentIndex];
+            // DDCB and FDCB put the displacement before the opcode
+            if (prefix == PREFIX_IX_BITS || prefix == PREFIX_IY_BITS)
+                instruction = dF->data[currentIndex + 1];
+            else
+                instruction = dF->data[currentIndex];
             decomp_deriveInstructionInformation();
             // break;
         }
@@ -257,7 +220,10 @@ bool decomp_next() {
 
     if (instrNumOperands > 0) {
         // Display the operands for the instruction
-        if (instrNumOperands == 1) {
+        if (prefix == PREFIX_IX_BITS || prefix == PREFIX_IY_BITS) {
+            decompL("$%02X", operand = dF->data[currentIndex]);
+        }
+        else if (instrNumOperands == 1) {
             // Display the number in correct notation
             decompL("$%02X", operand = dF->data[currentIndex + 1]);
         }
@@ -291,6 +257,7 @@ bool decomp_next() {
         decomp_addError(startIndex, "instrByteLen < 0 || funcPointer == NULL");
         return false;
     }
-    currentIndex += instrByteLen;
+    // The length includes the prefixes, which currentIndex has already stepped over
+    currentIndex = startIndex + instrByteLen;
     return true;
 }
\ No newline at end of file
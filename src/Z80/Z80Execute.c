@@ -0,0 +1,764 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Execute.c : Execution of the full Z80 instruction set, with a handler per opcode generated from Z80Opcodes.def
+
+*/
+
+#include "Z80Execute.h"
+#include "Z80.h"
+#include "Z80Alu.h"
+#include "Z80Flags.h"
+#include "Z80Instructions.h"
+#include "Z80Bus.h"
+#include "Z80Step.h"
+#include "Z80Opcodes.h"
+#include "Z80Refresh.h"
+
+#include "../Signals.h"
+#include "../Memory/MemoryController.h"
+#include "../IO/IOController.h"
+
+#include <string.h>
+
+/********************************************************************
+
+    VARIABLES / DEFS / STRUCTS
+
+********************************************************************/
+
+/* Z80 Instruction */
+extern Z0_MACHINE_LOCAL Z80_Instr_t cInstr;
+
+/* Bulk block instructions */
+Z0_MACHINE_LOCAL bool Z80_bulkEnabled = true;
+Z0_MACHINE_LOCAL uint64_t Z80_bulkRuns = 0;
+Z0_MACHINE_LOCAL uint64_t Z80_bulkIterations = 0;
+
+/* Memory and port writes made by instructions, so a caller can tell whether anything was written between two points */
+Z0_MACHINE_LOCAL uint64_t Z80_writes = 0;
+Z0_MACHINE_LOCAL uint64_t Z80_refreshReads = 0;
+
+/* HALT skip */
+Z0_MACHINE_LOCAL bool Z80_haltSkipEnabled = true;
+Z0_MACHINE_LOCAL uint64_t Z80_haltSkipped = 0;
+Z0_MACHINE_LOCAL uint64_t Z80_haltSkippedTStates = 0;
+
+/* 8 bit register access, through the byte halves of the register file. Writes go through a temporary so an ALU call that
+also writes F is sequenced before the store */
+#define REG_A (Z80_registers.main.r.af.b.h)
+#define REG_F Z80FLAGS_READ()
+#define REG_B (Z80_registers.main.r.bc.b.h)
+#define REG_C (Z80_registers.main.r.bc.b.l)
+#define REG_D (Z80_registers.main.r.de.b.h)
+#define REG_E (Z80_registers.main.r.de.b.l)
+#define REG_H (Z80_registers.main.r.hl.b.h)
+#define REG_L (Z80_registers.main.r.hl.b.l)
+#define SET_BYTE(r, v) do { uint8_t _v = (uint8_t)(v); r = _v; } while (0)
+#define SET_HIGH(r, v) do { uint8_t _v = (uint8_t)(v); r = (uint16_t)((r & 0x00FF) | (_v << 8)); } while (0)
+#define SET_LOW(r, v) do { uint8_t _v = (uint8_t)(v); r = (uint16_t)((r & 0xFF00) | _v); } while (0)
+#define SET_A(v) SET_BYTE(REG_A, v)
+#define SET_B(v) SET_BYTE(REG_B, v)
+#define SET_C(v) SET_BYTE(REG_C, v)
+#define SET_D(v) SET_BYTE(REG_D, v)
+#define SET_E(v) SET_BYTE(REG_E, v)
+#define SET_H(v) SET_BYTE(REG_H, v)
+#define SET_L(v) SET_BYTE(REG_L, v)
+#define SET_F(v) do { Z80FLAGS_DISCARD(); SET_BYTE(Z80_registers.main.r.af.b.l, v); } while (0)
+
+/* Immediate operands, as laid out by the operand reads */
+#define IMM8 (cInstr.operand0)
+#define IMM16 ((uint16_t)((cInstr.operand0 << 8) | cInstr.operand1))
+
+/* Index register access for the DD and FD handlers, which define IDX as IX or IY */
+#define REG_XH REG_UPPER(IDX)
+#define REG_XL REG_LOWER(IDX)
+#define SET_XH(v) SET_HIGH(IDX, v)
+#define SET_XL(v) SET_LOW(IDX, v)
+#define IDX_ADDR ((uint16_t)(IDX + (int8_t)cInstr.operand0)) // (IX+d) with d as the only operand
+#define IDX_IMM_ADDR ((uint16_t)(IDX + (int8_t)cInstr.operand1)) // (IX+d) in LD (IX+d),n, where d is read before n
+#define IDX_BIT_ADDR ((uint16_t)(IDX + (int8_t)cInstr.operand1)) // (IX+d) in DDCB d op, where d is read before the opcode
+
+/********************************************************************
+
+    Z80 Handler Templates
+    The handler column of Z80Opcodes.def. Register operands are pasted onto REG_ and SET_, so every opcode gets a handler of its own
+
+********************************************************************/
+
+/* Branch conditions */
+// Z and C come straight from a pending ALU operation, so a test after DEC or CP doesn't build F
+#define COND_NZ (!Z80FLAGS_IS_ZERO())
+#define COND_Z Z80FLAGS_IS_ZERO()
+#define COND_NC (!Z80FLAGS_IS_CARRY())
+#define COND_C Z80FLAGS_IS_CARRY()
+#define COND_PO (!(REG_F & Z80FLAG_PV))
+#define COND_PE (REG_F & Z80FLAG_PV)
+#define COND_P (!(REG_F & Z80FLAG_S))
+#define COND_M (REG_F & Z80FLAG_S)
+
+/* Block instruction repeat conditions */
+#define REPEAT_BC (BC != 0)
+#define REPEAT_BC_NZ (BC != 0 && !(REG_F & Z80FLAG_Z))
+#define REPEAT_B (REG_B != 0)
+
+/* 8 bit ALU operations on A */
+#define ALU_ADD(v) SET_A(Z80Alu_add8(REG_A, v, 0))
+#define ALU_ADC(v) SET_A(Z80Alu_add8(REG_A, v, Z80Flags_readCarry()))
+#define ALU_SUB(v) SET_A(Z80Alu_sub8(REG_A, v, 0))
+#define ALU_SBC(v) SET_A(Z80Alu_sub8(REG_A, v, Z80Flags_readCarry()))
+#define ALU_AND(v) SET_A(Z80Alu_and8(REG_A, v))
+#define ALU_XOR(v) SET_A(Z80Alu_xor8(REG_A, v))
+#define ALU_OR(v) SET_A(Z80Alu_or8(REG_A, v))
+#define ALU_CP(v) Z80Alu_cp8(REG_A, v)
+
+/* Z80Alu_rotateShift() operations */
+#define ROT_RLC 0
+#define ROT_RRC 1
+#define ROT_RL 2
+#define ROT_RR 3
+#define ROT_SLA 4
+#define ROT_SRA 5
+#define ROT_SLL 6
+#define ROT_SRL 7
+
+/* Loads */
+#define OP_NOP()
+#define OP_PREFIX() return INSTR_EXEC_FAILED // Prefixes are followed by the decoder, never executed
+#define OP_LD_R_R(dst, src) SET_##dst(REG_##src)
+#define OP_LD_R_N(r) SET_##r(IMM8)
+#define OP_LD_R_MEM(r, address) SET_##r(Z80_readByte(address))
+#define OP_LD_MEM_R(address, r) Z80_writeByte(address, REG_##r)
+#define OP_LD_MEM_N(address) Z80_writeByte(address, IMM8)
+#define OP_LD_RR_NN(rr) rr = IMM16
+#define OP_LD_RR_RR(dst, src) dst = src
+#define OP_LD_RR_MEM(rr) rr = Z80_readWord(IMM16)
+#define OP_LD_NN_RR(rr) Z80_writeWord(IMM16, rr)
+#define OP_LD_I_A() IVMR = (uint16_t)((IVMR & 0x00FF) | (REG_A << 8))
+#define OP_LD_REFRESH_A() { IVMR = (uint16_t)((IVMR & 0xFF00) | REG_A); if (Z80Refresh_enabled) Z80Refresh_onWrite(); }
+#define OP_LD_A_I() { SET_A(IVMR >> 8); Z80_loadIRFlags(); }
+#define OP_LD_A_REFRESH() { SET_A(IVMR & 0xFF); Z80_loadIRFlags(); Z80_refreshReads++; }
+
+/* Stack and exchanges */
+#define OP_PUSH(rr) Z80_push(rr)
+#define OP_POP(rr) rr = Z80_pop()
+#define OP_PUSH_AF() { Z80FLAGS_SYNC(); Z80_push(AF); }
+#define OP_POP_AF() { AF = Z80_pop(); Z80FLAGS_DISCARD(); }
+#define OP_EX_AF() { Z80FLAGS_SYNC(); Z80_exchangeBanks(Z80_BANK_MASK_AF); }
+#define OP_EXX() Z80_exchangeBanks(Z80_BANK_MASK_EXX)
+#define OP_EX_DE_HL() Z80_exchange(&DE, &HL)
+#define OP_EX_SP(rr) { uint16_t value = Z80_readWord(SP); Z80_writeByte(SP + 1, rr >> 8); Z80_writeByte(SP, rr & 0xFF); rr = value; }
+
+/* Arithmetic and logic */
+#define OP_INC_R(r) SET_##r(Z80Alu_inc8(REG_##r))
+#define OP_DEC_R(r) SET_##r(Z80Alu_dec8(REG_##r))
+#define OP_INC_MEM(address) { uint16_t target = address; Z80_writeByte(target, Z80Alu_inc8(Z80_readByte(target))); }
+#define OP_DEC_MEM(address) { uint16_t target = address; Z80_writeByte(target, Z80Alu_dec8(Z80_readByte(target))); }
+#define OP_ALU_R(op, r) ALU_##op(REG_##r)
+#define OP_ALU_MEM(op, address) ALU_##op(Z80_readByte(address))
+#define OP_ALU_N(op) ALU_##op(IMM8)
+#define OP_ACC(fn) SET_A(Z80Alu_##fn(REG_A))
+#define OP_FLAGS(fn) Z80Alu_##fn(REG_A)
+#define OP_NEG() SET_A(Z80Alu_sub8(0, REG_A, 0))
+#define OP_INC_RR(rr) rr++
+#define OP_DEC_RR(rr) rr--
+#define OP_ADD_RR(dst, src) dst = Z80Alu_add16(dst, src)
+#define OP_ADC_HL(rr) HL = Z80Alu_adc16(HL, rr)
+#define OP_SBC_HL(rr) HL = Z80Alu_sbc16(HL, rr)
+#define OP_RRD() Z80_rrd()
+#define OP_RLD() Z80_rld()
+
+/* Jumps, calls and returns */
+#define OP_JR() PC += (int8_t)IMM8
+#define OP_JR_CC(cc) if (COND_##cc) { PC += (int8_t)IMM8; cInstr.tStates += TSTATES_BRANCH_JR; }
+#define OP_DJNZ() { SET_B(REG_B - 1); if (REG_B != 0) { PC += (int8_t)IMM8; cInstr.tStates += TSTATES_BRANCH_JR; } }
+#define OP_JP() PC = IMM16
+#define OP_JP_CC(cc) if (COND_##cc) PC = IMM16
+#define OP_JP_RR(rr) PC = rr
+#define OP_CALL() { Z80_push(PC); PC = IMM16; }
+#define OP_CALL_CC(cc) if (COND_##cc) { Z80_push(PC); PC = IMM16; cInstr.tStates += TSTATES_BRANCH_CALL; }
+#define OP_RET() PC = Z80_pop()
+#define OP_RET_CC(cc) if (COND_##cc) { PC = Z80_pop(); cInstr.tStates += TSTATES_BRANCH_RET; }
+#define OP_RETN() { IFF1 = IFF2; PC = Z80_pop(); }
+#define OP_RST(address) { Z80_push(PC); PC = address; }
+
+/* CPU control */
+#define OP_HALT() Z80_halt()
+#define OP_DI() { IFF1 = false; IFF2 = false; }
+#define OP_EI() { IFF1 = true; IFF2 = true; eiPending = true; }
+#define OP_IM(mode) interruptMode = mode
+
+/* Input and output */
+#define OP_IN_A_N() SET_A(Z80_inPort((uint16_t)((REG_A << 8) | IMM8)))
+#define OP_OUT_N_A() Z80_outPort((uint16_t)((REG_A << 8) | IMM8), REG_A)
+#define OP_IN_R_C(r) { uint8_t value = Z80_inPort(BC); Z80Alu_flagsSZP(value); SET_##r(value); }
+#define OP_IN_C() Z80Alu_flagsSZP(Z80_inPort(BC)) // IN (C), flags only
+#define OP_OUT_C_R(r) Z80_outPort(BC, REG_##r)
+#define OP_OUT_C_0() Z80_outPort(BC, 0)
+
+/* Block instructions. The repeating forms run again from the same PC until their condition fails */
+#define OP_BLOCK(fn, step) Z80_block##fn(step)
+#define OP_BLOCK_REPEAT(fn, step, repeat) { Z80_block##fn(step); if (Z80_bulkEnabled && (repeat)) Z80_bulk##fn(step); if (repeat) { PC -= 2; cInstr.tStates += TSTATES_BLOCK_REPEAT; } }
+
+/* Rotates, shifts and bit operations */
+#define OP_ROT_R(op, r) SET_##r(Z80Alu_rotateShift(ROT_##op, REG_##r))
+#define OP_ROT_MEM(op, address) Z80_writeByte(address, Z80Alu_rotateShift(ROT_##op, Z80_readByte(address)))
+#define OP_BIT_R(bit, r) Z80Alu_bit(bit, REG_##r, REG_##r)
+#define OP_BIT_MEM(bit, address) Z80Alu_bit(bit, Z80_readByte(address), (uint8_t)((address) >> 8))
+#define OP_RES_R(bit, r) SET_##r(REG_##r & ~(1 << (bit)))
+#define OP_RES_MEM(bit, address) Z80_writeByte(address, (uint8_t)(Z80_readByte(address) & ~(1 << (bit))))
+#define OP_SET_R(bit, r) SET_##r(REG_##r | (1 << (bit)))
+#define OP_SET_MEM(bit, address) Z80_writeByte(address, (uint8_t)(Z80_readByte(address) | (1 << (bit))))
+
+/* DDCB and FDCB operations on (IX+d). The _R forms also copy the result into a register */
+#define OP_ROT_IDX(op) { uint16_t target = IDX_BIT_ADDR; Z80_writeByte(target, Z80Alu_rotateShift(ROT_##op, Z80_readByte(target))); }
+#define OP_ROT_IDX_R(op, r) { uint16_t target = IDX_BIT_ADDR; uint8_t value = Z80Alu_rotateShift(ROT_##op, Z80_readByte(target)); Z80_writeByte(target, value); SET_##r(value); }
+#define OP_BIT_IDX(bit) { uint16_t target = IDX_BIT_ADDR; Z80Alu_bit(bit, Z80_readByte(target), (uint8_t)(target >> 8)); }
+#define OP_RES_IDX(bit) { uint16_t target = IDX_BIT_ADDR; Z80_writeByte(target, (uint8_t)(Z80_readByte(target) & ~(1 << (bit)))); }
+#define OP_RES_IDX_R(bit, r) { uint16_t target = IDX_BIT_ADDR; uint8_t value = (uint8_t)(Z80_readByte(target) & ~(1 << (bit))); Z80_writeByte(target, value); SET_##r(value); }
+#define OP_SET_IDX(bit) { uint16_t target = IDX_BIT_ADDR; Z80_writeByte(target, (uint8_t)(Z80_readByte(target) | (1 << (bit)))); }
+#define OP_SET_IDX_R(bit, r) { uint16_t target = IDX_BIT_ADDR; uint8_t value = (uint8_t)(Z80_readByte(target) | (1 << (bit))); Z80_writeByte(target, value); SET_##r(value); }
+
+
+/********************************************************************
+
+    Z80 Bus Access Functions
+
+********************************************************************/
+
+/*
+Handler bus accesses. The machine cycle engine reports each one as a transaction once it has been made
+*/
+uint8_t Z80_readByte(uint16_t address) {
+    uint8_t value = memoryController_directRead(address);
+    if (Z80Bus_enabled)
+        Z80Bus_transaction(Z80MCYCLE_MEMORY_READ, address, value);
+    return value;
+}
+
+void Z80_writeByte(uint16_t address, uint8_t value) {
+    memoryController_directWrite(address, value);
+    Z80_writes++;
+    if (Z80Bus_enabled)
+        Z80Bus_transaction(Z80MCYCLE_MEMORY_WRITE, address, value);
+}
+
+uint16_t Z80_readWord(uint16_t address) {
+    return Z80_readByte(address) | (Z80_readByte(address + 1) << 8);
+}
+
+void Z80_writeWord(uint16_t address, uint16_t value) {
+    Z80_writeByte(address, value & 0xFF);
+    Z80_writeByte(address + 1, value >> 8);
+}
+
+uint8_t Z80_inPort(uint16_t port) {
+    uint8_t value = ioController_directRead(port);
+    if (Z80Bus_enabled)
+        Z80Bus_transaction(Z80MCYCLE_PORT_READ, port, value);
+    return value;
+}
+
+void Z80_outPort(uint16_t port, uint8_t value) {
+    ioController_directWrite(port, value);
+    Z80_writes++;
+    if (Z80Bus_enabled)
+        Z80Bus_transaction(Z80MCYCLE_PORT_WRITE, port, value);
+}
+
+/*
+The stack grows down, so a push stores the high byte first
+*/
+void Z80_push(uint16_t value) {
+    Z80_writeByte(--SP, value >> 8);
+    Z80_writeByte(--SP, value & 0xFF);
+}
+
+uint16_t Z80_pop() {
+    uint16_t value = Z80_readWord(SP);
+    SP += 2;
+    return value;
+}
+
+/********************************************************************
+
+    Z80 Execute Helpers
+
+********************************************************************/
+
+void Z80_exchange(uint16_t* a, uint16_t* b) {
+    uint16_t t = *a;
+    *a = *b;
+    *b = t;
+}
+
+/*
+Swaps the registers picked by 'mask' between the main and alternate banks
+*/
+void Z80_exchangeBanks(uint64_t mask) {
+    uint64_t x = (Z80_registers.main.packed ^ Z80_registers.alternate.packed) & mask;
+    Z80_registers.main.packed ^= x;
+    Z80_registers.alternate.packed ^= x;
+}
+
+/*
+HALT repeats itself until an interrupt arrives. PC is left on the HALT so the interrupt return address is correct
+*/
+void Z80_halt() {
+    halted = true;
+    PC--;
+    Z80_haltSkip();
+}
+
+/*
+LD A,I and LD A,R copy IFF2 into P/V
+*/
+void Z80_loadIRFlags() {
+    uint8_t f = (REG_F & Z80FLAG_C) | (REG_A & (Z80FLAG_S | Z80FLAG_XY)) | (REG_A == 0 ? Z80FLAG_Z : 0);
+    if (IFF2)
+        f |= Z80FLAG_PV;
+    SET_F(f);
+}
+
+void Z80_rrd() {
+    uint8_t m = Z80_readByte(HL);
+    Z80_writeByte(HL, (uint8_t)((REG_A << 4) | (m >> 4)));
+    SET_A((REG_A & 0xF0) | (m & 0x0F));
+    Z80Alu_flagsSZP(REG_A);
+}
+
+void Z80_rld() {
+    uint8_t m = Z80_readByte(HL);
+    Z80_writeByte(HL, (uint8_t)((m << 4) | (REG_A & 0x0F)));
+    SET_A((REG_A & 0xF0) | (m >> 4));
+    Z80Alu_flagsSZP(REG_A);
+}
+
+/*
+LDI / LDD. The undocumented bits come from A + the transferred byte
+*/
+void Z80_blockLoad(int step) {
+    uint8_t value = Z80_readByte(HL);
+    Z80_writeByte(DE, value);
+    HL += step;
+    DE += step;
+    BC--;
+
+    uint8_t n = value + REG_A;
+    uint8_t f = (REG_F & (Z80FLAG_S | Z80FLAG_Z | Z80FLAG_C)) | (n & Z80FLAG_X) | ((n << 4) & Z80FLAG_Y);
+    if (BC != 0)
+        f |= Z80FLAG_PV;
+    SET_F(f);
+}
+
+/*
+CPI / CPD. Carry is preserved, the undocumented bits come from A - (HL) - H
+*/
+void Z80_blockCompare(int step) {
+    uint8_t value = Z80_readByte(HL);
+    uint8_t carry = REG_F & Z80FLAG_C;
+    uint8_t r = Z80Alu_sub8(REG_A, value, 0);
+    HL += step;
+    BC--;
+
+    uint8_t f = (REG_F & (Z80FLAG_S | Z80FLAG_Z | Z80FLAG_H)) | Z80FLAG_N | carry;
+    uint8_t n = r - ((f & Z80FLAG_H) ? 1 : 0);
+    f |= (n & Z80FLAG_X) | ((n << 4) & Z80FLAG_Y);
+    if (BC != 0)
+        f |= Z80FLAG_PV;
+    SET_F(f);
+}
+
+/*
+Flags shared by the block I/O instructions. 'k' is the transferred byte added to the adjusted C or L
+*/
+void Z80_blockIOFlags(uint8_t value, unsigned int k) {
+    uint8_t b = REG_B;
+    uint8_t f = (b & (Z80FLAG_S | Z80FLAG_XY)) | (b == 0 ? Z80FLAG_Z : 0);
+    if (value & 0x80)
+        f |= Z80FLAG_N;
+    if (k > 0xFF)
+        f |= Z80FLAG_H | Z80FLAG_C;
+    if (Z80Alu_parity((uint8_t)((k & 7) ^ b)))
+        f |= Z80FLAG_PV;
+    SET_F(f);
+}
+
+/*
+INI / IND
+*/
+void Z80_blockIn(int step) {
+    uint8_t value = Z80_inPort(BC);
+    Z80_writeByte(HL, value);
+    HL += step;
+    SET_B(REG_B - 1);
+    Z80_blockIOFlags(value, value + (uint8_t)(REG_C + step));
+}
+
+/*
+OUTI / OUTD. B is decremented before it goes on the address bus
+*/
+void Z80_blockOut(int step) {
+    uint8_t value = Z80_readByte(HL);
+    SET_B(REG_B - 1);
+    Z80_outPort(BC, value);
+    HL += step;
+    Z80_blockIOFlags(value, value + REG_L);
+}
+
+
+/********************************************************************
+
+    Z80 Bulk Block Functions
+
+********************************************************************/
+
+/*
+True when an interrupt or WAIT would stop the CPU repeating an instruction. The interrupt inputs only change between engine
+slices, so one not due now stays that way until the slice ends
+*/
+bool Z80_interruptDue() {
+    return Z80_wait || nmiPending || eiPending || (IFF1 && signals_readSignal(&signal_INT)) || Z80Refresh_watching;
+}
+
+/*
+The number of repeats of 'iterationTStates' each, at most 'limit', that can start from T-state 'start' before the engine
+reaches Z80_tStateDeadline
+*/
+uint32_t Z80_repeatsBeforeDeadline(uint64_t start, uint32_t iterationTStates, uint32_t limit) {
+    if (start >= Z80_tStateDeadline)
+        return 0;
+    uint64_t allowed = (Z80_tStateDeadline - start - 1) / iterationTStates + 1;
+    return allowed < limit ? (uint32_t)allowed : limit;
+}
+
+/*
+The number of further iterations, at most 'limit', that can start before the engine reaches Z80_tStateDeadline. None when an
+interrupt would be accepted first
+*/
+uint32_t Z80_bulkAllowed(uint32_t limit) {
+    if (Z80_interruptDue())
+        return 0;
+
+    // The iteration just run repeats, so the next starts after it and the repeat
+    return Z80_repeatsBeforeDeadline(Z80_tStates + cInstr.tStates + TSTATES_BLOCK_REPEAT,
+        Z80Opcodes_extended[cInstr.opcode].tStates + TSTATES_BLOCK_REPEAT, limit);
+}
+
+/*
+True when the next iteration starts before any device that catches up on access can change. The iterations are all timed
+at the start of the instruction, which is only right while nothing they see has changed since
+*/
+bool Z80_bulkPortsHold() {
+    return Z80_tStates + cInstr.tStates + TSTATES_BLOCK_REPEAT < ioController_nextChange();
+}
+
+/*
+Bytes from 'address' to the edge of its page in the direction of 'step'
+*/
+uint32_t Z80_bulkPageRun(uint16_t address, int step) {
+    uint32_t offset = address & MEMORY_PAGE_MASK;
+    return step > 0 ? MEMORY_PAGE_SIZE - offset : offset + 1;
+}
+
+/*
+Cuts 'limit' iterations writing from 'address' short after the one that writes over the instruction, which would change
+what the next iteration fetches
+*/
+uint32_t Z80_bulkCodeLimit(uint16_t address, int step, uint32_t limit) {
+    uint16_t instrPC = PC - 2;
+    uint32_t toOpcode = (uint16_t)((instrPC - address) * step);
+    uint32_t toNext = (uint16_t)((instrPC + 1 - address) * step);
+    uint32_t toCode = toOpcode < toNext ? toOpcode : toNext;
+    return toCode < limit ? toCode + 1 : limit;
+}
+
+/*
+Counts 'iterations' further iterations as the re-executions they replace: their T-states, two opcode fetches each and an instruction each
+*/
+void Z80_bulkAccount(uint32_t iterations) {
+    cInstr.tStates += iterations * (Z80Opcodes_extended[cInstr.opcode].tStates + TSTATES_BLOCK_REPEAT);
+    Z80_ADVANCE_R(2 * iterations);
+    Z80_instructionsExecuted += iterations;
+    Z80_bulkIterations += iterations;
+}
+
+/*
+LDIR / LDDR within plain memory pages. All but the last iteration of a run only move their byte, one at a time so overlapping
+copies repeat as they do on the Z80. The last runs in full to leave the flags
+*/
+void Z80_bulkLoad(int step) {
+    uint16_t instrPC = PC - 2;
+    bool ran = false;
+
+    // Stop once an iteration has written over the instruction
+    while (BC != 0 && (uint16_t)(DE - step - instrPC) > 1) {
+        uint8_t* src = memoryController_readPages[HL >> MEMORY_PAGE_SHIFT];
+        uint8_t* dst = memoryController_writePages[DE >> MEMORY_PAGE_SHIFT];
+        if (src == NULL || dst == NULL)
+            break;
+
+        uint32_t n = Z80_bulkAllowed(BC);
+        uint32_t srcRun = Z80_bulkPageRun(HL, step);
+        uint32_t dstRun = Z80_bulkPageRun(DE, step);
+        if (n > srcRun)
+            n = srcRun;
+        if (n > dstRun)
+            n = dstRun;
+        n = Z80_bulkCodeLimit(DE, step, n);
+        if (n == 0)
+            break;
+
+        for (uint32_t i = 1; i < n; i++) {
+            dst[DE & MEMORY_PAGE_MASK] = src[HL & MEMORY_PAGE_MASK];
+            memoryController_notifyWrite(DE);
+            HL += step;
+            DE += step;
+        }
+        BC -= n - 1;
+        Z80_writes += n - 1;
+        Z80_blockLoad(step);
+        Z80_bulkAccount(n);
+        ran = true;
+    }
+    if (ran)
+        Z80_bulkRuns++;
+}
+
+/*
+CPIR / CPDR within plain memory pages. Iterations before the first byte equal to A only move HL and BC, the one that
+matches, or the last of the run, runs in full to leave the flags. Carry is the only flag carried between iterations and they all keep it
+*/
+void Z80_bulkCompare(int step) {
+    bool ran = false;
+
+    while (BC != 0 && !(REG_F & Z80FLAG_Z)) {
+        uint8_t* src = memoryController_readPages[HL >> MEMORY_PAGE_SHIFT];
+        if (src == NULL)
+            break;
+
+        uint32_t n = Z80_bulkAllowed(BC);
+        uint32_t srcRun = Z80_bulkPageRun(HL, step);
+        if (n > srcRun)
+            n = srcRun;
+        if (n == 0)
+            break;
+
+        const uint8_t* p = src + (HL & MEMORY_PAGE_MASK);
+        if (step > 0) {
+            const uint8_t* match = memchr(p, REG_A, n);
+            if (match != NULL)
+                n = (uint32_t)(match - p) + 1;
+        }
+        else {
+            for (uint32_t i = 0; i < n; i++) {
+                if (*(p - i) == REG_A) {
+                    n = i + 1;
+                    break;
+                }
+            }
+        }
+
+        HL = (uint16_t)(HL + step * (int)(n - 1));
+        BC -= n - 1;
+        Z80_blockCompare(step);
+        Z80_bulkAccount(n);
+        ran = true;
+    }
+    if (ran)
+        Z80_bulkRuns++;
+}
+
+/*
+INIR / INDR. Every iteration reads the port, so they run one at a time and the device can raise an interrupt or WAIT between them
+*/
+void Z80_bulkIn(int step) {
+    uint16_t instrPC = PC - 2;
+    bool ran = false;
+
+    while (REG_B != 0 && (uint16_t)(HL - step - instrPC) > 1 && Z80_bulkAllowed(1) > 0 && Z80_bulkPortsHold()) {
+        Z80_blockIn(step);
+        Z80_bulkAccount(1);
+        ran = true;
+    }
+    if (ran)
+        Z80_bulkRuns++;
+}
+
+/*
+OTIR / OTDR, one iteration at a time as with Z80_bulkIn()
+*/
+void Z80_bulkOut(int step) {
+    bool ran = false;
+
+    while (REG_B != 0 && Z80_bulkAllowed(1) > 0 && Z80_bulkPortsHold()) {
+        Z80_blockOut(step);
+        Z80_bulkAccount(1);
+        ran = true;
+    }
+    if (ran)
+        Z80_bulkRuns++;
+}
+
+
+/********************************************************************
+
+    Z80 HALT Skip Functions
+
+********************************************************************/
+
+/*
+True when a HALT's re-executions can be skipped: nothing can wake the CPU before the slice ends. Under the machine cycle
+engine the re-executions' fetches would reach the bus, so they are only skipped while nothing listens to it
+*/
+bool Z80_haltCanSkip() {
+    return Z80_haltSkipEnabled && !Z80_interruptDue() && !Z80Bus_observed();
+}
+
+/*
+Runs the re-executions of a HALT that fall before the engine's deadline in one go. Each is counted as the instruction it
+replaces: its T-states, its opcode fetch and an instruction
+*/
+void Z80_haltSkip() {
+    if (!Z80_haltCanSkip())
+        return;
+
+    uint32_t haltTStates = Z80Opcodes_main[0x76].tStates;
+    uint32_t n = Z80_repeatsBeforeDeadline(Z80_tStates + cInstr.tStates, haltTStates, Z80_HALT_MAX_SKIP);
+    if (n == 0)
+        return;
+
+    cInstr.tStates += n * haltTStates;
+    Z80_ADVANCE_R(n);
+    Z80_instructionsExecuted += n;
+    Z80_haltSkipped += n;
+    Z80_haltSkippedTStates += (uint64_t)n * haltTStates;
+}
+
+
+/********************************************************************
+
+    Z80 Execute Functions
+
+********************************************************************/
+
+/*
+Executes cInstr through the handler its decode selected
+*/
+int Z80_execute() {
+    return cInstr.execFunction();
+}
+
+/*
+One handler per line of Z80Opcodes.def. The DD and FD lines are generated twice, once for each index register
+*/
+#define Z80_HANDLER(name, handler) int name() { handler; return INSTR_EXEC_SUCCESS; }
+#define Z80_MAIN(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_HANDLER(Z80_executeMain##opcode, handler)
+#define Z80_ED(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_HANDLER(Z80_executeExtended##opcode, handler)
+#define Z80_CB(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_HANDLER(Z80_executeBit##opcode, handler)
+#define Z80_XY(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_HANDLER(Z80_executeIX##opcode, handler)
+#define Z80_XYCB(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_HANDLER(Z80_executeIXBit##opcode, handler)
+#define IDX IX
+#include "Z80Opcodes.def"
+#undef IDX
+
+#define Z80_XY(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_HANDLER(Z80_executeIY##opcode, handler)
+#define Z80_XYCB(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_HANDLER(Z80_executeIYBit##opcode, handler)
+#define IDX IY
+#include "Z80Opcodes.def"
+#undef IDX
+
+/*
+Fused handlers. Each op gets the cInstr fields its handler reads and moves PC on, as Z80_step() would, and its T-states
+are counted before the next op runs. The handlers are called directly, so the compiler can inline them into one body.
+R takes each op's opcode fetches just before it runs, so an LD R,A partway through keeps the fetches of the ops after it
+*/
+#define Z80_FUSED_OP(i, handler) \
+    Z80_ADVANCE_R(ops[i]->m1Cycles); \
+    cInstr.prefix = ops[i]->prefix; \
+    cInstr.opcode = ops[i]->opcode; \
+    cInstr.operand0 = ops[i]->operand0; \
+    cInstr.operand1 = ops[i]->operand1; \
+    cInstr.tStates = ops[i]->tStates; \
+    PC += ops[i]->len; \
+    Z80_execute##handler(); \
+    Z80_tStates += cInstr.tStates;
+#define Z80_FUSE2(name, mnemonic, first, second) int Z80_executeFused##name(const Z80MicroOp_t* const* ops) { \
+    Z80_FUSED_OP(0, first) Z80_FUSED_OP(1, second) \
+    return INSTR_EXEC_SUCCESS; }
+#define Z80_FUSE3(name, mnemonic, first, second, third) int Z80_executeFused##name(const Z80MicroOp_t* const* ops) { \
+    Z80_FUSED_OP(0, first) Z80_FUSED_OP(1, second) Z80_FUSED_OP(2, third) \
+    return INSTR_EXEC_SUCCESS; }
+#include "Z80Fusion.def"
+#undef Z80_FUSED_OP
+
+
+/********************************************************************
+
+    Z80 Interrupt Functions
+
+********************************************************************/
+
+/*
+Called before each instruction. Accepts a pending NMI or INT and returns the T-states the acceptance took, or 0
+*/
+int Z80_pollInterrupts() {
+    // An NMI can't be masked
+    if (nmiPending) {
+        nmiPending = false;
+        if (halted) {
+            halted = false;
+            PC++;
+        }
+        IFF1 = false;
+        Z80_INCREMENT_R();
+        // The NMI response starts with an opcode fetch whose byte is ignored
+        if (Z80Bus_enabled)
+            Z80Bus_beginInterrupt(PC, 5);
+        Z80_push(PC);
+        PC = 0x0066;
+        return TSTATES_INTERRUPT_NMI;
+    }
+
+    // EI takes effect after the instruction that follows it
+    if (eiPending) {
+        eiPending = false;
+        return 0;
+    }
+
+    // INT from the refresh address is only followed here while an event can't be in time for it
+    if (Z80Refresh_watching)
+        Z80Refresh_sync();
+    if (!IFF1 || !signals_readSignal(&signal_INT))
+        return 0;
+
+    if (halted) {
+        halted = false;
+        PC++;
+    }
+    IFF1 = false;
+    IFF2 = false;
+    Z80_INCREMENT_R();
+    // The acknowledge is an M1 with two wait states added
+    if (Z80Bus_enabled)
+        Z80Bus_beginInterrupt(PC, 7);
+    Z80_push(PC);
+    if (interruptMode == 2) {
+        // The data bus floats high, so the vector is read from (I << 8) | 0xFF
+        PC = Z80_readWord((uint16_t)((IVMR & 0xFF00) | 0xFF));
+        return TSTATES_INTERRUPT_IM2;
+    }
+    // Mode 0 sees 0xFF on the floating bus, which is RST 38h, the same as mode 1
+    PC = 0x0038;
+    return TSTATES_INTERRUPT_IM1;
+}
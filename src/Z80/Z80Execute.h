@@ -0,0 +1,143 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Execute.h : Execution of the full Z80 instruction set, with a handler per opcode generated from Z80Opcodes.def
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Z80Block.h"
+#include "../Z0Machine.h"
+
+/* Extra T-states taken when a conditional instruction takes its branch, or a block instruction repeats */
+#define TSTATES_BRANCH_JR 5
+#define TSTATES_BRANCH_CALL 7
+#define TSTATES_BRANCH_RET 6
+#define TSTATES_BLOCK_REPEAT 5
+
+/* Interrupt acceptance lengths in T-states */
+#define TSTATES_INTERRUPT_NMI 11
+#define TSTATES_INTERRUPT_IM1 13
+#define TSTATES_INTERRUPT_IM2 19
+
+/* Bulk block instructions. A repeating block instruction runs as many of its iterations as it can in one execution */
+extern Z0_MACHINE_LOCAL bool Z80_bulkEnabled;
+extern Z0_MACHINE_LOCAL uint64_t Z80_bulkRuns; // Executions that ran iterations in bulk
+extern Z0_MACHINE_LOCAL uint64_t Z80_bulkIterations; // Iterations run in bulk. Each is also counted as an instruction
+
+/* Memory and port writes made by instructions since Z80_init() */
+extern Z0_MACHINE_LOCAL uint64_t Z80_writes;
+/* LD A,R instructions run since Z80_init(). R is the only state they can see change from one iteration of a loop to the next */
+extern Z0_MACHINE_LOCAL uint64_t Z80_refreshReads;
+
+/* HALT skip. A halted CPU jumps to the engine's deadline rather than re-executing HALT every 4 T-states */
+#define Z80_HALT_MAX_SKIP (1u << 28) // Re-executions skipped per HALT, keeping its T-states within an int
+extern Z0_MACHINE_LOCAL bool Z80_haltSkipEnabled;
+extern Z0_MACHINE_LOCAL uint64_t Z80_haltSkipped; // Re-executions skipped. Each is also counted as an instruction
+extern Z0_MACHINE_LOCAL uint64_t Z80_haltSkippedTStates;
+
+/********************************************************************
+
+    Z80 Execute Functions
+    Executes the instruction held in cInstr. PC already points past the instruction
+
+********************************************************************/
+
+int Z80_execute();
+
+/* One handler per opcode, named after its table, e.g. Z80_executeMain0x41 or Z80_executeIYBit0x06 */
+#define Z80_MAIN(opcode, mnemonic, length, operands, tStates, mCycles, handler) int Z80_executeMain##opcode();
+#define Z80_ED(opcode, mnemonic, length, operands, tStates, mCycles, handler) int Z80_executeExtended##opcode();
+#define Z80_CB(opcode, mnemonic, length, operands, tStates, mCycles, handler) int Z80_executeBit##opcode();
+#define Z80_XY(opcode, mnemonic, length, operands, tStates, mCycles, handler) int Z80_executeIX##opcode(); int Z80_executeIY##opcode();
+#define Z80_XYCB(opcode, mnemonic, length, operands, tStates, mCycles, handler) int Z80_executeIXBit##opcode(); int Z80_executeIYBit##opcode();
+#include "Z80Opcodes.def"
+
+/* One handler per line of Z80Fusion.def, running its ops in turn, e.g. Z80_executeFusedDecB_JrNz */
+#define Z80_FUSE2(name, mnemonic, first, second) int Z80_executeFused##name(const Z80MicroOp_t* const* ops);
+#define Z80_FUSE3(name, mnemonic, first, second, third) int Z80_executeFused##name(const Z80MicroOp_t* const* ops);
+#include "Z80Fusion.def"
+
+/********************************************************************
+
+    Z80 Execute Helpers
+
+********************************************************************/
+
+void Z80_exchange(uint16_t* a, uint16_t* b);
+void Z80_exchangeBanks(uint64_t mask);
+void Z80_halt();
+void Z80_loadIRFlags();
+void Z80_rrd();
+void Z80_rld();
+void Z80_blockLoad(int step);
+void Z80_blockCompare(int step);
+void Z80_blockIOFlags(uint8_t value, unsigned int k);
+void Z80_blockIn(int step);
+void Z80_blockOut(int step);
+
+/********************************************************************
+
+    Z80 Bulk Block Functions
+    Further iterations of a repeating block instruction, run in place of re-executing it
+
+********************************************************************/
+
+bool Z80_interruptDue();
+uint32_t Z80_repeatsBeforeDeadline(uint64_t start, uint32_t iterationTStates, uint32_t limit);
+uint32_t Z80_bulkAllowed(uint32_t limit);
+bool Z80_bulkPortsHold();
+uint32_t Z80_bulkPageRun(uint16_t address, int step);
+uint32_t Z80_bulkCodeLimit(uint16_t address, int step, uint32_t limit);
+void Z80_bulkAccount(uint32_t iterations);
+void Z80_bulkLoad(int step);
+void Z80_bulkCompare(int step);
+void Z80_bulkIn(int step);
+void Z80_bulkOut(int step);
+
+/********************************************************************
+
+    Z80 HALT Skip Functions
+
+********************************************************************/
+
+bool Z80_haltCanSkip();
+void Z80_haltSkip();
+
+/********************************************************************
+
+    Z80 Interrupt Functions
+
+********************************************************************/
+
+int Z80_pollInterrupts();
+
+/********************************************************************
+
+    Z80 Bus Access Functions
+    Data accesses of the executing instruction
+
+********************************************************************/
+
+uint8_t Z80_readByte(uint16_t address);
+void Z80_writeByte(uint16_t address, uint8_t value);
+uint16_t Z80_readWord(uint16_t address);
+void Z80_writeWord(uint16_t address, uint16_t value);
+uint8_t Z80_inPort(uint16_t port);
+void Z80_outPort(uint16_t port, uint8_t value);
+void Z80_push(uint16_t value);
+uint16_t Z80_pop();
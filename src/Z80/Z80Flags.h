@@ -22,7 +22,7 @@ Z80FlagAccess.h : Abstraction header to functions that allow good access to the
 Flags register layout:
 
 7 6 5 4 3 2   1 0
-S Z X H X P/V N C
+S Z Y H X P/V N C
 
 C: Carry flag
 N: Add/subtract -- > ASFlag
@@ -30,19 +30,69 @@ P/V: Parity/Overflow flag
 H: Half carry flag
 Z: Zero flag
 S: Sign flag
-X: Not used
+X, Y: Not officially used. Copies of bits 3 and 5 of a result, which the ALU reproduces
 
 */
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#include "../Z0Machine.h"
 
 #define Z80FLAGS_CARRY 0
 #define Z80FLAGS_AS 1
 #define Z80FLAGS_PV 2
+#define Z80FLAGS_X 3
 #define Z80FLAGS_HCARRY 4
+#define Z80FLAGS_Y 5
 #define Z80FLAGS_ZERO 6
 #define Z80FLAGS_SIGN 7
 
+/* Flag masks, for building the whole F register at once */
+#define Z80FLAG_C (1 << Z80FLAGS_CARRY)
+#define Z80FLAG_N (1 << Z80FLAGS_AS)
+#define Z80FLAG_PV (1 << Z80FLAGS_PV)
+#define Z80FLAG_X (1 << Z80FLAGS_X)
+#define Z80FLAG_H (1 << Z80FLAGS_HCARRY)
+#define Z80FLAG_Y (1 << Z80FLAGS_Y)
+#define Z80FLAG_Z (1 << Z80FLAGS_ZERO)
+#define Z80FLAG_S (1 << Z80FLAGS_SIGN)
+#define Z80FLAG_XY (Z80FLAG_X | Z80FLAG_Y)
+
 void Z80Flags_setFlag(int f);
 void Z80Flags_clearFlag(int f);
 bool Z80Flags_readFlag(int f);
+
+/*
+
+Lazy flags:
+
+The 8 bit ALU records the kind, operands and result of its last operation instead of building F.
+F is only built (materialised) into AF when something reads it, through Z80FLAGS_READ() or Z80Flags_materialise().
+Anything that writes the low byte of AF directly must first cancel the pending operation with Z80FLAGS_DISCARD()
+
+*/
+
+enum Z80LazyFlagsEnum { Z80LazyFlags_None, Z80LazyFlags_Add, Z80LazyFlags_Sub, Z80LazyFlags_Cp, Z80LazyFlags_And, Z80LazyFlags_Logic, Z80LazyFlags_Inc, Z80LazyFlags_Dec };
+
+typedef struct Z80LazyFlags {
+    int op; // Takes a value of Z80LazyFlagsEnum. Z80LazyFlags_None means F in AF is up to date
+    uint8_t a; // First operand
+    uint8_t b; // Second operand
+    uint16_t result; // Result, with the carry or borrow out in bit 8
+    uint8_t carry; // C from before an INC or DEC, which keep it
+} Z80LazyFlags_t;
+
+extern Z0_MACHINE_LOCAL Z80LazyFlags_t Z80Flags_lazy;
+extern Z0_MACHINE_LOCAL uint64_t Z80Flags_materialisations; // Number of times F has been built from a pending operation
+
+void Z80Flags_materialise();
+uint8_t Z80Flags_readCarry();
+
+#define Z80FLAGS_SYNC() (Z80Flags_lazy.op != Z80LazyFlags_None ? Z80Flags_materialise() : (void)0)
+#define Z80FLAGS_READ() (Z80FLAGS_SYNC(), (uint8_t)(AF & 0xFF))
+#define Z80FLAGS_DISCARD() (Z80Flags_lazy.op = Z80LazyFlags_None)
+
+/* Z and C for a condition, read from the pending operation without building F. Every operation sets Z from its 8 bit result */
+#define Z80FLAGS_IS_ZERO() (Z80Flags_lazy.op != Z80LazyFlags_None ? (uint8_t)Z80Flags_lazy.result == 0 : (AF & Z80FLAG_Z) != 0)
+#define Z80FLAGS_IS_CARRY() (Z80Flags_lazy.op != Z80LazyFlags_None ? Z80Flags_readCarry() != 0 : (AF & Z80FLAG_C) != 0)
@@ -0,0 +1,387 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Fusion.c : Superinstructions. Short runs of instructions that code repeats often are matched when blocks and the
+threaded ROM are built, and run through one fused handler generated from Z80Fusion.def
+
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "Z80Fusion.h"
+#include "Z80Instructions.h"
+#include "Z80Execute.h"
+#include "Z80Step.h"
+#include "Z80Opcodes.h"
+
+#include "../SysIO/Log.h"
+
+/* Z80 Instruction */
+extern Z0_MACHINE_LOCAL Z80_Instr_t cInstr;
+
+/* Patterns, in the order of Z80Fusion.def. A block or ROM address refers to one by its index + 1 */
+const Z80FusionPattern_t Z80Fusion_patterns[] = {
+#define Z80_FUSE2(name, mnemonic, first, second) { mnemonic, 2, { &Z80_execute##first, &Z80_execute##second, NULL }, &Z80_executeFused##name },
+#define Z80_FUSE3(name, mnemonic, first, second, third) { mnemonic, 3, { &Z80_execute##first, &Z80_execute##second, &Z80_execute##third }, &Z80_executeFused##name },
+#include "Z80Fusion.def"
+};
+const int Z80Fusion_nPatterns = sizeof(Z80Fusion_patterns) / sizeof(Z80Fusion_patterns[0]);
+
+Z0_MACHINE_LOCAL bool Z80Fusion_enabled = true;
+
+/* Statistics */
+Z0_MACHINE_LOCAL uint64_t Z80Fusion_patternRuns[MAX_NUMBER_OF_FUSION_PATTERNS];
+
+/* Profile */
+Z0_MACHINE_LOCAL bool Z80Fusion_profiling = false;
+Z0_MACHINE_LOCAL Z80FusionCount_t* Z80Fusion_profile = NULL;
+Z0_MACHINE_LOCAL uint32_t Z80Fusion_window[Z80_FUSION_MAX_OPS - 1];
+Z0_MACHINE_LOCAL int Z80Fusion_windowLen = 0;
+Z0_MACHINE_LOCAL uint16_t Z80Fusion_nextPC = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Fusion_profiled = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Fusion_profileDropped = 0;
+
+/* Prefix of each opcode table, by the table number in Z80Fusion_opKey() */
+const uint16_t Z80Fusion_prefixes[] = { 0, PREFIX_BITS, PREFIX_EXX, PREFIX_IX, PREFIX_IY, PREFIX_IX_BITS, PREFIX_IY_BITS };
+
+/********************************************************************
+
+    Z80 Fusion Functions
+
+********************************************************************/
+
+/*
+Sets up the profile if one was asked for
+*/
+void Z80Fusion_init() {
+    if (Z80Fusion_nPatterns > MAX_NUMBER_OF_FUSION_PATTERNS) {
+        formattedLog(stdlog, LOGTYPE_WARN, "Z80Fusion.def has %i patterns, the limit is %i. Fusion is disabled\n", Z80Fusion_nPatterns, MAX_NUMBER_OF_FUSION_PATTERNS);
+        Z80Fusion_enabled = false;
+    }
+    if (!Z80Fusion_profiling)
+        return;
+
+    if (Z80Fusion_profile == NULL)
+        Z80Fusion_profile = calloc(Z80_FUSION_PROFILE_SIZE, sizeof(Z80FusionCount_t));
+    if (Z80Fusion_profile == NULL) {
+        formattedLog(stdlog, LOGTYPE_WARN, "Unable to allocate the fusion profile, it is disabled\n");
+        Z80Fusion_profiling = false;
+        return;
+    }
+    Z80Fusion_breakLine();
+}
+
+/*
+Frees the profile and puts the module back as it was before Z80Fusion_init()
+*/
+void Z80Fusion_destroy() {
+    free(Z80Fusion_profile);
+    Z80Fusion_profile = NULL;
+    Z80Fusion_profiling = false;
+    Z80Fusion_enabled = true;
+    Z80Fusion_windowLen = 0;
+    Z80Fusion_nextPC = 0;
+    Z80Fusion_profiled = 0;
+    Z80Fusion_profileDropped = 0;
+
+    memset(Z80Fusion_patternRuns, 0, sizeof(Z80Fusion_patternRuns));
+}
+
+/*
+Returns the pattern starting with ops[0], as its index + 1, or 0 if none does. Only the first 'available' ops can be used
+*/
+uint8_t Z80Fusion_match(const Z80MicroOp_t* const* ops, int available) {
+    if (!Z80Fusion_enabled)
+        return 0;
+
+    for (int p = 0; p < Z80Fusion_nPatterns; p++) {
+        const Z80FusionPattern_t* pattern = &Z80Fusion_patterns[p];
+        if (pattern->numOps > available)
+            continue;
+
+        bool matched = true;
+        for (int i = 0; i < pattern->numOps && matched; i++) {
+            matched = ops[i]->len != 0 && ops[i]->exec == pattern->ops[i];
+            // LD R,A can raise INT when it follows the refresh address, so it may only end a run
+            if (Z80Refresh_enabled && i < pattern->numOps - 1 && ops[i]->prefix == PREFIX_EXX && ops[i]->opcode == 0x4F)
+                matched = false;
+        }
+        if (matched)
+            return (uint8_t)(p + 1);
+    }
+    return 0;
+}
+
+/*
+Finds the pattern starting at each op of a block that has just been built
+*/
+void Z80Fusion_markBlock(Z80Block_t* block) {
+    for (int i = 0; i < block->numOps; i++) {
+        const Z80MicroOp_t* ops[Z80_FUSION_MAX_OPS];
+        int available = 0;
+        while (available < Z80_FUSION_MAX_OPS && i + available < block->numOps) {
+            ops[available] = &block->ops[i + available];
+            available++;
+        }
+        block->fused[i] = Z80Fusion_match(ops, available);
+    }
+}
+
+/*
+Totals of Z80Fusion_patternRuns: the fused handlers run and the instructions they ran
+*/
+void Z80Fusion_totals(uint64_t* runs, uint64_t* instructions) {
+    *runs = 0;
+    *instructions = 0;
+    for (int p = 0; p < Z80Fusion_nPatterns && p < MAX_NUMBER_OF_FUSION_PATTERNS; p++) {
+        *runs += Z80Fusion_patternRuns[p];
+        *instructions += Z80Fusion_patternRuns[p] * Z80Fusion_patterns[p].numOps;
+    }
+}
+
+/********************************************************************
+
+    Z80 Fusion Profile Functions
+
+********************************************************************/
+
+/*
+Opcode with its table number above it, which fits in 11 bits
+*/
+uint32_t Z80Fusion_opKey(uint16_t prefix, uint8_t opcode) {
+    uint32_t table = 0;
+    for (uint32_t t = 0; t < sizeof(Z80Fusion_prefixes) / sizeof(Z80Fusion_prefixes[0]); t++) {
+        if (Z80Fusion_prefixes[t] == prefix)
+            table = t;
+    }
+    return (table << 8) | opcode;
+}
+
+/*
+Called by Z80_step() after the instruction in cInstr has run from 'address'. Counts it as the end of a pair and of a
+triple with the instructions run just before it, if it followed on from them without a branch or an interrupt
+*/
+void Z80Fusion_record(uint16_t address) {
+    uint32_t key = Z80Fusion_opKey(cInstr.prefix, cInstr.opcode);
+    Z80Fusion_profiled++;
+    if (address != Z80Fusion_nextPC)
+        Z80Fusion_windowLen = 0;
+
+    // Keys are 12 bits apart, oldest op first, with the number of ops above them
+    if (Z80Fusion_windowLen >= 1)
+        Z80Fusion_count((2ull << 36) | ((uint64_t)key << 12) | Z80Fusion_window[0]);
+    if (Z80Fusion_windowLen >= 2)
+        Z80Fusion_count((3ull << 36) | ((uint64_t)key << 24) | ((uint64_t)Z80Fusion_window[0] << 12) | Z80Fusion_window[1]);
+
+    if (PC != (uint16_t)(address + cInstr.instrByteLen)) {
+        Z80Fusion_windowLen = 0;
+        return;
+    }
+    Z80Fusion_window[1] = Z80Fusion_window[0];
+    Z80Fusion_window[0] = key;
+    if (Z80Fusion_windowLen < Z80_FUSION_MAX_OPS - 1)
+        Z80Fusion_windowLen++;
+    Z80Fusion_nextPC = PC;
+}
+
+void Z80Fusion_count(uint64_t key) {
+    uint32_t slot = (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> 40) & (Z80_FUSION_PROFILE_SIZE - 1);
+    for (int probe = 0; probe < Z80_FUSION_PROFILE_SIZE; probe++) {
+        Z80FusionCount_t* entry = &Z80Fusion_profile[(slot + probe) & (Z80_FUSION_PROFILE_SIZE - 1)];
+        if (entry->key == key) {
+            entry->count++;
+            return;
+        }
+        if (entry->key == 0) {
+            entry->key = key;
+            entry->count = 1;
+            return;
+        }
+    }
+    Z80Fusion_profileDropped++;
+}
+
+/*
+The next instruction doesn't follow on from the last, as an interrupt came in between
+*/
+void Z80Fusion_breakLine() {
+    Z80Fusion_windowLen = 0;
+}
+
+/*
+Logs the most frequent pairs and triples, with the share of the instructions run that each would fuse
+*/
+void Z80Fusion_logProfile() {
+    if (Z80Fusion_profile == NULL)
+        return;
+
+    Z80FusionCount_t* sorted = malloc(Z80_FUSION_PROFILE_SIZE * sizeof(Z80FusionCount_t));
+    if (sorted == NULL)
+        return;
+    memcpy(sorted, Z80Fusion_profile, Z80_FUSION_PROFILE_SIZE * sizeof(Z80FusionCount_t));
+    qsort(sorted, Z80_FUSION_PROFILE_SIZE, sizeof(Z80FusionCount_t), &Z80Fusion_compareCounts);
+
+    formattedLog(stdlog, LOGTYPE_MSG, "Fusion profile: %llu instructions, %llu sequences not counted\n", (unsigned long long)Z80Fusion_profiled, (unsigned long long)Z80Fusion_profileDropped);
+    for (int length = 2; length <= Z80_FUSION_MAX_OPS; length++) {
+        int logged = 0;
+        for (int i = 0; i < Z80_FUSION_PROFILE_SIZE && logged < Z80_FUSION_PROFILE_REPORT && sorted[i].key != 0; i++) {
+            if ((int)(sorted[i].key >> 36) != length)
+                continue;
+            char text[128];
+            Z80Fusion_describe(sorted[i].key, text, sizeof(text));
+            formattedLog(stdlog, LOGTYPE_MSG, "    %llu runs (%.2f%% of instructions): %s\n", (unsigned long long)sorted[i].count,
+                Z80Fusion_profiled > 0 ? 100.0 * length * sorted[i].count / Z80Fusion_profiled : 0.0, text);
+            logged++;
+        }
+    }
+    free(sorted);
+}
+
+/*
+qsort() order for Z80Fusion_logProfile(), most frequent first
+*/
+int Z80Fusion_compareCounts(const void* a, const void* b) {
+    uint64_t countA = ((const Z80FusionCount_t*)a)->count;
+    uint64_t countB = ((const Z80FusionCount_t*)b)->count;
+    return countA < countB ? 1 : countA > countB ? -1 : 0;
+}
+
+/*
+Writes the mnemonics of a profiled sequence into 'text', separated by '; '
+*/
+void Z80Fusion_describe(uint64_t key, char* text, size_t textLen) {
+    int length = (int)(key >> 36);
+    text[0] = '\0';
+    for (int i = 0; i < length; i++) {
+        uint32_t opKey = (key >> (12 * i)) & 0xFFF;
+        const Z80OpcodeInfo_t* info = &Z80Opcodes_table(Z80Fusion_prefixes[opKey >> 8])[opKey & 0xFF];
+        size_t used = strlen(text);
+        snprintf(text + used, textLen - used, "%s%s", i > 0 ? "; " : "", info->mnemonic);
+    }
+}
+
+/********************************************************************
+
+    Z80 Fusion Check Functions
+
+********************************************************************/
+
+/*
+Builds the op a pattern expects at position 'index' from the opcode tables, with the given operand bytes.
+Returns false if no table entry has the pattern's handler
+*/
+bool Z80Fusion_checkOp(const Z80FusionPattern_t* pattern, int index, uint8_t operand0, uint8_t operand1, Z80MicroOp_t* op) {
+    for (uint32_t t = 0; t < sizeof(Z80Fusion_prefixes) / sizeof(Z80Fusion_prefixes[0]); t++) {
+        const Z80OpcodeInfo_t* table = Z80Opcodes_table(Z80Fusion_prefixes[t]);
+        for (int opcode = 0; opcode < 0x100; opcode++) {
+            if (table[opcode].execFunction != pattern->ops[index] || table[opcode].length <= 0)
+                continue;
+            op->exec = table[opcode].execFunction;
+            op->prefix = Z80Fusion_prefixes[t];
+            op->opcode = (uint8_t)opcode;
+            op->operand0 = operand0;
+            op->operand1 = operand1;
+            op->len = (uint8_t)table[opcode].length;
+            op->tStates = table[opcode].tStates;
+            // Each prefix byte is an opcode fetch, but the opcode of DDCB and FDCB is read as an operand
+            op->m1Cycles = Z80Fusion_prefixes[t] == 0 ? 1 : 2;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+Checks every pattern's fused handler against running its ops one at a time as a block does, from a spread of register
+states. Everything the ops can change is compared, R included. The CPU is left as it was
+*/
+bool Z80Fusion_selfCheck() {
+    Z80State_t saved;
+    Z80_saveState(&saved);
+    uint64_t cases = 0;
+    uint64_t failures = 0;
+    uint32_t seed = 0x2545F491;
+
+    for (int p = 0; p < Z80Fusion_nPatterns; p++) {
+        const Z80FusionPattern_t* pattern = &Z80Fusion_patterns[p];
+        for (int run = 0; run < Z80_FUSION_CHECK_RUNS; run++) {
+            Z80MicroOp_t opsData[Z80_FUSION_MAX_OPS];
+            const Z80MicroOp_t* ops[Z80_FUSION_MAX_OPS];
+            bool found = true;
+            for (int i = 0; i < pattern->numOps; i++) {
+                seed = seed * 1664525 + 1013904223;
+                found = found && Z80Fusion_checkOp(pattern, i, (uint8_t)(seed >> 24), (uint8_t)(seed >> 16), &opsData[i]);
+                ops[i] = &opsData[i];
+            }
+            if (!found) {
+                failures++;
+                formattedLog(stdlog, LOGTYPE_ERROR, "Fusion self-check: %s has an op missing from the opcode tables\n", pattern->mnemonic);
+                break;
+            }
+
+            // A random CPU state, with the interrupts off so nothing else can run
+            Z80State_t start = saved;
+            Z80RegisterPair_t* pairs[] = { &start.registers.main.r.af, &start.registers.main.r.bc, &start.registers.main.r.de, &start.registers.main.r.hl,
+                &start.registers.alternate.r.af, &start.registers.alternate.r.bc, &start.registers.alternate.r.de, &start.registers.alternate.r.hl,
+                &start.registers.ix, &start.registers.iy, &start.registers.sp, &start.registers.pc, &start.registers.ivmr };
+            for (int i = 0; i < (int)(sizeof(pairs) / sizeof(pairs[0])); i++) {
+                seed = seed * 1664525 + 1013904223;
+                pairs[i]->w = (uint16_t)(seed >> 16);
+            }
+            start.lazy = (Z80LazyFlags_t){ Z80LazyFlags_None, 0, 0, 0, 0 };
+            start.iff1 = start.iff2 = start.halted = start.eiPending = start.nmiPending = false;
+
+            Z80_loadState(&start);
+            pattern->exec(ops);
+            Z80Flags_materialise();
+            Z80State_t fused;
+            Z80_saveState(&fused);
+
+            Z80_loadState(&start);
+            for (int i = 0; i < pattern->numOps; i++) {
+                Z80_ISSUE_MICRO_OP(ops[i]);
+                PC += ops[i]->len;
+                ops[i]->exec();
+                Z80_tStates += cInstr.tStates;
+            }
+            Z80Flags_materialise();
+            Z80State_t separate;
+            Z80_saveState(&separate);
+
+            cases++;
+            const Z80Registers_t* a = &fused.registers;
+            const Z80Registers_t* b = &separate.registers;
+            bool same = a->main.packed == b->main.packed && a->alternate.packed == b->alternate.packed && a->ix.w == b->ix.w && a->iy.w == b->iy.w;
+            same = same && a->sp.w == b->sp.w && a->pc.w == b->pc.w && a->ivmr.w == b->ivmr.w;
+            same = same && fused.iff1 == separate.iff1 && fused.iff2 == separate.iff2 && fused.eiPending == separate.eiPending;
+            same = same && fused.halted == separate.halted && fused.interruptMode == separate.interruptMode && fused.tStates == separate.tStates;
+            if (!same) {
+                failures++;
+                formattedLog(debuglog, LOGTYPE_ERROR, "Fusion self-check: %s gives AF=%04X R=%02X in %llu T-states fused, AF=%04X R=%02X in %llu one at a time\n",
+                    pattern->mnemonic, fused.registers.main.r.af.w, fused.registers.ivmr.w & 0xFF, (unsigned long long)(fused.tStates - start.tStates),
+                    separate.registers.main.r.af.w, separate.registers.ivmr.w & 0xFF, (unsigned long long)(separate.tStates - start.tStates));
+            }
+        }
+    }
+    Z80_loadState(&saved);
+
+    if (failures == 0) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Fusion self-check passed: %llu cases\n", (unsigned long long)cases);
+    }
+    else {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Fusion self-check failed: %llu of %llu cases\n", (unsigned long long)failures, (unsigned long long)cases);
+    }
+    return failures == 0;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Fusion.h : Superinstructions. Short runs of instructions that code repeats often are matched when blocks and the
+threaded ROM are built, and run through one fused handler generated from Z80Fusion.def
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "Z80.h"
+#include "Z80Block.h"
+#include "Z80Refresh.h"
+#include "../Signals.h"
+#include "../Z0Machine.h"
+
+#define Z80_FUSION_MAX_OPS 3
+#define MAX_NUMBER_OF_FUSION_PATTERNS 64
+#define Z80_FUSION_PROFILE_SIZE 0x4000 // Sequences the profile can count. Must be a power of 2
+#define Z80_FUSION_PROFILE_REPORT 24 // Most frequent pairs and triples logged
+#define Z80_FUSION_CHECK_RUNS 64 // Register states each pattern is checked from by Z80Fusion_selfCheck()
+
+/* Fused handler. ops[i] is the i-th op of the run, and PC is at the first */
+typedef int (*Z80FusedFunction_t)(const Z80MicroOp_t* const* ops);
+
+/* One line of Z80Fusion.def */
+typedef struct Z80FusionPattern {
+    const char* mnemonic;
+    int numOps;
+    const int (*ops[Z80_FUSION_MAX_OPS])(); // Handlers the ops must have, in order
+    Z80FusedFunction_t exec;
+} Z80FusionPattern_t;
+
+/* A sequence seen by the profile. 'key' holds up to three Z80Fusion_opKey() values, first op in the low bits */
+typedef struct Z80FusionCount {
+    uint64_t key;
+    uint64_t count;
+} Z80FusionCount_t;
+
+extern Z0_MACHINE_LOCAL bool Z80Fusion_enabled;
+extern const Z80FusionPattern_t Z80Fusion_patterns[];
+extern const int Z80Fusion_nPatterns;
+
+/* Statistics */
+extern Z0_MACHINE_LOCAL uint64_t Z80Fusion_patternRuns[MAX_NUMBER_OF_FUSION_PATTERNS]; // Fused handler runs, by pattern
+
+/* Profile of the instruction sequences run, used to choose the patterns */
+extern Z0_MACHINE_LOCAL bool Z80Fusion_profiling;
+extern Z0_MACHINE_LOCAL Z80FusionCount_t* Z80Fusion_profile; // ALLOCATED: Z80_FUSION_PROFILE_SIZE entries, open addressed
+extern Z0_MACHINE_LOCAL uint32_t Z80Fusion_window[Z80_FUSION_MAX_OPS - 1]; // Keys of the last instructions run in a straight line, newest first
+extern Z0_MACHINE_LOCAL int Z80Fusion_windowLen;
+extern Z0_MACHINE_LOCAL uint16_t Z80Fusion_nextPC; // Where the straight line continues
+extern Z0_MACHINE_LOCAL uint64_t Z80Fusion_profiled; // Instructions seen by the profile
+extern Z0_MACHINE_LOCAL uint64_t Z80Fusion_profileDropped; // Sequences that didn't fit in the profile
+
+/* True when no interrupt can be taken between the ops of a run. Called after the poll before its first op */
+#define Z80FUSION_UNINTERRUPTED() (!Z80Refresh_watching && (!IFF1 || !signals_readSignal(&signal_INT)))
+
+/*
+Runs the ops of pattern 'pattern' (index + 1) through its fused handler, with PC at the first of them and interrupts
+already polled, and sets 'ran' to the T-states taken. It only runs if the engine would have gone on to the last op: no
+interrupt can be taken in between, and the T-states of the ops before it leave some of 'budget'. Otherwise 'ran' is 0 and
+the ops have to be run one at a time. A macro rather than a function, as the call would cost what fusing saves
+*/
+#define Z80FUSION_RUN(pattern, ops, budget, ran) do { \
+    const Z80FusionPattern_t* fusionPattern = &Z80Fusion_patterns[(pattern) - 1]; \
+    uint64_t fusionLead = 0; \
+    for (int fusionOp = 0; fusionOp < fusionPattern->numOps - 1; fusionOp++) \
+        fusionLead += (ops)[fusionOp]->tStates; \
+    (ran) = 0; \
+    if (fusionLead < (budget) && Z80FUSION_UNINTERRUPTED()) { \
+        uint64_t fusionStart = Z80_tStates; \
+        internalState = Z80State_Execute; \
+        fusionPattern->exec(ops); \
+        internalState = Z80State_Fetch; \
+        Z80_instructionsExecuted += fusionPattern->numOps; \
+        Z80Fusion_patternRuns[(pattern) - 1]++; \
+        (ran) = Z80_tStates - fusionStart; \
+    } \
+} while (0)
+
+/********************************************************************
+
+    Z80 Fusion Functions
+
+********************************************************************/
+
+void Z80Fusion_init();
+void Z80Fusion_destroy();
+uint8_t Z80Fusion_match(const Z80MicroOp_t* const* ops, int available);
+void Z80Fusion_markBlock(Z80Block_t* block);
+void Z80Fusion_totals(uint64_t* runs, uint64_t* instructions);
+
+/********************************************************************
+
+    Z80 Fusion Profile Functions
+
+********************************************************************/
+
+uint32_t Z80Fusion_opKey(uint16_t prefix, uint8_t opcode);
+void Z80Fusion_record(uint16_t address);
+void Z80Fusion_count(uint64_t key);
+void Z80Fusion_breakLine();
+void Z80Fusion_logProfile();
+int Z80Fusion_compareCounts(const void* a, const void* b);
+void Z80Fusion_describe(uint64_t key, char* text, size_t textLen);
+
+/********************************************************************
+
+    Z80 Fusion Check Functions
+
+********************************************************************/
+
+bool Z80Fusion_checkOp(const Z80FusionPattern_t* pattern, int index, uint8_t operand0, uint8_t operand1, Z80MicroOp_t* op);
+bool Z80Fusion_selfCheck();
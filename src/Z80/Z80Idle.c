@@ -0,0 +1,206 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Idle.c : Idle loop detector. Finds tight loops that can't change anything before the next slice and skips them to the engine's deadline
+
+*/
+
+#include "Z80Idle.h"
+#include "Z80.h"
+#include "Z80Step.h"
+#include "Z80Execute.h"
+#include "Z80Bus.h"
+#include "Z80Opcodes.h"
+
+#include "../Memory/MemoryController.h"
+#include "../IO/IOController.h"
+
+/* Detector state */
+Z0_MACHINE_LOCAL bool Z80Idle_enabled = true;
+Z0_MACHINE_LOCAL Z80IdleState_t Z80Idle_head = { 0 };
+
+/* Statistics */
+Z0_MACHINE_LOCAL Z80IdleLoop_t Z80Idle_loops[MAX_NUMBER_OF_IDLE_LOOPS];
+Z0_MACHINE_LOCAL uint8_t Z80Idle_nLoops = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Idle_skips = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Idle_iterations = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Idle_tStates = 0;
+
+/********************************************************************
+
+    Z80 Idle Loop Functions
+
+********************************************************************/
+
+/*
+Forgets the last loop head and the loops seen, and switches detection back on
+*/
+void Z80Idle_destroy() {
+    Z80Idle_enabled = true;
+    Z80Idle_head = (Z80IdleState_t){ 0 };
+    Z80Idle_nLoops = 0;
+    Z80Idle_skips = 0;
+    Z80Idle_iterations = 0;
+    Z80Idle_tStates = 0;
+}
+
+/*
+Called by the engines when a backward branch lands on PC, which may be the head of a tight loop. If the CPU was last here
+with the same state, and nothing has been written and R not read since, every iteration will repeat that one exactly: memory is unchanged,
+the interrupt inputs only change between engine slices and the ports not before ioController_nextChange(). The iterations
+that fit before Z80Idle_deadline() are then counted in one go. Returns the T-states skipped
+*/
+uint64_t Z80Idle_loopHead() {
+    if (!Z80Idle_canSkip()) {
+        Z80Idle_capture(&Z80Idle_head);
+        return 0;
+    }
+
+    // DJNZ to itself only changes B, so its count is known without watching it repeat
+    uint64_t skipped = Z80Idle_skipCountedLoop();
+    if (skipped > 0)
+        return skipped;
+
+    Z80IdleState_t now;
+    Z80Idle_capture(&now);
+    uint64_t instructions = now.instructions - Z80Idle_head.instructions;
+    uint64_t tStates = now.tStates - Z80Idle_head.tStates;
+    // A loop that reads R sees it move on every iteration, so it can't be taken to repeat
+    bool repeated = Z80Idle_sameState(&now, &Z80Idle_head) && now.writes == Z80Idle_head.writes
+        && now.refreshReads == Z80Idle_head.refreshReads && instructions > 0 && instructions <= Z80_IDLE_MAX_LOOP_INSTRUCTIONS;
+    uint8_t fetches = (now.r - Z80Idle_head.r) & 0x7F;
+    Z80Idle_head = now;
+
+    if (!repeated)
+        return 0;
+    return Z80Idle_skip((uint32_t)tStates, (uint32_t)instructions, fetches);
+}
+
+/*
+True when nothing can break into a loop before the deadline. Under the machine cycle engine the iterations' cycles
+would reach the bus, so they are only skipped while nothing listens to it
+*/
+bool Z80Idle_canSkip() {
+    return Z80Idle_enabled && !Z80_interruptDue() && !Z80Bus_observed() && Z80_tStates < Z80Idle_deadline();
+}
+
+/*
+The engine's deadline, or sooner if a device that catches up on access may read differently before then
+*/
+uint64_t Z80Idle_deadline() {
+    uint64_t change = ioController_nextChange();
+    return change < Z80_tStateDeadline ? change : Z80_tStateDeadline;
+}
+
+void Z80Idle_capture(Z80IdleState_t* state) {
+    state->pc = PC;
+    state->af = AF;
+    state->bc = BC;
+    state->de = DE;
+    state->hl = HL;
+    state->afPrime = AFPrime;
+    state->bcPrime = BCPrime;
+    state->dePrime = DEPrime;
+    state->hlPrime = HLPrime;
+    state->ix = IX;
+    state->iy = IY;
+    state->sp = SP;
+    state->ivmr = IVMR & 0xFF80;
+    state->iff1 = IFF1;
+    state->iff2 = IFF2;
+    state->halted = halted;
+    state->eiPending = eiPending;
+    state->interruptMode = interruptMode;
+    state->lazy = Z80Flags_lazy;
+    state->r = IVMR & 0x7F;
+    state->tStates = Z80_tStates;
+    state->instructions = Z80_instructionsExecuted;
+    state->writes = Z80_writes;
+    state->refreshReads = Z80_refreshReads;
+    state->deadline = Z80Idle_deadline();
+}
+
+/*
+Compares everything but R and the counters. Flags held differently compare as different, which only costs a missed skip.
+States either side of a deadline never match, as a device may have changed what the loop reads in between
+*/
+bool Z80Idle_sameState(const Z80IdleState_t* a, const Z80IdleState_t* b) {
+    return a->deadline == b->deadline && a->pc == b->pc && a->af == b->af && a->bc == b->bc && a->de == b->de && a->hl == b->hl
+        && a->afPrime == b->afPrime && a->bcPrime == b->bcPrime && a->dePrime == b->dePrime && a->hlPrime == b->hlPrime
+        && a->ix == b->ix && a->iy == b->iy && a->sp == b->sp && a->ivmr == b->ivmr
+        && a->iff1 == b->iff1 && a->iff2 == b->iff2 && a->halted == b->halted && a->eiPending == b->eiPending
+        && a->interruptMode == b->interruptMode && a->lazy.op == b->lazy.op && a->lazy.a == b->lazy.a
+        && a->lazy.b == b->lazy.b && a->lazy.result == b->lazy.result && a->lazy.carry == b->lazy.carry;
+}
+
+/*
+DJNZ $, the usual delay loop. Runs the taken iterations that fit before the deadline, leaving the last, which falls
+through, to the engine
+*/
+uint64_t Z80Idle_skipCountedLoop() {
+    if (memoryController_directRead(PC) != 0x10 || memoryController_directRead(PC + 1) != 0xFE || REG_UPPER(BC) < 2)
+        return 0;
+
+    uint32_t iterationTStates = Z80Opcodes_main[0x10].tStates + TSTATES_BRANCH_JR;
+    uint64_t n = (Z80Idle_deadline() - Z80_tStates) / iterationTStates;
+    if (n > (uint64_t)REG_UPPER(BC) - 1)
+        n = REG_UPPER(BC) - 1;
+    if (n == 0)
+        return 0;
+
+    BC -= (uint16_t)(n << 8);
+    Z80_ADVANCE_R(n);
+    Z80_tStates += n * iterationTStates;
+    Z80_instructionsExecuted += n;
+    Z80Idle_report(PC, n, n * iterationTStates);
+    return n * iterationTStates;
+}
+
+/*
+Counts the iterations of a repeating loop that end before the deadline as if they had run, landing on the loop head
+where the engine would have been
+*/
+uint64_t Z80Idle_skip(uint32_t iterationTStates, uint32_t iterationInstructions, uint8_t iterationFetches) {
+    uint64_t available = Z80Idle_deadline() - Z80_tStates;
+    if (available > Z80_IDLE_MAX_SKIP_TSTATES)
+        available = Z80_IDLE_MAX_SKIP_TSTATES;
+    uint64_t n = available / iterationTStates;
+    if (n == 0)
+        return 0;
+
+    Z80_ADVANCE_R(n * iterationFetches);
+    Z80_tStates += n * iterationTStates;
+    Z80_instructionsExecuted += n * iterationInstructions;
+    Z80Idle_report(PC, n, n * iterationTStates);
+
+    // The next arrival is another iteration of the same loop
+    Z80Idle_capture(&Z80Idle_head);
+    return n * iterationTStates;
+}
+
+void Z80Idle_report(uint16_t pc, uint64_t iterations, uint64_t tStates) {
+    Z80Idle_skips++;
+    Z80Idle_iterations += iterations;
+    Z80Idle_tStates += tStates;
+
+    for (int i = 0; i < Z80Idle_nLoops; i++) {
+        if (Z80Idle_loops[i].pc == pc) {
+            Z80Idle_loops[i].skips++;
+            Z80Idle_loops[i].iterations += iterations;
+            Z80Idle_loops[i].tStates += tStates;
+            return;
+        }
+    }
+    if (Z80Idle_nLoops < MAX_NUMBER_OF_IDLE_LOOPS)
+        Z80Idle_loops[Z80Idle_nLoops++] = (Z80IdleLoop_t){ pc, 1, iterations, tStates };
+}
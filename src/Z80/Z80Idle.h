@@ -0,0 +1,86 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Idle.h : Idle loop detector. Finds tight loops that can't change anything before the next slice and skips them to the engine's deadline
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Z80Flags.h"
+#include "../Z0Machine.h"
+
+/* Tuning */
+#define Z80_IDLE_MAX_LOOP_BYTES 32 // Furthest a backward branch can reach and still be closing a tight loop
+#define Z80_IDLE_MAX_LOOP_INSTRUCTIONS 16 // Longest iteration that counts as a tight loop
+#define Z80_IDLE_MAX_SKIP_TSTATES (1ull << 32) // T-states skipped per detection
+#define MAX_NUMBER_OF_IDLE_LOOPS 16 // Loops reported on their own. Any more are only in the totals
+
+/* True when a branch from the instruction at 'from' to 'to' can be closing a tight loop */
+#define Z80IDLE_IS_LOOP_BRANCH(from, to) ((uint16_t)((from) - (to)) < Z80_IDLE_MAX_LOOP_BYTES)
+
+/* CPU state at a loop head. R is left out, as the opcode fetches change it every iteration, so loops that read it are never skipped */
+typedef struct Z80IdleState {
+    uint16_t pc;
+    uint16_t af, bc, de, hl;
+    uint16_t afPrime, bcPrime, dePrime, hlPrime;
+    uint16_t ix, iy, sp;
+    uint16_t ivmr; // I and bit 7 of R
+    bool iff1, iff2, halted, eiPending;
+    int interruptMode;
+    Z80LazyFlags_t lazy; // A pending flag operation. F is compared as it is held, so building it is not needed
+    uint8_t r; // Low 7 bits of R, to count the iteration's opcode fetches
+    uint64_t tStates;
+    uint64_t instructions;
+    uint64_t writes;
+    uint64_t refreshReads;
+    uint64_t deadline; // Z80Idle_deadline(), which tells apart states a device may have changed between
+} Z80IdleState_t;
+
+/* Per loop report */
+typedef struct Z80IdleLoop {
+    uint16_t pc; // Loop head
+    uint64_t skips; // Times the loop was skipped ahead
+    uint64_t iterations; // Iterations skipped
+    uint64_t tStates; // T-states skipped
+} Z80IdleLoop_t;
+
+/* Detector state */
+extern Z0_MACHINE_LOCAL bool Z80Idle_enabled;
+extern Z0_MACHINE_LOCAL Z80IdleState_t Z80Idle_head; // State when the CPU last arrived at a loop head
+
+/* Statistics */
+extern Z0_MACHINE_LOCAL Z80IdleLoop_t Z80Idle_loops[MAX_NUMBER_OF_IDLE_LOOPS];
+extern Z0_MACHINE_LOCAL uint8_t Z80Idle_nLoops;
+extern Z0_MACHINE_LOCAL uint64_t Z80Idle_skips;
+extern Z0_MACHINE_LOCAL uint64_t Z80Idle_iterations;
+extern Z0_MACHINE_LOCAL uint64_t Z80Idle_tStates;
+
+/********************************************************************
+
+    Z80 Idle Loop Functions
+
+********************************************************************/
+
+void Z80Idle_destroy();
+uint64_t Z80Idle_loopHead();
+bool Z80Idle_canSkip();
+uint64_t Z80Idle_deadline();
+void Z80Idle_capture(Z80IdleState_t* state);
+bool Z80Idle_sameState(const Z80IdleState_t* a, const Z80IdleState_t* b);
+uint64_t Z80Idle_skipCountedLoop();
+uint64_t Z80Idle_skip(uint32_t iterationTStates, uint32_t iterationInstructions, uint8_t iterationFetches);
+void Z80Idle_report(uint16_t pc, uint64_t iterations, uint64_t tStates);
@@ -47,6 +47,8 @@ typedef struct Z80_Instr {
     uint8_t numOperands; // Number of operands the instruction has after the opcode
     uint8_t numOperandsToRead; // Number of operands left to be read
     uint8_t instrByteLen;
+    uint32_t tStates; // T-states the instruction takes. Conditional instructions add to this when executed, bulk block instructions a whole run
+    uint8_t ignoredPrefixes; // DD / FD prefixes that were overridden by a following prefix, 4 T-states each
     const int (*execFunction)();
     bool detectedPrefix;
 } Z80_Instr_t;
@@ -59,30 +61,4 @@ extern const Z80_Instr_t instructions_NULLInstr;
 #define INSTR_EXEC_SUCCESS 0
 #define INSTR_EXEC_CONT 1
 
-/* Instruction pointer tables */
-int instructions_NInstr();
-extern const int (*instructions_mainInstructionFuncs[0x100])(); // There are 256 opcodes in the primary table
-extern const int (*instructions_extendedInstructionFuncs[0x100])(); // PREFIX 0xED
-extern const int (*instructions_bitInstructionFuncs[0x100])(); // PREFIX 0xCB
-extern const int (*instructions_IXInstructionFuncs[0x100])(); // PREFIX 0xDD
-extern const int (*instructions_IXBitInstructionFuncs[0x100])(); // PREFIX 0xDDCB
-extern const int (*instructions_IYInstructionFuncs[0x100])(); // PREFIX 0xFD
-extern const int (*instructions_IYBitInstructionFuncs[0x100])(); // PREFIX 0xFDCB
-
-/* Human-readable strings for the opcodes table */
-extern const char* instructions_mainInstructionText[0x100]; // There are 256 opcodes in the primary table
-extern const char* instructions_extendedInstructionText[0x100]; // PREFIX 0xED
-extern const char* instructions_bitInstructionText[0x100]; // PREFIX 0xCB
-extern const char* instructions_IXInstructionText[0x100]; // PREFIX 0xDD
-extern const char* instructions_IXBitInstructionText[0x100]; // PREFIX 0xDDCB
-extern const char* instructions_IYInstructionText[0x100]; // PREFIX 0xFD
-extern const char* instructions_IYBitInstructionText[0x100]; // PREFIX 0xFDCB
-
-/* Instruction length and operand number information. The table contains the length of the instruction in bytes. If > 1, num operands = (length in bytes - 1). If == -1, marks a prefix */
-extern const char instructions_mainInstructionParams[0x100]; // There are 256 opcodes in the primary table
-extern const char instructions_extendedInstructionParams[0x100]; // PREFIX 0xED
-extern const char instructions_bitInstructionParams[0x100]; // PREFIX 0xCB
-extern const char instructions_IXInstructionParams[0x100]; // PREFIX 0xDD
-extern const char instructions_IXBitInstructionParams[0x100]; // PREFIX 0xDDCB
-extern const char instructions_IYInstructionParams[0x100]; // PREFIX 0xFD
-extern const char instructions_IYBitInstructionParams[0x100]; // PREFIX 0xFDCB
\ No newline at end of file
+/* Mnemonics, lengths, timings and handlers for every opcode are in the packed tables of Z80Opcodes.h */
@@ -1,1579 +0,0 @@
-/*
-
- _____   ____         ______ ____
-/__  /  / __ \ _  __ / ____// __ \
-  / /  / / / /| |/_//___ \ / / / /
- / /__/ /_/ /_>  < ____/ // /_/ /
-/____/\____//_/|_|/_____/ \____/
-
-Zilog 80 Emulator
-
-Basic interface to the Z80 processor and associated modules.
-Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
-
-Z80Instructions.c : Instructions that the Z80 CPU can perform
-
-*/
-
-#include "Z80Instructions.h"
-#include "../SysIO/Log.h"
-
-int instructions_NInstr() {
-    // Throw an error
-    formattedLog(stdlog, LOGTYPE_ERROR, "Instruction: Not configured! Std instructions_NInstr() executed. Failed instruction execution\n");
-    return INSTR_EXEC_NOTIMPL; // We return INSTRUCTION_EXEC_NOTIMPL in the instruction so the CPU knows it failed
-}
-
-const int (*instructions_IYBitInstructionFuncs[0x100])() = {
-    /* 00 */&instructions_NInstr,
-    /* 01 */&instructions_NInstr,
-    /* 02 */&instructions_NInstr,
-    /* 03 */&instructions_NInstr,
-    /* 04 */&instructions_NInstr,
-    /* 05 */&instructions_NInstr,
-    /* 06 */&instructions_NInstr,
-    /* 07 */&instructions_NInstr,
-    /* 08 */&instructions_NInstr,
-    /* 09 */&instructions_NInstr,
-    /* 0A */&instructions_NInstr,
-    /* 0B */&instructions_NInstr,
-    /* 0C */&instructions_NInstr,
-    /* 0D */&instructions_NInstr,
-    /* 0E */&instructions_NInstr,
-    /* 0F */&instructions_NInstr,
-    /* 10 */&instructions_NInstr,
-    /* 11 */&instructions_NInstr,
-    /* 12 */&instructions_NInstr,
-    /* 13 */&instructions_NInstr,
-    /* 14 */&instructions_NInstr,
-    /* 15 */&instructions_NInstr,
-    /* 16 */&instructions_NInstr,
-    /* 17 */&instructions_NInstr,
-    /* 18 */&instructions_NInstr,
-    /* 19 */&instructions_NInstr,
-    /* 1A */&instructions_NInstr,
-    /* 1B */&instructions_NInstr,
-    /* 1C */&instructions_NInstr,
-    /* 1D */&instructions_NInstr,
-    /* 1E */&instructions_NInstr,
-    /* 1F */&instructions_NInstr,
-    /* 20 */&instructions_NInstr,
-    /* 21 */&instructions_NInstr,
-    /* 22 */&instructions_NInstr,
-    /* 23 */&instructions_NInstr,
-    /* 24 */&instructions_NInstr,
-    /* 25 */&instructions_NInstr,
-    /* 26 */&instructions_NInstr,
-    /* 27 */&instructions_NInstr,
-    /* 28 */&instructions_NInstr,
-    /* 29 */&instructions_NInstr,
-    /* 2A */&instructions_NInstr,
-    /* 2B */&instructions_NInstr,
-    /* 2C */&instructions_NInstr,
-    /* 2D */&instructions_NInstr,
-    /* 2E */&instructions_NInstr,
-    /* 2F */&instructions_NInstr,
-    /* 30 */&instructions_NInstr,
-    /* 31 */&instructions_NInstr,
-    /* 32 */&instructions_NInstr,
-    /* 33 */&instructions_NInstr,
-    /* 34 */&instructions_NInstr,
-    /* 35 */&instructions_NInstr,
-    /* 36 */&instructions_NInstr,
-    /* 37 */&instructions_NInstr,
-    /* 38 */&instructions_NInstr,
-    /* 39 */&instructions_NInstr,
-    /* 3A */&instructions_NInstr,
-    /* 3B */&instructions_NInstr,
-    /* 3C */&instructions_NInstr,
-    /* 3D */&instructions_NInstr,
-    /* 3E */&instructions_NInstr,
-    /* 3F */&instructions_NInstr,
-    /* 40 */&instructions_NInstr,
-    /* 41 */&instructions_NInstr,
-    /* 42 */&instructions_NInstr,
-    /* 43 */&instructions_NInstr,
-    /* 44 */&instructions_NInstr,
-    /* 45 */&instructions_NInstr,
-    /* 46 */&instructions_NInstr,
-    /* 47 */&instructions_NInstr,
-    /* 48 */&instructions_NInstr,
-    /* 49 */&instructions_NInstr,
-    /* 4A */&instructions_NInstr,
-    /* 4B */&instructions_NInstr,
-    /* 4C */&instructions_NInstr,
-    /* 4D */&instructions_NInstr,
-    /* 4E */&instructions_NInstr,
-    /* 4F */&instructions_NInstr,
-    /* 50 */&instructions_NInstr,
-    /* 51 */&instructions_NInstr,
-    /* 52 */&instructions_NInstr,
-    /* 53 */&instructions_NInstr,
-    /* 54 */&instructions_NInstr,
-    /* 55 */&instructions_NInstr,
-    /* 56 */&instructions_NInstr,
-    /* 57 */&instructions_NInstr,
-    /* 58 */&instructions_NInstr,
-    /* 59 */&instructions_NInstr,
-    /* 5A */&instructions_NInstr,
-    /* 5B */&instructions_NInstr,
-    /* 5C */&instructions_NInstr,
-    /* 5D */&instructions_NInstr,
-    /* 5E */&instructions_NInstr,
-    /* 5F */&instructions_NInstr,
-    /* 60 */&instructions_NInstr,
-    /* 61 */&instructions_NInstr,
-    /* 62 */&instructions_NInstr,
-    /* 63 */&instructions_NInstr,
-    /* 64 */&instructions_NInstr,
-    /* 65 */&instructions_NInstr,
-    /* 66 */&instructions_NInstr,
-    /* 67 */&instructions_NInstr,
-    /* 68 */&instructions_NInstr,
-    /* 69 */&instructions_NInstr,
-    /* 6A */&instructions_NInstr,
-    /* 6B */&instructions_NInstr,
-    /* 6C */&instructions_NInstr,
-    /* 6D */&instructions_NInstr,
-    /* 6E */&instructions_NInstr,
-    /* 6F */&instructions_NInstr,
-    /* 70 */&instructions_NInstr,
-    /* 71 */&instructions_NInstr,
-    /* 72 */&instructions_NInstr,
-    /* 73 */&instructions_NInstr,
-    /* 74 */&instructions_NInstr,
-    /* 75 */&instructions_NInstr,
-    /* 76 */&instructions_NInstr,
-    /* 77 */&instructions_NInstr,
-    /* 78 */&instructions_NInstr,
-    /* 79 */&instructions_NInstr,
-    /* 7A */&instructions_NInstr,
-    /* 7B */&instructions_NInstr,
-    /* 7C */&instructions_NInstr,
-    /* 7D */&instructions_NInstr,
-    /* 7E */&instructions_NInstr,
-    /* 7F */&instructions_NInstr,
-    /* 80 */&instructions_NInstr,
-    /* 81 */&instructions_NInstr,
-    /* 82 */&instructions_NInstr,
-    /* 83 */&instructions_NInstr,
-    /* 84 */&instructions_NInstr,
-    /* 85 */&instructions_NInstr,
-    /* 86 */&instructions_NInstr,
-    /* 87 */&instructions_NInstr,
-    /* 88 */&instructions_NInstr,
-    /* 89 */&instructions_NInstr,
-    /* 8A */&instructions_NInstr,
-    /* 8B */&instructions_NInstr,
-    /* 8C */&instructions_NInstr,
-    /* 8D */&instructions_NInstr,
-    /* 8E */&instructions_NInstr,
-    /* 8F */&instructions_NInstr,
-    /* 90 */&instructions_NInstr,
-    /* 91 */&instructions_NInstr,
-    /* 92 */&instructions_NInstr,
-    /* 93 */&instructions_NInstr,
-    /* 94 */&instructions_NInstr,
-    /* 95 */&instructions_NInstr,
-    /* 96 */&instructions_NInstr,
-    /* 97 */&instructions_NInstr,
-    /* 98 */&instructions_NInstr,
-    /* 99 */&instructions_NInstr,
-    /* 9A */&instructions_NInstr,
-    /* 9B */&instructions_NInstr,
-    /* 9C */&instructions_NInstr,
-    /* 9D */&instructions_NInstr,
-    /* 9E */&instructions_NInstr,
-    /* 9F */&instructions_NInstr,
-    /* A0 */&instructions_NInstr,
-    /* A1 */&instructions_NInstr,
-    /* A2 */&instructions_NInstr,
-    /* A3 */&instructions_NInstr,
-    /* A4 */&instructions_NInstr,
-    /* A5 */&instructions_NInstr,
-    /* A6 */&instructions_NInstr,
-    /* A7 */&instructions_NInstr,
-    /* A8 */&instructions_NInstr,
-    /* A9 */&instructions_NInstr,
-    /* AA */&instructions_NInstr,
-    /* AB */&instructions_NInstr,
-    /* AC */&instructions_NInstr,
-    /* AD */&instructions_NInstr,
-    /* AE */&instructions_NInstr,
-    /* AF */&instructions_NInstr,
-    /* B0 */&instructions_NInstr,
-    /* B1 */&instructions_NInstr,
-    /* B2 */&instructions_NInstr,
-    /* B3 */&instructions_NInstr,
-    /* B4 */&instructions_NInstr,
-    /* B5 */&instructions_NInstr,
-    /* B6 */&instructions_NInstr,
-    /* B7 */&instructions_NInstr,
-    /* B8 */&instructions_NInstr,
-    /* B9 */&instructions_NInstr,
-    /* BA */&instructions_NInstr,
-    /* BB */&instructions_NInstr,
-    /* BC */&instructions_NInstr,
-    /* BD */&instructions_NInstr,
-    /* BE */&instructions_NInstr,
-    /* BF */&instructions_NInstr,
-    /* C0 */&instructions_NInstr,
-    /* C1 */&instructions_NInstr,
-    /* C2 */&instructions_NInstr,
-    /* C3 */&instructions_NInstr,
-    /* C4 */&instructions_NInstr,
-    /* C5 */&instructions_NInstr,
-    /* C6 */&instructions_NInstr,
-    /* C7 */&instructions_NInstr,
-    /* C8 */&instructions_NInstr,
-    /* C9 */&instructions_NInstr,
-    /* CA */&instructions_NInstr,
-    /* CB */&instructions_NInstr,
-    /* CC */&instructions_NInstr,
-    /* CD */&instructions_NInstr,
-    /* CE */&instructions_NInstr,
-    /* CF */&instructions_NInstr,
-    /* D0 */&instructions_NInstr,
-    /* D1 */&instructions_NInstr,
-    /* D2 */&instructions_NInstr,
-    /* D3 */&instructions_NInstr,
-    /* D4 */&instructions_NInstr,
-    /* D5 */&instructions_NInstr,
-    /* D6 */&instructions_NInstr,
-    /* D7 */&instructions_NInstr,
-    /* D8 */&instructions_NInstr,
-    /* D9 */&instructions_NInstr,
-    /* DA */&instructions_NInstr,
-    /* DB */&instructions_NInstr,
-    /* DC */&instructions_NInstr,
-    /* DD */&instructions_NInstr,
-    /* DE */&instructions_NInstr,
-    /* DF */&instructions_NInstr,
-    /* E0 */&instructions_NInstr,
-    /* E1 */&instructions_NInstr,
-    /* E2 */&instructions_NInstr,
-    /* E3 */&instructions_NInstr,
-    /* E4 */&instructions_NInstr,
-    /* E5 */&instructions_NInstr,
-    /* E6 */&instructions_NInstr,
-    /* E7 */&instructions_NInstr,
-    /* E8 */&instructions_NInstr,
-    /* E9 */&instructions_NInstr,
-    /* EA */&instructions_NInstr,
-    /* EB */&instructions_NInstr,
-    /* EC */&instructions_NInstr,
-    /* ED */&instructions_NInstr,
-    /* EE */&instructions_NInstr,
-    /* EF */&instructions_NInstr,
-    /* F0 */&instructions_NInstr,
-    /* F1 */&instructions_NInstr,
-    /* F2 */&instructions_NInstr,
-    /* F3 */&instructions_NInstr,
-    /* F4 */&instructions_NInstr,
-    /* F5 */&instructions_NInstr,
-    /* F6 */&instructions_NInstr,
-    /* F7 */&instructions_NInstr,
-    /* F8 */&instructions_NInstr,
-    /* F9 */&instructions_NInstr,
-    /* FA */&instructions_NInstr,
-    /* FB */&instructions_NInstr,
-    /* FC */&instructions_NInstr,
-    /* FD */&instructions_NInstr,
-    /* FE */&instructions_NInstr,
-    /* FF */&instructions_NInstr
-};
-
-const int (*instructions_IYInstructionFuncs[0x100])() = {
-    /* 00 */&instructions_NInstr,
-    /* 01 */&instructions_NInstr,
-    /* 02 */&instructions_NInstr,
-    /* 03 */&instructions_NInstr,
-    /* 04 */&instructions_NInstr,
-    /* 05 */&instructions_NInstr,
-    /* 06 */&instructions_NInstr,
-    /* 07 */&instructions_NInstr,
-    /* 08 */&instructions_NInstr,
-    /* 09 */&instructions_NInstr,
-    /* 0A */&instructions_NInstr,
-    /* 0B */&instructions_NInstr,
-    /* 0C */&instructions_NInstr,
-    /* 0D */&instructions_NInstr,
-    /* 0E */&instructions_NInstr,
-    /* 0F */&instructions_NInstr,
-    /* 10 */&instructions_NInstr,
-    /* 11 */&instructions_NInstr,
-    /* 12 */&instructions_NInstr,
-    /* 13 */&instructions_NInstr,
-    /* 14 */&instructions_NInstr,
-    /* 15 */&instructions_NInstr,
-    /* 16 */&instructions_NInstr,
-    /* 17 */&instructions_NInstr,
-    /* 18 */&instructions_NInstr,
-    /* 19 */&instructions_NInstr,
-    /* 1A */&instructions_NInstr,
-    /* 1B */&instructions_NInstr,
-    /* 1C */&instructions_NInstr,
-    /* 1D */&instructions_NInstr,
-    /* 1E */&instructions_NInstr,
-    /* 1F */&instructions_NInstr,
-    /* 20 */&instructions_NInstr,
-    /* 21 */&instructions_NInstr,
-    /* 22 */&instructions_NInstr,
-    /* 23 */&instructions_NInstr,
-    /* 24 */&instructions_NInstr,
-    /* 25 */&instructions_NInstr,
-    /* 26 */&instructions_NInstr,
-    /* 27 */&instructions_NInstr,
-    /* 28 */&instructions_NInstr,
-    /* 29 */&instructions_NInstr,
-    /* 2A */&instructions_NInstr,
-    /* 2B */&instructions_NInstr,
-    /* 2C */&instructions_NInstr,
-    /* 2D */&instructions_NInstr,
-    /* 2E */&instructions_NInstr,
-    /* 2F */&instructions_NInstr,
-    /* 30 */&instructions_NInstr,
-    /* 31 */&instructions_NInstr,
-    /* 32 */&instructions_NInstr,
-    /* 33 */&instructions_NInstr,
-    /* 34 */&instructions_NInstr,
-    /* 35 */&instructions_NInstr,
-    /* 36 */&instructions_NInstr,
-    /* 37 */&instructions_NInstr,
-    /* 38 */&instructions_NInstr,
-    /* 39 */&instructions_NInstr,
-    /* 3A */&instructions_NInstr,
-    /* 3B */&instructions_NInstr,
-    /* 3C */&instructions_NInstr,
-    /* 3D */&instructions_NInstr,
-    /* 3E */&instructions_NInstr,
-    /* 3F */&instructions_NInstr,
-    /* 40 */&instructions_NInstr,
-    /* 41 */&instructions_NInstr,
-    /* 42 */&instructions_NInstr,
-    /* 43 */&instructions_NInstr,
-    /* 44 */&instructions_NInstr,
-    /* 45 */&instructions_NInstr,
-    /* 46 */&instructions_NInstr,
-    /* 47 */&instructions_NInstr,
-    /* 48 */&instructions_NInstr,
-    /* 49 */&instructions_NInstr,
-    /* 4A */&instructions_NInstr,
-    /* 4B */&instructions_NInstr,
-    /* 4C */&instructions_NInstr,
-    /* 4D */&instructions_NInstr,
-    /* 4E */&instructions_NInstr,
-    /* 4F */&instructions_NInstr,
-    /* 50 */&instructions_NInstr,
-    /* 51 */&instructions_NInstr,
-    /* 52 */&instructions_NInstr,
-    /* 53 */&instructions_NInstr,
-    /* 54 */&instructions_NInstr,
-    /* 55 */&instructions_NInstr,
-    /* 56 */&instructions_NInstr,
-    /* 57 */&instructions_NInstr,
-    /* 58 */&instructions_NInstr,
-    /* 59 */&instructions_NInstr,
-    /* 5A */&instructions_NInstr,
-    /* 5B */&instructions_NInstr,
-    /* 5C */&instructions_NInstr,
-    /* 5D */&instructions_NInstr,
-    /* 5E */&instructions_NInstr,
-    /* 5F */&instructions_NInstr,
-    /* 60 */&instructions_NInstr,
-    /* 61 */&instructions_NInstr,
-    /* 62 */&instructions_NInstr,
-    /* 63 */&instructions_NInstr,
-    /* 64 */&instructions_NInstr,
-    /* 65 */&instructions_NInstr,
-    /* 66 */&instructions_NInstr,
-    /* 67 */&instructions_NInstr,
-    /* 68 */&instructions_NInstr,
-    /* 69 */&instructions_NInstr,
-    /* 6A */&instructions_NInstr,
-    /* 6B */&instructions_NInstr,
-    /* 6C */&instructions_NInstr,
-    /* 6D */&instructions_NInstr,
-    /* 6E */&instructions_NInstr,
-    /* 6F */&instructions_NInstr,
-    /* 70 */&instructions_NInstr,
-    /* 71 */&instructions_NInstr,
-    /* 72 */&instructions_NInstr,
-    /* 73 */&instructions_NInstr,
-    /* 74 */&instructions_NInstr,
-    /* 75 */&instructions_NInstr,
-    /* 76 */&instructions_NInstr,
-    /* 77 */&instructions_NInstr,
-    /* 78 */&instructions_NInstr,
-    /* 79 */&instructions_NInstr,
-    /* 7A */&instructions_NInstr,
-    /* 7B */&instructions_NInstr,
-    /* 7C */&instructions_NInstr,
-    /* 7D */&instructions_NInstr,
-    /* 7E */&instructions_NInstr,
-    /* 7F */&instructions_NInstr,
-    /* 80 */&instructions_NInstr,
-    /* 81 */&instructions_NInstr,
-    /* 82 */&instructions_NInstr,
-    /* 83 */&instructions_NInstr,
-    /* 84 */&instructions_NInstr,
-    /* 85 */&instructions_NInstr,
-    /* 86 */&instructions_NInstr,
-    /* 87 */&instructions_NInstr,
-    /* 88 */&instructions_NInstr,
-    /* 89 */&instructions_NInstr,
-    /* 8A */&instructions_NInstr,
-    /* 8B */&instructions_NInstr,
-    /* 8C */&instructions_NInstr,
-    /* 8D */&instructions_NInstr,
-    /* 8E */&instructions_NInstr,
-    /* 8F */&instructions_NInstr,
-    /* 90 */&instructions_NInstr,
-    /* 91 */&instructions_NInstr,
-    /* 92 */&instructions_NInstr,
-    /* 93 */&instructions_NInstr,
-    /* 94 */&instructions_NInstr,
-    /* 95 */&instructions_NInstr,
-    /* 96 */&instructions_NInstr,
-    /* 97 */&instructions_NInstr,
-    /* 98 */&instructions_NInstr,
-    /* 99 */&instructions_NInstr,
-    /* 9A */&instructions_NInstr,
-    /* 9B */&instructions_NInstr,
-    /* 9C */&instructions_NInstr,
-    /* 9D */&instructions_NInstr,
-    /* 9E */&instructions_NInstr,
-    /* 9F */&instructions_NInstr,
-    /* A0 */&instructions_NInstr,
-    /* A1 */&instructions_NInstr,
-    /* A2 */&instructions_NInstr,
-    /* A3 */&instructions_NInstr,
-    /* A4 */&instructions_NInstr,
-    /* A5 */&instructions_NInstr,
-    /* A6 */&instructions_NInstr,
-    /* A7 */&instructions_NInstr,
-    /* A8 */&instructions_NInstr,
-    /* A9 */&instructions_NInstr,
-    /* AA */&instructions_NInstr,
-    /* AB */&instructions_NInstr,
-    /* AC */&instructions_NInstr,
-    /* AD */&instructions_NInstr,
-    /* AE */&instructions_NInstr,
-    /* AF */&instructions_NInstr,
-    /* B0 */&instructions_NInstr,
-    /* B1 */&instructions_NInstr,
-    /* B2 */&instructions_NInstr,
-    /* B3 */&instructions_NInstr,
-    /* B4 */&instructions_NInstr,
-    /* B5 */&instructions_NInstr,
-    /* B6 */&instructions_NInstr,
-    /* B7 */&instructions_NInstr,
-    /* B8 */&instructions_NInstr,
-    /* B9 */&instructions_NInstr,
-    /* BA */&instructions_NInstr,
-    /* BB */&instructions_NInstr,
-    /* BC */&instructions_NInstr,
-    /* BD */&instructions_NInstr,
-    /* BE */&instructions_NInstr,
-    /* BF */&instructions_NInstr,
-    /* C0 */&instructions_NInstr,
-    /* C1 */&instructions_NInstr,
-    /* C2 */&instructions_NInstr,
-    /* C3 */&instructions_NInstr,
-    /* C4 */&instructions_NInstr,
-    /* C5 */&instructions_NInstr,
-    /* C6 */&instructions_NInstr,
-    /* C7 */&instructions_NInstr,
-    /* C8 */&instructions_NInstr,
-    /* C9 */&instructions_NInstr,
-    /* CA */&instructions_NInstr,
-    /* CB */&instructions_NInstr,
-    /* CC */&instructions_NInstr,
-    /* CD */&instructions_NInstr,
-    /* CE */&instructions_NInstr,
-    /* CF */&instructions_NInstr,
-    /* D0 */&instructions_NInstr,
-    /* D1 */&instructions_NInstr,
-    /* D2 */&instructions_NInstr,
-    /* D3 */&instructions_NInstr,
-    /* D4 */&instructions_NInstr,
-    /* D5 */&instructions_NInstr,
-    /* D6 */&instructions_NInstr,
-    /* D7 */&instructions_NInstr,
-    /* D8 */&instructions_NInstr,
-    /* D9 */&instructions_NInstr,
-    /* DA */&instructions_NInstr,
-    /* DB */&instructions_NInstr,
-    /* DC */&instructions_NInstr,
-    /* DD */&instructions_NInstr,
-    /* DE */&instructions_NInstr,
-    /* DF */&instructions_NInstr,
-    /* E0 */&instructions_NInstr,
-    /* E1 */&instructions_NInstr,
-    /* E2 */&instructions_NInstr,
-    /* E3 */&instructions_NInstr,
-    /* E4 */&instructions_NInstr,
-    /* E5 */&instructions_NInstr,
-    /* E6 */&instructions_NInstr,
-    /* E7 */&instructions_NInstr,
-    /* E8 */&instructions_NInstr,
-    /* E9 */&instructions_NInstr,
-    /* EA */&instructions_NInstr,
-    /* EB */&instructions_NInstr,
-    /* EC */&instructions_NInstr,
-    /* ED */&instructions_NInstr,
-    /* EE */&instructions_NInstr,
-    /* EF */&instructions_NInstr,
-    /* F0 */&instructions_NInstr,
-    /* F1 */&instructions_NInstr,
-    /* F2 */&instructions_NInstr,
-    /* F3 */&instructions_NInstr,
-    /* F4 */&instructions_NInstr,
-    /* F5 */&instructions_NInstr,
-    /* F6 */&instructions_NInstr,
-    /* F7 */&instructions_NInstr,
-    /* F8 */&instructions_NInstr,
-    /* F9 */&instructions_NInstr,
-    /* FA */&instructions_NInstr,
-    /* FB */&instructions_NInstr,
-    /* FC */&instructions_NInstr,
-    /* FD */&instructions_NInstr,
-    /* FE */&instructions_NInstr,
-    /* FF */&instructions_NInstr
-};
-
-const int (*instructions_IXInstructionFuncs[0x100])() = {
-    /* 00 */&instructions_NInstr,
-    /* 01 */&instructions_NInstr,
-    /* 02 */&instructions_NInstr,
-    /* 03 */&instructions_NInstr,
-    /* 04 */&instructions_NInstr,
-    /* 05 */&instructions_NInstr,
-    /* 06 */&instructions_NInstr,
-    /* 07 */&instructions_NInstr,
-    /* 08 */&instructions_NInstr,
-    /* 09 */&instructions_NInstr,
-    /* 0A */&instructions_NInstr,
-    /* 0B */&instructions_NInstr,
-    /* 0C */&instructions_NInstr,
-    /* 0D */&instructions_NInstr,
-    /* 0E */&instructions_NInstr,
-    /* 0F */&instructions_NInstr,
-    /* 10 */&instructions_NInstr,
-    /* 11 */&instructions_NInstr,
-    /* 12 */&instructions_NInstr,
-    /* 13 */&instructions_NInstr,
-    /* 14 */&instructions_NInstr,
-    /* 15 */&instructions_NInstr,
-    /* 16 */&instructions_NInstr,
-    /* 17 */&instructions_NInstr,
-    /* 18 */&instructions_NInstr,
-    /* 19 */&instructions_NInstr,
-    /* 1A */&instructions_NInstr,
-    /* 1B */&instructions_NInstr,
-    /* 1C */&instructions_NInstr,
-    /* 1D */&instructions_NInstr,
-    /* 1E */&instructions_NInstr,
-    /* 1F */&instructions_NInstr,
-    /* 20 */&instructions_NInstr,
-    /* 21 */&instructions_NInstr,
-    /* 22 */&instructions_NInstr,
-    /* 23 */&instructions_NInstr,
-    /* 24 */&instructions_NInstr,
-    /* 25 */&instructions_NInstr,
-    /* 26 */&instructions_NInstr,
-    /* 27 */&instructions_NInstr,
-    /* 28 */&instructions_NInstr,
-    /* 29 */&instructions_NInstr,
-    /* 2A */&instructions_NInstr,
-    /* 2B */&instructions_NInstr,
-    /* 2C */&instructions_NInstr,
-    /* 2D */&instructions_NInstr,
-    /* 2E */&instructions_NInstr,
-    /* 2F */&instructions_NInstr,
-    /* 30 */&instructions_NInstr,
-    /* 31 */&instructions_NInstr,
-    /* 32 */&instructions_NInstr,
-    /* 33 */&instructions_NInstr,
-    /* 34 */&instructions_NInstr,
-    /* 35 */&instructions_NInstr,
-    /* 36 */&instructions_NInstr,
-    /* 37 */&instructions_NInstr,
-    /* 38 */&instructions_NInstr,
-    /* 39 */&instructions_NInstr,
-    /* 3A */&instructions_NInstr,
-    /* 3B */&instructions_NInstr,
-    /* 3C */&instructions_NInstr,
-    /* 3D */&instructions_NInstr,
-    /* 3E */&instructions_NInstr,
-    /* 3F */&instructions_NInstr,
-    /* 40 */&instructions_NInstr,
-    /* 41 */&instructions_NInstr,
-    /* 42 */&instructions_NInstr,
-    /* 43 */&instructions_NInstr,
-    /* 44 */&instructions_NInstr,
-    /* 45 */&instructions_NInstr,
-    /* 46 */&instructions_NInstr,
-    /* 47 */&instructions_NInstr,
-    /* 48 */&instructions_NInstr,
-    /* 49 */&instructions_NInstr,
-    /* 4A */&instructions_NInstr,
-    /* 4B */&instructions_NInstr,
-    /* 4C */&instructions_NInstr,
-    /* 4D */&instructions_NInstr,
-    /* 4E */&instructions_NInstr,
-    /* 4F */&instructions_NInstr,
-    /* 50 */&instructions_NInstr,
-    /* 51 */&instructions_NInstr,
-    /* 52 */&instructions_NInstr,
-    /* 53 */&instructions_NInstr,
-    /* 54 */&instructions_NInstr,
-    /* 55 */&instructions_NInstr,
-    /* 56 */&instructions_NInstr,
-    /* 57 */&instructions_NInstr,
-    /* 58 */&instructions_NInstr,
-    /* 59 */&instructions_NInstr,
-    /* 5A */&instructions_NInstr,
-    /* 5B */&instructions_NInstr,
-    /* 5C */&instructions_NInstr,
-    /* 5D */&instructions_NInstr,
-    /* 5E */&instructions_NInstr,
-    /* 5F */&instructions_NInstr,
-    /* 60 */&instructions_NInstr,
-    /* 61 */&instructions_NInstr,
-    /* 62 */&instructions_NInstr,
-    /* 63 */&instructions_NInstr,
-    /* 64 */&instructions_NInstr,
-    /* 65 */&instructions_NInstr,
-    /* 66 */&instructions_NInstr,
-    /* 67 */&instructions_NInstr,
-    /* 68 */&instructions_NInstr,
-    /* 69 */&instructions_NInstr,
-    /* 6A */&instructions_NInstr,
-    /* 6B */&instructions_NInstr,
-    /* 6C */&instructions_NInstr,
-    /* 6D */&instructions_NInstr,
-    /* 6E */&instructions_NInstr,
-    /* 6F */&instructions_NInstr,
-    /* 70 */&instructions_NInstr,
-    /* 71 */&instructions_NInstr,
-    /* 72 */&instructions_NInstr,
-    /* 73 */&instructions_NInstr,
-    /* 74 */&instructions_NInstr,
-    /* 75 */&instructions_NInstr,
-    /* 76 */&instructions_NInstr,
-    /* 77 */&instructions_NInstr,
-    /* 78 */&instructions_NInstr,
-    /* 79 */&instructions_NInstr,
-    /* 7A */&instructions_NInstr,
-    /* 7B */&instructions_NInstr,
-    /* 7C */&instructions_NInstr,
-    /* 7D */&instructions_NInstr,
-    /* 7E */&instructions_NInstr,
-    /* 7F */&instructions_NInstr,
-    /* 80 */&instructions_NInstr,
-    /* 81 */&instructions_NInstr,
-    /* 82 */&instructions_NInstr,
-    /* 83 */&instructions_NInstr,
-    /* 84 */&instructions_NInstr,
-    /* 85 */&instructions_NInstr,
-    /* 86 */&instructions_NInstr,
-    /* 87 */&instructions_NInstr,
-    /* 88 */&instructions_NInstr,
-    /* 89 */&instructions_NInstr,
-    /* 8A */&instructions_NInstr,
-    /* 8B */&instructions_NInstr,
-    /* 8C */&instructions_NInstr,
-    /* 8D */&instructions_NInstr,
-    /* 8E */&instructions_NInstr,
-    /* 8F */&instructions_NInstr,
-    /* 90 */&instructions_NInstr,
-    /* 91 */&instructions_NInstr,
-    /* 92 */&instructions_NInstr,
-    /* 93 */&instructions_NInstr,
-    /* 94 */&instructions_NInstr,
-    /* 95 */&instructions_NInstr,
-    /* 96 */&instructions_NInstr,
-    /* 97 */&instructions_NInstr,
-    /* 98 */&instructions_NInstr,
-    /* 99 */&instructions_NInstr,
-    /* 9A */&instructions_NInstr,
-    /* 9B */&instructions_NInstr,
-    /* 9C */&instructions_NInstr,
-    /* 9D */&instructions_NInstr,
-    /* 9E */&instructions_NInstr,
-    /* 9F */&instructions_NInstr,
-    /* A0 */&instructions_NInstr,
-    /* A1 */&instructions_NInstr,
-    /* A2 */&instructions_NInstr,
-    /* A3 */&instructions_NInstr,
-    /* A4 */&instructions_NInstr,
-    /* A5 */&instructions_NInstr,
-    /* A6 */&instructions_NInstr,
-    /* A7 */&instructions_NInstr,
-    /* A8 */&instructions_NInstr,
-    /* A9 */&instructions_NInstr,
-    /* AA */&instructions_NInstr,
-    /* AB */&instructions_NInstr,
-    /* AC */&instructions_NInstr,
-    /* AD */&instructions_NInstr,
-    /* AE */&instructions_NInstr,
-    /* AF */&instructions_NInstr,
-    /* B0 */&instructions_NInstr,
-    /* B1 */&instructions_NInstr,
-    /* B2 */&instructions_NInstr,
-    /* B3 */&instructions_NInstr,
-    /* B4 */&instructions_NInstr,
-    /* B5 */&instructions_NInstr,
-    /* B6 */&instructions_NInstr,
-    /* B7 */&instructions_NInstr,
-    /* B8 */&instructions_NInstr,
-    /* B9 */&instructions_NInstr,
-    /* BA */&instructions_NInstr,
-    /* BB */&instructions_NInstr,
-    /* BC */&instructions_NInstr,
-    /* BD */&instructions_NInstr,
-    /* BE */&instructions_NInstr,
-    /* BF */&instructions_NInstr,
-    /* C0 */&instructions_NInstr,
-    /* C1 */&instructions_NInstr,
-    /* C2 */&instructions_NInstr,
-    /* C3 */&instructions_NInstr,
-    /* C4 */&instructions_NInstr,
-    /* C5 */&instructions_NInstr,
-    /* C6 */&instructions_NInstr,
-    /* C7 */&instructions_NInstr,
-    /* C8 */&instructions_NInstr,
-    /* C9 */&instructions_NInstr,
-    /* CA */&instructions_NInstr,
-    /* CB */&instructions_NInstr,
-    /* CC */&instructions_NInstr,
-    /* CD */&instructions_NInstr,
-    /* CE */&instructions_NInstr,
-    /* CF */&instructions_NInstr,
-    /* D0 */&instructions_NInstr,
-    /* D1 */&instructions_NInstr,
-    /* D2 */&instructions_NInstr,
-    /* D3 */&instructions_NInstr,
-    /* D4 */&instructions_NInstr,
-    /* D5 */&instructions_NInstr,
-    /* D6 */&instructions_NInstr,
-    /* D7 */&instructions_NInstr,
-    /* D8 */&instructions_NInstr,
-    /* D9 */&instructions_NInstr,
-    /* DA */&instructions_NInstr,
-    /* DB */&instructions_NInstr,
-    /* DC */&instructions_NInstr,
-    /* DD */&instructions_NInstr,
-    /* DE */&instructions_NInstr,
-    /* DF */&instructions_NInstr,
-    /* E0 */&instructions_NInstr,
-    /* E1 */&instructions_NInstr,
-    /* E2 */&instructions_NInstr,
-    /* E3 */&instructions_NInstr,
-    /* E4 */&instructions_NInstr,
-    /* E5 */&instructions_NInstr,
-    /* E6 */&instructions_NInstr,
-    /* E7 */&instructions_NInstr,
-    /* E8 */&instructions_NInstr,
-    /* E9 */&instructions_NInstr,
-    /* EA */&instructions_NInstr,
-    /* EB */&instructions_NInstr,
-    /* EC */&instructions_NInstr,
-    /* ED */&instructions_NInstr,
-    /* EE */&instructions_NInstr,
-    /* EF */&instructions_NInstr,
-    /* F0 */&instructions_NInstr,
-    /* F1 */&instructions_NInstr,
-    /* F2 */&instructions_NInstr,
-    /* F3 */&instructions_NInstr,
-    /* F4 */&instructions_NInstr,
-    /* F5 */&instructions_NInstr,
-    /* F6 */&instructions_NInstr,
-    /* F7 */&instructions_NInstr,
-    /* F8 */&instructions_NInstr,
-    /* F9 */&instructions_NInstr,
-    /* FA */&instructions_NInstr,
-    /* FB */&instructions_NInstr,
-    /* FC */&instructions_NInstr,
-    /* FD */&instructions_NInstr,
-    /* FE */&instructions_NInstr,
-    /* FF */&instructions_NInstr
-};
-
-const int (*instructions_bitInstructionFuncs[0x100])() = {
-    /* 00 */&instructions_NInstr,
-    /* 01 */&instructions_NInstr,
-    /* 02 */&instructions_NInstr,
-    /* 03 */&instructions_NInstr,
-    /* 04 */&instructions_NInstr,
-    /* 05 */&instructions_NInstr,
-    /* 06 */&instructions_NInstr,
-    /* 07 */&instructions_NInstr,
-    /* 08 */&instructions_NInstr,
-    /* 09 */&instructions_NInstr,
-    /* 0A */&instructions_NInstr,
-    /* 0B */&instructions_NInstr,
-    /* 0C */&instructions_NInstr,
-    /* 0D */&instructions_NInstr,
-    /* 0E */&instructions_NInstr,
-    /* 0F */&instructions_NInstr,
-    /* 10 */&instructions_NInstr,
-    /* 11 */&instructions_NInstr,
-    /* 12 */&instructions_NInstr,
-    /* 13 */&instructions_NInstr,
-    /* 14 */&instructions_NInstr,
-    /* 15 */&instructions_NInstr,
-    /* 16 */&instructions_NInstr,
-    /* 17 */&instructions_NInstr,
-    /* 18 */&instructions_NInstr,
-    /* 19 */&instructions_NInstr,
-    /* 1A */&instructions_NInstr,
-    /* 1B */&instructions_NInstr,
-    /* 1C */&instructions_NInstr,
-    /* 1D */&instructions_NInstr,
-    /* 1E */&instructions_NInstr,
-    /* 1F */&instructions_NInstr,
-    /* 20 */&instructions_NInstr,
-    /* 21 */&instructions_NInstr,
-    /* 22 */&instructions_NInstr,
-    /* 23 */&instructions_NInstr,
-    /* 24 */&instructions_NInstr,
-    /* 25 */&instructions_NInstr,
-    /* 26 */&instructions_NInstr,
-    /* 27 */&instructions_NInstr,
-    /* 28 */&instructions_NInstr,
-    /* 29 */&instructions_NInstr,
-    /* 2A */&instructions_NInstr,
-    /* 2B */&instructions_NInstr,
-    /* 2C */&instructions_NInstr,
-    /* 2D */&instructions_NInstr,
-    /* 2E */&instructions_NInstr,
-    /* 2F */&instructions_NInstr,
-    /* 30 */&instructions_NInstr,
-    /* 31 */&instructions_NInstr,
-    /* 32 */&instructions_NInstr,
-    /* 33 */&instructions_NInstr,
-    /* 34 */&instructions_NInstr,
-    /* 35 */&instructions_NInstr,
-    /* 36 */&instructions_NInstr,
-    /* 37 */&instructions_NInstr,
-    /* 38 */&instructions_NInstr,
-    /* 39 */&instructions_NInstr,
-    /* 3A */&instructions_NInstr,
-    /* 3B */&instructions_NInstr,
-    /* 3C */&instructions_NInstr,
-    /* 3D */&instructions_NInstr,
-    /* 3E */&instructions_NInstr,
-    /* 3F */&instructions_NInstr,
-    /* 40 */&instructions_NInstr,
-    /* 41 */&instructions_NInstr,
-    /* 42 */&instructions_NInstr,
-    /* 43 */&instructions_NInstr,
-    /* 44 */&instructions_NInstr,
-    /* 45 */&instructions_NInstr,
-    /* 46 */&instructions_NInstr,
-    /* 47 */&instructions_NInstr,
-    /* 48 */&instructions_NInstr,
-    /* 49 */&instructions_NInstr,
-    /* 4A */&instructions_NInstr,
-    /* 4B */&instructions_NInstr,
-    /* 4C */&instructions_NInstr,
-    /* 4D */&instructions_NInstr,
-    /* 4E */&instructions_NInstr,
-    /* 4F */&instructions_NInstr,
-    /* 50 */&instructions_NInstr,
-    /* 51 */&instructions_NInstr,
-    /* 52 */&instructions_NInstr,
-    /* 53 */&instructions_NInstr,
-    /* 54 */&instructions_NInstr,
-    /* 55 */&instructions_NInstr,
-    /* 56 */&instructions_NInstr,
-    /* 57 */&instructions_NInstr,
-    /* 58 */&instructions_NInstr,
-    /* 59 */&instructions_NInstr,
-    /* 5A */&instructions_NInstr,
-    /* 5B */&instructions_NInstr,
-    /* 5C */&instructions_NInstr,
-    /* 5D */&instructions_NInstr,
-    /* 5E */&instructions_NInstr,
-    /* 5F */&instructions_NInstr,
-    /* 60 */&instructions_NInstr,
-    /* 61 */&instructions_NInstr,
-    /* 62 */&instructions_NInstr,
-    /* 63 */&instructions_NInstr,
-    /* 64 */&instructions_NInstr,
-    /* 65 */&instructions_NInstr,
-    /* 66 */&instructions_NInstr,
-    /* 67 */&instructions_NInstr,
-    /* 68 */&instructions_NInstr,
-    /* 69 */&instructions_NInstr,
-    /* 6A */&instructions_NInstr,
-    /* 6B */&instructions_NInstr,
-    /* 6C */&instructions_NInstr,
-    /* 6D */&instructions_NInstr,
-    /* 6E */&instructions_NInstr,
-    /* 6F */&instructions_NInstr,
-    /* 70 */&instructions_NInstr,
-    /* 71 */&instructions_NInstr,
-    /* 72 */&instructions_NInstr,
-    /* 73 */&instructions_NInstr,
-    /* 74 */&instructions_NInstr,
-    /* 75 */&instructions_NInstr,
-    /* 76 */&instructions_NInstr,
-    /* 77 */&instructions_NInstr,
-    /* 78 */&instructions_NInstr,
-    /* 79 */&instructions_NInstr,
-    /* 7A */&instructions_NInstr,
-    /* 7B */&instructions_NInstr,
-    /* 7C */&instructions_NInstr,
-    /* 7D */&instructions_NInstr,
-    /* 7E */&instructions_NInstr,
-    /* 7F */&instructions_NInstr,
-    /* 80 */&instructions_NInstr,
-    /* 81 */&instructions_NInstr,
-    /* 82 */&instructions_NInstr,
-    /* 83 */&instructions_NInstr,
-    /* 84 */&instructions_NInstr,
-    /* 85 */&instructions_NInstr,
-    /* 86 */&instructions_NInstr,
-    /* 87 */&instructions_NInstr,
-    /* 88 */&instructions_NInstr,
-    /* 89 */&instructions_NInstr,
-    /* 8A */&instructions_NInstr,
-    /* 8B */&instructions_NInstr,
-    /* 8C */&instructions_NInstr,
-    /* 8D */&instructions_NInstr,
-    /* 8E */&instructions_NInstr,
-    /* 8F */&instructions_NInstr,
-    /* 90 */&instructions_NInstr,
-    /* 91 */&instructions_NInstr,
-    /* 92 */&instructions_NInstr,
-    /* 93 */&instructions_NInstr,
-    /* 94 */&instructions_NInstr,
-    /* 95 */&instructions_NInstr,
-    /* 96 */&instructions_NInstr,
-    /* 97 */&instructions_NInstr,
-    /* 98 */&instructions_NInstr,
-    /* 99 */&instructions_NInstr,
-    /* 9A */&instructions_NInstr,
-    /* 9B */&instructions_NInstr,
-    /* 9C */&instructions_NInstr,
-    /* 9D */&instructions_NInstr,
-    /* 9E */&instructions_NInstr,
-    /* 9F */&instructions_NInstr,
-    /* A0 */&instructions_NInstr,
-    /* A1 */&instructions_NInstr,
-    /* A2 */&instructions_NInstr,
-    /* A3 */&instructions_NInstr,
-    /* A4 */&instructions_NInstr,
-    /* A5 */&instructions_NInstr,
-    /* A6 */&instructions_NInstr,
-    /* A7 */&instructions_NInstr,
-    /* A8 */&instructions_NInstr,
-    /* A9 */&instructions_NInstr,
-    /* AA */&instructions_NInstr,
-    /* AB */&instructions_NInstr,
-    /* AC */&instructions_NInstr,
-    /* AD */&instructions_NInstr,
-    /* AE */&instructions_NInstr,
-    /* AF */&instructions_NInstr,
-    /* B0 */&instructions_NInstr,
-    /* B1 */&instructions_NInstr,
-    /* B2 */&instructions_NInstr,
-    /* B3 */&instructions_NInstr,
-    /* B4 */&instructions_NInstr,
-    /* B5 */&instructions_NInstr,
-    /* B6 */&instructions_NInstr,
-    /* B7 */&instructions_NInstr,
-    /* B8 */&instructions_NInstr,
-    /* B9 */&instructions_NInstr,
-    /* BA */&instructions_NInstr,
-    /* BB */&instructions_NInstr,
-    /* BC */&instructions_NInstr,
-    /* BD */&instructions_NInstr,
-    /* BE */&instructions_NInstr,
-    /* BF */&instructions_NInstr,
-    /* C0 */&instructions_NInstr,
-    /* C1 */&instructions_NInstr,
-    /* C2 */&instructions_NInstr,
-    /* C3 */&instructions_NInstr,
-    /* C4 */&instructions_NInstr,
-    /* C5 */&instructions_NInstr,
-    /* C6 */&instructions_NInstr,
-    /* C7 */&instructions_NInstr,
-    /* C8 */&instructions_NInstr,
-    /* C9 */&instructions_NInstr,
-    /* CA */&instructions_NInstr,
-    /* CB */&instructions_NInstr,
-    /* CC */&instructions_NInstr,
-    /* CD */&instructions_NInstr,
-    /* CE */&instructions_NInstr,
-    /* CF */&instructions_NInstr,
-    /* D0 */&instructions_NInstr,
-    /* D1 */&instructions_NInstr,
-    /* D2 */&instructions_NInstr,
-    /* D3 */&instructions_NInstr,
-    /* D4 */&instructions_NInstr,
-    /* D5 */&instructions_NInstr,
-    /* D6 */&instructions_NInstr,
-    /* D7 */&instructions_NInstr,
-    /* D8 */&instructions_NInstr,
-    /* D9 */&instructions_NInstr,
-    /* DA */&instructions_NInstr,
-    /* DB */&instructions_NInstr,
-    /* DC */&instructions_NInstr,
-    /* DD */&instructions_NInstr,
-    /* DE */&instructions_NInstr,
-    /* DF */&instructions_NInstr,
-    /* E0 */&instructions_NInstr,
-    /* E1 */&instructions_NInstr,
-    /* E2 */&instructions_NInstr,
-    /* E3 */&instructions_NInstr,
-    /* E4 */&instructions_NInstr,
-    /* E5 */&instructions_NInstr,
-    /* E6 */&instructions_NInstr,
-    /* E7 */&instructions_NInstr,
-    /* E8 */&instructions_NInstr,
-    /* E9 */&instructions_NInstr,
-    /* EA */&instructions_NInstr,
-    /* EB */&instructions_NInstr,
-    /* EC */&instructions_NInstr,
-    /* ED */&instructions_NInstr,
-    /* EE */&instructions_NInstr,
-    /* EF */&instructions_NInstr,
-    /* F0 */&instructions_NInstr,
-    /* F1 */&instructions_NInstr,
-    /* F2 */&instructions_NInstr,
-    /* F3 */&instructions_NInstr,
-    /* F4 */&instructions_NInstr,
-    /* F5 */&instructions_NInstr,
-    /* F6 */&instructions_NInstr,
-    /* F7 */&instructions_NInstr,
-    /* F8 */&instructions_NInstr,
-    /* F9 */&instructions_NInstr,
-    /* FA */&instructions_NInstr,
-    /* FB */&instructions_NInstr,
-    /* FC */&instructions_NInstr,
-    /* FD */&instructions_NInstr,
-    /* FE */&instructions_NInstr,
-    /* FF */&instructions_NInstr
-};
-
-const int (*instructions_extendedInstructionFuncs[0x100])() = {
-    /* 00 */&instructions_NInstr,
-    /* 01 */&instructions_NInstr,
-    /* 02 */&instructions_NInstr,
-    /* 03 */&instructions_NInstr,
-    /* 04 */&instructions_NInstr,
-    /* 05 */&instructions_NInstr,
-    /* 06 */&instructions_NInstr,
-    /* 07 */&instructions_NInstr,
-    /* 08 */&instructions_NInstr,
-    /* 09 */&instructions_NInstr,
-    /* 0A */&instructions_NInstr,
-    /* 0B */&instructions_NInstr,
-    /* 0C */&instructions_NInstr,
-    /* 0D */&instructions_NInstr,
-    /* 0E */&instructions_NInstr,
-    /* 0F */&instructions_NInstr,
-    /* 10 */&instructions_NInstr,
-    /* 11 */&instructions_NInstr,
-    /* 12 */&instructions_NInstr,
-    /* 13 */&instructions_NInstr,
-    /* 14 */&instructions_NInstr,
-    /* 15 */&instructions_NInstr,
-    /* 16 */&instructions_NInstr,
-    /* 17 */&instructions_NInstr,
-    /* 18 */&instructions_NInstr,
-    /* 19 */&instructions_NInstr,
-    /* 1A */&instructions_NInstr,
-    /* 1B */&instructions_NInstr,
-    /* 1C */&instructions_NInstr,
-    /* 1D */&instructions_NInstr,
-    /* 1E */&instructions_NInstr,
-    /* 1F */&instructions_NInstr,
-    /* 20 */&instructions_NInstr,
-    /* 21 */&instructions_NInstr,
-    /* 22 */&instructions_NInstr,
-    /* 23 */&instructions_NInstr,
-    /* 24 */&instructions_NInstr,
-    /* 25 */&instructions_NInstr,
-    /* 26 */&instructions_NInstr,
-    /* 27 */&instructions_NInstr,
-    /* 28 */&instructions_NInstr,
-    /* 29 */&instructions_NInstr,
-    /* 2A */&instructions_NInstr,
-    /* 2B */&instructions_NInstr,
-    /* 2C */&instructions_NInstr,
-    /* 2D */&instructions_NInstr,
-    /* 2E */&instructions_NInstr,
-    /* 2F */&instructions_NInstr,
-    /* 30 */&instructions_NInstr,
-    /* 31 */&instructions_NInstr,
-    /* 32 */&instructions_NInstr,
-    /* 33 */&instructions_NInstr,
-    /* 34 */&instructions_NInstr,
-    /* 35 */&instructions_NInstr,
-    /* 36 */&instructions_NInstr,
-    /* 37 */&instructions_NInstr,
-    /* 38 */&instructions_NInstr,
-    /* 39 */&instructions_NInstr,
-    /* 3A */&instructions_NInstr,
-    /* 3B */&instructions_NInstr,
-    /* 3C */&instructions_NInstr,
-    /* 3D */&instructions_NInstr,
-    /* 3E */&instructions_NInstr,
-    /* 3F */&instructions_NInstr,
-    /* 40 */&instructions_NInstr,
-    /* 41 */&instructions_NInstr,
-    /* 42 */&instructions_NInstr,
-    /* 43 */&instructions_NInstr,
-    /* 44 */&instructions_NInstr,
-    /* 45 */&instructions_NInstr,
-    /* 46 */&instructions_NInstr,
-    /* 47 */&instructions_NInstr,
-    /* 48 */&instructions_NInstr,
-    /* 49 */&instructions_NInstr,
-    /* 4A */&instructions_NInstr,
-    /* 4B */&instructions_NInstr,
-    /* 4C */&instructions_NInstr,
-    /* 4D */&instructions_NInstr,
-    /* 4E */&instructions_NInstr,
-    /* 4F */&instructions_NInstr,
-    /* 50 */&instructions_NInstr,
-    /* 51 */&instructions_NInstr,
-    /* 52 */&instructions_NInstr,
-    /* 53 */&instructions_NInstr,
-    /* 54 */&instructions_NInstr,
-    /* 55 */&instructions_NInstr,
-    /* 56 */&instructions_NInstr,
-    /* 57 */&instructions_NInstr,
-    /* 58 */&instructions_NInstr,
-    /* 59 */&instructions_NInstr,
-    /* 5A */&instructions_NInstr,
-    /* 5B */&instructions_NInstr,
-    /* 5C */&instructions_NInstr,
-    /* 5D */&instructions_NInstr,
-    /* 5E */&instructions_NInstr,
-    /* 5F */&instructions_NInstr,
-    /* 60 */&instructions_NInstr,
-    /* 61 */&instructions_NInstr,
-    /* 62 */&instructions_NInstr,
-    /* 63 */&instructions_NInstr,
-    /* 64 */&instructions_NInstr,
-    /* 65 */&instructions_NInstr,
-    /* 66 */&instructions_NInstr,
-    /* 67 */&instructions_NInstr,
-    /* 68 */&instructions_NInstr,
-    /* 69 */&instructions_NInstr,
-    /* 6A */&instructions_NInstr,
-    /* 6B */&instructions_NInstr,
-    /* 6C */&instructions_NInstr,
-    /* 6D */&instructions_NInstr,
-    /* 6E */&instructions_NInstr,
-    /* 6F */&instructions_NInstr,
-    /* 70 */&instructions_NInstr,
-    /* 71 */&instructions_NInstr,
-    /* 72 */&instructions_NInstr,
-    /* 73 */&instructions_NInstr,
-    /* 74 */&instructions_NInstr,
-    /* 75 */&instructions_NInstr,
-    /* 76 */&instructions_NInstr,
-    /* 77 */&instructions_NInstr,
-    /* 78 */&instructions_NInstr,
-    /* 79 */&instructions_NInstr,
-    /* 7A */&instructions_NInstr,
-    /* 7B */&instructions_NInstr,
-    /* 7C */&instructions_NInstr,
-    /* 7D */&instructions_NInstr,
-    /* 7E */&instructions_NInstr,
-    /* 7F */&instructions_NInstr,
-    /* 80 */&instructions_NInstr,
-    /* 81 */&instructions_NInstr,
-    /* 82 */&instructions_NInstr,
-    /* 83 */&instructions_NInstr,
-    /* 84 */&instructions_NInstr,
-    /* 85 */&instructions_NInstr,
-    /* 86 */&instructions_NInstr,
-    /* 87 */&instructions_NInstr,
-    /* 88 */&instructions_NInstr,
-    /* 89 */&instructions_NInstr,
-    /* 8A */&instructions_NInstr,
-    /* 8B */&instructions_NInstr,
-    /* 8C */&instructions_NInstr,
-    /* 8D */&instructions_NInstr,
-    /* 8E */&instructions_NInstr,
-    /* 8F */&instructions_NInstr,
-    /* 90 */&instructions_NInstr,
-    /* 91 */&instructions_NInstr,
-    /* 92 */&instructions_NInstr,
-    /* 93 */&instructions_NInstr,
-    /* 94 */&instructions_NInstr,
-    /* 95 */&instructions_NInstr,
-    /* 96 */&instructions_NInstr,
-    /* 97 */&instructions_NInstr,
-    /* 98 */&instructions_NInstr,
-    /* 99 */&instructions_NInstr,
-    /* 9A */&instructions_NInstr,
-    /* 9B */&instructions_NInstr,
-    /* 9C */&instructions_NInstr,
-    /* 9D */&instructions_NInstr,
-    /* 9E */&instructions_NInstr,
-    /* 9F */&instructions_NInstr,
-    /* A0 */&instructions_NInstr,
-    /* A1 */&instructions_NInstr,
-    /* A2 */&instructions_NInstr,
-    /* A3 */&instructions_NInstr,
-    /* A4 */&instructions_NInstr,
-    /* A5 */&instructions_NInstr,
-    /* A6 */&instructions_NInstr,
-    /* A7 */&instructions_NInstr,
-    /* A8 */&instructions_NInstr,
-    /* A9 */&instructions_NInstr,
-    /* AA */&instructions_NInstr,
-    /* AB */&instructions_NInstr,
-    /* AC */&instructions_NInstr,
-    /* AD */&instructions_NInstr,
-    /* AE */&instructions_NInstr,
-    /* AF */&instructions_NInstr,
-    /* B0 */&instructions_NInstr,
-    /* B1 */&instructions_NInstr,
-    /* B2 */&instructions_NInstr,
-    /* B3 */&instructions_NInstr,
-    /* B4 */&instructions_NInstr,
-    /* B5 */&instructions_NInstr,
-    /* B6 */&instructions_NInstr,
-    /* B7 */&instructions_NInstr,
-    /* B8 */&instructions_NInstr,
-    /* B9 */&instructions_NInstr,
-    /* BA */&instructions_NInstr,
-    /* BB */&instructions_NInstr,
-    /* BC */&instructions_NInstr,
-    /* BD */&instructions_NInstr,
-    /* BE */&instructions_NInstr,
-    /* BF */&instructions_NInstr,
-    /* C0 */&instructions_NInstr,
-    /* C1 */&instructions_NInstr,
-    /* C2 */&instructions_NInstr,
-    /* C3 */&instructions_NInstr,
-    /* C4 */&instructions_NInstr,
-    /* C5 */&instructions_NInstr,
-    /* C6 */&instructions_NInstr,
-    /* C7 */&instructions_NInstr,
-    /* C8 */&instructions_NInstr,
-    /* C9 */&instructions_NInstr,
-    /* CA */&instructions_NInstr,
-    /* CB */&instructions_NInstr,
-    /* CC */&instructions_NInstr,
-    /* CD */&instructions_NInstr,
-    /* CE */&instructions_NInstr,
-    /* CF */&instructions_NInstr,
-    /* D0 */&instructions_NInstr,
-    /* D1 */&instructions_NInstr,
-    /* D2 */&instructions_NInstr,
-    /* D3 */&instructions_NInstr,
-    /* D4 */&instructions_NInstr,
-    /* D5 */&instructions_NInstr,
-    /* D6 */&instructions_NInstr,
-    /* D7 */&instructions_NInstr,
-    /* D8 */&instructions_NInstr,
-    /* D9 */&instructions_NInstr,
-    /* DA */&instructions_NInstr,
-    /* DB */&instructions_NInstr,
-    /* DC */&instructions_NInstr,
-    /* DD */&instructions_NInstr,
-    /* DE */&instructions_NInstr,
-    /* DF */&instructions_NInstr,
-    /* E0 */&instructions_NInstr,
-    /* E1 */&instructions_NInstr,
-    /* E2 */&instructions_NInstr,
-    /* E3 */&instructions_NInstr,
-    /* E4 */&instructions_NInstr,
-    /* E5 */&instructions_NInstr,
-    /* E6 */&instructions_NInstr,
-    /* E7 */&instructions_NInstr,
-    /* E8 */&instructions_NInstr,
-    /* E9 */&instructions_NInstr,
-    /* EA */&instructions_NInstr,
-    /* EB */&instructions_NInstr,
-    /* EC */&instructions_NInstr,
-    /* ED */&instructions_NInstr,
-    /* EE */&instructions_NInstr,
-    /* EF */&instructions_NInstr,
-    /* F0 */&instructions_NInstr,
-    /* F1 */&instructions_NInstr,
-    /* F2 */&instructions_NInstr,
-    /* F3 */&instructions_NInstr,
-    /* F4 */&instructions_NInstr,
-    /* F5 */&instructions_NInstr,
-    /* F6 */&instructions_NInstr,
-    /* F7 */&instructions_NInstr,
-    /* F8 */&instructions_NInstr,
-    /* F9 */&instructions_NInstr,
-    /* FA */&instructions_NInstr,
-    /* FB */&instructions_NInstr,
-    /* FC */&instructions_NInstr,
-    /* FD */&instructions_NInstr,
-    /* FE */&instructions_NInstr,
-    /* FF */&instructions_NInstr
-};
-
-const int (*instructions_mainInstructionFuncs[0x100])() = {
-    /* 00 */&instructions_NInstr,
-    /* 01 */&instructions_NInstr,
-    /* 02 */&instructions_NInstr,
-    /* 03 */&instructions_NInstr,
-    /* 04 */&instructions_NInstr,
-    /* 05 */&instructions_NInstr,
-    /* 06 */&instructions_NInstr,
-    /* 07 */&instructions_NInstr,
-    /* 08 */&instructions_NInstr,
-    /* 09 */&instructions_NInstr,
-    /* 0A */&instructions_NInstr,
-    /* 0B */&instructions_NInstr,
-    /* 0C */&instructions_NInstr,
-    /* 0D */&instructions_NInstr,
-    /* 0E */&instructions_NInstr,
-    /* 0F */&instructions_NInstr,
-    /* 10 */&instructions_NInstr,
-    /* 11 */&instructions_NInstr,
-    /* 12 */&instructions_NInstr,
-    /* 13 */&instructions_NInstr,
-    /* 14 */&instructions_NInstr,
-    /* 15 */&instructions_NInstr,
-    /* 16 */&instructions_NInstr,
-    /* 17 */&instructions_NInstr,
-    /* 18 */&instructions_NInstr,
-    /* 19 */&instructions_NInstr,
-    /* 1A */&instructions_NInstr,
-    /* 1B */&instructions_NInstr,
-    /* 1C */&instructions_NInstr,
-    /* 1D */&instructions_NInstr,
-    /* 1E */&instructions_NInstr,
-    /* 1F */&instructions_NInstr,
-    /* 20 */&instructions_NInstr,
-    /* 21 */&instructions_NInstr,
-    /* 22 */&instructions_NInstr,
-    /* 23 */&instructions_NInstr,
-    /* 24 */&instructions_NInstr,
-    /* 25 */&instructions_NInstr,
-    /* 26 */&instructions_NInstr,
-    /* 27 */&instructions_NInstr,
-    /* 28 */&instructions_NInstr,
-    /* 29 */&instructions_NInstr,
-    /* 2A */&instructions_NInstr,
-    /* 2B */&instructions_NInstr,
-    /* 2C */&instructions_NInstr,
-    /* 2D */&instructions_NInstr,
-    /* 2E */&instructions_NInstr,
-    /* 2F */&instructions_NInstr,
-    /* 30 */&instructions_NInstr,
-    /* 31 */&instructions_NInstr,
-    /* 32 */&instructions_NInstr,
-    /* 33 */&instructions_NInstr,
-    /* 34 */&instructions_NInstr,
-    /* 35 */&instructions_NInstr,
-    /* 36 */&instructions_NInstr,
-    /* 37 */&instructions_NInstr,
-    /* 38 */&instructions_NInstr,
-    /* 39 */&instructions_NInstr,
-    /* 3A */&instructions_NInstr,
-    /* 3B */&instructions_NInstr,
-    /* 3C */&instructions_NInstr,
-    /* 3D */&instructions_NInstr,
-    /* 3E */&instructions_NInstr,
-    /* 3F */&instructions_NInstr,
-    /* 40 */&instructions_NInstr,
-    /* 41 */&instructions_NInstr,
-    /* 42 */&instructions_NInstr,
-    /* 43 */&instructions_NInstr,
-    /* 44 */&instructions_NInstr,
-    /* 45 */&instructions_NInstr,
-    /* 46 */&instructions_NInstr,
-    /* 47 */&instructions_NInstr,
-    /* 48 */&instructions_NInstr,
-    /* 49 */&instructions_NInstr,
-    /* 4A */&instructions_NInstr,
-    /* 4B */&instructions_NInstr,
-    /* 4C */&instructions_NInstr,
-    /* 4D */&instructions_NInstr,
-    /* 4E */&instructions_NInstr,
-    /* 4F */&instructions_NInstr,
-    /* 50 */&instructions_NInstr,
-    /* 51 */&instructions_NInstr,
-    /* 52 */&instructions_NInstr,
-    /* 53 */&instructions_NInstr,
-    /* 54 */&instructions_NInstr,
-    /* 55 */&instructions_NInstr,
-    /* 56 */&instructions_NInstr,
-    /* 57 */&instructions_NInstr,
-    /* 58 */&instructions_NInstr,
-    /* 59 */&instructions_NInstr,
-    /* 5A */&instructions_NInstr,
-    /* 5B */&instructions_NInstr,
-    /* 5C */&instructions_NInstr,
-    /* 5D */&instructions_NInstr,
-    /* 5E */&instructions_NInstr,
-    /* 5F */&instructions_NInstr,
-    /* 60 */&instructions_NInstr,
-    /* 61 */&instructions_NInstr,
-    /* 62 */&instructions_NInstr,
-    /* 63 */&instructions_NInstr,
-    /* 64 */&instructions_NInstr,
-    /* 65 */&instructions_NInstr,
-    /* 66 */&instructions_NInstr,
-    /* 67 */&instructions_NInstr,
-    /* 68 */&instructions_NInstr,
-    /* 69 */&instructions_NInstr,
-    /* 6A */&instructions_NInstr,
-    /* 6B */&instructions_NInstr,
-    /* 6C */&instructions_NInstr,
-    /* 6D */&instructions_NInstr,
-    /* 6E */&instructions_NInstr,
-    /* 6F */&instructions_NInstr,
-    /* 70 */&instructions_NInstr,
-    /* 71 */&instructions_NInstr,
-    /* 72 */&instructions_NInstr,
-    /* 73 */&instructions_NInstr,
-    /* 74 */&instructions_NInstr,
-    /* 75 */&instructions_NInstr,
-    /* 76 */&instructions_NInstr,
-    /* 77 */&instructions_NInstr,
-    /* 78 */&instructions_NInstr,
-    /* 79 */&instructions_NInstr,
-    /* 7A */&instructions_NInstr,
-    /* 7B */&instructions_NInstr,
-    /* 7C */&instructions_NInstr,
-    /* 7D */&instructions_NInstr,
-    /* 7E */&instructions_NInstr,
-    /* 7F */&instructions_NInstr,
-    /* 80 */&instructions_NInstr,
-    /* 81 */&instructions_NInstr,
-    /* 82 */&instructions_NInstr,
-    /* 83 */&instructions_NInstr,
-    /* 84 */&instructions_NInstr,
-    /* 85 */&instructions_NInstr,
-    /* 86 */&instructions_NInstr,
-    /* 87 */&instructions_NInstr,
-    /* 88 */&instructions_NInstr,
-    /* 89 */&instructions_NInstr,
-    /* 8A */&instructions_NInstr,
-    /* 8B */&instructions_NInstr,
-    /* 8C */&instructions_NInstr,
-    /* 8D */&instructions_NInstr,
-    /* 8E */&instructions_NInstr,
-    /* 8F */&instructions_NInstr,
-    /* 90 */&instructions_NInstr,
-    /* 91 */&instructions_NInstr,
-    /* 92 */&instructions_NInstr,
-    /* 93 */&instructions_NInstr,
-    /* 94 */&instructions_NInstr,
-    /* 95 */&instructions_NInstr,
-    /* 96 */&instructions_NInstr,
-    /* 97 */&instructions_NInstr,
-    /* 98 */&instructions_NInstr,
-    /* 99 */&instructions_NInstr,
-    /* 9A */&instructions_NInstr,
-    /* 9B */&instructions_NInstr,
-    /* 9C */&instructions_NInstr,
-    /* 9D */&instructions_NInstr,
-    /* 9E */&instructions_NInstr,
-    /* 9F */&instructions_NInstr,
-    /* A0 */&instructions_NInstr,
-    /* A1 */&instructions_NInstr,
-    /* A2 */&instructions_NInstr,
-    /* A3 */&instructions_NInstr,
-    /* A4 */&instructions_NInstr,
-    /* A5 */&instructions_NInstr,
-    /* A6 */&instructions_NInstr,
-    /* A7 */&instructions_NInstr,
-    /* A8 */&instructions_NInstr,
-    /* A9 */&instructions_NInstr,
-    /* AA */&instructions_NInstr,
-    /* AB */&instructions_NInstr,
-    /* AC */&instructions_NInstr,
-    /* AD */&instructions_NInstr,
-    /* AE */&instructions_NInstr,
-    /* AF */&instructions_NInstr,
-    /* B0 */&instructions_NInstr,
-    /* B1 */&instructions_NInstr,
-    /* B2 */&instructions_NInstr,
-    /* B3 */&instructions_NInstr,
-    /* B4 */&instructions_NInstr,
-    /* B5 */&instructions_NInstr,
-    /* B6 */&instructions_NInstr,
-    /* B7 */&instructions_NInstr,
-    /* B8 */&instructions_NInstr,
-    /* B9 */&instructions_NInstr,
-    /* BA */&instructions_NInstr,
-    /* BB */&instructions_NInstr,
-    /* BC */&instructions_NInstr,
-    /* BD */&instructions_NInstr,
-    /* BE */&instructions_NInstr,
-    /* BF */&instructions_NInstr,
-    /* C0 */&instructions_NInstr,
-    /* C1 */&instructions_NInstr,
-    /* C2 */&instructions_NInstr,
-    /* C3 */&instructions_NInstr,
-    /* C4 */&instructions_NInstr,
-    /* C5 */&instructions_NInstr,
-    /* C6 */&instructions_NInstr,
-    /* C7 */&instructions_NInstr,
-    /* C8 */&instructions_NInstr,
-    /* C9 */&instructions_NInstr,
-    /* CA */&instructions_NInstr,
-    /* CB */&instructions_NInstr,
-    /* CC */&instructions_NInstr,
-    /* CD */&instructions_NInstr,
-    /* CE */&instructions_NInstr,
-    /* CF */&instructions_NInstr,
-    /* D0 */&instructions_NInstr,
-    /* D1 */&instructions_NInstr,
-    /* D2 */&instructions_NInstr,
-    /* D3 */&instructions_NInstr,
-    /* D4 */&instructions_NInstr,
-    /* D5 */&instructions_NInstr,
-    /* D6 */&instructions_NInstr,
-    /* D7 */&instructions_NInstr,
-    /* D8 */&instructions_NInstr,
-    /* D9 */&instructions_NInstr,
-    /* DA */&instructions_NInstr,
-    /* DB */&instructions_NInstr,
-    /* DC */&instructions_NInstr,
-    /* DD */&instructions_NInstr,
-    /* DE */&instructions_NInstr,
-    /* DF */&instructions_NInstr,
-    /* E0 */&instructions_NInstr,
-    /* E1 */&instructions_NInstr,
-    /* E2 */&instructions_NInstr,
-    /* E3 */&instructions_NInstr,
-    /* E4 */&instructions_NInstr,
-    /* E5 */&instructions_NInstr,
-    /* E6 */&instructions_NInstr,
-    /* E7 */&instructions_NInstr,
-    /* E8 */&instructions_NInstr,
-    /* E9 */&instructions_NInstr,
-    /* EA */&instructions_NInstr,
-    /* EB */&instructions_NInstr,
-    /* EC */&instructions_NInstr,
-    /* ED */&instructions_NInstr,
-    /* EE */&instructions_NInstr,
-    /* EF */&instructions_NInstr,
-    /* F0 */&instructions_NInstr,
-    /* F1 */&instructions_NInstr,
-    /* F2 */&instructions_NInstr,
-    /* F3 */&instructions_NInstr,
-    /* F4 */&instructions_NInstr,
-    /* F5 */&instructions_NInstr,
-    /* F6 */&instructions_NInstr,
-    /* F7 */&instructions_NInstr,
-    /* F8 */&instructions_NInstr,
-    /* F9 */&instructions_NInstr,
-    /* FA */&instructions_NInstr,
-    /* FB */&instructions_NInstr,
-    /* FC */&instructions_NInstr,
-    /* FD */&instructions_NInstr,
-    /* FE */&instructions_NInstr,
-    /* FF */&instructions_NInstr
-};
\ No newline at end of file
@@ -0,0 +1,492 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Jit.c : x86-64 compiler for hot blocks from the block cache. Only built on x86-64 with the System V calling convention
+
+Compiled code runs the ops of a block in order. Simple register loads and 16 bit increments are done natively,
+everything else calls the op's execute function with cInstr filled in, just as the interpreter does.
+After each op the T-states and instruction count are updated, and the code returns if PC left the block,
+the T-state budget ran out or a page holding code was written.
+Blocks are only entered when no interrupt can be accepted, and I/O instructions and EI are never compiled,
+so the interrupt checks the interpreter makes between ops can be left out.
+
+*/
+
+#include <string.h>
+
+#include "Z80Jit.h"
+#include "Z80.h"
+#include "Z80Instructions.h"
+#include "Z80Step.h"
+#include "Z80Refresh.h"
+
+#include "../Signals.h"
+#include "../SysIO/Log.h"
+
+#if Z80JIT_SUPPORTED
+#include <sys/mman.h>
+#endif
+
+/* Z80 Instruction */
+extern Z0_MACHINE_LOCAL Z80_Instr_t cInstr;
+
+/* JIT state */
+Z0_MACHINE_LOCAL bool Z80Jit_enabled = true;
+Z0_MACHINE_LOCAL uint8_t* Z80Jit_arena = NULL;
+Z0_MACHINE_LOCAL size_t Z80Jit_arenaUsed = 0;
+
+/* Compiler state. Jumps to the exit labels are patched once the labels are bound at the end of the function */
+Z0_MACHINE_LOCAL uint8_t* Z80Jit_cursor = NULL;
+Z0_MACHINE_LOCAL uint8_t* Z80Jit_labels[4];
+Z0_MACHINE_LOCAL uint8_t* Z80Jit_fixups[Z80_JIT_MAX_FIXUPS];
+Z0_MACHINE_LOCAL int Z80Jit_fixupLabels[Z80_JIT_MAX_FIXUPS];
+Z0_MACHINE_LOCAL int Z80Jit_numFixups = 0;
+
+/* Statistics */
+Z0_MACHINE_LOCAL uint64_t Z80Jit_compiled = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Jit_nativeEntries = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Jit_nativeOps = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Jit_inlinedOps = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Jit_arenaResets = 0;
+
+/* Condition codes for Z80Jit_emitJump() */
+#define JIT_JMP 0x00
+#define JIT_JE 0x84
+#define JIT_JNE 0x85
+#define JIT_JAE 0x83
+
+/********************************************************************
+
+    Z80 JIT Functions
+
+********************************************************************/
+
+/*
+Maps the executable arena. The JIT is switched off if this isn't an x86-64 System V build or the arena can't be mapped
+*/
+void Z80Jit_init() {
+#if Z80JIT_SUPPORTED
+    if (!Z80Jit_enabled)
+        return;
+
+    void* arena = mmap(NULL, Z80_JIT_ARENA_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (arena == MAP_FAILED) {
+        formattedLog(stdlog, LOGTYPE_WARN, "Unable to map the JIT arena, the JIT is disabled\n");
+        Z80Jit_enabled = false;
+        return;
+    }
+    Z80Jit_arena = arena;
+    Z80Jit_arenaUsed = 0;
+    formattedLog(debuglog, LOGTYPE_DEBUG, "JIT: %i byte arena, blocks compiled after %i entries\n", Z80_JIT_ARENA_SIZE, Z80_JIT_THRESHOLD);
+#else
+    if (Z80Jit_enabled) {
+        formattedLog(stdlog, LOGTYPE_WARN, "The JIT needs an x86-64 System V build, it is disabled\n");
+    }
+    Z80Jit_enabled = false;
+#endif
+}
+
+/*
+Unmaps the arena and puts the JIT back as it was before Z80Jit_init()
+*/
+void Z80Jit_destroy() {
+#if Z80JIT_SUPPORTED
+    if (Z80Jit_arena != NULL)
+        munmap(Z80Jit_arena, Z80_JIT_ARENA_SIZE);
+#endif
+    Z80Jit_arena = NULL;
+    Z80Jit_arenaUsed = 0;
+    Z80Jit_enabled = true;
+    Z80Jit_compiled = 0;
+    Z80Jit_nativeEntries = 0;
+    Z80Jit_nativeOps = 0;
+    Z80Jit_inlinedOps = 0;
+    Z80Jit_arenaResets = 0;
+}
+
+/*
+Empties the arena. Every compiled block is dropped and has to get hot again
+*/
+void Z80Jit_resetArena() {
+    for (int i = 0; i < Z80Block_poolUsed; i++) {
+        Z80Block_pool[i].native = NULL;
+        Z80Block_pool[i].nativeOps = 0;
+        Z80Block_pool[i].entryCount = 0;
+    }
+    Z80Jit_arenaUsed = 0;
+    Z80Jit_arenaResets++;
+}
+
+/*
+True if Z80_pollInterrupts() would accept nothing before any op of a compiled block.
+Compiled blocks hold no EI or I/O, so nothing they run can change that part way through
+*/
+bool Z80Jit_canEnter() {
+    return !nmiPending && !eiPending && !(IFF1 && signals_readSignal(&signal_INT)) && !Z80Refresh_watching;
+}
+
+/*
+Counts an entry to the block, compiling it once it is hot, and runs its compiled code if it can.
+Returns the number of ops done, for the interpreter to carry on from, or -1 if the block has been left
+*/
+int Z80Jit_enter(Z80Block_t* block, uint64_t* executed, uint64_t tStates) {
+    if (block->native == NULL) {
+        if (++block->entryCount == Z80_JIT_THRESHOLD)
+            Z80Jit_compile(block);
+        if (block->native == NULL)
+            return 0;
+    }
+    if (!Z80Jit_canEnter())
+        return 0;
+
+    Z80JitState_t state;
+    state.executed = *executed;
+    state.budget = tStates;
+    state.codeWrites = Z80Block_codeWrites;
+    state.response = INSTR_EXEC_SUCCESS;
+    state.opsDone = 0;
+
+    int exit = ((Z80JitFunction_t)block->native)(&state);
+    *executed = state.executed;
+    Z80Jit_nativeEntries++;
+    Z80Jit_nativeOps += state.opsDone;
+
+    switch (exit) {
+    case Z80_JIT_EXIT_END:
+        return state.opsDone;
+    case Z80_JIT_EXIT_RECHECK:
+        // The write may have missed this block's pages
+        return Z80Block_isCurrent(block) ? state.opsDone : -1;
+    case Z80_JIT_EXIT_FAILED:
+        formattedLog(stdlog, LOGTYPE_ERROR, "Compiled execution has failed: opcode %04X %02X returned %i\n", cInstr.prefix, cInstr.opcode, state.response);
+        signals_raiseSignal(&signal_WAIT);
+        internalState = Z80State_Failure;
+        return -1;
+    default:
+        return -1;
+    }
+}
+
+/*
+True for ops the compiled code must leave to the interpreter: I/O, and EI as it changes when interrupts are accepted. So
+does LD R,A when INT follows the refresh address
+*/
+bool Z80Jit_isInterpretedOnly(Z80MicroOp_t* op) {
+    uint8_t x = op->opcode >> 6;
+    uint8_t z = op->opcode & 0x07;
+
+    switch (op->prefix) {
+    case PREFIX_BITS:
+    case PREFIX_IX_BITS:
+    case PREFIX_IY_BITS:
+        return false;
+    case PREFIX_EXX:
+        // IN r,(C), OUT (C),r and the block I/O instructions
+        return (x == 1 && z <= 1) || (x == 2 && (z == 2 || z == 3)) || (Z80Refresh_enabled && op->opcode == 0x4F);
+    default:
+        // OUT (n),A, IN A,(n) and EI, which DD and FD fall through to as well
+        return op->opcode == 0xD3 || op->opcode == 0xDB || op->opcode == 0xFB;
+    }
+}
+
+/********************************************************************
+
+    Z80 JIT Compiler Functions
+
+********************************************************************/
+
+/*
+Compiles the block's ops up to the first one only the interpreter can run. Blocks with too few ops to be worth it are left alone
+*/
+void Z80Jit_compile(Z80Block_t* block) {
+#if Z80JIT_SUPPORTED
+    int numOps = 0;
+    while (numOps < block->numOps && !Z80Jit_isInterpretedOnly(&block->ops[numOps]))
+        numOps++;
+    if (numOps < Z80_JIT_MIN_OPS)
+        return;
+
+    size_t worstCase = (size_t)numOps * Z80_JIT_MAX_OP_BYTES + 64;
+    if (Z80Jit_arenaUsed + worstCase > Z80_JIT_ARENA_SIZE)
+        Z80Jit_resetArena();
+
+    uint8_t* start = Z80Jit_arena + Z80Jit_arenaUsed;
+    Z80Jit_cursor = start;
+    Z80Jit_numFixups = 0;
+
+    // push rbx; push r12; sub rsp, 8; mov rbx, rdi. This also leaves the stack aligned for the calls
+    Z80Jit_emit8(0x53);
+    Z80Jit_emit8(0x41); Z80Jit_emit8(0x54);
+    Z80Jit_emit8(0x48); Z80Jit_emit8(0x83); Z80Jit_emit8(0xEC); Z80Jit_emit8(0x08);
+    Z80Jit_emit8(0x48); Z80Jit_emit8(0x89); Z80Jit_emit8(0xFB);
+
+    // The register file stays in R12 for the whole block: mov r12, &Z80_registers
+    Z80Jit_emit8(0x49); Z80Jit_emit8(0xBC);
+    Z80Jit_emit64((uint64_t)(uintptr_t)&Z80_registers);
+
+    uint16_t opPC = block->pc;
+    for (int i = 0; i < numOps; i++) {
+        Z80MicroOp_t* op = &block->ops[i];
+        uint16_t nextPC = opPC + op->len;
+
+        // Stop when the budget has run out: mov rax, [rbx]; cmp rax, [rbx + budget]; jae leave
+        Z80Jit_emit8(0x48); Z80Jit_emit8(0x8B); Z80Jit_emit8(0x03);
+        Z80Jit_emit8(0x48); Z80Jit_emit8(0x3B); Z80Jit_emit8(0x43); Z80Jit_emit8(offsetof(Z80JitState_t, budget));
+        Z80Jit_emitJump(JIT_JAE, Z80_JIT_EXIT_LEAVE);
+
+        // R advances by the opcode fetches, keeping bit 7
+        Z80Jit_emitRegisterAddress(&IVMR);
+        Z80Jit_emit8(0x0F); Z80Jit_emit8(0xB7); Z80Jit_emit8(0x08); // movzx ecx, word [rax]
+        Z80Jit_emit8(0x8D); Z80Jit_emit8(0x51); Z80Jit_emit8(op->m1Cycles); // lea edx, [rcx + m1Cycles]
+        Z80Jit_emit8(0x83); Z80Jit_emit8(0xE2); Z80Jit_emit8(0x7F); // and edx, 0x7F
+        Z80Jit_emit8(0x81); Z80Jit_emit8(0xE1); Z80Jit_emit32(0xFF80); // and ecx, 0xFF80
+        Z80Jit_emit8(0x09); Z80Jit_emit8(0xD1); // or ecx, edx
+        Z80Jit_emit8(0x66); Z80Jit_emit8(0x89); Z80Jit_emit8(0x08); // mov [rax], cx
+
+        // PC moves on before the op runs
+        Z80Jit_emitRegisterAddress(&PC);
+        Z80Jit_emit8(0x66); Z80Jit_emit8(0xC7); Z80Jit_emit8(0x00); Z80Jit_emit16(nextPC);
+
+        if (Z80Jit_emitInline(op)) {
+            // Fixed T-states: add qword [rbx], tStates; add qword [Z80_tStates], tStates
+            Z80Jit_emit8(0x48); Z80Jit_emit8(0x81); Z80Jit_emit8(0x03); Z80Jit_emit32(op->tStates);
+            Z80Jit_emitLoadAddress(&Z80_tStates);
+            Z80Jit_emit8(0x48); Z80Jit_emit8(0x81); Z80Jit_emit8(0x00); Z80Jit_emit32(op->tStates);
+            Z80Jit_emitLoadAddress(&Z80_instructionsExecuted);
+            Z80Jit_emit8(0x48); Z80Jit_emit8(0xFF); Z80Jit_emit8(0x00); // inc qword [rax]
+            Z80Jit_emit8(0xFF); Z80Jit_emit8(0x43); Z80Jit_emit8(offsetof(Z80JitState_t, opsDone)); // inc dword [rbx + opsDone]
+            Z80Jit_inlinedOps++;
+        }
+        else {
+            Z80Jit_emitCall(op);
+
+            // Branches may have added to cInstr.tStates: mov ecx, dword [cInstr.tStates]; add [rbx], rcx; add [Z80_tStates], rcx
+            Z80Jit_emitLoadAddress(&cInstr);
+            Z80Jit_emit8(0x8B); Z80Jit_emit8(0x48); Z80Jit_emit8(offsetof(Z80_Instr_t, tStates));
+            Z80Jit_emit8(0x48); Z80Jit_emit8(0x01); Z80Jit_emit8(0x0B);
+            Z80Jit_emitLoadAddress(&Z80_tStates);
+            Z80Jit_emit8(0x48); Z80Jit_emit8(0x01); Z80Jit_emit8(0x08);
+            Z80Jit_emitLoadAddress(&Z80_instructionsExecuted);
+            Z80Jit_emit8(0x48); Z80Jit_emit8(0xFF); Z80Jit_emit8(0x00); // inc qword [rax]
+            Z80Jit_emit8(0xFF); Z80Jit_emit8(0x43); Z80Jit_emit8(offsetof(Z80JitState_t, opsDone)); // inc dword [rbx + opsDone]
+
+            // mov eax, [rbx + response]; test eax, eax; jne failed
+            Z80Jit_emit8(0x8B); Z80Jit_emit8(0x43); Z80Jit_emit8(offsetof(Z80JitState_t, response));
+            Z80Jit_emit8(0x85); Z80Jit_emit8(0xC0);
+            Z80Jit_emitJump(JIT_JNE, Z80_JIT_EXIT_FAILED);
+
+            // Leave if the op branched: cmp word [PC], nextPC; jne leave
+            Z80Jit_emitRegisterAddress(&PC);
+            Z80Jit_emit8(0x66); Z80Jit_emit8(0x81); Z80Jit_emit8(0x38); Z80Jit_emit16(nextPC);
+            Z80Jit_emitJump(JIT_JNE, Z80_JIT_EXIT_LEAVE);
+
+            // Leave if a page holding code was written: mov eax, [Z80Block_codeWrites]; cmp eax, [rbx + codeWrites]; jne recheck
+            Z80Jit_emitLoadAddress(&Z80Block_codeWrites);
+            Z80Jit_emit8(0x8B); Z80Jit_emit8(0x00);
+            Z80Jit_emit8(0x3B); Z80Jit_emit8(0x43); Z80Jit_emit8(offsetof(Z80JitState_t, codeWrites));
+            Z80Jit_emitJump(JIT_JNE, Z80_JIT_EXIT_RECHECK);
+        }
+
+        opPC = nextPC;
+    }
+
+    // Exits: mov eax, <exit>; add rsp, 8; pop r12; pop rbx; ret
+    for (int exit = Z80_JIT_EXIT_END; exit <= Z80_JIT_EXIT_FAILED; exit++) {
+        Z80Jit_bindLabel(exit);
+        Z80Jit_emit8(0xB8); Z80Jit_emit32(exit);
+        Z80Jit_emit8(0x48); Z80Jit_emit8(0x83); Z80Jit_emit8(0xC4); Z80Jit_emit8(0x08);
+        Z80Jit_emit8(0x41); Z80Jit_emit8(0x5C);
+        Z80Jit_emit8(0x5B);
+        Z80Jit_emit8(0xC3);
+    }
+
+    // Patch the jumps to the exits
+    for (int i = 0; i < Z80Jit_numFixups; i++) {
+        uint8_t* next = Z80Jit_fixups[i] + 4;
+        int32_t rel = (int32_t)(Z80Jit_labels[Z80Jit_fixupLabels[i]] - next);
+        memcpy(Z80Jit_fixups[i], &rel, sizeof(rel));
+    }
+
+    block->native = start;
+    block->nativeOps = (uint8_t)numOps;
+    Z80Jit_arenaUsed += Z80Jit_cursor - start;
+    Z80Jit_compiled++;
+#else
+    (void)block;
+#endif
+}
+
+/*
+Emits native code for ops that only move values between registers. Returns false for anything else.
+The DD and FD forms are the same ops with IX or IY in place of HL
+*/
+bool Z80Jit_emitInline(Z80MicroOp_t* op) {
+    Z80RegisterPair_t* hl = Z80Jit_indexPair(op->prefix);
+    if (hl == NULL)
+        return false;
+
+    uint8_t x = op->opcode >> 6;
+    uint8_t y = (op->opcode >> 3) & 0x07;
+    uint8_t z = op->opcode & 0x07;
+    uint8_t p = y >> 1;
+    uint8_t q = y & 1;
+
+    if (op->opcode == 0x00) { // NOP
+        return true;
+    }
+    if (x == 0 && z == 1 && q == 0) { // LD rr,nn: mov word [rr], nn
+        Z80Jit_emitRegisterAddress(Z80Jit_registerPair(p, hl));
+        Z80Jit_emit8(0x66); Z80Jit_emit8(0xC7); Z80Jit_emit8(0x00); Z80Jit_emit16((uint16_t)((op->operand0 << 8) | op->operand1));
+        return true;
+    }
+    if (x == 0 && z == 3) { // INC rr / DEC rr: inc / dec word [rr]
+        Z80Jit_emitRegisterAddress(Z80Jit_registerPair(p, hl));
+        Z80Jit_emit8(0x66); Z80Jit_emit8(0xFF); Z80Jit_emit8(q == 0 ? 0x00 : 0x08);
+        return true;
+    }
+    if (x == 0 && z == 6 && y != 6) { // LD r,n: mov byte [r], n
+        Z80Jit_emitRegisterAddress(Z80Jit_registerByte(y, hl));
+        Z80Jit_emit8(0xC6); Z80Jit_emit8(0x00); Z80Jit_emit8(op->operand0);
+        return true;
+    }
+    if (x == 1 && y != 6 && z != 6) { // LD r,r': mov cl, [r']; mov [r], cl
+        Z80Jit_emitRegisterAddress(Z80Jit_registerByte(z, hl));
+        Z80Jit_emit8(0x8A); Z80Jit_emit8(0x08);
+        Z80Jit_emitRegisterAddress(Z80Jit_registerByte(y, hl));
+        Z80Jit_emit8(0x88); Z80Jit_emit8(0x08);
+        return true;
+    }
+    return false;
+}
+
+/*
+Emits a call to the op's execute function, with the cInstr fields it reads filled in first
+*/
+void Z80Jit_emitCall(Z80MicroOp_t* op) {
+    Z80Jit_emitLoadAddress(&cInstr);
+    // mov word [rax + prefix], prefix
+    Z80Jit_emit8(0x66); Z80Jit_emit8(0xC7); Z80Jit_emit8(0x40); Z80Jit_emit8(offsetof(Z80_Instr_t, prefix)); Z80Jit_emit16(op->prefix);
+    // mov byte [rax + field], value
+    Z80Jit_emit8(0xC6); Z80Jit_emit8(0x40); Z80Jit_emit8(offsetof(Z80_Instr_t, opcode)); Z80Jit_emit8(op->opcode);
+    Z80Jit_emit8(0xC6); Z80Jit_emit8(0x40); Z80Jit_emit8(offsetof(Z80_Instr_t, operand0)); Z80Jit_emit8(op->operand0);
+    Z80Jit_emit8(0xC6); Z80Jit_emit8(0x40); Z80Jit_emit8(offsetof(Z80_Instr_t, operand1)); Z80Jit_emit8(op->operand1);
+    Z80Jit_emit8(0xC6); Z80Jit_emit8(0x40); Z80Jit_emit8(offsetof(Z80_Instr_t, instrByteLen)); Z80Jit_emit8(op->len);
+    // mov dword [rax + tStates], tStates
+    Z80Jit_emit8(0xC7); Z80Jit_emit8(0x40); Z80Jit_emit8(offsetof(Z80_Instr_t, tStates)); Z80Jit_emit32(op->tStates);
+
+    // call the execute function, then mov [rbx + response], eax
+    Z80Jit_emitLoadAddress((const void*)op->exec);
+    Z80Jit_emit8(0xFF); Z80Jit_emit8(0xD0);
+    Z80Jit_emit8(0x89); Z80Jit_emit8(0x43); Z80Jit_emit8(offsetof(Z80JitState_t, response));
+}
+
+/*
+The pair that stands for HL under the prefix: HL itself, IX or IY. NULL for the CB and ED tables
+*/
+Z80RegisterPair_t* Z80Jit_indexPair(uint16_t prefix) {
+    switch (prefix) {
+    case 0: return &Z80_registers.main.r.hl;
+    case PREFIX_IX: return &Z80_registers.ix;
+    case PREFIX_IY: return &Z80_registers.iy;
+    default: return NULL;
+    }
+}
+
+/*
+Address of an 8 bit register from its 3 bit opcode field: B, C, D, E, H, L, (HL), A. H and L are the halves of 'hl'
+*/
+uint8_t* Z80Jit_registerByte(uint8_t r, Z80RegisterPair_t* hl) {
+    switch (r) {
+    case 0: return &Z80_registers.main.r.bc.b.h;
+    case 1: return &Z80_registers.main.r.bc.b.l;
+    case 2: return &Z80_registers.main.r.de.b.h;
+    case 3: return &Z80_registers.main.r.de.b.l;
+    case 4: return &hl->b.h;
+    case 5: return &hl->b.l;
+    case 7: return &Z80_registers.main.r.af.b.h;
+    default: return NULL;
+    }
+}
+
+/*
+Address of a register pair from its 2 bit opcode field: BC, DE, HL, SP, with 'hl' for HL
+*/
+uint16_t* Z80Jit_registerPair(uint8_t p, Z80RegisterPair_t* hl) {
+    switch (p) {
+    case 0: return &BC;
+    case 1: return &DE;
+    case 2: return &hl->w;
+    default: return &SP;
+    }
+}
+
+/********************************************************************
+
+    Z80 JIT Emitter Functions
+
+********************************************************************/
+
+void Z80Jit_emit8(uint8_t value) {
+    *Z80Jit_cursor++ = value;
+}
+
+void Z80Jit_emit16(uint16_t value) {
+    memcpy(Z80Jit_cursor, &value, sizeof(value));
+    Z80Jit_cursor += sizeof(value);
+}
+
+void Z80Jit_emit32(uint32_t value) {
+    memcpy(Z80Jit_cursor, &value, sizeof(value));
+    Z80Jit_cursor += sizeof(value);
+}
+
+void Z80Jit_emit64(uint64_t value) {
+    memcpy(Z80Jit_cursor, &value, sizeof(value));
+    Z80Jit_cursor += sizeof(value);
+}
+
+/*
+mov rax, address
+*/
+void Z80Jit_emitLoadAddress(const void* address) {
+    Z80Jit_emit8(0x48); Z80Jit_emit8(0xB8);
+    Z80Jit_emit64((uint64_t)(uintptr_t)address);
+}
+
+/*
+lea rax, [r12 + offset], for a register in Z80_registers. Shorter than loading its full address
+*/
+void Z80Jit_emitRegisterAddress(const void* reg) {
+    uint8_t offset = (uint8_t)((const uint8_t*)reg - (const uint8_t*)&Z80_registers);
+    Z80Jit_emit8(0x49); Z80Jit_emit8(0x8D); Z80Jit_emit8(0x44); Z80Jit_emit8(0x24); Z80Jit_emit8(offset);
+}
+
+/*
+Emits a jump, conditional unless 'condition' is JIT_JMP, to an exit label bound later
+*/
+void Z80Jit_emitJump(uint8_t condition, int label) {
+    if (condition == JIT_JMP) {
+        Z80Jit_emit8(0xE9);
+    }
+    else {
+        Z80Jit_emit8(0x0F); Z80Jit_emit8(condition);
+    }
+    Z80Jit_fixups[Z80Jit_numFixups] = Z80Jit_cursor;
+    Z80Jit_fixupLabels[Z80Jit_numFixups] = label;
+    Z80Jit_numFixups++;
+    Z80Jit_emit32(0);
+}
+
+void Z80Jit_bindLabel(int label) {
+    Z80Jit_labels[label] = Z80Jit_cursor;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Jit.h : x86-64 compiler for hot blocks from the block cache. Only built on x86-64 with the System V calling convention
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "Z80.h"
+#include "Z80Block.h"
+#include "../Z0Machine.h"
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#define Z80JIT_SUPPORTED 1
+#else
+#define Z80JIT_SUPPORTED 0
+#endif
+
+/* Tuning */
+#define Z80_JIT_THRESHOLD 16 // Block entries before the block is compiled
+#define Z80_JIT_MIN_OPS 4 // Shorter blocks cost more to enter than compiling saves
+#define Z80_JIT_ARENA_SIZE (4 * 1024 * 1024)
+#define Z80_JIT_MAX_OP_BYTES 256 // Upper bound on the code emitted for one op
+#define Z80_JIT_MAX_FIXUPS (Z80_BLOCK_MAX_OPS * 4)
+
+/* Why compiled code returned */
+#define Z80_JIT_EXIT_END 0 // Ran all of its ops in sequence
+#define Z80_JIT_EXIT_LEAVE 1 // Branched, or ran out of T-states
+#define Z80_JIT_EXIT_RECHECK 2 // Something wrote to a page holding code
+#define Z80_JIT_EXIT_FAILED 3 // An op's execute function failed, its response is in the state
+
+/* Shared with the compiled code, which keeps a pointer to it in RBX */
+typedef struct Z80JitState {
+    uint64_t executed; // T-states run so far in this Z80Block_run()
+    uint64_t budget; // T-states Z80Block_run() was asked for
+    uint32_t codeWrites; // Z80Block_codeWrites when the block was entered
+    int32_t response; // Execute function response when the exit is Z80_JIT_EXIT_FAILED
+    int32_t opsDone; // Ops completed
+} Z80JitState_t;
+
+typedef int (*Z80JitFunction_t)(Z80JitState_t* state);
+
+/* JIT state */
+extern Z0_MACHINE_LOCAL bool Z80Jit_enabled;
+extern Z0_MACHINE_LOCAL uint8_t* Z80Jit_arena;
+extern Z0_MACHINE_LOCAL size_t Z80Jit_arenaUsed;
+
+/* Statistics */
+extern Z0_MACHINE_LOCAL uint64_t Z80Jit_compiled;
+extern Z0_MACHINE_LOCAL uint64_t Z80Jit_nativeEntries;
+extern Z0_MACHINE_LOCAL uint64_t Z80Jit_nativeOps;
+extern Z0_MACHINE_LOCAL uint64_t Z80Jit_inlinedOps;
+extern Z0_MACHINE_LOCAL uint64_t Z80Jit_arenaResets;
+
+/********************************************************************
+
+    Z80 JIT Functions
+
+********************************************************************/
+
+void Z80Jit_init();
+void Z80Jit_destroy();
+void Z80Jit_resetArena();
+bool Z80Jit_canEnter();
+int Z80Jit_enter(Z80Block_t* block, uint64_t* executed, uint64_t tStates);
+bool Z80Jit_isInterpretedOnly(Z80MicroOp_t* op);
+
+/********************************************************************
+
+    Z80 JIT Compiler Functions
+
+********************************************************************/
+
+void Z80Jit_compile(Z80Block_t* block);
+bool Z80Jit_emitInline(Z80MicroOp_t* op);
+void Z80Jit_emitCall(Z80MicroOp_t* op);
+Z80RegisterPair_t* Z80Jit_indexPair(uint16_t prefix);
+uint8_t* Z80Jit_registerByte(uint8_t r, Z80RegisterPair_t* hl);
+uint16_t* Z80Jit_registerPair(uint8_t p, Z80RegisterPair_t* hl);
+
+/********************************************************************
+
+    Z80 JIT Emitter Functions
+
+********************************************************************/
+
+void Z80Jit_emit8(uint8_t value);
+void Z80Jit_emit16(uint16_t value);
+void Z80Jit_emit32(uint32_t value);
+void Z80Jit_emit64(uint64_t value);
+void Z80Jit_emitLoadAddress(const void* address);
+void Z80Jit_emitRegisterAddress(const void* reg);
+void Z80Jit_emitJump(uint8_t condition, int label);
+void Z80Jit_bindLabel(int label);
@@ -0,0 +1,1399 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Lockstep.c : Lockstep engine. Runs several instances of the machine's CPU side by side, each with its own registers
+and writeable memory
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Z80Lockstep.h"
+#include "Z80.h"
+#include "Z80Instructions.h"
+#include "Z80Execute.h"
+#include "Z80Step.h"
+#include "Z80Flags.h"
+#include "Z80Alu.h"
+#include "Z80Block.h"
+#include "Z80DecodeCache.h"
+#include "Z80Threaded.h"
+#include "Z80Idle.h"
+
+#include "../Signals.h"
+#include "../SysIO/Log.h"
+#include "../Memory/MemoryController.h"
+
+/* Z80 Instruction */
+extern Z0_MACHINE_LOCAL Z80_Instr_t cInstr;
+
+/* Lanes */
+Z0_MACHINE_LOCAL Z80_CACHE_ALIGNED Z80Lanes_t Z80Lockstep_lanes;
+Z0_MACHINE_LOCAL int Z80Lockstep_nLanes = 0; // 0 when the engine isn't set up
+Z0_MACHINE_LOCAL Z80LockstepDecode_t* Z80Lockstep_decodes = NULL; // Z80_LOCKSTEP_DECODE_SIZE entries, allocated by Z80Lockstep_init()
+Z0_MACHINE_LOCAL Z80LockstepHome_t Z80Lockstep_home;
+Z0_MACHINE_LOCAL int Z80Lockstep_resident = -1; // Lane whose memory is swapped into the machine, -1 for the machine's own
+Z0_MACHINE_LOCAL bool Z80Lockstep_unmapped[MEMORY_NUM_PAGES];
+Z0_MACHINE_LOCAL uint8_t Z80Lockstep_floating = 0xFF;
+Z0_MACHINE_LOCAL uint8_t Z80Lockstep_discard = 0xFF;
+
+/* Statistics */
+Z0_MACHINE_LOCAL uint64_t Z80Lockstep_vectorInstructions = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Lockstep_vectorGroups = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Lockstep_scalarInstructions = 0;
+
+/*
+Lane loops run over every lane with a fixed trip count and no early exits, so the compiler can turn each one into a few
+vector instructions. Lanes outside the group keep their values by blending with the selection mask 'sel'
+*/
+#define Z80_LANES(l) for (int l = 0; l < Z80_LOCKSTEP_MAX_LANES; l++)
+#define LANE_SET(reg, l, value) reg[l] = (uint16_t)((reg[l] & ~sel[l]) | ((value) & sel[l]))
+#define LANE_MASK(condition) ((uint16_t)-(uint16_t)((condition) != 0))
+
+/* Flags of an 8 bit result held in a 16 bit lane */
+#define LANE_SZ(r) (((r) & (Z80FLAG_S | Z80FLAG_XY)) | ((r) == 0 ? Z80FLAG_Z : 0))
+#define LANE_P(r) (((~((r) ^ ((r) >> 1) ^ ((r) >> 2) ^ ((r) >> 3) ^ ((r) >> 4) ^ ((r) >> 5) ^ ((r) >> 6) ^ ((r) >> 7))) & 1) << Z80FLAGS_PV)
+#define LANE_KEEP_SZP (Z80FLAG_S | Z80FLAG_Z | Z80FLAG_PV)
+
+/* Flag tested by each branch condition, NZ Z NC C PO PE P M. Odd conditions branch when it is set */
+const uint16_t Z80Lockstep_conditionFlags[8] = { Z80FLAG_Z, Z80FLAG_Z, Z80FLAG_C, Z80FLAG_C, Z80FLAG_PV, Z80FLAG_PV, Z80FLAG_S, Z80FLAG_S };
+
+/********************************************************************
+
+    Z80 Lockstep Functions
+
+********************************************************************/
+
+/*
+Sets up 'nLanes' instances, each a copy of the machine as it stands: registers, T-state count and writeable memory.
+The caches keyed by address can't be shared between instances, so they are turned off until Z80Lockstep_destroy().
+Returns false if the machine can't run in lockstep
+*/
+bool Z80Lockstep_init(int nLanes) {
+    if (nLanes < 1 || nLanes > Z80_LOCKSTEP_MAX_LANES) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to start lockstep: %i lanes, the limit is %i\n", nLanes, Z80_LOCKSTEP_MAX_LANES);
+        return false;
+    }
+    if (Z80_engine != Z80Engine_Step) {
+        formattedLog(stdlog, LOGTYPE_WARN, "Lockstep needs the step engine\n");
+        return false;
+    }
+
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    memset(lanes, 0, sizeof(Z80Lanes_t));
+    Z80Lockstep_decodes = calloc(Z80_LOCKSTEP_DECODE_SIZE, sizeof(Z80LockstepDecode_t));
+    if (Z80Lockstep_decodes == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to start lockstep: can't allocate the decodes\n");
+        return false;
+    }
+    for (int l = 0; l < nLanes; l++) {
+        lanes->memory[l] = memoryController_createImage();
+        if (lanes->memory[l] == NULL) {
+            Z80Lockstep_nLanes = l;
+            Z80Lockstep_destroy();
+            return false;
+        }
+    }
+
+    Z80FLAGS_SYNC();
+    Z80Lockstep_home.registers = Z80_registers;
+    Z80Lockstep_home.iff1 = IFF1;
+    Z80Lockstep_home.iff2 = IFF2;
+    Z80Lockstep_home.interruptMode = interruptMode;
+    Z80Lockstep_home.halted = halted;
+    Z80Lockstep_home.eiPending = eiPending;
+    Z80Lockstep_home.tStates = Z80_tStates;
+    Z80Lockstep_home.instructions = Z80_instructionsExecuted;
+    Z80Lockstep_home.deadline = Z80_tStateDeadline;
+    Z80Lockstep_home.decodeCache = Z80DecodeCache_enabled;
+    Z80Lockstep_home.block = Z80Block_enabled;
+    Z80Lockstep_home.idle = Z80Idle_enabled;
+    Z80DecodeCache_enabled = false;
+    Z80Block_enabled = false;
+    Z80Idle_enabled = false;
+
+    for (int page = 0; page < MEMORY_NUM_PAGES; page++)
+        Z80Lockstep_unmapped[page] = memoryController_isUnmapped((uint16_t)(page << MEMORY_PAGE_SHIFT), 1 << MEMORY_PAGE_SHIFT);
+    Z80Lockstep_floating = 0xFF;
+
+    Z80Lockstep_nLanes = nLanes;
+    Z80Lockstep_resident = -1;
+    for (int l = 0; l < nLanes; l++)
+        Z80Lockstep_leave(l);
+
+    Z80Lockstep_vectorInstructions = 0;
+    Z80Lockstep_vectorGroups = 0;
+    Z80Lockstep_scalarInstructions = 0;
+    return true;
+}
+
+/*
+Drops the instances and puts the machine back as it was before Z80Lockstep_init()
+*/
+void Z80Lockstep_destroy() {
+    Z80Lockstep_swapTo(-1);
+    for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+        memoryController_destroyImage(Z80Lockstep_lanes.memory[l]);
+        Z80Lockstep_lanes.memory[l] = NULL;
+    }
+    free(Z80Lockstep_decodes);
+    Z80Lockstep_decodes = NULL;
+    if (Z80Lockstep_nLanes == 0)
+        return;
+    Z80Lockstep_nLanes = 0;
+
+    Z80_registers = Z80Lockstep_home.registers;
+    Z80FLAGS_DISCARD();
+    IFF1 = Z80Lockstep_home.iff1;
+    IFF2 = Z80Lockstep_home.iff2;
+    interruptMode = Z80Lockstep_home.interruptMode;
+    halted = Z80Lockstep_home.halted;
+    eiPending = Z80Lockstep_home.eiPending;
+    Z80_tStates = Z80Lockstep_home.tStates;
+    Z80_instructionsExecuted = Z80Lockstep_home.instructions;
+    Z80_tStateDeadline = Z80Lockstep_home.deadline;
+    Z80DecodeCache_enabled = Z80Lockstep_home.decodeCache;
+    Z80Block_enabled = Z80Lockstep_home.block;
+    Z80Idle_enabled = Z80Lockstep_home.idle;
+}
+
+/*
+Runs every instance for at least 'tStates' more T-states, each stopping on its first instruction boundary past them as
+Z80_runFor() would. The instance furthest behind leads, and every instance at its PC with the same code goes along
+*/
+void Z80Lockstep_run(uint64_t tStates) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+        lanes->target[l] = lanes->tStates[l] + tStates;
+        lanes->done[l] = lanes->failed[l];
+    }
+
+    while (true) {
+        int leader = -1;
+        for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+            if (lanes->done[l])
+                continue;
+            if (lanes->tStates[l] >= lanes->target[l]) {
+                lanes->done[l] = true;
+                continue;
+            }
+            if (leader < 0 || lanes->tStates[l] < lanes->tStates[leader])
+                leader = l;
+        }
+        if (leader < 0)
+            break;
+        Z80Lockstep_stepGroup(leader);
+    }
+}
+
+/*
+Runs one instruction on the leader and on every instance that can go along with it
+*/
+void Z80Lockstep_stepGroup(int leader) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    bool interruptRequest = signals_readSignal(&signal_INT);
+    uint16_t pc = lanes->pc[leader];
+
+    Z80LockstepDecode_t* decode = Z80Lockstep_canGroup(leader, interruptRequest) ? Z80Lockstep_decode(leader, pc) : NULL;
+    int members = 0;
+    memset(lanes->sel, 0, sizeof(lanes->sel));
+    if (decode != NULL) {
+        for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+            if (lanes->pc[l] == pc && !lanes->done[l] && Z80Lockstep_canGroup(l, interruptRequest) && (l == leader || Z80Lockstep_codeMatches(l, decode))) {
+                lanes->sel[l] = Z80_LOCKSTEP_LANE_ON;
+                members++;
+            }
+        }
+        if (Z80Lockstep_kernel(&decode->op)) {
+            Z80Lockstep_vectorInstructions += members;
+            Z80Lockstep_vectorGroups++;
+            return;
+        }
+    }
+
+    // No lane loop for this instruction. Every instance that would have gone along still takes its step now
+    if (members == 0)
+        lanes->sel[leader] = Z80_LOCKSTEP_LANE_ON;
+    for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+        if (lanes->sel[l])
+            Z80Lockstep_stepScalar(l);
+    }
+}
+
+/*
+Runs one instance through Z80_step(), with its state loaded into the machine. It keeps going while its next
+instruction has no decode for the lanes either, so code the lanes can't follow costs one memory swap rather than one
+per instruction
+*/
+void Z80Lockstep_stepScalar(int lane) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    Z80Lockstep_swapTo(lane);
+    Z80Lockstep_enter(lane);
+    int tStates;
+    do {
+        tStates = Z80_step();
+        Z80Lockstep_scalarInstructions++;
+    } while (tStates > 0 && Z80_tStates < lanes->target[lane] && Z80Lockstep_decode(lane, PC) == NULL);
+    Z80Lockstep_leave(lane);
+
+    if (tStates == 0) {
+        // The instance stops here, but the machine goes on for the others
+        formattedLog(debuglog, LOGTYPE_DEBUG, "Lockstep lane %i has failed at %04X\n", lane, lanes->pc[lane]);
+        lanes->failed[lane] = true;
+        lanes->done[lane] = true;
+        internalState = Z80State_Fetch;
+        signals_dropSignal(&signal_WAIT);
+    }
+}
+
+/*
+Loads an instance's registers and counters into the machine
+*/
+void Z80Lockstep_enter(int lane) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    AF = lanes->af[lane];
+    BC = lanes->bc[lane];
+    DE = lanes->de[lane];
+    HL = lanes->hl[lane];
+    IX = lanes->ix[lane];
+    IY = lanes->iy[lane];
+    SP = lanes->sp[lane];
+    PC = lanes->pc[lane];
+    IVMR = lanes->ir[lane];
+    Z80_registers.alternate = lanes->alternate[lane];
+    Z80FLAGS_DISCARD();
+    IFF1 = lanes->iff1[lane];
+    IFF2 = lanes->iff2[lane];
+    interruptMode = lanes->interruptMode[lane];
+    halted = lanes->halted[lane];
+    eiPending = lanes->eiPending[lane];
+    Z80_tStates = lanes->tStates[lane];
+    Z80_instructionsExecuted = lanes->instructions[lane];
+    Z80_tStateDeadline = lanes->target[lane];
+}
+
+/*
+Stores the machine's registers and counters into an instance. Also used to fill the lanes at the start
+*/
+void Z80Lockstep_leave(int lane) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    Z80FLAGS_SYNC();
+    lanes->af[lane] = AF;
+    lanes->bc[lane] = BC;
+    lanes->de[lane] = DE;
+    lanes->hl[lane] = HL;
+    lanes->ix[lane] = IX;
+    lanes->iy[lane] = IY;
+    lanes->sp[lane] = SP;
+    lanes->pc[lane] = PC;
+    lanes->ir[lane] = IVMR;
+    lanes->alternate[lane] = Z80_registers.alternate;
+    lanes->iff1[lane] = IFF1;
+    lanes->iff2[lane] = IFF2;
+    lanes->interruptMode[lane] = interruptMode;
+    lanes->halted[lane] = halted;
+    lanes->eiPending[lane] = eiPending;
+    lanes->tStates[lane] = Z80_tStates;
+    lanes->instructions[lane] = Z80_instructionsExecuted;
+}
+
+/*
+True if an instance can run its next instruction in a lane loop. Halted instances and those with an interrupt to take
+need Z80_step()
+*/
+bool Z80Lockstep_canGroup(int lane, bool interruptRequest) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    if (lanes->halted[lane] || nmiPending || Z80_wait)
+        return false;
+    // Straight after EI no interrupt is taken, the lane loop only has to clear eiPending
+    return lanes->eiPending[lane] || !(lanes->iff1[lane] && interruptRequest);
+}
+
+/********************************************************************
+
+    Z80 Lockstep Memory Functions
+
+********************************************************************/
+
+/*
+Swaps a lane's memory into the machine, -1 for the machine's own. The last lane swapped in stays there until another
+is wanted, as consecutive steps through Z80_step() are often on the same lane
+*/
+void Z80Lockstep_swapTo(int lane) {
+    if (lane == Z80Lockstep_resident)
+        return;
+    if (Z80Lockstep_resident >= 0)
+        memoryController_swapImage(Z80Lockstep_lanes.memory[Z80Lockstep_resident]);
+    if (lane >= 0)
+        memoryController_swapImage(Z80Lockstep_lanes.memory[lane]);
+    Z80Lockstep_resident = lane;
+}
+
+/*
+Where an instance's byte at 'address' is kept, NULL if the memory controller has no direct page for it. The resident
+lane's pages are the machine's. Pages no device covers are the same for every instance: they read Z80Lockstep_floating
+and write to Z80Lockstep_discard
+*/
+uint8_t* Z80Lockstep_readPointer(int lane, uint16_t address) {
+    uint8_t* page = (lane == Z80Lockstep_resident ? memoryController_readPages : Z80Lockstep_lanes.memory[lane]->readPages)[address >> MEMORY_PAGE_SHIFT];
+    if (page == NULL)
+        return Z80Lockstep_unmapped[address >> MEMORY_PAGE_SHIFT] ? &Z80Lockstep_floating : NULL;
+    return page + (address & MEMORY_PAGE_MASK);
+}
+
+uint8_t* Z80Lockstep_writePointer(int lane, uint16_t address) {
+    uint8_t* page = (lane == Z80Lockstep_resident ? memoryController_writePages : Z80Lockstep_lanes.memory[lane]->writePages)[address >> MEMORY_PAGE_SHIFT];
+    if (page == NULL)
+        return Z80Lockstep_unmapped[address >> MEMORY_PAGE_SHIFT] ? &Z80Lockstep_discard : NULL;
+    return page + (address & MEMORY_PAGE_MASK);
+}
+
+uint8_t Z80Lockstep_readByte(int lane, uint16_t address) {
+    uint8_t* pointer = Z80Lockstep_readPointer(lane, address);
+    if (pointer != NULL)
+        return *pointer;
+
+    Z80Lockstep_swapTo(lane);
+    return memoryController_directRead(address);
+}
+
+void Z80Lockstep_writeByte(int lane, uint16_t address, uint8_t value) {
+    Z80Lockstep_swapTo(lane);
+    memoryController_directWrite(address, value);
+}
+
+/*
+Decodes the instruction an instance has at 'pc'. ROM instructions come from the threaded code, which every instance
+shares, and the rest from the lane decodes, decoding again if the instance's bytes differ.
+Returns NULL if the instruction's bytes aren't all behind direct pages, as the other lanes couldn't check them
+*/
+Z80LockstepDecode_t* Z80Lockstep_decode(int lane, uint16_t pc) {
+    Z80LockstepDecode_t* decode = &Z80Lockstep_decodes[pc & Z80_LOCKSTEP_DECODE_MASK];
+    if (decode->valid && decode->pc == pc && Z80Lockstep_codeMatches(lane, decode))
+        return decode;
+
+    decode->valid = false;
+    Z80MicroOp_t* threaded = Z80Threaded_lookup(pc);
+    if (threaded != NULL) {
+        decode->op = *threaded;
+    }
+    else {
+        Z80Lockstep_swapTo(lane);
+        uint8_t m1Cycles = Z80_decodeAt(pc);
+        Z80Block_captureOp(&decode->op, m1Cycles);
+        internalState = Z80State_Fetch;
+    }
+    if (decode->op.len > Z80_LOCKSTEP_MAX_INSTR_LEN)
+        return NULL;
+
+    for (int i = 0; i < decode->op.len; i++) {
+        uint8_t* pointer = Z80Lockstep_readPointer(lane, (uint16_t)(pc + i));
+        if (pointer == NULL)
+            return NULL;
+        decode->bytes[i] = *pointer;
+    }
+    decode->pc = pc;
+    decode->valid = true;
+    return decode;
+}
+
+bool Z80Lockstep_codeMatches(int lane, const Z80LockstepDecode_t* decode) {
+    for (int i = 0; i < decode->op.len; i++) {
+        uint8_t* pointer = Z80Lockstep_readPointer(lane, (uint16_t)(decode->pc + i));
+        if (pointer == NULL || *pointer != decode->bytes[i])
+            return false;
+    }
+    return true;
+}
+
+/*
+Reads the byte at each lane's address for the lanes in 'mask'. Returns false, having changed nothing, if any of them
+has no direct page there
+*/
+bool Z80Lockstep_load(const uint16_t* mask, const uint16_t* addresses, uint16_t* values) {
+    for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+        if (!mask[l])
+            continue;
+        uint8_t* pointer = Z80Lockstep_readPointer(l, addresses[l]);
+        if (pointer == NULL)
+            return false;
+        values[l] = *pointer;
+    }
+    return true;
+}
+
+/*
+A word is read low byte first from 'addresses', wrapping at the top of memory
+*/
+bool Z80Lockstep_loadWord(const uint16_t* mask, const uint16_t* addresses, uint16_t* values) {
+    for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+        if (!mask[l])
+            continue;
+        uint8_t* low = Z80Lockstep_readPointer(l, addresses[l]);
+        uint8_t* high = Z80Lockstep_readPointer(l, (uint16_t)(addresses[l] + 1));
+        if (low == NULL || high == NULL)
+            return false;
+        values[l] = (uint16_t)((*high << 8) | *low);
+    }
+    return true;
+}
+
+/*
+Finds where each lane in 'mask' would store to its address, before anything has been changed, so an instruction
+either runs in the lane loop or falls back to Z80_step() whole
+*/
+bool Z80Lockstep_prepareStore(const uint16_t* mask, const uint16_t* addresses, uint8_t** pointers) {
+    for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+        if (!mask[l])
+            continue;
+        pointers[l] = Z80Lockstep_writePointer(l, addresses[l]);
+        if (pointers[l] == NULL)
+            return false;
+    }
+    return true;
+}
+
+bool Z80Lockstep_prepareWord(const uint16_t* mask, const uint16_t* addresses, uint8_t** low, uint8_t** high) {
+    uint16_t highAddresses[Z80_LOCKSTEP_MAX_LANES];
+    Z80_LANES(l)
+        highAddresses[l] = (uint16_t)(addresses[l] + 1);
+    return Z80Lockstep_prepareStore(mask, addresses, low) && Z80Lockstep_prepareStore(mask, highAddresses, high);
+}
+
+/*
+Stores a byte or word through pointers from Z80Lockstep_prepareStore() / Z80Lockstep_prepareWord()
+*/
+void Z80Lockstep_store(const uint16_t* mask, uint8_t** pointers, const uint16_t* values) {
+    for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+        if (mask[l])
+            *pointers[l] = (uint8_t)values[l];
+    }
+}
+
+void Z80Lockstep_storeWord(const uint16_t* mask, uint8_t** low, uint8_t** high, const uint16_t* values) {
+    for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+        if (mask[l]) {
+            *high[l] = (uint8_t)(values[l] >> 8);
+            *low[l] = (uint8_t)values[l];
+        }
+    }
+}
+
+/********************************************************************
+
+    Z80 Lockstep Lane Loops
+
+********************************************************************/
+
+/*
+Runs an unprefixed instruction on every selected lane. Anything that might touch memory without a direct page, or state
+kept outside the lanes' registers, is left to Z80_step().
+Returns false, having changed nothing, if the instruction can't run in lane loops
+*/
+bool Z80Lockstep_kernel(const Z80MicroOp_t* op) {
+    if (op->prefix == PREFIX_BITS)
+        return Z80Lockstep_kernelBits(op);
+    if (op->prefix == PREFIX_EXX)
+        return Z80Lockstep_kernelExtended(op);
+    if (op->prefix != 0)
+        return false;
+
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    uint16_t* sel = lanes->sel;
+    uint8_t opcode = op->opcode;
+    int x = opcode >> 6;
+    int y = (opcode >> 3) & 7;
+    int z = opcode & 7;
+    int p = y >> 1;
+    int q = y & 1;
+    uint16_t nn = (uint16_t)((op->operand0 << 8) | op->operand1);
+    int8_t displacement = (int8_t)op->operand0;
+
+    uint16_t values[Z80_LOCKSTEP_MAX_LANES] = { 0 };
+    uint16_t addresses[Z80_LOCKSTEP_MAX_LANES] = { 0 };
+    uint16_t taken[Z80_LOCKSTEP_MAX_LANES] = { 0 };
+    uint8_t* low[Z80_LOCKSTEP_MAX_LANES];
+    uint8_t* high[Z80_LOCKSTEP_MAX_LANES];
+
+    switch (x) {
+    case 0:
+        switch (z) {
+        case 0:
+            if (y == 0) { // NOP
+                Z80Lockstep_advance(op);
+            }
+            else if (y == 1) { // EX AF,AF'
+                Z80Lockstep_advance(op);
+                Z80Lockstep_exchange(false);
+            }
+            else if (y == 2) { // DJNZ e
+                Z80Lockstep_advance(op);
+                Z80_LANES(l) {
+                    uint16_t b = (uint16_t)(((lanes->bc[l] >> 8) - 1) & 0xFF);
+                    LANE_SET(lanes->bc, l, (b << 8) | (lanes->bc[l] & 0xFF));
+                    taken[l] = sel[l] & LANE_MASK(b);
+                }
+                Z80Lockstep_branch(taken, TSTATES_BRANCH_JR);
+                Z80_LANES(l)
+                    lanes->pc[l] = (uint16_t)(lanes->pc[l] + ((uint16_t)displacement & taken[l]));
+            }
+            else { // JR e, JR cc,e
+                Z80Lockstep_advance(op);
+                if (y == 3)
+                    memcpy(taken, sel, sizeof(taken));
+                else {
+                    Z80Lockstep_taken(y - 4, taken);
+                    Z80Lockstep_branch(taken, TSTATES_BRANCH_JR);
+                }
+                Z80_LANES(l)
+                    lanes->pc[l] = (uint16_t)(lanes->pc[l] + ((uint16_t)displacement & taken[l]));
+            }
+            return true;
+
+        case 1:
+            Z80Lockstep_advance(op);
+            if (q == 0) { // LD rr,nn
+                uint16_t* rr = Z80Lockstep_pair(p, false);
+                Z80_LANES(l)
+                    LANE_SET(rr, l, nn);
+            }
+            else { // ADD HL,rr
+                uint16_t* rr = Z80Lockstep_pair(p, false);
+                Z80_LANES(l) {
+                    uint32_t a = lanes->hl[l];
+                    uint32_t b = rr[l];
+                    uint32_t r = a + b;
+                    uint16_t f = (uint16_t)((lanes->af[l] & LANE_KEEP_SZP) | (((a ^ b ^ r) >> 8) & Z80FLAG_H) | ((r >> 8) & Z80FLAG_XY) | ((r >> 16) & Z80FLAG_C));
+                    LANE_SET(lanes->af, l, (lanes->af[l] & 0xFF00) | f);
+                    LANE_SET(lanes->hl, l, r);
+                }
+            }
+            return true;
+
+        case 2: {
+            // LD (BC),A  LD A,(BC)  LD (DE),A  LD A,(DE)  LD (nn),HL  LD HL,(nn)  LD (nn),A  LD A,(nn)
+            uint16_t* pair = y < 2 ? lanes->bc : y < 4 ? lanes->de : NULL;
+            Z80_LANES(l)
+                addresses[l] = pair != NULL ? pair[l] : nn;
+            if (y == 4) {
+                if (!Z80Lockstep_prepareWord(sel, addresses, low, high))
+                    return false;
+                Z80Lockstep_advance(op);
+                Z80Lockstep_storeWord(sel, low, high, lanes->hl);
+            }
+            else if (y == 5) {
+                if (!Z80Lockstep_loadWord(sel, addresses, values))
+                    return false;
+                Z80Lockstep_advance(op);
+                Z80_LANES(l)
+                    LANE_SET(lanes->hl, l, values[l]);
+            }
+            else if (q == 0) {
+                if (!Z80Lockstep_prepareStore(sel, addresses, low))
+                    return false;
+                Z80Lockstep_advance(op);
+                Z80Lockstep_getR(7, values);
+                Z80Lockstep_store(sel, low, values);
+            }
+            else {
+                if (!Z80Lockstep_load(sel, addresses, values))
+                    return false;
+                Z80Lockstep_advance(op);
+                Z80Lockstep_setR(7, values);
+            }
+            return true;
+        }
+
+        case 3: { // INC rr, DEC rr
+            Z80Lockstep_advance(op);
+            uint16_t* rr = Z80Lockstep_pair(p, false);
+            uint16_t step = q == 0 ? 1 : 0xFFFF;
+            Z80_LANES(l)
+                LANE_SET(rr, l, rr[l] + step);
+            return true;
+        }
+
+        case 4:
+        case 5: // INC r, DEC r
+            if (y == 6) {
+                if (!Z80Lockstep_load(sel, lanes->hl, values) || !Z80Lockstep_prepareStore(sel, lanes->hl, low))
+                    return false;
+                Z80Lockstep_advance(op);
+                Z80Lockstep_incDec(z == 5, values);
+                Z80Lockstep_store(sel, low, values);
+            }
+            else {
+                Z80Lockstep_advance(op);
+                Z80Lockstep_getR(y, values);
+                Z80Lockstep_incDec(z == 5, values);
+                Z80Lockstep_setR(y, values);
+            }
+            return true;
+
+        case 6: // LD r,n
+            Z80_LANES(l)
+                values[l] = op->operand0;
+            if (y == 6) {
+                if (!Z80Lockstep_prepareStore(sel, lanes->hl, low))
+                    return false;
+                Z80Lockstep_advance(op);
+                Z80Lockstep_store(sel, low, values);
+            }
+            else {
+                Z80Lockstep_advance(op);
+                Z80Lockstep_setR(y, values);
+            }
+            return true;
+
+        default: // RLCA RRCA RLA RRA DAA CPL SCF CCF
+            if (y == 4)
+                return false;
+            Z80Lockstep_advance(op);
+            Z80Lockstep_accumulator(y);
+            return true;
+        }
+
+    case 1:
+        if (opcode == 0x76) // HALT
+            return false;
+        if (z == 6) { // LD r,(HL)
+            if (!Z80Lockstep_load(sel, lanes->hl, values))
+                return false;
+            Z80Lockstep_advance(op);
+            Z80Lockstep_setR(y, values);
+        }
+        else if (y == 6) { // LD (HL),r
+            if (!Z80Lockstep_prepareStore(sel, lanes->hl, low))
+                return false;
+            Z80Lockstep_advance(op);
+            Z80Lockstep_getR(z, values);
+            Z80Lockstep_store(sel, low, values);
+        }
+        else { // LD r,r'
+            Z80Lockstep_advance(op);
+            Z80Lockstep_getR(z, values);
+            Z80Lockstep_setR(y, values);
+        }
+        return true;
+
+    case 2: // ALU A,r  ALU A,(HL)
+        if (z == 6) {
+            if (!Z80Lockstep_load(sel, lanes->hl, values))
+                return false;
+        }
+        else {
+            Z80Lockstep_getR(z, values);
+        }
+        Z80Lockstep_advance(op);
+        Z80Lockstep_alu(y, values);
+        return true;
+
+    default:
+        break;
+    }
+
+    switch (z) {
+    case 0: // RET cc
+        Z80Lockstep_taken(y, taken);
+        if (!Z80Lockstep_loadWord(taken, lanes->sp, values))
+            return false;
+        Z80Lockstep_advance(op);
+        Z80Lockstep_branch(taken, TSTATES_BRANCH_RET);
+        Z80Lockstep_return(taken, values);
+        return true;
+
+    case 1:
+        if (q == 0) { // POP rr
+            if (!Z80Lockstep_loadWord(sel, lanes->sp, values))
+                return false;
+            Z80Lockstep_advance(op);
+            uint16_t* rr = Z80Lockstep_pair(p, true);
+            Z80_LANES(l) {
+                LANE_SET(rr, l, values[l]);
+                LANE_SET(lanes->sp, l, lanes->sp[l] + 2);
+            }
+        }
+        else if (p == 0) { // RET
+            if (!Z80Lockstep_loadWord(sel, lanes->sp, values))
+                return false;
+            Z80Lockstep_advance(op);
+            Z80Lockstep_return(sel, values);
+        }
+        else if (p == 1) { // EXX
+            Z80Lockstep_advance(op);
+            Z80Lockstep_exchange(true);
+        }
+        else { // JP (HL), LD SP,HL
+            Z80Lockstep_advance(op);
+            uint16_t* rr = p == 2 ? lanes->pc : lanes->sp;
+            Z80_LANES(l)
+                LANE_SET(rr, l, lanes->hl[l]);
+        }
+        return true;
+
+    case 2: // JP cc,nn
+        Z80Lockstep_advance(op);
+        Z80Lockstep_taken(y, taken);
+        Z80_LANES(l)
+            lanes->pc[l] = (uint16_t)((lanes->pc[l] & ~taken[l]) | (nn & taken[l]));
+        return true;
+
+    case 3:
+        if (y == 0) { // JP nn
+            Z80Lockstep_advance(op);
+            Z80_LANES(l)
+                LANE_SET(lanes->pc, l, nn);
+        }
+        else if (y == 2 || y == 3) { // OUT (n),A  IN A,(n)
+            Z80_LANES(l) {
+                addresses[l] = (uint16_t)((lanes->af[l] & 0xFF00) | op->operand0);
+                values[l] = lanes->af[l] >> 8;
+            }
+            if (y == 2)
+                Z80Lockstep_out(addresses, values);
+            else
+                Z80Lockstep_in(addresses, values);
+            Z80Lockstep_advance(op);
+            if (y == 3)
+                Z80Lockstep_setR(7, values);
+        }
+        else if (y == 4) { // EX (SP),HL
+            if (!Z80Lockstep_loadWord(sel, lanes->sp, values) || !Z80Lockstep_prepareWord(sel, lanes->sp, low, high))
+                return false;
+            Z80Lockstep_advance(op);
+            Z80Lockstep_storeWord(sel, low, high, lanes->hl);
+            Z80_LANES(l)
+                LANE_SET(lanes->hl, l, values[l]);
+        }
+        else if (y == 5) { // EX DE,HL
+            Z80Lockstep_advance(op);
+            Z80_LANES(l) {
+                uint16_t de = lanes->de[l];
+                LANE_SET(lanes->de, l, lanes->hl[l]);
+                LANE_SET(lanes->hl, l, de);
+            }
+        }
+        else if (y == 6) { // DI
+            Z80Lockstep_advance(op);
+            for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+                if (sel[l]) {
+                    lanes->iff1[l] = false;
+                    lanes->iff2[l] = false;
+                }
+            }
+        }
+        else if (y == 7) { // EI
+            Z80Lockstep_advance(op);
+            for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+                if (sel[l]) {
+                    lanes->iff1[l] = true;
+                    lanes->iff2[l] = true;
+                    lanes->eiPending[l] = true;
+                }
+            }
+        }
+        else { // The CB prefix
+            return false;
+        }
+        return true;
+
+    case 4: // CALL cc,nn
+        Z80Lockstep_taken(y, taken);
+        if (!Z80Lockstep_call(op, taken, nn))
+            return false;
+        Z80Lockstep_branch(taken, TSTATES_BRANCH_CALL);
+        return true;
+
+    case 5:
+        if (q == 0) { // PUSH rr
+            uint16_t* rr = Z80Lockstep_pair(p, true);
+            Z80_LANES(l)
+                addresses[l] = (uint16_t)(lanes->sp[l] - 2);
+            if (!Z80Lockstep_prepareWord(sel, addresses, low, high))
+                return false;
+            Z80Lockstep_advance(op);
+            Z80Lockstep_storeWord(sel, low, high, rr);
+            Z80_LANES(l)
+                LANE_SET(lanes->sp, l, addresses[l]);
+            return true;
+        }
+        if (p == 0) // CALL nn
+            return Z80Lockstep_call(op, sel, nn);
+        return false; // DD, ED and FD prefixes
+
+    case 6: // ALU A,n
+        Z80_LANES(l)
+            values[l] = op->operand0;
+        Z80Lockstep_advance(op);
+        Z80Lockstep_alu(y, values);
+        return true;
+
+    default: // RST
+        return Z80Lockstep_call(op, sel, (uint16_t)(y * 8));
+    }
+}
+
+/*
+CB prefixed rotates, shifts and bit operations on a register or (HL)
+*/
+bool Z80Lockstep_kernelBits(const Z80MicroOp_t* op) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    uint16_t* sel = lanes->sel;
+    int x = op->opcode >> 6;
+    int y = (op->opcode >> 3) & 7;
+    int z = op->opcode & 7;
+    uint16_t values[Z80_LOCKSTEP_MAX_LANES] = { 0 };
+    uint8_t* pointers[Z80_LOCKSTEP_MAX_LANES];
+
+    if (z == 6) {
+        if (!Z80Lockstep_load(sel, lanes->hl, values) || (x != 1 && !Z80Lockstep_prepareStore(sel, lanes->hl, pointers)))
+            return false;
+    }
+    else {
+        Z80Lockstep_getR(z, values);
+    }
+    Z80Lockstep_advance(op);
+
+    uint16_t mask = (uint16_t)(1 << y);
+    switch (x) {
+    case 0:
+        Z80Lockstep_rotate(y, values);
+        break;
+    case 1: {
+        // BIT takes the undocumented bits from the operand, or from H for (HL)
+        uint16_t* xySource = z == 6 ? lanes->hl : values;
+        int xyShift = z == 6 ? 8 : 0;
+        Z80_LANES(l) {
+            uint16_t tested = values[l] & mask;
+            uint16_t f = (uint16_t)((lanes->af[l] & Z80FLAG_C) | Z80FLAG_H | ((xySource[l] >> xyShift) & Z80FLAG_XY) | (tested == 0 ? Z80FLAG_Z | Z80FLAG_PV : 0) | (tested & Z80FLAG_S));
+            LANE_SET(lanes->af, l, (lanes->af[l] & 0xFF00) | f);
+        }
+        return true;
+    }
+    case 2:
+        Z80_LANES(l)
+            values[l] &= ~mask;
+        break;
+    default:
+        Z80_LANES(l)
+            values[l] |= mask;
+        break;
+    }
+
+    if (z == 6)
+        Z80Lockstep_store(sel, pointers, values);
+    else
+        Z80Lockstep_setR(z, values);
+    return true;
+}
+
+/*
+The ED prefixed instructions that only touch registers, memory through direct pages and ports. Block instructions,
+RRD, RLD and the returns are left to Z80_step()
+*/
+bool Z80Lockstep_kernelExtended(const Z80MicroOp_t* op) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    uint16_t* sel = lanes->sel;
+    int x = op->opcode >> 6;
+    int y = (op->opcode >> 3) & 7;
+    int z = op->opcode & 7;
+    int p = y >> 1;
+    int q = y & 1;
+    uint16_t nn = (uint16_t)((op->operand0 << 8) | op->operand1);
+    uint16_t values[Z80_LOCKSTEP_MAX_LANES] = { 0 };
+    uint16_t addresses[Z80_LOCKSTEP_MAX_LANES] = { 0 };
+    uint8_t* low[Z80_LOCKSTEP_MAX_LANES];
+    uint8_t* high[Z80_LOCKSTEP_MAX_LANES];
+    const int modes[8] = { 0, 0, 1, 2, 0, 0, 1, 2 };
+
+    if (x != 1)
+        return false;
+
+    switch (z) {
+    case 0: // IN r,(C), IN (C)
+        Z80Lockstep_in(lanes->bc, values);
+        Z80Lockstep_advance(op);
+        Z80_LANES(l) {
+            uint16_t f = (uint16_t)((lanes->af[l] & Z80FLAG_C) | LANE_SZ(values[l]) | LANE_P(values[l]));
+            LANE_SET(lanes->af, l, (lanes->af[l] & 0xFF00) | f);
+        }
+        if (y != 6)
+            Z80Lockstep_setR(y, values);
+        return true;
+
+    case 1: // OUT (C),r, OUT (C),0
+        if (y == 6)
+            memset(values, 0, sizeof(values));
+        else
+            Z80Lockstep_getR(y, values);
+        Z80Lockstep_out(lanes->bc, values);
+        Z80Lockstep_advance(op);
+        return true;
+
+    case 2: { // SBC HL,rr, ADC HL,rr
+        Z80Lockstep_advance(op);
+        uint16_t* rr = Z80Lockstep_pair(p, false);
+        bool subtract = q == 0;
+        Z80_LANES(l) {
+            uint32_t a = lanes->hl[l];
+            uint32_t b = rr[l];
+            uint32_t carry = lanes->af[l] & Z80FLAG_C;
+            uint32_t r32 = subtract ? a - b - carry : a + b + carry;
+            uint16_t r = (uint16_t)r32;
+            uint32_t overflow = subtract ? ((a ^ b) & (a ^ r)) : ((a ^ ~b) & (a ^ r));
+            uint16_t f = (uint16_t)(((r >> 8) & (Z80FLAG_S | Z80FLAG_XY)) | (r == 0 ? Z80FLAG_Z : 0) | (subtract ? Z80FLAG_N : 0) | (((a ^ b ^ r) >> 8) & Z80FLAG_H) |
+                ((overflow & 0x8000) >> 13) | ((r32 >> 16) & Z80FLAG_C));
+            LANE_SET(lanes->af, l, (lanes->af[l] & 0xFF00) | f);
+            LANE_SET(lanes->hl, l, r);
+        }
+        return true;
+    }
+
+    case 3: // LD (nn),rr, LD rr,(nn)
+        Z80_LANES(l)
+            addresses[l] = nn;
+        if (q == 0) {
+            if (!Z80Lockstep_prepareWord(sel, addresses, low, high))
+                return false;
+            Z80Lockstep_advance(op);
+            Z80Lockstep_storeWord(sel, low, high, Z80Lockstep_pair(p, false));
+        }
+        else {
+            if (!Z80Lockstep_loadWord(sel, addresses, values))
+                return false;
+            Z80Lockstep_advance(op);
+            uint16_t* rr = Z80Lockstep_pair(p, false);
+            Z80_LANES(l)
+                LANE_SET(rr, l, values[l]);
+        }
+        return true;
+
+    case 4: // NEG, a SUB of A from 0
+        Z80Lockstep_advance(op);
+        Z80Lockstep_getR(7, values);
+        Z80_LANES(l)
+            LANE_SET(lanes->af, l, lanes->af[l] & 0x00FF);
+        Z80Lockstep_alu(2, values);
+        return true;
+
+    case 6: // IM
+        Z80Lockstep_advance(op);
+        for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+            if (sel[l])
+                lanes->interruptMode[l] = modes[y];
+        }
+        return true;
+
+    case 7:
+        if (y >= 4) // RRD, RLD and two NOPs
+            return false;
+        Z80Lockstep_advance(op);
+        Z80_LANES(l) {
+            uint16_t a = lanes->af[l] >> 8;
+            uint16_t ir = lanes->ir[l];
+            uint16_t iff2 = (uint16_t)(lanes->iff2[l] ? Z80FLAG_PV : 0);
+            switch (y) {
+            case 0: // LD I,A
+                LANE_SET(lanes->ir, l, (ir & 0x00FF) | (a << 8));
+                break;
+            case 1: // LD R,A
+                LANE_SET(lanes->ir, l, (ir & 0xFF00) | a);
+                break;
+            default: { // LD A,I  LD A,R, with IFF2 in P/V
+                uint16_t v = y == 2 ? ir >> 8 : ir & 0xFF;
+                uint16_t f = (uint16_t)((lanes->af[l] & Z80FLAG_C) | LANE_SZ(v) | iff2);
+                LANE_SET(lanes->af, l, (v << 8) | f);
+                break;
+            }
+            }
+        }
+        return true;
+
+    default: // RETN, RETI
+        return false;
+    }
+}
+
+/*
+RLC RRC RL RR SLA SRA SLL SRL of 'values' in place, for 'op' from the opcode's y field
+*/
+void Z80Lockstep_rotate(int op, uint16_t* values) {
+    uint16_t* sel = Z80Lockstep_lanes.sel;
+    uint16_t* af = Z80Lockstep_lanes.af;
+    Z80_LANES(l) {
+        uint16_t v = values[l];
+        uint16_t carryIn = af[l] & Z80FLAG_C;
+        uint16_t r;
+        uint16_t carry;
+        switch (op) {
+        case 0: r = (v << 1) | (v >> 7); carry = v >> 7; break;
+        case 1: r = (v >> 1) | (v << 7); carry = v & 1; break;
+        case 2: r = (v << 1) | carryIn; carry = v >> 7; break;
+        case 3: r = (v >> 1) | (carryIn << 7); carry = v & 1; break;
+        case 4: r = v << 1; carry = v >> 7; break;
+        case 5: r = (v >> 1) | (v & 0x80); carry = v & 1; break;
+        case 6: r = (v << 1) | 1; carry = v >> 7; break;
+        default: r = v >> 1; carry = v & 1; break;
+        }
+        r &= 0xFF;
+        LANE_SET(af, l, (af[l] & 0xFF00) | LANE_SZ(r) | LANE_P(r) | carry);
+        values[l] = r;
+    }
+}
+
+/*
+EX AF,AF' or, if 'exx', EXX on the selected lanes
+*/
+void Z80Lockstep_exchange(bool exx) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+        if (!lanes->sel[l])
+            continue;
+        Z80RegisterBank_t* alternate = &lanes->alternate[l];
+        uint16_t swap;
+        if (exx) {
+            swap = lanes->bc[l]; lanes->bc[l] = alternate->r.bc.w; alternate->r.bc.w = swap;
+            swap = lanes->de[l]; lanes->de[l] = alternate->r.de.w; alternate->r.de.w = swap;
+            swap = lanes->hl[l]; lanes->hl[l] = alternate->r.hl.w; alternate->r.hl.w = swap;
+        }
+        else {
+            swap = lanes->af[l]; lanes->af[l] = alternate->r.af.w; alternate->r.af.w = swap;
+        }
+    }
+}
+
+/*
+Port reads and writes for the selected lanes. Every instance shares the machine's devices, which see the accesses in
+lane order with the CPU clock at the lane's own count, just as they would from Z80_step()
+*/
+void Z80Lockstep_in(const uint16_t* ports, uint16_t* values) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    uint64_t tStates = Z80_tStates;
+    for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+        if (lanes->sel[l]) {
+            Z80_tStates = lanes->tStates[l];
+            values[l] = Z80_inPort(ports[l]);
+        }
+    }
+    Z80_tStates = tStates;
+}
+
+void Z80Lockstep_out(const uint16_t* ports, const uint16_t* values) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    uint64_t tStates = Z80_tStates;
+    for (int l = 0; l < Z80Lockstep_nLanes; l++) {
+        if (lanes->sel[l]) {
+            Z80_tStates = lanes->tStates[l];
+            Z80_outPort(ports[l], (uint8_t)values[l]);
+        }
+    }
+    Z80_tStates = tStates;
+}
+
+/*
+Moves the selected lanes past the instruction, counting its base T-states and opcode fetches
+*/
+void Z80Lockstep_advance(const Z80MicroOp_t* op) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    uint16_t* sel = lanes->sel;
+    Z80_LANES(l) {
+        LANE_SET(lanes->pc, l, lanes->pc[l] + op->len);
+        LANE_SET(lanes->ir, l, (lanes->ir[l] & 0xFF80) | ((lanes->ir[l] + op->m1Cycles) & 0x7F));
+        lanes->tStates[l] += sel[l] & op->tStates;
+        lanes->instructions[l] += sel[l] & 1;
+        lanes->eiPending[l] = lanes->eiPending[l] && !sel[l];
+    }
+}
+
+/*
+Adds a taken branch's extra T-states to the lanes in 'taken'
+*/
+void Z80Lockstep_branch(const uint16_t* taken, uint16_t tStates) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    Z80_LANES(l)
+        lanes->tStates[l] += taken[l] & tStates;
+}
+
+/*
+Selects the lanes where 'condition' holds, out of those in the group
+*/
+void Z80Lockstep_taken(int condition, uint16_t* taken) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    uint16_t flag = Z80Lockstep_conditionFlags[condition];
+    uint16_t whenSet = LANE_MASK(condition & 1);
+    Z80_LANES(l)
+        taken[l] = lanes->sel[l] & ~(LANE_MASK(lanes->af[l] & flag) ^ whenSet);
+}
+
+/*
+Pushes the return address and jumps to 'target' on the lanes in 'taken', the others just moving past the instruction.
+Returns false, having changed nothing, if a lane's stack has no direct page
+*/
+bool Z80Lockstep_call(const Z80MicroOp_t* op, const uint16_t* taken, uint16_t target) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    uint16_t addresses[Z80_LOCKSTEP_MAX_LANES];
+    uint8_t* low[Z80_LOCKSTEP_MAX_LANES];
+    uint8_t* high[Z80_LOCKSTEP_MAX_LANES];
+    Z80_LANES(l)
+        addresses[l] = (uint16_t)(lanes->sp[l] - 2);
+    if (!Z80Lockstep_prepareWord(taken, addresses, low, high))
+        return false;
+
+    Z80Lockstep_advance(op);
+    Z80Lockstep_storeWord(taken, low, high, lanes->pc);
+    Z80_LANES(l) {
+        lanes->sp[l] = (uint16_t)((lanes->sp[l] & ~taken[l]) | (addresses[l] & taken[l]));
+        lanes->pc[l] = (uint16_t)((lanes->pc[l] & ~taken[l]) | (target & taken[l]));
+    }
+    return true;
+}
+
+/*
+Returns to the addresses popped from the stack on the lanes in 'taken'
+*/
+void Z80Lockstep_return(const uint16_t* taken, const uint16_t* addresses) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    Z80_LANES(l) {
+        lanes->pc[l] = (uint16_t)((lanes->pc[l] & ~taken[l]) | (addresses[l] & taken[l]));
+        lanes->sp[l] = (uint16_t)(lanes->sp[l] + (taken[l] & 2));
+    }
+}
+
+/*
+Register pair 'index' from an opcode's p field, BC DE HL SP, or BC DE HL AF for PUSH and POP
+*/
+uint16_t* Z80Lockstep_pair(int index, bool afLast) {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    switch (index) {
+    case 0:
+        return lanes->bc;
+    case 1:
+        return lanes->de;
+    case 2:
+        return lanes->hl;
+    default:
+        return afLast ? lanes->af : lanes->sp;
+    }
+}
+
+/*
+8 bit register 'r' from an opcode's y or z field, B C D E H L - A. (HL) is handled by the caller
+*/
+void Z80Lockstep_getR(int r, uint16_t* values) {
+    uint16_t* pair = Z80Lockstep_pair(r == 7 ? 3 : r >> 1, true);
+    int shift = (r == 7 || (r & 1) == 0) ? 8 : 0;
+    Z80_LANES(l)
+        values[l] = (pair[l] >> shift) & 0xFF;
+}
+
+void Z80Lockstep_setR(int r, const uint16_t* values) {
+    uint16_t* sel = Z80Lockstep_lanes.sel;
+    uint16_t* pair = Z80Lockstep_pair(r == 7 ? 3 : r >> 1, true);
+    if (r == 7 || (r & 1) == 0) {
+        Z80_LANES(l)
+            LANE_SET(pair, l, (pair[l] & 0x00FF) | (values[l] << 8));
+    }
+    else {
+        Z80_LANES(l)
+            LANE_SET(pair, l, (pair[l] & 0xFF00) | values[l]);
+    }
+}
+
+/*
+ADD ADC SUB SBC AND XOR OR CP of A with 'operand', for 'op' from the opcode's y field. The flags follow Z80Alu
+*/
+void Z80Lockstep_alu(int op, const uint16_t* operand) {
+    uint16_t* sel = Z80Lockstep_lanes.sel;
+    uint16_t* af = Z80Lockstep_lanes.af;
+    uint16_t carryIn = (op == 1 || op == 3) ? Z80FLAG_C : 0;
+
+    if (op < 2) {
+        Z80_LANES(l) {
+            uint16_t a = af[l] >> 8;
+            uint16_t b = operand[l];
+            uint16_t r = (uint16_t)(a + b + (af[l] & carryIn));
+            uint16_t r8 = r & 0xFF;
+            uint16_t f = (uint16_t)(LANE_SZ(r8) | ((a ^ b ^ r) & Z80FLAG_H) | (((a ^ b ^ 0x80) & (a ^ r) & 0x80) >> 5) | ((r >> 8) & Z80FLAG_C));
+            LANE_SET(af, l, (r8 << 8) | f);
+        }
+    }
+    else if (op < 4 || op == 7) {
+        // CP keeps A and takes the undocumented bits from the operand
+        uint16_t cp = LANE_MASK(op == 7);
+        Z80_LANES(l) {
+            uint16_t a = af[l] >> 8;
+            uint16_t b = operand[l];
+            uint16_t r = (uint16_t)(a - b - (af[l] & carryIn));
+            uint16_t r8 = r & 0xFF;
+            uint16_t f = (uint16_t)(Z80FLAG_N | (r8 & Z80FLAG_S) | (r8 == 0 ? Z80FLAG_Z : 0) | (((b & cp) | (r8 & ~cp)) & Z80FLAG_XY) | ((a ^ b ^ r) & Z80FLAG_H) | (((a ^ b) & (a ^ r) & 0x80) >> 5) | ((r >> 8) & Z80FLAG_C));
+            LANE_SET(af, l, (((a & cp) | (r8 & ~cp)) << 8) | f);
+        }
+    }
+    else {
+        uint16_t andOp = LANE_MASK(op == 4);
+        uint16_t orOp = LANE_MASK(op == 6);
+        uint16_t xorOp = LANE_MASK(op == 5);
+        Z80_LANES(l) {
+            uint16_t a = af[l] >> 8;
+            uint16_t b = operand[l];
+            uint16_t r = (uint16_t)(((a & b) & andOp) | ((a | b) & orOp) | ((a ^ b) & xorOp));
+            uint16_t f = (uint16_t)(LANE_SZ(r) | LANE_P(r) | (Z80FLAG_H & andOp));
+            LANE_SET(af, l, (r << 8) | f);
+        }
+    }
+}
+
+/*
+INC or DEC of 'values' in place. The carry is kept
+*/
+void Z80Lockstep_incDec(bool dec, uint16_t* values) {
+    uint16_t* sel = Z80Lockstep_lanes.sel;
+    uint16_t* af = Z80Lockstep_lanes.af;
+    if (dec) {
+        Z80_LANES(l) {
+            uint16_t r = (values[l] - 1) & 0xFF;
+            uint16_t f = (uint16_t)((af[l] & Z80FLAG_C) | LANE_SZ(r) | Z80FLAG_N | ((r & 0x0F) == 0x0F ? Z80FLAG_H : 0) | (r == 0x7F ? Z80FLAG_PV : 0));
+            LANE_SET(af, l, (af[l] & 0xFF00) | f);
+            values[l] = r;
+        }
+    }
+    else {
+        Z80_LANES(l) {
+            uint16_t r = (values[l] + 1) & 0xFF;
+            uint16_t f = (uint16_t)((af[l] & Z80FLAG_C) | LANE_SZ(r) | ((r & 0x0F) == 0 ? Z80FLAG_H : 0) | (r == 0x80 ? Z80FLAG_PV : 0));
+            LANE_SET(af, l, (af[l] & 0xFF00) | f);
+            values[l] = r;
+        }
+    }
+}
+
+/*
+RLCA RRCA RLA RRA - CPL SCF CCF, for 'op' from the opcode's y field
+*/
+void Z80Lockstep_accumulator(int op) {
+    uint16_t* sel = Z80Lockstep_lanes.sel;
+    uint16_t* af = Z80Lockstep_lanes.af;
+    Z80_LANES(l) {
+        uint16_t a = af[l] >> 8;
+        uint16_t f = af[l] & 0xFF;
+        uint16_t carry = f & Z80FLAG_C;
+        uint16_t r;
+        switch (op) {
+        case 0:
+            r = ((a << 1) | (a >> 7)) & 0xFF;
+            f = (f & LANE_KEEP_SZP) | (r & Z80FLAG_XY) | (a >> 7);
+            break;
+        case 1:
+            r = ((a >> 1) | (a << 7)) & 0xFF;
+            f = (f & LANE_KEEP_SZP) | (r & Z80FLAG_XY) | (a & Z80FLAG_C);
+            break;
+        case 2:
+            r = ((a << 1) | carry) & 0xFF;
+            f = (f & LANE_KEEP_SZP) | (r & Z80FLAG_XY) | (a >> 7);
+            break;
+        case 3:
+            r = (a >> 1) | (carry << 7);
+            f = (f & LANE_KEEP_SZP) | (r & Z80FLAG_XY) | (a & Z80FLAG_C);
+            break;
+        case 5:
+            r = ~a & 0xFF;
+            f = (f & (LANE_KEEP_SZP | Z80FLAG_C)) | Z80FLAG_H | Z80FLAG_N | (r & Z80FLAG_XY);
+            break;
+        case 6:
+            r = a;
+            f = (f & LANE_KEEP_SZP) | Z80FLAG_C | (a & Z80FLAG_XY);
+            break;
+        default:
+            r = a;
+            f = (f & LANE_KEEP_SZP) | (carry ? Z80FLAG_H : 0) | (carry ^ Z80FLAG_C) | (a & Z80FLAG_XY);
+            break;
+        }
+        LANE_SET(af, l, (r << 8) | f);
+    }
+}
+
+/*
+Checks the lane ALU against Z80Alu for every value of A, the operand and the carry, on every lane at once.
+Only needs Z80Alu_init(), not the lanes
+*/
+bool Z80Lockstep_selfCheck() {
+    Z80Lanes_t* lanes = &Z80Lockstep_lanes;
+    uint16_t values[Z80_LOCKSTEP_MAX_LANES];
+    uint64_t cases = 0;
+    uint64_t failures = 0;
+    int saveLanes = Z80Lockstep_nLanes;
+    uint16_t saveAF = AF;
+
+    Z80Lockstep_nLanes = Z80_LOCKSTEP_MAX_LANES;
+    memset(lanes->sel, 0xFF, sizeof(lanes->sel));
+
+    // ALU operations and INC / DEC (op 8 and 9) of A
+    for (int op = 0; op < 10; op++) {
+        for (int a = 0; a < 0x100; a++) {
+            for (int b = 0; b < 0x100; b += Z80_LOCKSTEP_MAX_LANES) {
+                for (int carry = 0; carry < 2; carry++) {
+                    Z80_LANES(l) {
+                        lanes->af[l] = (uint16_t)((a << 8) | carry);
+                        values[l] = (uint16_t)(b + l);
+                    }
+                    if (op < 8)
+                        Z80Lockstep_alu(op, values);
+                    else
+                        Z80Lockstep_incDec(op == 9, values);
+
+                    for (int l = 0; l < Z80_LOCKSTEP_MAX_LANES; l++) {
+                        uint8_t operand = (uint8_t)(b + l);
+                        AF = (uint16_t)((a << 8) | carry);
+                        Z80FLAGS_DISCARD();
+                        uint8_t result = (uint8_t)a;
+                        switch (op) {
+                        case 0: result = Z80Alu_add8((uint8_t)a, operand, 0); break;
+                        case 1: result = Z80Alu_add8((uint8_t)a, operand, (uint8_t)carry); break;
+                        case 2: result = Z80Alu_sub8((uint8_t)a, operand, 0); break;
+                        case 3: result = Z80Alu_sub8((uint8_t)a, operand, (uint8_t)carry); break;
+                        case 4: result = Z80Alu_and8((uint8_t)a, operand); break;
+                        case 5: result = Z80Alu_xor8((uint8_t)a, operand); break;
+                        case 6: result = Z80Alu_or8((uint8_t)a, operand); break;
+                        case 7: Z80Alu_cp8((uint8_t)a, operand); break;
+                        case 8: result = Z80Alu_inc8(operand); break;
+                        default: result = Z80Alu_dec8(operand); break;
+                        }
+                        Z80FLAGS_SYNC();
+
+                        // INC and DEC leave their result in 'values' rather than A
+                        uint16_t expected = (uint16_t)((result << 8) | (AF & 0xFF));
+                        uint16_t got = op < 8 ? lanes->af[l] : (uint16_t)((values[l] << 8) | (lanes->af[l] & 0xFF));
+                        cases++;
+                        if (expected != got && failures++ < 8) {
+                            formattedLog(stdlog, LOGTYPE_ERROR, "Lockstep self-check op %i: A=%02X operand=%02X carry=%i expected %04X got %04X\n", op, a, operand, carry, expected, got);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    Z80Lockstep_nLanes = saveLanes;
+    memset(lanes->sel, 0, sizeof(lanes->sel));
+    AF = saveAF;
+    Z80FLAGS_DISCARD();
+
+    if (failures == 0) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Lockstep self-check passed: %llu cases\n", (unsigned long long)cases);
+    }
+    else {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Lockstep self-check failed: %llu of %llu cases\n", (unsigned long long)failures, (unsigned long long)cases);
+    }
+    return failures == 0;
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Lockstep.h : Lockstep engine. Runs several instances of the machine's CPU side by side, each with its own registers
+and writeable memory. Instances at the same PC with the same code run the instruction together in one set of lane
+loops, and any other instruction is run for each instance in turn through Z80_step()
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Z80.h"
+#include "Z80Block.h"
+#include "../Memory/MemoryController.h"
+
+/* One 256 bit vector holds a 16 bit register for 16 instances */
+#define Z80_LOCKSTEP_MAX_LANES 16
+
+#define Z80_LOCKSTEP_LANE_ON 0xFFFF // Lanes taking part in a lane loop have this in Z80Lanes_t.sel, the others 0
+#define Z80_LOCKSTEP_DECODE_SIZE 0x1000 // Decoded instructions kept, by PC
+#define Z80_LOCKSTEP_DECODE_MASK (Z80_LOCKSTEP_DECODE_SIZE - 1)
+#define Z80_LOCKSTEP_MAX_INSTR_LEN 4
+
+/*
+Register file of every instance, one array per register so a lane loop works on contiguous values. F in af is always
+up to date, the lanes have no lazy flags
+*/
+typedef struct Z80Lanes {
+    uint16_t af[Z80_LOCKSTEP_MAX_LANES];
+    uint16_t bc[Z80_LOCKSTEP_MAX_LANES];
+    uint16_t de[Z80_LOCKSTEP_MAX_LANES];
+    uint16_t hl[Z80_LOCKSTEP_MAX_LANES];
+    uint16_t ix[Z80_LOCKSTEP_MAX_LANES];
+    uint16_t iy[Z80_LOCKSTEP_MAX_LANES];
+    uint16_t sp[Z80_LOCKSTEP_MAX_LANES];
+    uint16_t pc[Z80_LOCKSTEP_MAX_LANES];
+    uint16_t ir[Z80_LOCKSTEP_MAX_LANES];
+    uint16_t sel[Z80_LOCKSTEP_MAX_LANES];
+    uint64_t tStates[Z80_LOCKSTEP_MAX_LANES];
+    uint64_t instructions[Z80_LOCKSTEP_MAX_LANES];
+    uint64_t target[Z80_LOCKSTEP_MAX_LANES]; // T-state each instance runs to in Z80Lockstep_run()
+
+    // State only Z80_step() touches
+    Z80RegisterBank_t alternate[Z80_LOCKSTEP_MAX_LANES];
+    bool iff1[Z80_LOCKSTEP_MAX_LANES];
+    bool iff2[Z80_LOCKSTEP_MAX_LANES];
+    int interruptMode[Z80_LOCKSTEP_MAX_LANES];
+    bool halted[Z80_LOCKSTEP_MAX_LANES];
+    bool eiPending[Z80_LOCKSTEP_MAX_LANES];
+
+    bool failed[Z80_LOCKSTEP_MAX_LANES];
+    bool done[Z80_LOCKSTEP_MAX_LANES];
+    MemoryImage_t* memory[Z80_LOCKSTEP_MAX_LANES]; // ALLOCATED: the instance's writeable memory
+} Z80Lanes_t;
+
+/* An instruction decoded for the lanes, with the bytes it was decoded from so each lane can check its code matches */
+typedef struct Z80LockstepDecode {
+    Z80MicroOp_t op;
+    uint8_t bytes[Z80_LOCKSTEP_MAX_INSTR_LEN];
+    uint16_t pc;
+    bool valid;
+} Z80LockstepDecode_t;
+
+/* What the machine was doing before the lanes took over, put back by Z80Lockstep_destroy() */
+typedef struct Z80LockstepHome {
+    Z80Registers_t registers;
+    bool iff1;
+    bool iff2;
+    int interruptMode;
+    bool halted;
+    bool eiPending;
+    uint64_t tStates;
+    uint64_t instructions;
+    uint64_t deadline;
+    bool decodeCache;
+    bool block;
+    bool idle;
+} Z80LockstepHome_t;
+
+extern Z0_MACHINE_LOCAL Z80_CACHE_ALIGNED Z80Lanes_t Z80Lockstep_lanes;
+extern Z0_MACHINE_LOCAL int Z80Lockstep_nLanes;
+extern Z0_MACHINE_LOCAL Z80LockstepDecode_t* Z80Lockstep_decodes; // ALLOCATED
+extern Z0_MACHINE_LOCAL Z80LockstepHome_t Z80Lockstep_home;
+extern Z0_MACHINE_LOCAL int Z80Lockstep_resident;
+extern Z0_MACHINE_LOCAL bool Z80Lockstep_unmapped[MEMORY_NUM_PAGES]; // Pages no memory device covers, by address >> MEMORY_PAGE_SHIFT
+extern Z0_MACHINE_LOCAL uint8_t Z80Lockstep_floating; // What every lane reads from an unmapped page
+extern Z0_MACHINE_LOCAL uint8_t Z80Lockstep_discard; // Where every lane's writes to an unmapped page go
+
+/* Counters since Z80Lockstep_init() */
+extern Z0_MACHINE_LOCAL uint64_t Z80Lockstep_vectorInstructions; // Instructions run by lane loops, one per lane
+extern Z0_MACHINE_LOCAL uint64_t Z80Lockstep_vectorGroups; // Lane loop runs
+extern Z0_MACHINE_LOCAL uint64_t Z80Lockstep_scalarInstructions; // Instructions run through Z80_step()
+
+/********************************************************************
+
+    Z80 Lockstep Functions
+
+********************************************************************/
+
+bool Z80Lockstep_init(int nLanes);
+void Z80Lockstep_destroy();
+void Z80Lockstep_run(uint64_t tStates);
+void Z80Lockstep_stepGroup(int leader);
+void Z80Lockstep_stepScalar(int lane);
+void Z80Lockstep_enter(int lane);
+void Z80Lockstep_leave(int lane);
+bool Z80Lockstep_canGroup(int lane, bool interruptRequest);
+
+/********************************************************************
+
+    Z80 Lockstep Memory Functions
+
+********************************************************************/
+
+void Z80Lockstep_swapTo(int lane);
+uint8_t* Z80Lockstep_readPointer(int lane, uint16_t address);
+uint8_t* Z80Lockstep_writePointer(int lane, uint16_t address);
+uint8_t Z80Lockstep_readByte(int lane, uint16_t address);
+void Z80Lockstep_writeByte(int lane, uint16_t address, uint8_t value);
+Z80LockstepDecode_t* Z80Lockstep_decode(int lane, uint16_t pc);
+bool Z80Lockstep_codeMatches(int lane, const Z80LockstepDecode_t* decode);
+bool Z80Lockstep_load(const uint16_t* mask, const uint16_t* addresses, uint16_t* values);
+bool Z80Lockstep_loadWord(const uint16_t* mask, const uint16_t* addresses, uint16_t* values);
+bool Z80Lockstep_prepareStore(const uint16_t* mask, const uint16_t* addresses, uint8_t** pointers);
+bool Z80Lockstep_prepareWord(const uint16_t* mask, const uint16_t* addresses, uint8_t** low, uint8_t** high);
+void Z80Lockstep_store(const uint16_t* mask, uint8_t** pointers, const uint16_t* values);
+void Z80Lockstep_storeWord(const uint16_t* mask, uint8_t** low, uint8_t** high, const uint16_t* values);
+
+/********************************************************************
+
+    Z80 Lockstep Lane Loops
+
+********************************************************************/
+
+bool Z80Lockstep_kernel(const Z80MicroOp_t* op);
+bool Z80Lockstep_kernelBits(const Z80MicroOp_t* op);
+bool Z80Lockstep_kernelExtended(const Z80MicroOp_t* op);
+void Z80Lockstep_advance(const Z80MicroOp_t* op);
+void Z80Lockstep_branch(const uint16_t* taken, uint16_t tStates);
+void Z80Lockstep_taken(int condition, uint16_t* taken);
+bool Z80Lockstep_call(const Z80MicroOp_t* op, const uint16_t* taken, uint16_t target);
+void Z80Lockstep_return(const uint16_t* taken, const uint16_t* addresses);
+uint16_t* Z80Lockstep_pair(int index, bool afLast);
+void Z80Lockstep_getR(int r, uint16_t* values);
+void Z80Lockstep_setR(int r, const uint16_t* values);
+void Z80Lockstep_alu(int op, const uint16_t* operand);
+void Z80Lockstep_incDec(bool dec, uint16_t* values);
+void Z80Lockstep_accumulator(int op);
+void Z80Lockstep_rotate(int op, uint16_t* values);
+void Z80Lockstep_exchange(bool exx);
+void Z80Lockstep_in(const uint16_t* ports, uint16_t* values);
+void Z80Lockstep_out(const uint16_t* ports, const uint16_t* values);
+bool Z80Lockstep_selfCheck();
@@ -0,0 +1,159 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Opcodes.c : Packed opcode tables generated from Z80Opcodes.def, shared by the CPU and the decompiler
+
+*/
+
+#include "Z80Opcodes.h"
+#include "Z80Instructions.h"
+#include "Z80Execute.h"
+
+#include "../SysIO/Log.h"
+
+/********************************************************************
+
+    Z80 Opcode Tables
+
+********************************************************************/
+
+/* Spellings of the mCycles column */
+#define M(...) { __VA_ARGS__ }
+#define OCF(t) Z80_MCYCLE(Z80MCYCLE_OPCODE_FETCH, t)
+#define MR(t) Z80_MCYCLE(Z80MCYCLE_MEMORY_READ, t)
+#define MW(t) Z80_MCYCLE(Z80MCYCLE_MEMORY_WRITE, t)
+#define PR(t) Z80_MCYCLE(Z80MCYCLE_PORT_READ, t)
+#define PW(t) Z80_MCYCLE(Z80MCYCLE_PORT_WRITE, t)
+#define IC(t) Z80_MCYCLE(Z80MCYCLE_INTERNAL, t)
+
+/* One table entry, pointing at the handler Z80Execute.c generates for the same line. The machine cycles come last, as their braces hold commas by the time they arrive */
+#define Z80_OPCODE_ENTRY(table, opcode, mnemonic, length, operands, tStates, ...) \
+    [opcode] = { mnemonic, &Z80_execute##table##opcode, length, Z80OPND_##operands, tStates, __VA_ARGS__ },
+
+const Z80OpcodeInfo_t Z80Opcodes_main[0x100] = {
+#define Z80_MAIN(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_OPCODE_ENTRY(Main, opcode, mnemonic, length, operands, tStates, mCycles)
+#include "Z80Opcodes.def"
+};
+
+const Z80OpcodeInfo_t Z80Opcodes_extended[0x100] = {
+#define Z80_ED(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_OPCODE_ENTRY(Extended, opcode, mnemonic, length, operands, tStates, mCycles)
+#include "Z80Opcodes.def"
+};
+
+const Z80OpcodeInfo_t Z80Opcodes_bit[0x100] = {
+#define Z80_CB(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_OPCODE_ENTRY(Bit, opcode, mnemonic, length, operands, tStates, mCycles)
+#include "Z80Opcodes.def"
+};
+
+#define XY "IX"
+const Z80OpcodeInfo_t Z80Opcodes_IX[0x100] = {
+#define Z80_XY(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_OPCODE_ENTRY(IX, opcode, mnemonic, length, operands, tStates, mCycles)
+#include "Z80Opcodes.def"
+};
+
+const Z80OpcodeInfo_t Z80Opcodes_IXBit[0x100] = {
+#define Z80_XYCB(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_OPCODE_ENTRY(IXBit, opcode, mnemonic, length, operands, tStates, mCycles)
+#include "Z80Opcodes.def"
+};
+#undef XY
+
+#define XY "IY"
+const Z80OpcodeInfo_t Z80Opcodes_IY[0x100] = {
+#define Z80_XY(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_OPCODE_ENTRY(IY, opcode, mnemonic, length, operands, tStates, mCycles)
+#include "Z80Opcodes.def"
+};
+
+const Z80OpcodeInfo_t Z80Opcodes_IYBit[0x100] = {
+#define Z80_XYCB(opcode, mnemonic, length, operands, tStates, mCycles, handler) Z80_OPCODE_ENTRY(IYBit, opcode, mnemonic, length, operands, tStates, mCycles)
+#include "Z80Opcodes.def"
+};
+#undef XY
+
+/********************************************************************
+
+    Z80 Opcode Table Functions
+
+********************************************************************/
+
+/*
+Returns the table for the opcodes that follow 'prefix', or NULL if it is not a prefix
+*/
+const Z80OpcodeInfo_t* Z80Opcodes_table(uint16_t prefix) {
+    switch (prefix) {
+    case 0:
+        return Z80Opcodes_main;
+    case PREFIX_BITS:
+        return Z80Opcodes_bit;
+    case PREFIX_EXX:
+        return Z80Opcodes_extended;
+    case PREFIX_IX:
+        return Z80Opcodes_IX;
+    case PREFIX_IY:
+        return Z80Opcodes_IY;
+    case PREFIX_IX_BITS:
+        return Z80Opcodes_IXBit;
+    case PREFIX_IY_BITS:
+        return Z80Opcodes_IYBit;
+    default:
+        return NULL;
+    }
+}
+
+/*
+Returns the number of prefix bytes in front of the opcode: none, one, or two for the DDCB and FDCB bit instructions
+*/
+unsigned int Z80Opcodes_prefixBytes(uint16_t prefix) {
+    if (prefix == 0)
+        return 0;
+    return prefix > 0xFF ? 2 : 1;
+}
+
+/*
+Checks every table entry against itself: the machine cycles must add up to the T-states, begin with an opcode fetch, and the length must cover the prefixes, opcode and operands.
+Returns true if every entry is consistent
+*/
+bool Z80Opcodes_selfCheck() {
+    const uint16_t prefixes[] = { 0, PREFIX_BITS, PREFIX_EXX, PREFIX_IX, PREFIX_IY, PREFIX_IX_BITS, PREFIX_IY_BITS };
+    unsigned long failures = 0;
+    unsigned long entries = 0;
+
+    for (unsigned int t = 0; t < sizeof(prefixes) / sizeof(prefixes[0]); t++) {
+        const Z80OpcodeInfo_t* table = Z80Opcodes_table(prefixes[t]);
+        int prefixBytes = (int)Z80Opcodes_prefixBytes(prefixes[t]);
+
+        for (int opcode = 0; opcode < 0x100; opcode++) {
+            const Z80OpcodeInfo_t* info = &table[opcode];
+            entries++;
+
+            unsigned int tStates = 0;
+            for (int i = 0; i < Z80_MAX_MCYCLES && info->mCycles[i] != 0; i++)
+                tStates += Z80_MCYCLE_TSTATES(info->mCycles[i]);
+
+            bool valid = info->mnemonic != NULL && info->execFunction != NULL;
+            valid = valid && tStates == info->tStates && Z80_MCYCLE_KIND(info->mCycles[0]) == Z80MCYCLE_OPCODE_FETCH;
+            valid = valid && (info->length == -1 || info->length == prefixBytes + 1 + Z80OPND_BYTES(info->operands));
+            if (!valid) {
+                failures++;
+                formattedLog(stdlog, LOGTYPE_ERROR, "Opcode self-check %04X %02X: length %i, %u T-states, M-cycles add up to %u\n", prefixes[t], opcode, info->length, info->tStates, tStates);
+            }
+        }
+    }
+
+    if (failures == 0) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Opcode self-check passed: %lu entries\n", entries);
+    }
+    else {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Opcode self-check FAILED: %lu of %lu entries are inconsistent\n", failures, entries);
+    }
+    return failures == 0;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Opcodes.h : Packed opcode tables generated from Z80Opcodes.def, shared by the CPU and the decompiler
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Operand kinds. The low two bits are the number of operand bytes */
+#define Z80OPND_NONE 0x00
+#define Z80OPND_IMM8 0x01 // n
+#define Z80OPND_REL8 0x11 // e, relative to the next instruction
+#define Z80OPND_PORT8 0x21 // (n), a port
+#define Z80OPND_DISP8 0x31 // d, an index displacement
+#define Z80OPND_IMM16 0x02 // nn
+#define Z80OPND_ADDR16 0x12 // (nn), an address
+#define Z80OPND_DISP8_IMM8 0x22 // d then n
+#define Z80OPND_BYTES(kind) ((kind) & 0x03)
+
+/* Machine cycle kinds, packed with the cycle length in T-states by Z80_MCYCLE() */
+#define Z80MCYCLE_OPCODE_FETCH 1
+#define Z80MCYCLE_MEMORY_READ 2
+#define Z80MCYCLE_MEMORY_WRITE 3
+#define Z80MCYCLE_PORT_READ 4
+#define Z80MCYCLE_PORT_WRITE 5
+#define Z80MCYCLE_INTERNAL 6
+#define Z80_MCYCLE(kind, tStates) (uint8_t)(((kind) << 4) | (tStates))
+#define Z80_MCYCLE_KIND(mCycle) ((mCycle) >> 4)
+#define Z80_MCYCLE_TSTATES(mCycle) ((mCycle) & 0x0F)
+#define Z80_MAX_MCYCLES 7
+
+/* One opcode, after any prefixes */
+typedef struct Z80OpcodeInfo {
+    const char* mnemonic;
+    const int (*execFunction)(); // Handler specialised for this opcode in Z80Execute.c
+    int8_t length; // Bytes including prefixes and operands, or -1 for a prefix
+    uint8_t operands; // Z80OPND_ kind
+    uint8_t tStates; // Base T-states, see Z80Opcodes.def
+    uint8_t mCycles[Z80_MAX_MCYCLES]; // Z80_MCYCLE() values, ending at the first 0
+} Z80OpcodeInfo_t;
+
+/* Tables, indexed by the opcode after the prefix */
+extern const Z80OpcodeInfo_t Z80Opcodes_main[0x100];
+extern const Z80OpcodeInfo_t Z80Opcodes_extended[0x100]; // PREFIX 0xED
+extern const Z80OpcodeInfo_t Z80Opcodes_bit[0x100]; // PREFIX 0xCB
+extern const Z80OpcodeInfo_t Z80Opcodes_IX[0x100]; // PREFIX 0xDD
+extern const Z80OpcodeInfo_t Z80Opcodes_IXBit[0x100]; // PREFIX 0xDDCB
+extern const Z80OpcodeInfo_t Z80Opcodes_IY[0x100]; // PREFIX 0xFD
+extern const Z80OpcodeInfo_t Z80Opcodes_IYBit[0x100]; // PREFIX 0xFDCB
+
+/********************************************************************
+
+    Z80 Opcode Table Functions
+
+********************************************************************/
+
+const Z80OpcodeInfo_t* Z80Opcodes_table(uint16_t prefix);
+unsigned int Z80Opcodes_prefixBytes(uint16_t prefix);
+bool Z80Opcodes_selfCheck();
@@ -0,0 +1,167 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Refresh.c : INT driven by the refresh address, as on the ZX80, which wires A6 to INT so the display routine can time
+each line by loading R. R only moves by one per opcode fetch, so the T-state at which A6 next changes is predicted from R
+and posted as a scheduler event rather than the refresh cycles being watched
+
+*/
+
+#include "Z80Refresh.h"
+#include "Z80Step.h"
+
+#include "../Signals.h"
+#include "../Scheduler.h"
+#include "../SysIO/Log.h"
+
+/* State */
+Z0_MACHINE_LOCAL bool Z80Refresh_enabled = false;
+Z0_MACHINE_LOCAL bool Z80Refresh_watching = false;
+
+/* Statistics */
+Z0_MACHINE_LOCAL uint64_t Z80Refresh_edges = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Refresh_checks = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Refresh_early = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Refresh_writes = 0;
+Z0_MACHINE_LOCAL uint64_t Z80Refresh_watches = 0;
+
+/********************************************************************
+
+    Z80 Refresh Functions
+
+********************************************************************/
+
+/*
+Switches the source off and clears the counts. Its event goes with the scheduler's
+*/
+void Z80Refresh_destroy() {
+    Z80Refresh_enabled = false;
+    Z80Refresh_watching = false;
+    Z80Refresh_edges = 0;
+    Z80Refresh_checks = 0;
+    Z80Refresh_early = 0;
+    Z80Refresh_writes = 0;
+    Z80Refresh_watches = 0;
+}
+
+/*
+Sets INT from R and posts the first check. Called once the machine is built, and again whenever R or the scheduler has
+been reset under it
+*/
+void Z80Refresh_start() {
+    if (!Z80Refresh_enabled)
+        return;
+
+    Z80Refresh_watching = false;
+    Z80Refresh_sync();
+    Z80Refresh_plan();
+}
+
+/*
+Brings INT in line with the last refresh address
+*/
+void Z80Refresh_sync() {
+    bool low = Z80REFRESH_INT_LOW();
+    if (low == signals_readSignal(&signal_INT))
+        return;
+
+    if (low)
+        signals_raiseSignal(&signal_INT);
+    else
+        signals_dropSignal(&signal_INT);
+    Z80Refresh_edges++;
+}
+
+/*
+Opcode fetches, from R as 'r', before the refresh address changes A6. Always at least one
+*/
+uint32_t Z80Refresh_m1UntilChange(uint8_t r) {
+    r &= 0x7F;
+    // The last fetch refreshed with r - 1: A6 is low for r from 0x01 to 0x40, and rises again once r reaches 0x41
+    if (((r - 1) & Z80_REFRESH_INT_BIT) == 0)
+        return 0x41 - r;
+    return (0x01 - r) & 0x7F;
+}
+
+/*
+Replaces the pending check with one at the earliest T-state A6 can change, each fetch taking the fewest T-states it can.
+Returns that T-state
+*/
+uint64_t Z80Refresh_plan() {
+    uint64_t due = scheduler_now() + (uint64_t)Z80Refresh_m1UntilChange((uint8_t)IVMR) * Z80_REFRESH_MIN_M1_TSTATES;
+    scheduler_cancel(&Z80Refresh_event);
+    scheduler_post(due, &Z80Refresh_event);
+    return due;
+}
+
+/*
+Scheduler event, on the first instruction boundary at or after the predicted change. Where the fetches took longer than
+the minimum the change is still ahead and the check is posted again, closer in
+*/
+void Z80Refresh_event(uint64_t tState) {
+    (void)tState;
+    Z80Refresh_checks++;
+    Z80Refresh_watching = false;
+
+    uint64_t edges = Z80Refresh_edges;
+    Z80Refresh_sync();
+    if (Z80Refresh_edges == edges)
+        Z80Refresh_early++;
+    Z80Refresh_plan();
+}
+
+/*
+Called after LD R,A, which moves R anywhere. INT follows at once, and the check is planned again from the new value. The
+stepped engines only stop for events between slices, so if the change now falls before the running slice ends the level
+is watched at every poll until it does
+*/
+void Z80Refresh_onWrite() {
+    Z80Refresh_writes++;
+    Z80Refresh_sync();
+    if (Z80Refresh_plan() < Z80_tStateDeadline && !Z80Refresh_watching) {
+        Z80Refresh_watching = true;
+        Z80Refresh_watches++;
+    }
+}
+
+/*
+Checks the predicted fetch counts against stepping R one fetch at a time, for every value of R
+*/
+bool Z80Refresh_selfCheck() {
+    uint64_t cases = 0;
+    uint64_t failures = 0;
+
+    for (int r = 0; r < 0x100; r++) {
+        bool low = ((((r & 0x7F) - 1) & Z80_REFRESH_INT_BIT) == 0);
+        uint32_t fetches = 0;
+        uint8_t stepped = (uint8_t)r;
+        do {
+            stepped = (uint8_t)((stepped & 0x80) | ((stepped + 1) & 0x7F));
+            fetches++;
+        } while (((((stepped & 0x7F) - 1) & Z80_REFRESH_INT_BIT) == 0) == low && fetches <= 0x80);
+
+        cases++;
+        if (Z80Refresh_m1UntilChange((uint8_t)r) != fetches) {
+            failures++;
+            formattedLog(debuglog, LOGTYPE_ERROR, "Refresh self-check: R=%02X predicts %u fetches, stepping takes %u\n", r, Z80Refresh_m1UntilChange((uint8_t)r), fetches);
+        }
+    }
+
+    if (failures == 0) {
+        formattedLog(stdlog, LOGTYPE_MSG, "Refresh self-check passed: %llu cases\n", (unsigned long long)cases);
+    }
+    else {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Refresh self-check failed: %llu of %llu cases\n", (unsigned long long)failures, (unsigned long long)cases);
+    }
+    return failures == 0;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Refresh.h : INT driven by the refresh address, as on the ZX80, which wires A6 to INT so the display routine can time
+each line by loading R. R only moves by one per opcode fetch, so the T-state at which A6 next changes is predicted from R
+and posted as a scheduler event rather than the refresh cycles being watched
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Z80.h"
+#include "../Z0Machine.h"
+
+#define Z80_REFRESH_INT_BIT 0x40 // Bit of R on A6
+#define Z80_REFRESH_MIN_M1_TSTATES 4 // No opcode fetch is shorter, so R can't advance faster than one per 4 T-states
+
+/*
+True when the last opcode fetch put A6 low on the refresh address. The fetch had already advanced R past the value it
+refreshed with, and INT is sampled at the end of the instruction, which for the NOPs and HALT of a ZX80 display line is
+that refresh cycle
+*/
+#define Z80REFRESH_INT_LOW() ((((IVMR & 0x7F) - 1) & Z80_REFRESH_INT_BIT) == 0)
+
+extern Z0_MACHINE_LOCAL bool Z80Refresh_enabled;
+// Set when a write to R moved the next change of A6 in front of the end of the running slice, so the event can't be
+// there in time. Until the slice ends the level is followed at each interrupt poll, and no shortcut may assume it holds
+extern Z0_MACHINE_LOCAL bool Z80Refresh_watching;
+
+/* Statistics */
+extern Z0_MACHINE_LOCAL uint64_t Z80Refresh_edges; // Changes of INT
+extern Z0_MACHINE_LOCAL uint64_t Z80Refresh_checks; // Events fired
+extern Z0_MACHINE_LOCAL uint64_t Z80Refresh_early; // Events that fired before A6 had changed, as the fetches took longer than the minimum
+extern Z0_MACHINE_LOCAL uint64_t Z80Refresh_writes; // Writes to R
+extern Z0_MACHINE_LOCAL uint64_t Z80Refresh_watches; // Writes that had the level followed to the end of the slice
+
+/********************************************************************
+
+    Z80 Refresh Functions
+
+********************************************************************/
+
+void Z80Refresh_destroy();
+void Z80Refresh_start();
+void Z80Refresh_sync();
+uint32_t Z80Refresh_m1UntilChange(uint8_t r);
+uint64_t Z80Refresh_plan();
+void Z80Refresh_event(uint64_t tState);
+void Z80Refresh_onWrite();
+bool Z80Refresh_selfCheck();
@@ -0,0 +1,200 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Step.c : Instruction-stepped Z80 engine. Runs a whole instruction per call and only keeps a T-state count
+
+*/
+
+#include "Z80Step.h"
+#include "Z80.h"
+#include "Z80Instructions.h"
+#include "Z80Execute.h"
+#include "Z80DecodeCache.h"
+#include "Z80Block.h"
+#include "Z80Threaded.h"
+#include "Z80Bus.h"
+#include "Z80Idle.h"
+#include "Z80Opcodes.h"
+#include "Z80Fusion.h"
+
+#include "../Signals.h"
+#include "../SysIO/Log.h"
+#include "../Memory/MemoryController.h"
+
+/* Z80 Instruction */
+extern Z0_MACHINE_LOCAL Z80_Instr_t cInstr;
+
+/* Stepped engine counters */
+Z0_MACHINE_LOCAL uint64_t Z80_tStates = 0;
+Z0_MACHINE_LOCAL uint64_t Z80_instructionsExecuted = 0;
+Z0_MACHINE_LOCAL uint64_t Z80_tStateDeadline = 0;
+
+/********************************************************************
+
+    Z80 Stepped Execution Functions
+
+********************************************************************/
+
+/*
+Fetches, decodes and executes the instruction at PC in one call. Memory is read directly rather than through the bus signals.
+Returns the number of T-states the instruction took, or 0 if the CPU is unable to run
+*/
+int Z80_step() {
+    if (Z80_wait || internalState == Z80State_Failure)
+        return 0;
+
+    // Interrupts are accepted between instructions
+    int interruptTStates = Z80_pollInterrupts();
+    if (interruptTStates > 0) {
+        Z80_tStates += interruptTStates;
+        if (Z80Fusion_profiling)
+            Z80Fusion_breakLine();
+        return interruptTStates;
+    }
+
+    // Threaded ROM and cached decodes skip the memory reads, but the opcode fetches still refresh R
+    uint16_t address = PC;
+    Z80MicroOp_t* threaded = Z80Threaded_lookup(address);
+    Z80DecodeCacheEntry_t* cached = (threaded == NULL && Z80DecodeCache_enabled) ? Z80DecodeCache_lookup(address) : NULL;
+    if (threaded != NULL) {
+        Z80_ISSUE_MICRO_OP(threaded);
+        Z80Threaded_instructions++;
+    }
+    else if (cached != NULL) {
+        cInstr = cached->instr;
+        for (int i = 0; i < cached->m1Cycles; i++)
+            Z80_INCREMENT_R();
+    }
+    else {
+        Z80_stepDecode(address);
+    }
+
+    // The machine cycle engine times the fetches it held back against the decoded instruction's cycle list
+    if (Z80Bus_enabled)
+        Z80Bus_beginInstruction(Z80Opcodes_table(cInstr.prefix)[cInstr.opcode].mCycles);
+
+    // Execute through the handler the decode, the decode cache or the threaded op selected
+    PC += cInstr.instrByteLen;
+    internalState = Z80State_Execute;
+    int execFuncResponse = Z80_execute();
+
+    if (execFuncResponse == INSTR_EXEC_SUCCESS) {
+        internalState = Z80State_Fetch;
+        if (Z80Fusion_profiling)
+            Z80Fusion_record(address);
+    }
+    else {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Stepped execution has failed: opcode %04X %02X returned %i\n", cInstr.prefix, cInstr.opcode, execFuncResponse);
+        signals_raiseSignal(&signal_WAIT);
+        internalState = Z80State_Failure;
+    }
+
+    // The instruction may have added T-states for a taken branch
+    int tStates = cInstr.tStates;
+    Z80_tStates += tStates;
+    Z80_instructionsExecuted++;
+    return tStates;
+}
+
+/*
+Fetches and decodes the instruction at 'address' into cInstr, operands included, then offers it to the decode cache
+*/
+void Z80_stepDecode(uint16_t address) {
+    uint8_t m1Cycles = Z80_decodeAt(address);
+    for (int i = 0; i < m1Cycles; i++)
+        Z80_INCREMENT_R();
+
+    Z80DecodeCache_store(address, &cInstr, m1Cycles);
+}
+
+/*
+Decodes the instruction at 'address' into cInstr, operands included, without touching any registers.
+Under the machine cycle engine the fetches are held by Z80Bus until Z80Bus_beginInstruction().
+Returns the number of opcode fetches (M1 cycles) the instruction makes
+*/
+uint8_t Z80_decodeAt(uint16_t address) {
+    uint8_t m1Cycles = 1;
+
+    // Fetch the opcode (M1)
+    internalState = Z80State_Fetch;
+    cInstr = instructions_NULLInstr;
+    cInstr.opcode = Z80Bus_fetchOpcode(address);
+
+    // A single DD or FD goes straight to its index table, and DDCB or FDCB to its bit table with the displacement and
+    // opcode read together, so the common indexed forms take one decode as unprefixed opcodes do
+    internalState = Z80State_Decode;
+    if (cInstr.opcode == PREFIX_IX || cInstr.opcode == PREFIX_IY) {
+        cInstr.prefix = cInstr.opcode;
+        cInstr.opcode = Z80Bus_fetchOpcode(++address);
+        m1Cycles++;
+        if (cInstr.opcode == PREFIX_BITS) {
+            cInstr.prefix = (cInstr.prefix << 8) | PREFIX_BITS;
+            cInstr.operand1 = Z80Bus_fetchOperand(++address);
+            cInstr.opcode = Z80Bus_fetchOperand(++address);
+        }
+    }
+
+    // Decode, following any further prefixes. Each prefix byte is another opcode fetch
+    Z80_decode();
+    while (cInstr.detectedPrefix) {
+        Z80_accumulatePrefix();
+        if (cInstr.prefix == PREFIX_IX_BITS || cInstr.prefix == PREFIX_IY_BITS) {
+            // DDCB and FDCB put the displacement before the opcode, and the opcode isn't an M1
+            cInstr.operand1 = Z80Bus_fetchOperand(++address);
+            cInstr.opcode = Z80Bus_fetchOperand(++address);
+        }
+        else {
+            cInstr.opcode = Z80Bus_fetchOpcode(++address);
+            m1Cycles++;
+        }
+        Z80_decode();
+    }
+
+    // Read the operands. Two byte operands arrive low byte first into operand1, as in Z80_prepReadOperands()
+    if (cInstr.numOperandsToRead == 2) {
+        cInstr.operand1 = Z80Bus_fetchOperand(++address);
+        cInstr.operand0 = Z80Bus_fetchOperand(++address);
+    }
+    else if (cInstr.numOperandsToRead == 1) {
+        cInstr.operand0 = Z80Bus_fetchOperand(++address);
+    }
+    cInstr.numOperandsToRead = 0;
+
+    return m1Cycles;
+}
+
+/*
+Runs whole instructions until at least 'tStates' T-states have elapsed, or the CPU stops.
+Returns the number of T-states actually executed, which may overshoot by part of an instruction
+*/
+uint64_t Z80_runFor(uint64_t tStates) {
+    // Bulk block instructions, HALT and idle loop skips stop where the engine would
+    Z80_tStateDeadline = Z80_tStates + tStates;
+
+    if (Z80Block_enabled)
+        return Z80Block_run(tStates);
+
+    uint64_t executed = 0;
+    while (executed < tStates) {
+        uint16_t from = PC;
+        int stepTStates = Z80_step();
+        if (stepTStates == 0)
+            break;
+        executed += stepTStates;
+
+        // A backward branch may have closed a tight loop
+        if (Z80Idle_enabled && Z80IDLE_IS_LOOP_BRANCH(from, PC))
+            executed += Z80Idle_loopHead();
+    }
+    return executed;
+}
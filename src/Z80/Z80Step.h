@@ -0,0 +1,39 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Step.h : Instruction-stepped Z80 engine. Runs a whole instruction per call and only keeps a T-state count
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../Z0Machine.h"
+
+/* Stepped engine counters */
+extern Z0_MACHINE_LOCAL uint64_t Z80_tStates; // T-states executed since Z80_init()
+extern Z0_MACHINE_LOCAL uint64_t Z80_instructionsExecuted; // Instructions completed since Z80_init()
+extern Z0_MACHINE_LOCAL uint64_t Z80_tStateDeadline; // Z80_tStates at which the current Z80_runFor() stops starting instructions
+
+/********************************************************************
+
+    Z80 Stepped Execution Functions
+
+********************************************************************/
+
+int Z80_step();
+void Z80_stepDecode(uint16_t address);
+uint8_t Z80_decodeAt(uint16_t address);
+uint64_t Z80_runFor(uint64_t tStates);
@@ -0,0 +1,219 @@
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Threaded.c : Threaded code for read-only memory. The ROM is decoded once at load time, one micro-op for every address
+
+*/
+
+#include <stdlib.h>
+
+#include "Z80Threaded.h"
+#include "Z80.h"
+#include "Z80Instructions.h"
+#include "Z80Execute.h"
+#include "Z80Step.h"
+#include "Z80Idle.h"
+#include "Z80Fusion.h"
+
+#include "../Signals.h"
+#include "../SysIO/Log.h"
+#include "../Memory/MemoryController.h"
+
+/* Z80 Instruction */
+extern Z0_MACHINE_LOCAL Z80_Instr_t cInstr;
+
+/* Threaded ROM state */
+Z0_MACHINE_LOCAL bool Z80Threaded_enabled = true;
+Z0_MACHINE_LOCAL Z80MicroOp_t* Z80Threaded_ops = NULL;
+Z0_MACHINE_LOCAL uint8_t* Z80Threaded_fused = NULL;
+Z0_MACHINE_LOCAL uint16_t Z80Threaded_base = 0;
+Z0_MACHINE_LOCAL uint32_t Z80Threaded_len = 0;
+
+/* Statistics */
+Z0_MACHINE_LOCAL uint64_t Z80Threaded_instructions = 0;
+
+/********************************************************************
+
+    Z80 Threaded ROM Functions
+
+********************************************************************/
+
+/*
+Decodes an op at every address of a ROM image that has already been loaded. Only the read-only part from the start of the range
+is threaded, as nothing watches it for writes. Decoding at every address rather than following the code means jumps into the middle
+of an instruction still find an op. Returns false if nothing could be threaded
+*/
+bool Z80Threaded_predecode(uint16_t base, uint32_t len) {
+    Z80Threaded_release();
+    if (!Z80Threaded_enabled)
+        return false;
+
+    uint32_t readOnlyLen = 0;
+    while (readOnlyLen < len && base + readOnlyLen < 0x10000 && memoryController_isReadOnly((uint16_t)(base + readOnlyLen)))
+        readOnlyLen++;
+    if (readOnlyLen == 0) {
+        formattedLog(debuglog, LOGTYPE_DEBUG, "Not threading ROM at %04X: it can be written\n", base);
+        return false;
+    }
+    if (readOnlyLen < len) {
+        formattedLog(debuglog, LOGTYPE_DEBUG, "Threading ROM at %04X up to %04X, the rest can be written\n", base, base + readOnlyLen);
+    }
+    len = readOnlyLen;
+
+    Z80Threaded_ops = malloc(len * sizeof(Z80MicroOp_t));
+    Z80Threaded_fused = calloc(len, sizeof(uint8_t));
+    if (Z80Threaded_ops == NULL || Z80Threaded_fused == NULL) {
+        formattedLog(stdlog, LOGTYPE_ERROR, "Unable to allocate threaded code for the ROM\n");
+        Z80Threaded_release();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < len; i++) {
+        uint8_t m1Cycles = Z80_decodeAt((uint16_t)(base + i));
+        Z80Block_captureOp(&Z80Threaded_ops[i], m1Cycles);
+        // The whole instruction has to be in the ROM, otherwise it is left to the normal path
+        if (i + cInstr.instrByteLen > len)
+            Z80Threaded_ops[i].len = 0;
+    }
+    internalState = Z80State_Fetch;
+
+    Z80Threaded_base = base;
+    Z80Threaded_len = len;
+    Z80Threaded_fuse();
+    return true;
+}
+
+/*
+Finds the Z80Fusion pattern starting at each ROM address, following the code from there as it would run
+*/
+void Z80Threaded_fuse() {
+    for (uint32_t i = 0; i < Z80Threaded_len; i++) {
+        const Z80MicroOp_t* ops[Z80_FUSION_MAX_OPS];
+        int available = Z80Threaded_group(i, ops);
+        Z80Threaded_fused[i] = available > 0 ? Z80Fusion_match(ops, available) : 0;
+    }
+}
+
+/*
+Fills 'ops' with the ops that run one after the other from ROM offset 'offset', up to Z80_FUSION_MAX_OPS of them, and
+returns how many there are before one runs off the threaded code
+*/
+int Z80Threaded_group(uint32_t offset, const Z80MicroOp_t** ops) {
+    int numOps = 0;
+    while (numOps < Z80_FUSION_MAX_OPS && offset < Z80Threaded_len && Z80Threaded_ops[offset].len != 0) {
+        ops[numOps++] = &Z80Threaded_ops[offset];
+        offset += Z80Threaded_ops[offset].len;
+    }
+    return numOps;
+}
+
+/*
+Drops the threaded code
+*/
+void Z80Threaded_release() {
+    free(Z80Threaded_ops);
+    free(Z80Threaded_fused);
+    Z80Threaded_ops = NULL;
+    Z80Threaded_fused = NULL;
+    Z80Threaded_len = 0;
+}
+
+/*
+Drops the threaded code and puts the module back as it was before any ROM was threaded
+*/
+void Z80Threaded_destroy() {
+    Z80Threaded_release();
+    Z80Threaded_base = 0;
+    Z80Threaded_enabled = true;
+    Z80Threaded_instructions = 0;
+}
+
+/*
+Returns the op for the instruction at 'address', or NULL if it isn't in the threaded ROM
+*/
+Z80MicroOp_t* Z80Threaded_lookup(uint16_t address) {
+    if (!Z80THREADED_COVERS(address))
+        return NULL;
+    return &Z80Threaded_ops[(uint16_t)(address - Z80Threaded_base)];
+}
+
+/*
+Runs instructions straight from the threaded code while PC stays in the ROM, until at least 'tStates' T-states have elapsed or the CPU stops.
+Interrupts are polled before every instruction as in Z80_step()
+*/
+uint64_t Z80Threaded_run(uint64_t tStates) {
+    uint64_t executed = 0;
+
+    while (executed < tStates && !Z80_wait && internalState != Z80State_Failure) {
+        // Checked before polling, as the poll ends the EI delay and the instruction after EI has to follow it
+        if (!Z80THREADED_COVERS(PC))
+            break;
+
+        if (Z80_INTERRUPT_POSSIBLE()) {
+            int interruptTStates = Z80_pollInterrupts();
+            if (interruptTStates > 0) {
+                Z80_tStates += interruptTStates;
+                executed += interruptTStates;
+                continue;
+            }
+        }
+
+        uint16_t from = PC;
+        uint16_t offset = (uint16_t)(from - Z80Threaded_base);
+
+        // A run of ops with a fused handler goes through it in one call
+        if (Z80Threaded_fused[offset] != 0) {
+            // The ROM can't change, so the ops are still the ones Z80Threaded_fuse() matched, each following the last
+            const Z80MicroOp_t* group[Z80_FUSION_MAX_OPS];
+            int numOps = Z80Fusion_patterns[Z80Threaded_fused[offset] - 1].numOps;
+            group[0] = &Z80Threaded_ops[offset];
+            for (int j = 1; j < numOps; j++)
+                group[j] = group[j - 1] + group[j - 1]->len;
+            uint64_t fusedTStates;
+            Z80FUSION_RUN(Z80Threaded_fused[offset], group, tStates - executed, fusedTStates);
+            if (fusedTStates > 0) {
+                executed += fusedTStates;
+                Z80Threaded_instructions += numOps;
+                // The idle loop detector sees the branch from the last op
+                uint16_t last = (uint16_t)(from + (group[numOps - 1] - group[0]));
+                if (Z80Idle_enabled && Z80IDLE_IS_LOOP_BRANCH(last, PC))
+                    executed += Z80Idle_loopHead();
+                continue;
+            }
+        }
+
+        Z80MicroOp_t* op = &Z80Threaded_ops[offset];
+        Z80_ISSUE_MICRO_OP(op);
+
+        PC += op->len;
+        internalState = Z80State_Execute;
+        int execFuncResponse = op->exec();
+
+        Z80_tStates += cInstr.tStates;
+        executed += cInstr.tStates;
+        Z80_instructionsExecuted++;
+        Z80Threaded_instructions++;
+
+        if (execFuncResponse != INSTR_EXEC_SUCCESS) {
+            formattedLog(stdlog, LOGTYPE_ERROR, "Threaded execution has failed: opcode %04X %02X returned %i\n", cInstr.prefix, cInstr.opcode, execFuncResponse);
+            signals_raiseSignal(&signal_WAIT);
+            internalState = Z80State_Failure;
+            break;
+        }
+        internalState = Z80State_Fetch;
+
+        if (Z80Idle_enabled && Z80IDLE_IS_LOOP_BRANCH(from, PC))
+            executed += Z80Idle_loopHead();
+    }
+    return executed;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+/*
+
+ _____   ____         ______ ____
+/__  /  / __ \ _  __ / ____// __ \
+  / /  / / / /| |/_//___ \ / / / /
+ / /__/ /_/ /_>  < ____/ // /_/ /
+/____/\____//_/|_|/_____/ \____/
+
+Zilog 80 Emulator
+
+Basic interface to the Z80 processor and associated modules.
+Can be run as a Sinclair ZX Spectrum or used as a basis for a larger project.
+
+Z80Threaded.h : Threaded code for read-only memory. The ROM is decoded once at load time, one micro-op for every address
+
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Z80Block.h"
+#include "../Z0Machine.h"
+
+/* Threaded ROM state */
+extern Z0_MACHINE_LOCAL bool Z80Threaded_enabled;
+extern Z0_MACHINE_LOCAL Z80MicroOp_t* Z80Threaded_ops; // One op per ROM address. A length of 0 marks an instruction running off the end of the ROM
+extern Z0_MACHINE_LOCAL uint8_t* Z80Threaded_fused; // ALLOCATED: Z80Fusion pattern starting at each ROM address, as its index + 1, or 0
+extern Z0_MACHINE_LOCAL uint16_t Z80Threaded_base;
+extern Z0_MACHINE_LOCAL uint32_t Z80Threaded_len;
+
+/* Statistics */
+extern Z0_MACHINE_LOCAL uint64_t Z80Threaded_instructions;
+
+/* True if PC is at an instruction that was decoded from the ROM */
+#define Z80THREADED_COVERS(address) ((uint16_t)((address) - Z80Threaded_base) < Z80Threaded_len \
+    && Z80Threaded_ops[(uint16_t)((address) - Z80Threaded_base)].len != 0)
+
+/********************************************************************
+
+    Z80 Threaded ROM Functions
+
+********************************************************************/
+
+bool Z80Threaded_predecode(uint16_t base, uint32_t len);
+void Z80Threaded_fuse();
+int Z80Threaded_group(uint32_t offset, const Z80MicroOp_t** ops);
+void Z80Threaded_release();
+void Z80Threaded_destroy();
+Z80MicroOp_t* Z80Threaded_lookup(uint16_t address);
+uint64_t Z80Threaded_run(uint64_t tStates);